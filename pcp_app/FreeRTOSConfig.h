@@ -55,6 +55,7 @@
 #define configCHECK_FOR_STACK_OVERFLOW			0
 #define configUSE_RECURSIVE_MUTEXES				1
 #define configQUEUE_REGISTRY_SIZE				20
+#define configQUEUE_REGISTRY_HASHED				1
 #define configUSE_MALLOC_FAILED_HOOK			1
 #define configUSE_APPLICATION_TASK_TAG			1
 #define configUSE_COUNTING_SEMAPHORES			1
@@ -63,6 +64,32 @@
 #define configUSE_TASK_NOTIFICATIONS			1
 #define configSUPPORT_STATIC_ALLOCATION			1
 
+/* Kernel objects and features that are off by default, used by pcp_bench. */
+#define configUSE_RW_LOCKS						1
+#define configMAX_PRIORITY_INHERITANCE_DEPTH	4
+#define configUSE_QUEUE_SET_READY_LIST			1
+#define configUSE_STREAM_BUFFER_ZERO_COPY		1
+#define configUSE_MRMW_STREAM_BUFFERS			1
+#define configUSE_BROADCAST_BUFFERS				1
+#define configUSE_STREAM_BUFFER_SCATTER_GATHER	1
+#define configUSE_STREAM_BUFFER_HOST_WRITER		1
+#define configUSE_EVENT_GROUP_WAITER_INDEX		1
+#define configUSE_EVENT_GROUP_DIRECT_ISR_SET	1
+#define configUSE_64_BIT_EVENT_GROUPS			1
+#define configUSE_QUEUE_ZERO_COPY				1
+#define configUSE_SPSC_QUEUES					1
+#define configUSE_PRIORITY_QUEUES				1
+#define configUSE_BARRIERS						1
+#define configUSE_EVENT_GROUP_STATS				1
+#define configEVENT_GROUP_STATS_WAIT_SHIFT		10
+#define configUSE_TRACE_FACILITY				1
+
+/* Turned off by the build of pcp_bench that measures queue_handoff without
+it. */
+#ifndef configUSE_QUEUE_DIRECT_HANDOFF
+	#define configUSE_QUEUE_DIRECT_HANDOFF		1
+#endif
+
 /* Software timer related configuration options. */
 #define configUSE_TIMERS						1
 #define configTIMER_TASK_PRIORITY				( configMAX_PRIORITIES - 1 )
@@ -71,18 +98,24 @@
 
 #define configMAX_PRIORITIES					( 32 )
 
-/* Run time stats gathering configuration options. */
-#define configGENERATE_RUN_TIME_STATS			0
+/* Run time stats gathering configuration options.  On the Posix port the
+run time counter counts nanoseconds, so needs to be 64 bits wide. */
+#define configGENERATE_RUN_TIME_STATS			1
+#define configRUN_TIME_COUNTER_TYPE				uint64_t
 
-/* Co-routine related configuration options. */
-#define configUSE_CO_ROUTINES 					1
+/* Co-routine related configuration options.  Turned off by the build of
+pcp_bench with more than one kernel instance, which co-routines do not
+support. */
+#ifndef configUSE_CO_ROUTINES
+	#define configUSE_CO_ROUTINES 				1
+#endif
 #define configMAX_CO_ROUTINE_PRIORITIES			( 2 )
 
 /* This demo makes use of one or more example stats formatting functions.  These
 format the raw data provided by the uxTaskGetSystemState() function in to human
 readable ASCII form.  See the notes in the implementation of vTaskList() within
 FreeRTOS/Source/tasks.c for limitations. */
-#define configUSE_STATS_FORMATTING_FUNCTIONS	0
+#define configUSE_STATS_FORMATTING_FUNCTIONS	1
 
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function.  In most cases the linker will remove unused
@@ -109,6 +142,17 @@ uses the same semantics as the standard C assert() macro. */
 extern void vAssertCalled( unsigned long ulLine, const char * const pcFileName );
 #define configASSERT( x ) if( ( x ) == 0 ) vAssertCalled( __LINE__, __FILE__ )
 
+/* Counts the context switches of task-set runs, see main_exercise.c. */
+extern void vExerciseTaskSwitchedIn( void *pvTask );
+#define traceTASK_SWITCHED_IN() vExerciseTaskSwitchedIn( pxCurrentTCB )
+
+/* Lets stream_host_writer of pcp_bench write to a stream buffer from a host
+thread while the reading task is between finding the buffer empty and
+blocking on it, see main_bench_stream_buffer.c.  The hook is NULL otherwise. */
+extern void ( * volatile pxStreamBufferWaitHook )( void *pvStreamBuffer, int iBlocking );
+#define traceSTREAM_BUFFER_RECEIVE_EMPTY( xStreamBuffer )			do { if( pxStreamBufferWaitHook != NULL ) { pxStreamBufferWaitHook( ( xStreamBuffer ), 0 ); } } while( 0 )
+#define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer )	do { if( pxStreamBufferWaitHook != NULL ) { pxStreamBufferWaitHook( ( xStreamBuffer ), 1 ); } } while( 0 )
+
 #define configINCLUDE_MESSAGE_BUFFER_AMP_DEMO	0
 #if ( configINCLUDE_MESSAGE_BUFFER_AMP_DEMO == 1 )
 	extern void vGenerateCoreBInterrupt( void * xUpdatedMessageBuffer );
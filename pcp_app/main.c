@@ -51,9 +51,19 @@
 #define mainREGION_2_SIZE	29905
 #define mainREGION_3_SIZE	6407
 
+#ifndef mainRUN_BATCH
+	#define mainRUN_BATCH	0
+#endif
+
+#ifndef mainRUN_BENCH
+	#define mainRUN_BENCH	0
+#endif
+
 /*-----------------------------------------------------------*/
 
 extern void main_exercise( void );
+extern int main_batch( int argc, char *argv[] );
+extern int main_bench( int argc, char *argv[] );
 
 static void  prvInitialiseHeap( void );
 
@@ -66,19 +76,40 @@ void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, Stack
 
 /*-----------------------------------------------------------*/
 
-StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+/* One per kernel instance, as each instance has a Timer task of its own. */
+StackType_t uxTimerTaskStack[ configNUMBER_OF_KERNEL_INSTANCES ][ configTIMER_TASK_STACK_DEPTH ];
 
 /* Notes if the trace is running or not. */
 static BaseType_t xTraceRunning = pdTRUE;
 
+/* Called by the stream buffer trace macros, see FreeRTOSConfig.h. */
+void ( * volatile pxStreamBufferWaitHook )( void *pvStreamBuffer, int iBlocking ) = NULL;
+
 /*-----------------------------------------------------------*/
 
-int main( void )
+int main( int argc, char *argv[] )
 {
 	prvInitialiseHeap();
 
-	main_exercise();
-	
+	/* pcp_batch is built from the same sources with mainRUN_BATCH set, see
+	main_batch.c, and pcp_bench with mainRUN_BENCH set, see main_bench.c. */
+	#if ( mainRUN_BATCH == 1 )
+	{
+		return main_batch( argc, argv );
+	}
+	#elif ( mainRUN_BENCH == 1 )
+	{
+		return main_bench( argc, argv );
+	}
+	#else
+	{
+		( void ) argc;
+		( void ) argv;
+
+		main_exercise();
+	}
+	#endif
+
 	return 0;
 }
 /*-----------------------------------------------------------*/
@@ -225,16 +256,18 @@ void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackTy
 {
 /* If the buffers to be provided to the Idle task are declared inside this
 function then they must be declared static - otherwise they will be allocated on
-the stack and so not exists after this function exits. */
-static StaticTask_t xIdleTaskTCB;
-static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+the stack and so not exists after this function exits.  Each kernel instance
+has an Idle task of its own, and calls this from the thread that starts its
+scheduler. */
+static StaticTask_t xIdleTaskTCB[ configNUMBER_OF_KERNEL_INSTANCES ];
+static StackType_t uxIdleTaskStack[ configNUMBER_OF_KERNEL_INSTANCES ][ configMINIMAL_STACK_SIZE ];
 
 	/* Pass out a pointer to the StaticTask_t structure in which the Idle task's
 	state will be stored. */
-	*ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+	*ppxIdleTaskTCBBuffer = &xIdleTaskTCB[ portGET_KERNEL_INSTANCE() ];
 
 	/* Pass out the array that will be used as the Idle task's stack. */
-	*ppxIdleTaskStackBuffer = uxIdleTaskStack;
+	*ppxIdleTaskStackBuffer = uxIdleTaskStack[ portGET_KERNEL_INSTANCE() ];
 
 	/* Pass out the size of the array pointed to by *ppxIdleTaskStackBuffer.
 	Note that, as the array is necessarily of type StackType_t,
@@ -250,15 +283,16 @@ void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, Stack
 {
 /* If the buffers to be provided to the Timer task are declared inside this
 function then they must be declared static - otherwise they will be allocated on
-the stack and so not exists after this function exits. */
-static StaticTask_t xTimerTaskTCB;
+the stack and so not exists after this function exits.  One per kernel
+instance, as for the Idle task. */
+static StaticTask_t xTimerTaskTCB[ configNUMBER_OF_KERNEL_INSTANCES ];
 
 	/* Pass out a pointer to the StaticTask_t structure in which the Timer
 	task's state will be stored. */
-	*ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+	*ppxTimerTaskTCBBuffer = &xTimerTaskTCB[ portGET_KERNEL_INSTANCE() ];
 
 	/* Pass out the array that will be used as the Timer task's stack. */
-	*ppxTimerTaskStackBuffer = uxTimerTaskStack;
+	*ppxTimerTaskStackBuffer = uxTimerTaskStack[ portGET_KERNEL_INSTANCE() ];
 
 	/* Pass out the size of the array pointed to by *ppxTimerTaskStackBuffer.
 	Note that, as the array is necessarily of type StackType_t,
@@ -0,0 +1,485 @@
+/******************************************************************************
+ * Batch runner for the ICPP exercise, built as pcp_batch.
+ *
+ *   pcp_batch [-j jobs] [-f csv|json] [-o file] [-t seconds] [-v] <directory>
+ *
+ * Runs every task-set description in <directory> (see main_exercise.h for the
+ * format) through main_exercise_task_set(), and writes one record of metrics
+ * per task set, in file name order, to <file> or to stdout.
+ *
+ * The kernel and the exercise keep their state in globals, so each task set
+ * runs in a child process of its own.  Up to <jobs> children run at a time,
+ * by default one per host CPU, and each time one exits the next task set in
+ * the queue is started, so the CPUs are kept busy however long each run
+ * takes.  Children return their metrics through shared memory.  The console
+ * output of the runs is discarded unless -v is given, and runs that take
+ * longer than <seconds> (default 60) of host time are killed.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+
+#include "main_exercise.h"
+
+#define batchMAX_PATH_LENGTH		( 512 )
+#define batchMAX_ERROR_LENGTH		( 160 )
+#define batchDEFAULT_TIMEOUT_S		( 60 )
+#define batchPOLL_PERIOD_NS			( 10000000L )
+
+typedef enum
+{
+	eRunQueued = 0,
+	eRunOk,
+	eRunError,
+	eRunCrashed,
+	eRunTimedOut
+} RunStatus_t;
+
+/* One task set.  Shared with the child process that runs it. */
+typedef struct BatchRun
+{
+	char cPath[ batchMAX_PATH_LENGTH ];
+	char cError[ batchMAX_ERROR_LENGTH ];
+	RunStatus_t eStatus;
+	pid_t xPid;
+	struct timespec xStarted;
+	ExerciseResult_t xResult;
+} BatchRun_t;
+
+/*-----------------------------------------------------------*/
+
+int main_batch( int argc, char *argv[] );
+
+static void prvUsage( const char *pcProgram );
+static int prvCompareRuns( const void *pvA, const void *pvB );
+static BatchRun_t *prvFindTaskSets( const char *pcDirectory, size_t *pxNumberOfRuns );
+static void prvRunTaskSet( BatchRun_t *pxRun, int iVerbose ) __attribute__( ( noreturn ) );
+static void prvRunAll( BatchRun_t *pxRuns, size_t xNumberOfRuns, long lJobs, long lTimeout, int iVerbose );
+static void prvWriteCsv( FILE *pxOut, const BatchRun_t *pxRuns, size_t xNumberOfRuns );
+static void prvWriteJson( FILE *pxOut, const BatchRun_t *pxRuns, size_t xNumberOfRuns );
+static void prvWriteCsvString( FILE *pxOut, const char *pcString );
+static void prvWriteJsonString( FILE *pxOut, const char *pcString );
+static uint32_t prvTotalDeadlineMisses( const ExerciseResult_t *pxResult );
+
+static const char * const pcStatusNames[] = { "queued", "ok", "error", "crashed", "timeout" };
+
+/*-----------------------------------------------------------*/
+
+int main_batch( int argc, char *argv[] )
+{
+long lJobs = sysconf( _SC_NPROCESSORS_ONLN );
+long lTimeout = batchDEFAULT_TIMEOUT_S;
+int iJson = 0, iVerbose = 0, iOption;
+const char *pcOutput = NULL;
+BatchRun_t *pxRuns;
+size_t xNumberOfRuns;
+FILE *pxOut = stdout;
+
+	while( ( iOption = getopt( argc, argv, "j:f:o:t:v" ) ) != -1 )
+	{
+		switch( iOption )
+		{
+			case 'j':	lJobs = strtol( optarg, NULL, 10 ); break;
+			case 't':	lTimeout = strtol( optarg, NULL, 10 ); break;
+			case 'o':	pcOutput = optarg; break;
+			case 'v':	iVerbose = 1; break;
+			case 'f':
+				if( strcmp( optarg, "json" ) == 0 )
+				{
+					iJson = 1;
+				}
+				else if( strcmp( optarg, "csv" ) != 0 )
+				{
+					prvUsage( argv[ 0 ] );
+					return EXIT_FAILURE;
+				}
+				break;
+			default:
+				prvUsage( argv[ 0 ] );
+				return EXIT_FAILURE;
+		}
+	}
+
+	if( ( optind != argc - 1 ) || ( lJobs < 1 ) || ( lTimeout < 1 ) )
+	{
+		prvUsage( argv[ 0 ] );
+		return EXIT_FAILURE;
+	}
+
+	pxRuns = prvFindTaskSets( argv[ optind ], &xNumberOfRuns );
+
+	if( pxRuns == NULL )
+	{
+		return EXIT_FAILURE;
+	}
+
+	if( pcOutput != NULL )
+	{
+		pxOut = fopen( pcOutput, "w" );
+
+		if( pxOut == NULL )
+		{
+			fprintf( stderr, "%s: %s\n", pcOutput, strerror( errno ) );
+			return EXIT_FAILURE;
+		}
+	}
+
+	prvRunAll( pxRuns, xNumberOfRuns, lJobs, lTimeout, iVerbose );
+
+	if( iJson != 0 )
+	{
+		prvWriteJson( pxOut, pxRuns, xNumberOfRuns );
+	}
+	else
+	{
+		prvWriteCsv( pxOut, pxRuns, xNumberOfRuns );
+	}
+
+	if( pxOut != stdout )
+	{
+		fclose( pxOut );
+	}
+
+	return EXIT_SUCCESS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUsage( const char *pcProgram )
+{
+	fprintf( stderr, "usage: %s [-j jobs] [-f csv|json] [-o file] [-t seconds] [-v] <task-set directory>\n", pcProgram );
+}
+/*-----------------------------------------------------------*/
+
+static int prvCompareRuns( const void *pvA, const void *pvB )
+{
+	return strcmp( ( ( const BatchRun_t * ) pvA )->cPath, ( ( const BatchRun_t * ) pvB )->cPath );
+}
+/*-----------------------------------------------------------*/
+
+static BatchRun_t *prvFindTaskSets( const char *pcDirectory, size_t *pxNumberOfRuns )
+{
+DIR *pxDirectory;
+struct dirent *pxEntry;
+struct stat xStat;
+BatchRun_t *pxRuns;
+size_t xCount = 0, xMaximum = 0;
+
+	pxDirectory = opendir( pcDirectory );
+
+	if( pxDirectory == NULL )
+	{
+		fprintf( stderr, "%s: %s\n", pcDirectory, strerror( errno ) );
+		return NULL;
+	}
+
+	/* Count the files first, as the runs are in memory shared with the
+	children, which cannot be grown. */
+	while( readdir( pxDirectory ) != NULL )
+	{
+		xMaximum++;
+	}
+
+	pxRuns = mmap( NULL, ( xMaximum + 1 ) * sizeof( BatchRun_t ), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+
+	if( pxRuns == MAP_FAILED )
+	{
+		fprintf( stderr, "mmap: %s\n", strerror( errno ) );
+		closedir( pxDirectory );
+		return NULL;
+	}
+
+	rewinddir( pxDirectory );
+
+	while( ( ( pxEntry = readdir( pxDirectory ) ) != NULL ) && ( xCount < xMaximum ) )
+	{
+		if( pxEntry->d_name[ 0 ] == '.' )
+		{
+			continue;
+		}
+
+		snprintf( pxRuns[ xCount ].cPath, sizeof( pxRuns[ xCount ].cPath ), "%s/%s", pcDirectory, pxEntry->d_name );
+
+		if( ( stat( pxRuns[ xCount ].cPath, &xStat ) == 0 ) && S_ISREG( xStat.st_mode ) )
+		{
+			xCount++;
+		}
+	}
+
+	closedir( pxDirectory );
+
+	qsort( pxRuns, xCount, sizeof( BatchRun_t ), prvCompareRuns );
+
+	*pxNumberOfRuns = xCount;
+
+	return pxRuns;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTaskSet( BatchRun_t *pxRun, int iVerbose )
+{
+int iNull;
+
+	if( iVerbose == 0 )
+	{
+		iNull = open( "/dev/null", O_WRONLY );
+
+		if( iNull >= 0 )
+		{
+			dup2( iNull, STDOUT_FILENO );
+			close( iNull );
+		}
+	}
+
+	if( xExerciseLoadTaskSet( pxRun->cPath, pxRun->cError, sizeof( pxRun->cError ) ) != pdPASS )
+	{
+		_exit( 2 );
+	}
+
+	main_exercise_task_set( &pxRun->xResult );
+
+	fflush( stdout );
+	_exit( 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunAll( BatchRun_t *pxRuns, size_t xNumberOfRuns, long lJobs, long lTimeout, int iVerbose )
+{
+size_t xNext = 0, x;
+long lRunning = 0;
+pid_t xPid;
+int iStatus;
+struct timespec xNow, xPoll = { 0, batchPOLL_PERIOD_NS };
+
+	while( ( xNext < xNumberOfRuns ) || ( lRunning > 0 ) )
+	{
+		/* Start the next task sets in the queue on the free CPUs. */
+		while( ( xNext < xNumberOfRuns ) && ( lRunning < lJobs ) )
+		{
+			fflush( NULL );
+			xPid = fork();
+
+			if( xPid == 0 )
+			{
+				prvRunTaskSet( &pxRuns[ xNext ], iVerbose );
+			}
+
+			if( xPid < 0 )
+			{
+				snprintf( pxRuns[ xNext ].cError, sizeof( pxRuns[ xNext ].cError ), "fork: %s", strerror( errno ) );
+				pxRuns[ xNext ].eStatus = eRunError;
+			}
+			else
+			{
+				pxRuns[ xNext ].xPid = xPid;
+				clock_gettime( CLOCK_MONOTONIC, &pxRuns[ xNext ].xStarted );
+				lRunning++;
+			}
+
+			xNext++;
+		}
+
+		xPid = waitpid( -1, &iStatus, WNOHANG );
+
+		if( xPid > 0 )
+		{
+			for( x = 0; ( x < xNext ) && ( pxRuns[ x ].xPid != xPid ); x++ )
+			{
+			}
+
+			if( x < xNext )
+			{
+				if( pxRuns[ x ].eStatus == eRunQueued )
+				{
+					if( WIFEXITED( iStatus ) && ( WEXITSTATUS( iStatus ) == 0 ) )
+					{
+						pxRuns[ x ].eStatus = eRunOk;
+					}
+					else if( WIFEXITED( iStatus ) )
+					{
+						pxRuns[ x ].eStatus = eRunError;
+					}
+					else
+					{
+						pxRuns[ x ].eStatus = eRunCrashed;
+						snprintf( pxRuns[ x ].cError, sizeof( pxRuns[ x ].cError ), "%s", strsignal( WTERMSIG( iStatus ) ) );
+					}
+				}
+
+				pxRuns[ x ].xPid = 0;
+				lRunning--;
+			}
+
+			continue;
+		}
+
+		/* Kill the runs that have taken too long, then wait a little. */
+		clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+		for( x = 0; x < xNext; x++ )
+		{
+			if( ( pxRuns[ x ].xPid > 0 ) && ( pxRuns[ x ].eStatus == eRunQueued ) &&
+				( ( ( xNow.tv_sec - pxRuns[ x ].xStarted.tv_sec ) * 1000000000L + ( xNow.tv_nsec - pxRuns[ x ].xStarted.tv_nsec ) ) >= lTimeout * 1000000000L ) )
+			{
+				pxRuns[ x ].eStatus = eRunTimedOut;
+				kill( pxRuns[ x ].xPid, SIGKILL );
+			}
+		}
+
+		nanosleep( &xPoll, NULL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTotalDeadlineMisses( const ExerciseResult_t *pxResult )
+{
+uint32_t ulMisses = 0, x;
+
+	for( x = 0; x < pxResult->ulNumberOfTasks; x++ )
+	{
+		ulMisses += pxResult->xTasks[ x ].ulDeadlineMisses;
+	}
+
+	return ulMisses;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteCsv( FILE *pxOut, const BatchRun_t *pxRuns, size_t xNumberOfRuns )
+{
+size_t x;
+uint32_t ulTask, ulJobs;
+TickType_t xMaxBlocking, xMaxResponse;
+const ExerciseResult_t *pxResult;
+
+	fprintf( pxOut, "task_set,status,tasks,jobs,deadline_misses,max_blocking_ticks,max_response_ticks,context_switches,simulated_ticks,error\n" );
+
+	for( x = 0; x < xNumberOfRuns; x++ )
+	{
+		pxResult = &pxRuns[ x ].xResult;
+		ulJobs = 0;
+		xMaxBlocking = 0;
+		xMaxResponse = 0;
+
+		for( ulTask = 0; ulTask < pxResult->ulNumberOfTasks; ulTask++ )
+		{
+			ulJobs += pxResult->xTasks[ ulTask ].ulJobs;
+
+			if( pxResult->xTasks[ ulTask ].xMaxBlocking > xMaxBlocking )
+			{
+				xMaxBlocking = pxResult->xTasks[ ulTask ].xMaxBlocking;
+			}
+
+			if( pxResult->xTasks[ ulTask ].xMaxResponse > xMaxResponse )
+			{
+				xMaxResponse = pxResult->xTasks[ ulTask ].xMaxResponse;
+			}
+		}
+
+		prvWriteCsvString( pxOut, pxRuns[ x ].cPath );
+		fprintf( pxOut, ",%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,", pcStatusNames[ pxRuns[ x ].eStatus ],
+				 ( unsigned long ) pxResult->ulNumberOfTasks, ( unsigned long ) ulJobs,
+				 ( unsigned long ) prvTotalDeadlineMisses( pxResult ), ( unsigned long ) xMaxBlocking,
+				 ( unsigned long ) xMaxResponse, ( unsigned long ) pxResult->ulContextSwitches,
+				 ( unsigned long ) pxResult->xSimulatedTicks );
+		prvWriteCsvString( pxOut, pxRuns[ x ].cError );
+		fputc( '\n', pxOut );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteCsvString( FILE *pxOut, const char *pcString )
+{
+	/* Always quoted, with quotes in the string doubled. */
+	fputc( '"', pxOut );
+
+	for( ; *pcString != '\0'; pcString++ )
+	{
+		if( *pcString == '"' )
+		{
+			fputc( '"', pxOut );
+		}
+
+		fputc( *pcString, pxOut );
+	}
+
+	fputc( '"', pxOut );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteJsonString( FILE *pxOut, const char *pcString )
+{
+	fputc( '"', pxOut );
+
+	for( ; *pcString != '\0'; pcString++ )
+	{
+		if( ( *pcString == '"' ) || ( *pcString == '\\' ) )
+		{
+			fprintf( pxOut, "\\%c", *pcString );
+		}
+		else if( ( unsigned char ) *pcString < 0x20 )
+		{
+			fprintf( pxOut, "\\u%04x", ( unsigned int ) *pcString );
+		}
+		else
+		{
+			fputc( *pcString, pxOut );
+		}
+	}
+
+	fputc( '"', pxOut );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteJson( FILE *pxOut, const BatchRun_t *pxRuns, size_t xNumberOfRuns )
+{
+size_t x;
+uint32_t ulTask;
+const ExerciseResult_t *pxResult;
+const ExerciseTaskResult_t *pxTask;
+
+	fprintf( pxOut, "[\n" );
+
+	for( x = 0; x < xNumberOfRuns; x++ )
+	{
+		pxResult = &pxRuns[ x ].xResult;
+
+		fprintf( pxOut, "  {\n    \"task_set\": " );
+		prvWriteJsonString( pxOut, pxRuns[ x ].cPath );
+		fprintf( pxOut, ",\n    \"status\": \"%s\",\n    \"error\": ", pcStatusNames[ pxRuns[ x ].eStatus ] );
+		prvWriteJsonString( pxOut, pxRuns[ x ].cError );
+		fprintf( pxOut, ",\n    \"deadline_misses\": %lu,\n    \"context_switches\": %lu,\n    \"simulated_ticks\": %lu,\n    \"tasks\": [",
+				 ( unsigned long ) prvTotalDeadlineMisses( pxResult ), ( unsigned long ) pxResult->ulContextSwitches,
+				 ( unsigned long ) pxResult->xSimulatedTicks );
+
+		for( ulTask = 0; ulTask < pxResult->ulNumberOfTasks; ulTask++ )
+		{
+			pxTask = &pxResult->xTasks[ ulTask ];
+
+			fprintf( pxOut, "%s\n      { \"name\": ", ( ulTask == 0 ) ? "" : "," );
+			prvWriteJsonString( pxOut, pxTask->cName );
+			fprintf( pxOut, ", \"jobs\": %lu, \"deadline_misses\": %lu, \"max_blocking_ticks\": %lu, \"max_response_ticks\": %lu }",
+					 ( unsigned long ) pxTask->ulJobs, ( unsigned long ) pxTask->ulDeadlineMisses,
+					 ( unsigned long ) pxTask->xMaxBlocking, ( unsigned long ) pxTask->xMaxResponse );
+		}
+
+		fprintf( pxOut, "%s]\n  }%s\n", ( pxResult->ulNumberOfTasks > 0 ) ? "\n    " : "", ( x + 1 < xNumberOfRuns ) ? "," : "" );
+	}
+
+	fprintf( pxOut, "]\n" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,383 @@
+/******************************************************************************
+ * Kernel benchmarks and behaviour checks, built as pcp_bench.
+ *
+ *   pcp_bench [-l] [-u] [-t seconds] [name...]
+ *
+ * Runs the named benchmarks, or all of them, one after the other, and prints
+ * their results.  -l lists the benchmarks instead.  -u runs them without the
+ * privileges the Posix port needs for SCHED_FIFO and mlockall(), to check that
+ * it carries on without them: RLIMIT_RTPRIO and RLIMIT_MEMLOCK are set to zero
+ * and, if it is root, the child gives up root.  Each benchmark checks the
+ * behaviour of what it measures as it goes, and the exit status is zero only if
+ * every benchmark that was run passed.
+ *
+ * The kernel keeps its state in globals and the scheduler can only be started
+ * once, so each benchmark runs in a child process of its own, as the task sets
+ * of pcp_batch do.  The benchmarks are run one at a time, so they do not
+ * compete for the host CPUs, and runs that take longer than <seconds> (default
+ * 30) of host time are killed, which is also what happens to a run that fails
+ * a configASSERT().
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "main_bench.h"
+
+#define benchDEFAULT_TIMEOUT_S		( 30 )
+#define benchPOLL_PERIOD_NS			( 10000000L )
+#define benchHOST_REPORT_SIZE		( 512 )
+
+/* The user and group that -u runs as when started as root. */
+#define benchUNPRIVILEGED_ID		( 65534 )
+
+/*-----------------------------------------------------------*/
+
+int main_bench( int argc, char *argv[] );
+
+static void prvUsage( const char *pcProgram );
+static const BenchDefinition_t *prvFindBench( const char *pcName );
+static int prvRunBench( const BenchDefinition_t *pxBench, long lTimeout );
+static void prvStartBench( const BenchDefinition_t *pxBench ) __attribute__( ( noreturn ) );
+static void prvDropPrivileges( const BenchDefinition_t *pxBench );
+static void prvBenchTask( void *pvParameters );
+
+static const BenchDefinition_t xBenches[] =
+{
+	{ "queue_batch", "xQueueSendMultiple()/xQueueReceiveMultiple() against one item per call", vBenchQueueBatch },
+	{ "queue_pingpong", "xQueueSend()/xQueueReceive() of fixed size copied and memcpy() copied items", vBenchQueuePingPong },
+	{ "spsc_throughput", "xSPSCQueueSend()/xSPSCQueueReceive() against xQueueSend()/xQueueReceive() for the items of queue_pingpong", vBenchSPSCThroughput },
+	{ "queue_handoff", "Send to receive latency of a receiver blocked in xQueueReceive(), and receivers that time out or wait beside a peeker", vBenchQueueHandoff },
+	{ "queue_zero_copy", "Queue reserve/commit and acquire/release against xQueueSend()/xQueueReceive(), and sends to the front while a slot is in use", vBenchQueueZeroCopy },
+	{ "queue_set", "xQueueSelectFromSet() order and member deletion, and select cost for 4, 16 and 64 members", vBenchQueueSet },
+	{ "priority_queue", "Priority queue receive order with equal keys, and 4 and 16 keys against one queue per key in a queue set", vBenchPriorityQueue },
+	{ "queue_registry", "Queue registry add, lookup, unregister and add again, with names in the same bucket", vBenchQueueRegistry },
+	{ "rwlock", "Readers-writer lock hand on order, and 1, 4 and 16 readers against a mutex", vBenchRWLock },
+	{ "mutex_chain", "Priority inheritance along chains of 1 to 3 mutex holders, and the wait at the head", vBenchMutexChain },
+	{ "barrier", "Barrier generations and timeouts, and rounds of 2 to 64 participants against xEventGroupSync()", vBenchBarrier },
+	{ "stream_zero_copy", "Stream and message buffer reserve/commit and peek/consume across the end of the storage area", vBenchStreamZeroCopy },
+	{ "mrmw_order", "MRMW stream buffer writes committed in the order their space was reserved", vBenchMRMWOrder },
+	{ "broadcast_overflow", "Broadcast buffer writes to a buffer full for drop oldest and block writer subscribers", vBenchBroadcastOverflow },
+	{ "message_batch", "xMessageBufferReceiveMany() against one message per call, and gather send, at 16, 64 and 1024 bytes", vBenchMessageBatch },
+	{ "stream_host_writer", "Stream buffer host thread writer against a blocked reader, and writes as the reader is about to block", vBenchStreamHostWriter },
+	{ "event_waiters", "Event group waiters woken by the bits they wait for, and set cost with 0, 4 and 12 other waiters", vBenchEventWaiters },
+	{ "isr_latency", "Interrupt to task latency of xEventGroupSetBitsFromISR(), direct and through the timer task", vBenchISRLatency },
+	{ "event_stats", "Event group statistics counts against a known sequence of sets, clears, waits and timeouts", vBenchEventStats },
+	{ "isr_paths", "Interrupt to task latency of xQueueSendFromISR(), vTaskNotifyGiveFromISR() and xStreamBufferSendFromISR() under load", vBenchISRPaths },
+	{ "isr_masking", "Simulated interrupts held by critical sections and the interrupt mask, and nested by priority", vBenchISRMasking },
+	{ "host_policy", "Posix port host scheduling options reported at scheduler start against the state of the host", vBenchHostPolicy },
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+	{ "instances", "Two kernel instances running at once, with their own queues, registries, delays and ticks", vBenchInstances },
+#endif
+};
+
+#define benchNUMBER_OF_BENCHES		( sizeof( xBenches ) / sizeof( xBenches[ 0 ] ) )
+
+/* Set in the child process when a check fails. */
+static BaseType_t xCheckFailed = pdFALSE;
+
+/* Set by -u. */
+static BaseType_t xUnprivileged = pdFALSE;
+
+/* In the child process, the benchmark being run, and what the port wrote to
+stderr while the scheduler started. */
+static const BenchDefinition_t *pxRunningBench = NULL;
+static FILE *pxHostReportFile = NULL;
+static int iSavedStderr = -1;
+static char cHostReport[ benchHOST_REPORT_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+int main_bench( int argc, char *argv[] )
+{
+long lTimeout = benchDEFAULT_TIMEOUT_S;
+int iOption, iArgument, iFailures = 0;
+size_t x;
+const BenchDefinition_t *pxBench;
+
+	while( ( iOption = getopt( argc, argv, "lut:" ) ) != -1 )
+	{
+		switch( iOption )
+		{
+			case 'l':
+				for( x = 0; x < benchNUMBER_OF_BENCHES; x++ )
+				{
+					printf( "%-24s %s\n", xBenches[ x ].pcName, xBenches[ x ].pcDescription );
+				}
+				return EXIT_SUCCESS;
+
+			case 'u':
+				xUnprivileged = pdTRUE;
+				break;
+
+			case 't':
+				lTimeout = strtol( optarg, NULL, 10 );
+				break;
+
+			default:
+				prvUsage( argv[ 0 ] );
+				return EXIT_FAILURE;
+		}
+	}
+
+	if( lTimeout < 1 )
+	{
+		prvUsage( argv[ 0 ] );
+		return EXIT_FAILURE;
+	}
+
+	/* Check the names first, so a typing error does not cost a full run. */
+	for( iArgument = optind; iArgument < argc; iArgument++ )
+	{
+		if( prvFindBench( argv[ iArgument ] ) == NULL )
+		{
+			fprintf( stderr, "%s: no benchmark called '%s', see -l\n", argv[ 0 ], argv[ iArgument ] );
+			return EXIT_FAILURE;
+		}
+	}
+
+	if( optind == argc )
+	{
+		for( x = 0; x < benchNUMBER_OF_BENCHES; x++ )
+		{
+			iFailures += prvRunBench( &xBenches[ x ], lTimeout );
+		}
+	}
+	else
+	{
+		for( iArgument = optind; iArgument < argc; iArgument++ )
+		{
+			pxBench = prvFindBench( argv[ iArgument ] );
+			iFailures += prvRunBench( pxBench, lTimeout );
+		}
+	}
+
+	return ( iFailures == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvUsage( const char *pcProgram )
+{
+	fprintf( stderr, "usage: %s [-l] [-u] [-t seconds] [benchmark...]\n", pcProgram );
+}
+/*-----------------------------------------------------------*/
+
+static const BenchDefinition_t *prvFindBench( const char *pcName )
+{
+size_t x;
+
+	for( x = 0; x < benchNUMBER_OF_BENCHES; x++ )
+	{
+		if( strcmp( xBenches[ x ].pcName, pcName ) == 0 )
+		{
+			return &xBenches[ x ];
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static int prvRunBench( const BenchDefinition_t *pxBench, long lTimeout )
+{
+pid_t xPid;
+int iStatus;
+long lPolls = 0;
+const char *pcResult;
+struct timespec xPoll = { 0, benchPOLL_PERIOD_NS };
+
+	printf( "%s: %s\n", pxBench->pcName, pxBench->pcDescription );
+	fflush( NULL );
+
+	xPid = fork();
+
+	if( xPid == 0 )
+	{
+		prvStartBench( pxBench );
+	}
+
+	if( xPid < 0 )
+	{
+		fprintf( stderr, "fork: %s\n", strerror( errno ) );
+		return 1;
+	}
+
+	while( waitpid( xPid, &iStatus, WNOHANG ) == 0 )
+	{
+		if( ++lPolls >= ( lTimeout * ( 1000000000L / benchPOLL_PERIOD_NS ) ) )
+		{
+			kill( xPid, SIGKILL );
+			( void ) waitpid( xPid, &iStatus, 0 );
+			printf( "%s: timeout\n\n", pxBench->pcName );
+			return 1;
+		}
+
+		nanosleep( &xPoll, NULL );
+	}
+
+	if( WIFEXITED( iStatus ) && ( WEXITSTATUS( iStatus ) == 0 ) )
+	{
+		pcResult = "ok";
+	}
+	else if( WIFEXITED( iStatus ) )
+	{
+		pcResult = "FAILED";
+	}
+	else
+	{
+		pcResult = strsignal( WTERMSIG( iStatus ) );
+	}
+
+	printf( "%s: %s\n\n", pxBench->pcName, pcResult );
+
+	return ( pcResult[ 0 ] == 'o' ) ? 0 : 1;
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartBench( const BenchDefinition_t *pxBench )
+{
+	if( xUnprivileged != pdFALSE )
+	{
+		prvDropPrivileges( pxBench );
+	}
+
+	/* The port reports its host scheduling policy on stderr as the scheduler
+	starts.  Keep a copy for host_policy, see prvBenchTask(). */
+	fflush( stderr );
+	pxHostReportFile = tmpfile();
+
+	if( pxHostReportFile != NULL )
+	{
+		iSavedStderr = dup( STDERR_FILENO );
+		( void ) dup2( fileno( pxHostReportFile ), STDERR_FILENO );
+	}
+
+	pxRunningBench = pxBench;
+	xTaskCreate( prvBenchTask, "Bench", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY, NULL );
+	vTaskStartScheduler();
+
+	/* Only reached if the scheduler could not start. */
+	printf( "%s: the scheduler did not start\n", pxBench->pcName );
+	fflush( stdout );
+	_exit( 2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvDropPrivileges( const BenchDefinition_t *pxBench )
+{
+struct rlimit xNone = { 0, 0 };
+int iError = 0;
+
+	/* With both limits at zero, SCHED_FIFO and mlockall() need CAP_SYS_NICE and
+	CAP_IPC_LOCK, which root has whatever its limits, so root is given up as
+	well.  The group goes first, as it cannot be changed once root is gone. */
+	#ifdef RLIMIT_RTPRIO
+		if( setrlimit( RLIMIT_RTPRIO, &xNone ) != 0 )
+		{
+			iError = errno;
+		}
+	#endif
+
+	if( setrlimit( RLIMIT_MEMLOCK, &xNone ) != 0 )
+	{
+		iError = errno;
+	}
+
+	if( geteuid() == 0 )
+	{
+		if( ( setgid( benchUNPRIVILEGED_ID ) != 0 ) || ( setuid( benchUNPRIVILEGED_ID ) != 0 ) )
+		{
+			iError = errno;
+		}
+	}
+
+	if( iError != 0 )
+	{
+		printf( "%s: could not drop privileges: %s\n", pxBench->pcName, strerror( iError ) );
+		fflush( stdout );
+		_exit( 2 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+/* The controller task of every benchmark.  Puts stderr back and passes on
+what the port wrote to it, then runs the benchmark's controller. */
+static void prvBenchTask( void *pvParameters )
+{
+size_t xLength;
+
+	( void ) pvParameters;
+
+	if( pxHostReportFile != NULL )
+	{
+		fflush( stderr );
+		( void ) dup2( iSavedStderr, STDERR_FILENO );
+		( void ) close( iSavedStderr );
+
+		rewind( pxHostReportFile );
+		xLength = fread( cHostReport, 1, sizeof( cHostReport ) - 1, pxHostReportFile );
+		cHostReport[ xLength ] = '\0';
+		fclose( pxHostReportFile );
+
+		fputs( cHostReport, stderr );
+	}
+
+	pxRunningBench->pxController( NULL );
+}
+/*-----------------------------------------------------------*/
+
+const char *pcBenchHostReport( void )
+{
+	return cHostReport;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBenchIsUnprivileged( void )
+{
+	return xUnprivileged;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullBenchNow( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( ( uint64_t ) xNow.tv_sec * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+void vBenchCheck( BaseType_t xPassed, const char *pcExpression, const char *pcFile, int iLine )
+{
+	if( xPassed == pdFALSE )
+	{
+		printf( "  %s:%d: check failed: %s\n", pcFile, iLine, pcExpression );
+		xCheckFailed = pdTRUE;
+		vBenchEnd();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchEnd( void )
+{
+	/* Ending the scheduler cleanly would need every task the benchmark
+	created to be deleted first, so leave the process directly. */
+	fflush( stdout );
+	_exit( ( xCheckFailed == pdFALSE ) ? 0 : 1 );
+}
+/*-----------------------------------------------------------*/
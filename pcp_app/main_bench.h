@@ -0,0 +1,78 @@
+#ifndef MAIN_BENCH_H
+#define MAIN_BENCH_H
+
+#include "FreeRTOS.h"
+
+/*
+ * Kernel benchmarks and behaviour checks, built as pcp_bench, see
+ * main_bench.c.
+ *
+ * Each benchmark is a controller task that is created on its own, in a child
+ * process of its own, before the scheduler is started.  It creates any other
+ * tasks and kernel objects it needs, prints its results to stdout, one line per
+ * result, and ends the run with vBenchEnd().  The checks made with benchCHECK()
+ * decide whether the run passes.
+ */
+
+/* The priority of the controller task.  Leaves room above and below for the
+tasks that it creates. */
+#define benchCONTROL_PRIORITY		( tskIDLE_PRIORITY + 10 )
+
+/* Stack depth of the tasks created by benchmarks.  The Posix port runs each
+task on a host thread with a stack of its own, so this is only what the
+kernel allocates for the TCB's stack. */
+#define benchSTACK_SIZE				( configMINIMAL_STACK_SIZE * 2 )
+
+/* End the run, failing it, if x is false. */
+#define benchCHECK( x )				vBenchCheck( ( x ) != 0, #x, __FILE__, __LINE__ )
+
+typedef struct BenchDefinition
+{
+	const char *pcName;
+	const char *pcDescription;
+	TaskFunction_t pxController;
+} BenchDefinition_t;
+
+/* Host monotonic time in nanoseconds. */
+uint64_t ullBenchNow( void );
+
+/* Ends the run of the calling benchmark, passing it unless a check failed. */
+void vBenchEnd( void ) __attribute__( ( noreturn ) );
+
+void vBenchCheck( BaseType_t xPassed, const char *pcExpression, const char *pcFile, int iLine );
+
+/* What the Posix port wrote to stderr while the scheduler started, which is
+where it reports its host scheduling options. */
+const char *pcBenchHostReport( void );
+
+/* pdTRUE if pcp_bench was run with -u. */
+BaseType_t xBenchIsUnprivileged( void );
+
+/* Controller tasks of the benchmarks, see the tables in main_bench.c. */
+void vBenchQueueBatch( void *pvParameters );
+void vBenchQueuePingPong( void *pvParameters );
+void vBenchSPSCThroughput( void *pvParameters );
+void vBenchQueueHandoff( void *pvParameters );
+void vBenchQueueZeroCopy( void *pvParameters );
+void vBenchQueueSet( void *pvParameters );
+void vBenchPriorityQueue( void *pvParameters );
+void vBenchQueueRegistry( void *pvParameters );
+void vBenchRWLock( void *pvParameters );
+void vBenchMutexChain( void *pvParameters );
+void vBenchBarrier( void *pvParameters );
+void vBenchStreamZeroCopy( void *pvParameters );
+void vBenchMRMWOrder( void *pvParameters );
+void vBenchBroadcastOverflow( void *pvParameters );
+void vBenchMessageBatch( void *pvParameters );
+void vBenchStreamHostWriter( void *pvParameters );
+void vBenchEventWaiters( void *pvParameters );
+void vBenchISRLatency( void *pvParameters );
+void vBenchEventStats( void *pvParameters );
+void vBenchISRPaths( void *pvParameters );
+void vBenchISRMasking( void *pvParameters );
+void vBenchHostPolicy( void *pvParameters );
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+	void vBenchInstances( void *pvParameters );
+#endif
+
+#endif /* MAIN_BENCH_H */
@@ -0,0 +1,567 @@
+/******************************************************************************
+ * Event group benchmarks, see main_bench.c.
+ *
+ * event_waiters: checks that setting bits wakes the tasks waiting for them,
+ * and only those, when the waiters are indexed by the bits they wait for.
+ * Each of benchEW_SINGLE_WAITERS tasks waits for a bit of its own, and setting
+ * a bit must wake its task alone.  A task waiting for all of two bits must
+ * stay blocked until the second is set, a task waiting for either of two bits
+ * must wake on the second, and a task whose wait times out must leave nothing
+ * behind for a later set to find.  The same must hold for bits above 31 of a
+ * 64-bit event group: setting bit 40 wakes its task and not the one waiting
+ * for bit 8, a task waiting for all of bits 33 and 55 wakes on the second, and
+ * clearing bit 47 leaves the bits below it.  Bit 50, set with
+ * xEventGroupSetBitsFromISR() from a simulated interrupt, must wake its task
+ * when the scheduler is resumed if it was suspended, through the walk the
+ * interrupt deferred, and before the interrupt returns if not.  It then times setting and clearing a bit
+ * that no task waits for while 0, 4 and benchEW_MAX_OTHER_WAITERS tasks wait
+ * for other bits, which with the index costs the same whatever the number of
+ * waiters.
+ *
+ * isr_latency: times how long a task waiting for an event bit takes to run
+ * after a simulated interrupt sets the bit with xEventGroupSetBitsFromISR(),
+ * measured from the handler to the task.  The bit is set directly, through the
+ * timer task with xTimerPendFunctionCallFromISR() as it is when
+ * configUSE_EVENT_GROUP_DIRECT_ISR_SET is 0, and directly with a NULL
+ * pxHigherPriorityTaskWoken.  The first two must wake the task before the
+ * interrupt returns.  The last leaves the check of the waiting tasks to the
+ * next context switch, so the task must still wake, at the latest on the next
+ * tick.
+ *
+ * event_stats: checks the statistics kept for an event group against a known
+ * sequence of operations.  A task waits benchES_ROUNDS times for a bit, each
+ * set after a delay, a task times out waiting, a bit nobody waits for is set
+ * and cleared, and one set wakes benchES_SHARED_WAITERS tasks at once.  The
+ * counts of sets, clears, waits, timeouts and woken tasks, the most tasks woken
+ * by one set, and the number of wait times in the histogram must match, and
+ * the line written by vEventGroupListStats() must hold the same values.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "timers.h"
+
+#include "main_bench.h"
+
+#define benchEW_SINGLE_WAITERS		( 8 )
+#define benchEW_ALL_BITS			( ( 1UL << 3 ) | ( 1UL << 7 ) )
+#define benchEW_ANY_BITS			( ( 1UL << 2 ) | ( 1UL << 9 ) )
+#define benchEW_TIMEOUT_BIT			( 1UL << 20 )
+#define benchEW_FIRST_OTHER_BIT		( 8 )
+#define benchEW_MAX_OTHER_WAITERS	( 12 )
+#define benchEW_UNWAITED_BIT		( 1UL << 23 )
+#define benchEW_LOOPS				( 100000UL )
+#define benchEW_HIGH_LOW_BIT		( ( EventBits_t ) 1 << 8 )
+#define benchEW_HIGH_BIT			( ( EventBits_t ) 1 << 40 )
+#define benchEW_HIGH_ALL_BITS		( ( ( EventBits_t ) 1 << 33 ) | ( ( EventBits_t ) 1 << 55 ) )
+#define benchEW_HIGH_CLEAR_BIT		( ( EventBits_t ) 1 << 47 )
+#define benchEW_HIGH_ISR_BIT		( ( EventBits_t ) 1 << 50 )
+#define benchEW_INTERRUPT			( 8UL )
+
+#define benchIL_INTERRUPT			( 3UL )
+#define benchIL_BIT					( 1UL << 0 )
+#define benchIL_RUNS				( 1000UL )
+#define benchIL_NULL_WOKEN_RUNS		( 100UL )
+#define benchIL_WAKE_LIMIT_NS		( 1000000000ULL )
+
+#define benchES_ROUNDS				( 10UL )
+#define benchES_SHARED_WAITERS		( 3UL )
+#define benchES_TIMEOUT				( 5 )
+#define benchES_ROUND_BIT			( 1UL << 0 )
+#define benchES_TIMEOUT_BITS		( ( 1UL << 1 ) | ( 1UL << 2 ) )
+#define benchES_UNWAITED_BIT		( 1UL << 4 )
+#define benchES_SHARED_BIT			( 1UL << 5 )
+
+/*-----------------------------------------------------------*/
+
+typedef struct BitWaiter
+{
+	EventGroupHandle_t xGroup;
+	EventBits_t uxBitsToWaitFor;
+	BaseType_t xWaitForAllBits;
+	TickType_t xTimeout;
+	volatile EventBits_t uxResult;	/* What xEventGroupWaitBits() returned. */
+	volatile BaseType_t xDone;		/* Set once the wait has ended. */
+} BitWaiter_t;
+
+/* How the interrupt handler sets the bit. */
+typedef enum
+{
+	eSetDirect,
+	eSetThroughTimerTask,
+	eSetWithoutWoken
+} ISRSetPath_t;
+
+static void prvCheckSingleBitWaiters( EventGroupHandle_t xGroup );
+static void prvCheckAllAndAnyWaiters( EventGroupHandle_t xGroup );
+static void prvCheckTimedOutWaiter( EventGroupHandle_t xGroup );
+static void prvCheckHighBits( EventGroupHandle_t xGroup );
+static uint32_t prvSetHighBitInterruptHandler( void );
+static void prvTimeUnwaitedSet( EventGroupHandle_t xGroup );
+static void prvStartWaiter( BitWaiter_t *pxWaiter, EventGroupHandle_t xGroup, EventBits_t uxBitsToWaitFor, BaseType_t xWaitForAllBits, TickType_t xTimeout );
+static void prvBitWaiterTask( void *pvParameters );
+static void prvTimeISRLatency( const char *pcPath, uint32_t ulRuns );
+static uint32_t prvSetBitsInterruptHandler( void );
+static void prvLatencyWaiterTask( void *pvParameters );
+static void prvCheckListedStats( EventGroupHandle_t xGroup, const EventGroupStats_t *pxStats );
+
+static EventGroupHandle_t xHighBitsGroup = NULL;
+static EventGroupHandle_t xISRGroup = NULL;
+static volatile ISRSetPath_t eISRSetPath = eSetDirect;
+static volatile uint64_t ullISRSetTime = 0;
+static volatile uint64_t ullISRWakeTime = 0;
+static volatile uint32_t ulISRWakes = 0;
+
+/*-----------------------------------------------------------*/
+
+void vBenchEventWaiters( void *pvParameters )
+{
+EventGroupHandle_t xGroup;
+
+	( void ) pvParameters;
+
+	printf( "  %s\n", ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) ? "waiters indexed by bit" : "waiters on one list" );
+
+	xGroup = xEventGroupCreate();
+	benchCHECK( xGroup != NULL );
+
+	prvCheckSingleBitWaiters( xGroup );
+	prvCheckAllAndAnyWaiters( xGroup );
+	prvCheckTimedOutWaiter( xGroup );
+	prvCheckHighBits( xGroup );
+	prvTimeUnwaitedSet( xGroup );
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSingleBitWaiters( EventGroupHandle_t xGroup )
+{
+static BitWaiter_t xWaiters[ benchEW_SINGLE_WAITERS ];
+UBaseType_t x, y;
+
+	for( x = 0; x < benchEW_SINGLE_WAITERS; x++ )
+	{
+		prvStartWaiter( &( xWaiters[ x ] ), xGroup, ( EventBits_t ) 1 << x, pdFALSE, portMAX_DELAY );
+	}
+
+	/* Each waiter runs as soon as it is woken, as it has a higher priority
+	than this task, and clears its bit on the way out. */
+	for( x = 0; x < benchEW_SINGLE_WAITERS; x++ )
+	{
+		( void ) xEventGroupSetBits( xGroup, ( EventBits_t ) 1 << x );
+
+		for( y = 0; y < benchEW_SINGLE_WAITERS; y++ )
+		{
+			benchCHECK( xWaiters[ y ].xDone == ( ( y <= x ) ? pdTRUE : pdFALSE ) );
+		}
+
+		benchCHECK( xWaiters[ x ].uxResult == ( ( EventBits_t ) 1 << x ) );
+		benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+	}
+
+	printf( "  setting a bit wakes only the task waiting for it: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckAllAndAnyWaiters( EventGroupHandle_t xGroup )
+{
+static BitWaiter_t xAll, xAny;
+
+	prvStartWaiter( &xAll, xGroup, benchEW_ALL_BITS, pdTRUE, portMAX_DELAY );
+	prvStartWaiter( &xAny, xGroup, benchEW_ANY_BITS, pdFALSE, portMAX_DELAY );
+
+	/* The first of the two bits leaves the task waiting for all of them
+	blocked, now waiting for the second. */
+	( void ) xEventGroupSetBits( xGroup, 1UL << 3 );
+	benchCHECK( xAll.xDone == pdFALSE );
+	benchCHECK( xEventGroupGetBits( xGroup ) == ( 1UL << 3 ) );
+
+	( void ) xEventGroupSetBits( xGroup, 1UL << 7 );
+	benchCHECK( xAll.xDone != pdFALSE );
+	benchCHECK( xAll.uxResult == benchEW_ALL_BITS );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+	printf( "  task waiting for all of two bits wakes on the second: ok\n" );
+
+	benchCHECK( xAny.xDone == pdFALSE );
+	( void ) xEventGroupSetBits( xGroup, 1UL << 9 );
+	benchCHECK( xAny.xDone != pdFALSE );
+	benchCHECK( xAny.uxResult == ( 1UL << 9 ) );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+	printf( "  task waiting for either of two bits wakes on one: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTimedOutWaiter( EventGroupHandle_t xGroup )
+{
+static BitWaiter_t xWaiter;
+
+	prvStartWaiter( &xWaiter, xGroup, benchEW_TIMEOUT_BIT, pdFALSE, 5 );
+
+	while( xWaiter.xDone == pdFALSE )
+	{
+		vTaskDelay( 1 );
+	}
+
+	benchCHECK( ( xWaiter.uxResult & benchEW_TIMEOUT_BIT ) == 0 );
+
+	/* Nothing waits for the bit now, so it stays set. */
+	( void ) xEventGroupSetBits( xGroup, benchEW_TIMEOUT_BIT );
+	benchCHECK( xEventGroupGetBits( xGroup ) == benchEW_TIMEOUT_BIT );
+	( void ) xEventGroupClearBits( xGroup, benchEW_TIMEOUT_BIT );
+	printf( "  timed out task is no longer waiting for its bit: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckHighBits( EventGroupHandle_t xGroup )
+{
+static BitWaiter_t xLow, xHigh, xAll, xISR;
+
+	/* Setting a bit above 31 wakes only the task waiting for it. */
+	prvStartWaiter( &xLow, xGroup, benchEW_HIGH_LOW_BIT, pdFALSE, portMAX_DELAY );
+	prvStartWaiter( &xHigh, xGroup, benchEW_HIGH_BIT, pdFALSE, portMAX_DELAY );
+
+	( void ) xEventGroupSetBits( xGroup, benchEW_HIGH_BIT );
+	benchCHECK( xHigh.xDone != pdFALSE );
+	benchCHECK( xHigh.uxResult == benchEW_HIGH_BIT );
+	benchCHECK( xLow.xDone == pdFALSE );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+
+	( void ) xEventGroupSetBits( xGroup, benchEW_HIGH_LOW_BIT );
+	benchCHECK( xLow.xDone != pdFALSE );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+
+	/* And waiting for all of two of them needs both. */
+	prvStartWaiter( &xAll, xGroup, benchEW_HIGH_ALL_BITS, pdTRUE, portMAX_DELAY );
+	( void ) xEventGroupSetBits( xGroup, ( EventBits_t ) 1 << 33 );
+	benchCHECK( xAll.xDone == pdFALSE );
+	( void ) xEventGroupSetBits( xGroup, ( EventBits_t ) 1 << 55 );
+	benchCHECK( xAll.xDone != pdFALSE );
+	benchCHECK( xAll.uxResult == benchEW_HIGH_ALL_BITS );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+
+	/* Clearing a bit above 31 leaves the bits below it. */
+	( void ) xEventGroupSetBits( xGroup, benchEW_HIGH_CLEAR_BIT | benchEW_HIGH_LOW_BIT );
+	benchCHECK( xEventGroupClearBits( xGroup, benchEW_HIGH_CLEAR_BIT ) == ( benchEW_HIGH_CLEAR_BIT | benchEW_HIGH_LOW_BIT ) );
+	benchCHECK( xEventGroupGetBits( xGroup ) == benchEW_HIGH_LOW_BIT );
+	( void ) xEventGroupClearBits( xGroup, benchEW_HIGH_LOW_BIT );
+	printf( "  bits above 31 set, waited for and cleared: ok\n" );
+
+	/* An interrupt that sets a bit while the scheduler is suspended leaves the
+	waiting tasks to the walk deferred until the scheduler is resumed. */
+	xHighBitsGroup = xGroup;
+	vPortSetInterruptHandler( benchEW_INTERRUPT, prvSetHighBitInterruptHandler );
+	prvStartWaiter( &xISR, xGroup, benchEW_HIGH_ISR_BIT, pdFALSE, portMAX_DELAY );
+
+	vTaskSuspendAll();
+	{
+		vPortGenerateSimulatedInterrupt( benchEW_INTERRUPT );
+		benchCHECK( xEventGroupGetBits( xGroup ) == benchEW_HIGH_ISR_BIT );
+		benchCHECK( xISR.xDone == pdFALSE );
+	}
+	( void ) xTaskResumeAll();
+
+	benchCHECK( xISR.xDone != pdFALSE );
+	benchCHECK( xISR.uxResult == benchEW_HIGH_ISR_BIT );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+
+	/* Otherwise the walk runs as the interrupt switches to the waiter. */
+	prvStartWaiter( &xISR, xGroup, benchEW_HIGH_ISR_BIT, pdFALSE, portMAX_DELAY );
+	vPortGenerateSimulatedInterrupt( benchEW_INTERRUPT );
+	benchCHECK( xISR.xDone != pdFALSE );
+	benchCHECK( xISR.uxResult == benchEW_HIGH_ISR_BIT );
+	benchCHECK( xEventGroupGetBits( xGroup ) == 0 );
+	printf( "  bit above 31 set from an interrupt, deferred and direct: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvSetHighBitInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	benchCHECK( xEventGroupSetBitsFromISR( xHighBitsGroup, benchEW_HIGH_ISR_BIT, &xHigherPriorityTaskWoken ) == pdPASS );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeUnwaitedSet( EventGroupHandle_t xGroup )
+{
+const UBaseType_t uxWaiters[] = { 0, 4, benchEW_MAX_OTHER_WAITERS };
+static BitWaiter_t xWaiters[ benchEW_MAX_OTHER_WAITERS ];
+UBaseType_t uxStarted = 0;
+uint64_t ullStart, ullTime;
+size_t x;
+uint32_t ul;
+
+	for( x = 0; x < ( sizeof( uxWaiters ) / sizeof( uxWaiters[ 0 ] ) ); x++ )
+	{
+		/* The waiters started for the previous run stay blocked, as the bits
+		they wait for are never set. */
+		while( uxStarted < uxWaiters[ x ] )
+		{
+			prvStartWaiter( &( xWaiters[ uxStarted ] ), xGroup, ( EventBits_t ) 1 << ( benchEW_FIRST_OTHER_BIT + uxStarted ), pdFALSE, portMAX_DELAY );
+			uxStarted++;
+		}
+
+		ullStart = ullBenchNow();
+
+		for( ul = 0; ul < benchEW_LOOPS; ul++ )
+		{
+			( void ) xEventGroupSetBits( xGroup, benchEW_UNWAITED_BIT );
+			( void ) xEventGroupClearBits( xGroup, benchEW_UNWAITED_BIT );
+		}
+
+		ullTime = ullBenchNow() - ullStart;
+
+		for( ul = 0; ul < uxStarted; ul++ )
+		{
+			benchCHECK( xWaiters[ ul ].xDone == pdFALSE );
+		}
+
+		printf( "  %2u tasks waiting for other bits: set+clear %6.1f ns\n",
+				( unsigned ) uxWaiters[ x ],
+				( double ) ullTime / ( double ) benchEW_LOOPS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartWaiter( BitWaiter_t *pxWaiter, EventGroupHandle_t xGroup, EventBits_t uxBitsToWaitFor, BaseType_t xWaitForAllBits, TickType_t xTimeout )
+{
+	pxWaiter->xGroup = xGroup;
+	pxWaiter->uxBitsToWaitFor = uxBitsToWaitFor;
+	pxWaiter->xWaitForAllBits = xWaitForAllBits;
+	pxWaiter->xTimeout = xTimeout;
+	pxWaiter->uxResult = 0;
+	pxWaiter->xDone = pdFALSE;
+
+	/* Runs, and blocks, before this returns. */
+	benchCHECK( xTaskCreate( prvBitWaiterTask, "Bits", benchSTACK_SIZE, pxWaiter, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( pxWaiter->xDone == pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBitWaiterTask( void *pvParameters )
+{
+BitWaiter_t *pxWaiter = ( BitWaiter_t * ) pvParameters;
+
+	pxWaiter->uxResult = xEventGroupWaitBits( pxWaiter->xGroup, pxWaiter->uxBitsToWaitFor, pdTRUE, pxWaiter->xWaitForAllBits, pxWaiter->xTimeout );
+	pxWaiter->xDone = pdTRUE;
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchISRLatency( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	xISRGroup = xEventGroupCreate();
+	benchCHECK( xISRGroup != NULL );
+
+	vPortSetInterruptHandler( benchIL_INTERRUPT, prvSetBitsInterruptHandler );
+	benchCHECK( xTaskCreate( prvLatencyWaiterTask, "Waiter", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+
+	eISRSetPath = eSetDirect;
+	prvTimeISRLatency( "direct:", benchIL_RUNS );
+
+	eISRSetPath = eSetThroughTimerTask;
+	prvTimeISRLatency( "timer task:", benchIL_RUNS );
+
+	eISRSetPath = eSetWithoutWoken;
+	prvTimeISRLatency( "NULL woken:", benchIL_NULL_WOKEN_RUNS );
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeISRLatency( const char *pcPath, uint32_t ulRuns )
+{
+uint64_t ullLatency, ullTotal = 0, ullMax = 0, ullStart;
+uint32_t ul, ulWakes;
+
+	for( ul = 0; ul < ulRuns; ul++ )
+	{
+		ulWakes = ulISRWakes;
+		vPortGenerateSimulatedInterrupt( benchIL_INTERRUPT );
+
+		if( eISRSetPath != eSetWithoutWoken )
+		{
+			/* The interrupt switched to the waiter, which has a higher
+			priority than this task, before it returned. */
+			benchCHECK( ulISRWakes == ( ulWakes + 1 ) );
+		}
+		else
+		{
+			/* Nothing switches context until the tick does, as this task does
+			not block. */
+			ullStart = ullBenchNow();
+
+			while( ( ulISRWakes == ulWakes ) && ( ( ullBenchNow() - ullStart ) < benchIL_WAKE_LIMIT_NS ) )
+			{
+			}
+
+			benchCHECK( ulISRWakes == ( ulWakes + 1 ) );
+		}
+
+		ullLatency = ullISRWakeTime - ullISRSetTime;
+		ullTotal += ullLatency;
+
+		if( ullLatency > ullMax )
+		{
+			ullMax = ullLatency;
+		}
+	}
+
+	benchCHECK( xEventGroupGetBits( xISRGroup ) == 0 );
+
+	printf( "  %-12s interrupt to task %7.1f us average, %7.1f us max\n",
+			pcPath,
+			( double ) ullTotal / ( double ) ulRuns / 1000.0,
+			( double ) ullMax / 1000.0 );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvSetBitsInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	ullISRSetTime = ullBenchNow();
+
+	switch( eISRSetPath )
+	{
+		case eSetDirect:
+			benchCHECK( xEventGroupSetBitsFromISR( xISRGroup, benchIL_BIT, &xHigherPriorityTaskWoken ) == pdPASS );
+			break;
+
+		case eSetThroughTimerTask:
+			benchCHECK( xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xISRGroup, ( uint32_t ) benchIL_BIT, &xHigherPriorityTaskWoken ) == pdPASS );
+			break;
+
+		default:
+			benchCHECK( xEventGroupSetBitsFromISR( xISRGroup, benchIL_BIT, NULL ) == pdPASS );
+			break;
+	}
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvLatencyWaiterTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		( void ) xEventGroupWaitBits( xISRGroup, benchIL_BIT, pdTRUE, pdFALSE, portMAX_DELAY );
+		ullISRWakeTime = ullBenchNow();
+		ulISRWakes++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchEventStats( void *pvParameters )
+{
+static BitWaiter_t xRoundWaiter, xTimeoutWaiter, xSharedWaiters[ benchES_SHARED_WAITERS ];
+EventGroupHandle_t xGroup;
+EventGroupStats_t xStats;
+uint32_t ul, ulWaitTimes = 0;
+
+	( void ) pvParameters;
+
+	xGroup = xEventGroupCreate();
+	benchCHECK( xGroup != NULL );
+
+	/* The timeout ends before the first of the rounds does. */
+	prvStartWaiter( &xTimeoutWaiter, xGroup, benchES_TIMEOUT_BITS, pdTRUE, benchES_TIMEOUT );
+
+	for( ul = 0; ul < benchES_ROUNDS; ul++ )
+	{
+		prvStartWaiter( &xRoundWaiter, xGroup, benchES_ROUND_BIT, pdFALSE, portMAX_DELAY );
+		vTaskDelay( benchES_TIMEOUT + 1 );
+		( void ) xEventGroupSetBits( xGroup, benchES_ROUND_BIT );
+		benchCHECK( xRoundWaiter.xDone != pdFALSE );
+	}
+
+	benchCHECK( xTimeoutWaiter.xDone != pdFALSE );
+
+	( void ) xEventGroupSetBits( xGroup, benchES_UNWAITED_BIT );
+	( void ) xEventGroupClearBits( xGroup, benchES_UNWAITED_BIT );
+
+	for( ul = 0; ul < benchES_SHARED_WAITERS; ul++ )
+	{
+		prvStartWaiter( &( xSharedWaiters[ ul ] ), xGroup, benchES_SHARED_BIT, pdFALSE, portMAX_DELAY );
+	}
+
+	( void ) xEventGroupSetBits( xGroup, benchES_SHARED_BIT );
+
+	for( ul = 0; ul < benchES_SHARED_WAITERS; ul++ )
+	{
+		benchCHECK( xSharedWaiters[ ul ].xDone != pdFALSE );
+	}
+
+	vEventGroupGetStats( xGroup, &xStats );
+
+	for( ul = 0; ul < configEVENT_GROUP_STATS_WAIT_BUCKETS; ul++ )
+	{
+		ulWaitTimes += xStats.ulWaitTimes[ ul ];
+	}
+
+	/* Bits cleared on exit by the woken tasks do not count as clears. */
+	benchCHECK( xStats.ulSets == ( benchES_ROUNDS + 2 ) );
+	benchCHECK( xStats.ulClears == 1 );
+	benchCHECK( xStats.ulWaits == ( benchES_ROUNDS + 1 + benchES_SHARED_WAITERS ) );
+	benchCHECK( xStats.ulTimeouts == 1 );
+	benchCHECK( xStats.ulTasksWoken == ( benchES_ROUNDS + benchES_SHARED_WAITERS ) );
+	benchCHECK( xStats.ulMaxTasksWokenByWalk == benchES_SHARED_WAITERS );
+	benchCHECK( xStats.ulTasksVisited >= xStats.ulTasksWoken );
+	benchCHECK( ulWaitTimes == xStats.ulTasksWoken );
+	benchCHECK( ( xStats.ulMaxSetBitsTime > 0 ) && ( xStats.ulTotalSetBitsTime >= xStats.ulMaxSetBitsTime ) );
+	printf( "  counts match the operations: ok\n" );
+
+	printf( "  set bits: %.1f us max, %.1f us average\n",
+			( double ) xStats.ulMaxSetBitsTime / 1000.0,
+			( double ) xStats.ulTotalSetBitsTime / ( double ) xStats.ulSets / 1000.0 );
+
+	prvCheckListedStats( xGroup, &xStats );
+
+	vEventGroupResetStats( xGroup );
+	vEventGroupGetStats( xGroup, &xStats );
+	benchCHECK( ( xStats.ulSets == 0 ) && ( xStats.ulWaits == 0 ) && ( xStats.ulMaxSetBitsTime == 0 ) );
+	benchCHECK( xStats.ulWaitTimes[ configEVENT_GROUP_STATS_WAIT_BUCKETS - 1 ] == 0 );
+	printf( "  reset clears the statistics: ok\n" );
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckListedStats( EventGroupHandle_t xGroup, const EventGroupStats_t *pxStats )
+{
+static char cLine[ 32 * 12 ];
+unsigned long long ullMaxSetBitsTime, ullTotalSetBitsTime;
+unsigned int uxNumber, uxSets, uxClears, uxWoken, uxMaxWoken, uxVisited, uxMaxVisited, uxWaits, uxTimeouts;
+
+	vEventGroupListStats( xGroup, cLine );
+	benchCHECK( strlen( cLine ) < sizeof( cLine ) );
+	printf( "  listed: %s", cLine );
+
+	benchCHECK( sscanf( cLine, "%u %llu %llu %u %u %u %u %u %u %u %u",
+						&uxNumber, &ullMaxSetBitsTime, &ullTotalSetBitsTime,
+						&uxSets, &uxClears, &uxWoken, &uxMaxWoken,
+						&uxVisited, &uxMaxVisited, &uxWaits, &uxTimeouts ) == 11 );
+	benchCHECK( ullMaxSetBitsTime == ( unsigned long long ) pxStats->ulMaxSetBitsTime );
+	benchCHECK( ullTotalSetBitsTime == ( unsigned long long ) pxStats->ulTotalSetBitsTime );
+	benchCHECK( ( uxSets == pxStats->ulSets ) && ( uxClears == pxStats->ulClears ) );
+	benchCHECK( ( uxWoken == pxStats->ulTasksWoken ) && ( uxMaxWoken == pxStats->ulMaxTasksWokenByWalk ) );
+	benchCHECK( ( uxVisited == pxStats->ulTasksVisited ) && ( uxMaxVisited == pxStats->ulMaxTasksVisitedByWalk ) );
+	benchCHECK( ( uxWaits == pxStats->ulWaits ) && ( uxTimeouts == pxStats->ulTimeouts ) );
+	printf( "  listed values match: ok\n" );
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,256 @@
+/******************************************************************************
+ * Host scheduling policy of the Posix port, see main_bench.c.
+ *
+ * host_policy: the Posix port reports each of its configPOSIX_CPU_AFFINITY,
+ * configPOSIX_USE_SCHED_FIFO, configPOSIX_LOCK_MEMORY and
+ * configPOSIX_PREFAULT_STACKS options on stderr as the scheduler starts, as
+ * "ok" or as the error that stopped it being applied.  Checks that there is a
+ * report line for each option that is turned on and none for those that are
+ * not, and that each line agrees with the host: the task threads are pinned
+ * and run with SCHED_FIFO, and memory is locked, exactly when the lines say
+ * so.  The stacks of the tasks created before the scheduler started must all
+ * have been faulted in.  Run with -u, where SCHED_FIFO and mlockall() are not
+ * permitted, those two lines must report EPERM and the kernel must carry on
+ * without them: a task of higher priority still preempts at once, and a delay
+ * still takes as long on the host as it should.
+ *******************************************************************************
+ */
+
+#ifdef __linux__
+	#ifndef _GNU_SOURCE
+		#define _GNU_SOURCE		/* For pthread_getaffinity_np(). */
+	#endif
+#endif
+
+/* Standard includes. */
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "main_bench.h"
+
+/* The defaults of the Posix port, which only port.c sees. */
+#ifndef configPOSIX_CPU_AFFINITY
+	#define configPOSIX_CPU_AFFINITY		( -1 )
+#endif
+#ifndef configPOSIX_USE_SCHED_FIFO
+	#define configPOSIX_USE_SCHED_FIFO		0
+#endif
+#ifndef configPOSIX_SCHED_FIFO_PRIORITY
+	#define configPOSIX_SCHED_FIFO_PRIORITY	50
+#endif
+#ifndef configPOSIX_LOCK_MEMORY
+	#define configPOSIX_LOCK_MEMORY			0
+#endif
+#ifndef configPOSIX_PREFAULT_STACKS
+	#define configPOSIX_PREFAULT_STACKS		0
+#endif
+
+#define benchHP_OUTCOME_SIZE		( 64 )
+#define benchHP_DELAY_MS			( 100 )
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvGetOutcome( const char *pcOption, char *pcOutcome );
+static void prvCheckOutcome( const char *pcOption, BaseType_t xEnabled, BaseType_t xApplied, BaseType_t xNeedsPrivilege );
+static BaseType_t prvThreadsPinned( void );
+static BaseType_t prvThreadRunsFIFO( void );
+static BaseType_t prvMemoryLocked( void );
+static void prvCheckScheduling( void );
+static void prvPreemptTask( void *pvParameters );
+
+static volatile BaseType_t xPreempted = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vBenchHostPolicy( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	prvCheckOutcome( "pin threads to CPU", configPOSIX_CPU_AFFINITY >= 0, prvThreadsPinned(), pdFALSE );
+	prvCheckOutcome( "SCHED_FIFO priority", configPOSIX_USE_SCHED_FIFO == 1, prvThreadRunsFIFO(), pdTRUE );
+	prvCheckOutcome( "mlockall", configPOSIX_LOCK_MEMORY == 1, prvMemoryLocked(), pdTRUE );
+
+	/* Nothing tells whether the stacks were resident before, so only the
+	report is checked, and faulting them in needs no privilege. */
+	prvCheckOutcome( "prefault task stacks", configPOSIX_PREFAULT_STACKS == 1, configPOSIX_PREFAULT_STACKS == 1, pdFALSE );
+
+	prvCheckScheduling();
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+/* Copies the outcome the port reported for pcOption, the text after the last
+": " of its line, to pcOutcome.  Returns pdFALSE if there is no such line. */
+static BaseType_t prvGetOutcome( const char *pcOption, char *pcOutcome )
+{
+char cPrefix[ 64 ];
+const char *pcLine, *pcEnd, *pcOutcomeStart, *pcSeparator;
+size_t xLength;
+
+	snprintf( cPrefix, sizeof( cPrefix ), "Posix port: %s", pcOption );
+	pcLine = strstr( pcBenchHostReport(), cPrefix );
+
+	if( pcLine == NULL )
+	{
+		return pdFALSE;
+	}
+
+	pcEnd = strchr( pcLine, '\n' );
+
+	if( pcEnd == NULL )
+	{
+		pcEnd = pcLine + strlen( pcLine );
+	}
+
+	pcOutcomeStart = pcLine + strlen( cPrefix );
+
+	while( ( pcSeparator = strstr( pcOutcomeStart, ": " ) ) != NULL && ( pcSeparator < pcEnd ) )
+	{
+		pcOutcomeStart = pcSeparator + 2;
+	}
+
+	xLength = ( size_t ) ( pcEnd - pcOutcomeStart );
+
+	if( xLength >= benchHP_OUTCOME_SIZE )
+	{
+		xLength = benchHP_OUTCOME_SIZE - 1;
+	}
+
+	memcpy( pcOutcome, pcOutcomeStart, xLength );
+	pcOutcome[ xLength ] = '\0';
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckOutcome( const char *pcOption, BaseType_t xEnabled, BaseType_t xApplied, BaseType_t xNeedsPrivilege )
+{
+char cOutcome[ benchHP_OUTCOME_SIZE ];
+BaseType_t xReported;
+
+	xReported = prvGetOutcome( pcOption, cOutcome );
+
+	if( xEnabled == pdFALSE )
+	{
+		printf( "  %-22s off\n", pcOption );
+		benchCHECK( xReported == pdFALSE );
+		return;
+	}
+
+	benchCHECK( xReported != pdFALSE );
+	printf( "  %-22s %s, %s on the host\n", pcOption, cOutcome, ( xApplied != pdFALSE ) ? "applied" : "not applied" );
+
+	/* The report and the host must agree. */
+	benchCHECK( ( strcmp( cOutcome, "ok" ) == 0 ) == ( xApplied != pdFALSE ) );
+
+	if( ( xNeedsPrivilege != pdFALSE ) && ( xBenchIsUnprivileged() != pdFALSE ) )
+	{
+		benchCHECK( strcmp( cOutcome, strerror( EPERM ) ) == 0 );
+	}
+	else if( xNeedsPrivilege == pdFALSE )
+	{
+		benchCHECK( strcmp( cOutcome, "ok" ) == 0 );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvThreadsPinned( void )
+{
+	#if ( configPOSIX_CPU_AFFINITY >= 0 ) && defined( __linux__ )
+	{
+	cpu_set_t xCpuSet;
+
+		benchCHECK( pthread_getaffinity_np( pthread_self(), sizeof( xCpuSet ), &xCpuSet ) == 0 );
+
+		return ( ( CPU_COUNT( &xCpuSet ) == 1 ) && CPU_ISSET( configPOSIX_CPU_AFFINITY, &xCpuSet ) ) ? pdTRUE : pdFALSE;
+	}
+	#else
+	{
+		return pdFALSE;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvThreadRunsFIFO( void )
+{
+struct sched_param xParam;
+int iPolicy;
+
+	benchCHECK( pthread_getschedparam( pthread_self(), &iPolicy, &xParam ) == 0 );
+
+	return ( ( iPolicy == SCHED_FIFO ) && ( xParam.sched_priority == configPOSIX_SCHED_FIFO_PRIORITY ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvMemoryLocked( void )
+{
+	#ifdef __linux__
+	{
+	FILE *pxStatus;
+	char cLine[ 128 ];
+	unsigned long ulLockedKB = 0;
+
+		pxStatus = fopen( "/proc/self/status", "r" );
+		benchCHECK( pxStatus != NULL );
+
+		while( fgets( cLine, sizeof( cLine ), pxStatus ) != NULL )
+		{
+			if( sscanf( cLine, "VmLck: %lu", &ulLockedKB ) == 1 )
+			{
+				break;
+			}
+		}
+
+		fclose( pxStatus );
+
+		return ( ulLockedKB > 0 ) ? pdTRUE : pdFALSE;
+	}
+	#else
+	{
+		return pdFALSE;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckScheduling( void )
+{
+TickType_t xStartTick, xTicks;
+uint64_t ullStart, ullElapsed;
+
+	/* A task of higher priority runs before xTaskCreate() returns. */
+	xPreempted = pdFALSE;
+	benchCHECK( xTaskCreate( prvPreemptTask, "Preempt", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xPreempted != pdFALSE );
+
+	/* The tick still runs at its rate. */
+	xStartTick = xTaskGetTickCount();
+	ullStart = ullBenchNow();
+	vTaskDelay( pdMS_TO_TICKS( benchHP_DELAY_MS ) );
+	ullElapsed = ullBenchNow() - ullStart;
+	xTicks = xTaskGetTickCount() - xStartTick;
+
+	printf( "  %-22s %lu ticks in %llu us\n", "vTaskDelay()", ( unsigned long ) xTicks, ( unsigned long long ) ( ullElapsed / 1000ULL ) );
+	benchCHECK( xTicks >= pdMS_TO_TICKS( benchHP_DELAY_MS ) );
+	benchCHECK( ullElapsed >= ( ( uint64_t ) benchHP_DELAY_MS * 1000000ULL * 9ULL ) / 10ULL );
+	benchCHECK( ullElapsed < ( uint64_t ) benchHP_DELAY_MS * 1000000ULL * 5ULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPreemptTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	xPreempted = pdTRUE;
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
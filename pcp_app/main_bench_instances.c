@@ -0,0 +1,292 @@
+/******************************************************************************
+ * Kernel instance benchmarks, see main_bench.c.  Only built into pcp_bench
+ * when configNUMBER_OF_KERNEL_INSTANCES is greater than 1, which is the case
+ * for the pcp_bench_instances build.
+ *
+ * instances: runs two schedulers at once, instance 0 started by the runner
+ * as usual and instance 1 by a host thread of its own, and checks that they
+ * do not share state.  Both instances run the same task, which registers a
+ * queue under the same name, passes tagged items through it from a second
+ * task, and times a delay, so an item sent to or taken from the wrong
+ * instance's queue, a registry lookup that finds the other instance's queue,
+ * or a delay counted on the other instance's tick fails the run.  Instance 1's
+ * tick count must start from zero, and each instance's tick must advance at no
+ * more than the tick rate, where one shared tick count would advance at twice
+ * that.  While instance 0 is held in a critical section, which holds its tick,
+ * instance 1's tick must carry on.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <stdio.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "main_bench.h"
+
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+
+#define benchKI_INSTANCES			( 2 )
+#define benchKI_ITEMS				( 2000UL )
+#define benchKI_QUEUE_LENGTH		( 4 )
+#define benchKI_DELAY_MS			( 100 )
+#define benchKI_START_GAP_MS		( 50 )
+#define benchKI_HOLD_NS				( 50000000ULL )
+
+/*-----------------------------------------------------------*/
+
+/* What one instance's tasks found, read by the controller in instance 0.  The
+instances share nothing else, as their objects must only be used by the
+instance that created them. */
+typedef struct InstanceResult
+{
+	UBaseType_t uxInstance;
+	QueueHandle_t xQueue;
+	volatile BaseType_t xDone;
+	volatile uint32_t ulReceived;
+	volatile uint32_t ulErrors;
+	volatile uint64_t ullDelayNs;
+	volatile TickType_t xDelayTicks;
+	volatile uint64_t ullStartNs;
+	volatile TickType_t xStartTick;
+	volatile TickType_t xTick;		/* Published every tick once xDone is set. */
+} InstanceResult_t;
+
+static void *prvInstanceThread( void *pvParameters );
+static void prvInstanceTask( void *pvParameters );
+static void prvSenderTask( void *pvParameters );
+static void prvCheckTickRates( void );
+static void prvCheckTickHeld( void );
+
+static InstanceResult_t xResults[ benchKI_INSTANCES ];
+
+/*-----------------------------------------------------------*/
+
+void vBenchInstances( void *pvParameters )
+{
+pthread_t xThread;
+UBaseType_t x;
+TickType_t xGapTick;
+int iError;
+
+	( void ) pvParameters;
+
+	benchCHECK( uxTaskGetKernelInstance() == 0 );
+
+	for( x = 0; x < benchKI_INSTANCES; x++ )
+	{
+		xResults[ x ].uxInstance = x;
+	}
+
+	benchCHECK( xTaskCreate( prvInstanceTask, "Instance", benchSTACK_SIZE, &xResults[ 0 ], benchCONTROL_PRIORITY - 1, NULL ) == pdPASS );
+
+	/* Start instance 1 later, so the two tick counts differ.  The thread
+	starts with all signals blocked, as the port requires, see isr_paths. */
+	vTaskDelay( pdMS_TO_TICKS( benchKI_START_GAP_MS ) );
+	xGapTick = xTaskGetTickCount();
+	taskENTER_CRITICAL();
+	iError = pthread_create( &xThread, NULL, prvInstanceThread, &xResults[ 1 ] );
+	taskEXIT_CRITICAL();
+	benchCHECK( iError == 0 );
+
+	while( ( xResults[ 0 ].xDone == pdFALSE ) || ( xResults[ 1 ].xDone == pdFALSE ) )
+	{
+		vTaskDelay( pdMS_TO_TICKS( 10 ) );
+	}
+
+	for( x = 0; x < benchKI_INSTANCES; x++ )
+	{
+		printf( "  instance %lu: %lu items, %lu errors, vTaskDelay( %d ) took %lu ticks, %llu us\n",
+				( unsigned long ) x,
+				( unsigned long ) xResults[ x ].ulReceived,
+				( unsigned long ) xResults[ x ].ulErrors,
+				benchKI_DELAY_MS,
+				( unsigned long ) xResults[ x ].xDelayTicks,
+				( unsigned long long ) ( xResults[ x ].ullDelayNs / 1000ULL ) );
+
+		benchCHECK( xResults[ x ].ulReceived == benchKI_ITEMS );
+		benchCHECK( xResults[ x ].ulErrors == 0 );
+		benchCHECK( xResults[ x ].xDelayTicks >= pdMS_TO_TICKS( benchKI_DELAY_MS ) );
+		benchCHECK( xResults[ x ].ullDelayNs >= ( ( uint64_t ) benchKI_DELAY_MS * 1000000ULL * 9ULL ) / 10ULL );
+		benchCHECK( xResults[ x ].ullDelayNs < ( uint64_t ) benchKI_DELAY_MS * 1000000ULL * 3ULL );
+	}
+
+	benchCHECK( xResults[ 0 ].xQueue != xResults[ 1 ].xQueue );
+
+	/* Instance 1 counts from zero from when it started, not from where
+	instance 0 had got to. */
+	printf( "  tick count when instance 1 started: instance 0 %lu, instance 1 %lu\n",
+			( unsigned long ) xGapTick, ( unsigned long ) xResults[ 1 ].xStartTick );
+	benchCHECK( xGapTick >= pdMS_TO_TICKS( benchKI_START_GAP_MS ) );
+	benchCHECK( xResults[ 1 ].xStartTick < pdMS_TO_TICKS( benchKI_START_GAP_MS / 2 ) );
+
+	prvCheckTickRates();
+	prvCheckTickHeld();
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void *prvInstanceThread( void *pvParameters )
+{
+InstanceResult_t *pxResult = ( InstanceResult_t * ) pvParameters;
+
+	vTaskSetKernelInstance( pxResult->uxInstance );
+
+	if( xTaskCreate( prvInstanceTask, "Instance", benchSTACK_SIZE, pxResult, benchCONTROL_PRIORITY - 1, NULL ) != pdPASS )
+	{
+		pxResult->ulErrors++;
+		pxResult->xDone = pdTRUE;
+		return NULL;
+	}
+
+	/* Only returns if the scheduler could not start. */
+	vTaskStartScheduler();
+	pxResult->ulErrors++;
+	pxResult->xDone = pdTRUE;
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInstanceTask( void *pvParameters )
+{
+InstanceResult_t *pxResult = ( InstanceResult_t * ) pvParameters;
+uint32_t ulItem, ulTag = ( uint32_t ) pxResult->uxInstance << 24;
+TickType_t xStartTick;
+uint64_t ullStart;
+
+	pxResult->xStartTick = xTaskGetTickCount();
+	pxResult->ullStartNs = ullBenchNow();
+
+	if( uxTaskGetKernelInstance() != pxResult->uxInstance )
+	{
+		pxResult->ulErrors++;
+	}
+
+	/* Both instances register their queue under the same name, and each
+	must find its own. */
+	pxResult->xQueue = xQueueCreate( benchKI_QUEUE_LENGTH, sizeof( uint32_t ) );
+	configASSERT( pxResult->xQueue != NULL );
+	vQueueAddToRegistry( pxResult->xQueue, "Instance" );
+
+	if( xQueueGetHandle( "Instance" ) != pxResult->xQueue )
+	{
+		pxResult->ulErrors++;
+	}
+
+	configASSERT( xTaskCreate( prvSenderTask, "Sender", benchSTACK_SIZE, pxResult, tskIDLE_PRIORITY + 1, NULL ) == pdPASS );
+
+	while( pxResult->ulReceived < benchKI_ITEMS )
+	{
+		if( xQueueReceive( pxResult->xQueue, &ulItem, pdMS_TO_TICKS( 1000 ) ) != pdPASS )
+		{
+			pxResult->ulErrors++;
+			break;
+		}
+
+		if( ulItem != ( ulTag | pxResult->ulReceived ) )
+		{
+			pxResult->ulErrors++;
+		}
+
+		pxResult->ulReceived++;
+	}
+
+	xStartTick = xTaskGetTickCount();
+	ullStart = ullBenchNow();
+	vTaskDelay( pdMS_TO_TICKS( benchKI_DELAY_MS ) );
+	pxResult->ullDelayNs = ullBenchNow() - ullStart;
+	pxResult->xDelayTicks = xTaskGetTickCount() - xStartTick;
+
+	pxResult->xTick = xTaskGetTickCount();
+	pxResult->xDone = pdTRUE;
+
+	for( ; ; )
+	{
+		vTaskDelay( 1 );
+		pxResult->xTick = xTaskGetTickCount();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSenderTask( void *pvParameters )
+{
+InstanceResult_t *pxResult = ( InstanceResult_t * ) pvParameters;
+uint32_t ulItem, ulValue, ulTag = ( uint32_t ) pxResult->uxInstance << 24;
+
+	for( ulItem = 0; ulItem < benchKI_ITEMS; ulItem++ )
+	{
+		ulValue = ulTag | ulItem;
+		( void ) xQueueSend( pxResult->xQueue, &ulValue, portMAX_DELAY );
+
+		/* Leave the CPU now and then, so the items pass while the other
+		instance and both ticks are running. */
+		if( ( ulItem % 64UL ) == 63UL )
+		{
+			vTaskDelay( 1 );
+		}
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTickRates( void )
+{
+uint64_t ullNow = ullBenchNow();
+TickType_t xTick0 = xTaskGetTickCount(), xTick1 = xResults[ 1 ].xTick;
+uint64_t ullExpected0, ullExpected1;
+
+	/* Ticks counted by each instance since its task started, against what
+	the host time since then gives at the tick rate. */
+	ullExpected0 = ( ( ullNow - xResults[ 0 ].ullStartNs ) / 1000000ULL ) * configTICK_RATE_HZ / 1000ULL;
+	ullExpected1 = ( ( ullNow - xResults[ 1 ].ullStartNs ) / 1000000ULL ) * configTICK_RATE_HZ / 1000ULL;
+
+	printf( "  ticks: instance 0 %lu of %llu, instance 1 %lu of %llu\n",
+			( unsigned long ) ( xTick0 - xResults[ 0 ].xStartTick ), ( unsigned long long ) ullExpected0,
+			( unsigned long ) ( xTick1 - xResults[ 1 ].xStartTick ), ( unsigned long long ) ullExpected1 );
+
+	/* A tick the host delivers late is merged with the next one, which
+	loses it, so only a count well short of the expected one fails, where
+	one count shared by both ticks would be close to twice it. */
+	benchCHECK( ( uint64_t ) ( xTick0 - xResults[ 0 ].xStartTick ) * 2ULL >= ullExpected0 );
+	benchCHECK( ( uint64_t ) ( xTick0 - xResults[ 0 ].xStartTick ) * 10ULL <= ullExpected0 * 12ULL + 20ULL );
+	benchCHECK( ( uint64_t ) ( xTick1 - xResults[ 1 ].xStartTick ) * 2ULL >= ullExpected1 );
+	benchCHECK( ( uint64_t ) ( xTick1 - xResults[ 1 ].xStartTick ) * 10ULL <= ullExpected1 * 12ULL + 20ULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckTickHeld( void )
+{
+TickType_t xOwnBefore, xOwnAfter, xOtherBefore, xOtherAfter;
+uint64_t ullStart;
+
+	taskENTER_CRITICAL();
+	{
+		xOwnBefore = xTaskGetTickCount();
+		xOtherBefore = xResults[ 1 ].xTick;
+		ullStart = ullBenchNow();
+
+		while( ( ullBenchNow() - ullStart ) < benchKI_HOLD_NS )
+		{
+		}
+
+		xOwnAfter = xTaskGetTickCount();
+		xOtherAfter = xResults[ 1 ].xTick;
+	}
+	taskEXIT_CRITICAL();
+
+	printf( "  %llu ms in a critical section of instance 0: instance 0 %lu ticks, instance 1 %lu ticks\n",
+			benchKI_HOLD_NS / 1000000ULL, ( unsigned long ) ( xOwnAfter - xOwnBefore ), ( unsigned long ) ( xOtherAfter - xOtherBefore ) );
+
+	benchCHECK( xOwnAfter == xOwnBefore );
+	benchCHECK( ( xOtherAfter - xOtherBefore ) >= pdMS_TO_TICKS( ( benchKI_HOLD_NS / 1000000ULL ) / 2ULL ) );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
@@ -0,0 +1,431 @@
+/******************************************************************************
+ * Simulated interrupt benchmarks, see main_bench.c.
+ *
+ * isr_paths: times how long a task takes to run after a simulated interrupt
+ * hands it data, for xQueueSendFromISR(), vTaskNotifyGiveFromISR() and
+ * xStreamBufferSendFromISR(), measured from the handler to the task.  The
+ * interrupts are raised by a host thread, benchIP_ROUNDS of them per path at
+ * irregular intervals, while a task of low priority keeps the CPU busy, so
+ * they arrive on whichever task is running, as a peripheral's would.  Each
+ * interrupt carries its sequence number, which the task checks, and the host
+ * thread waits for the task to take each one before raising the next, so an
+ * interrupt that is lost, or a task that is not woken, fails the run.
+ *
+ * isr_masking: checks that an interrupt raised inside a critical section is
+ * held until portEXIT_CRITICAL(), that portSET_INTERRUPT_MASK_FROM_ISR() holds
+ * interrupts at or below configMAX_SYSCALL_INTERRUPT_PRIORITY but not those
+ * above it, and that interrupts nest by priority: an interrupt of higher
+ * priority raised by a handler runs inside it, and one of lower priority runs
+ * after it returns.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "stream_buffer.h"
+
+#include "main_bench.h"
+
+#define benchIP_INTERRUPT			( 4UL )
+#define benchIP_ROUNDS				( 2000UL )
+#define benchIP_MIN_GAP_US			( 50L )
+#define benchIP_MAX_GAP_US			( 150L )
+#define benchIP_WAKE_LIMIT_NS		( 1000000000ULL )
+
+#define benchIM_LOW_INTERRUPT		( 5UL )
+#define benchIM_HIGH_INTERRUPT		( 6UL )
+#define benchIM_HOLD_NS				( 2000000ULL )
+
+/* Priorities of the interrupts used by isr_masking.  The Posix port sets
+configMAX_SYSCALL_INTERRUPT_PRIORITY to half of portMAX_INTERRUPT_PRIORITY
+unless FreeRTOSConfig.h sets it, so the first is masked by
+portSET_INTERRUPT_MASK_FROM_ISR() and the second is not. */
+#define benchIM_LOW_PRIORITY		( 2 )
+#define benchIM_HIGH_PRIORITY		( portMAX_INTERRUPT_PRIORITY )
+
+/*-----------------------------------------------------------*/
+
+/* The FromISR function the interrupt handler of isr_paths calls. */
+typedef enum
+{
+	ePathQueue,
+	ePathNotify,
+	ePathStreamBuffer
+} ISRPath_t;
+
+static void prvTimeISRPath( ISRPath_t ePath, const char *pcName );
+static uint32_t prvPathInterruptHandler( void );
+static void prvPathWaiterTask( void *pvParameters );
+static void prvLoadTask( void *pvParameters );
+static void *prvRaiseThread( void *pvParameters );
+static void prvCheckCriticalSectionHold( void );
+static void prvCheckInterruptMask( void );
+static void prvCheckNesting( void );
+static uint32_t prvLowInterruptHandler( void );
+static uint32_t prvHighInterruptHandler( void );
+static void prvRecordEvent( char cEvent );
+
+static volatile ISRPath_t ePath = ePathQueue;
+static QueueHandle_t xPathQueue = NULL;
+static StreamBufferHandle_t xPathStream = NULL;
+static TaskHandle_t xPathWaiter = NULL;
+static volatile uint32_t ulPathRaised = 0;		/* Interrupts taken by the handler. */
+static volatile uint32_t ulPathReceived = 0;	/* Sequence numbers received by the waiter. */
+static volatile uint32_t ulPathErrors = 0;
+static volatile uint64_t ullPathSetTime = 0;
+static volatile uint64_t ullPathLatencyTotal = 0;
+static volatile uint64_t ullPathLatencyMax = 0;
+static volatile BaseType_t xHostDone = pdFALSE;
+static volatile BaseType_t xLoadStop = pdFALSE;
+
+/* The order of events in the handlers, for isr_masking. */
+static volatile char cEvents[ 8 ];
+static volatile UBaseType_t uxEventNext = 0;
+static volatile BaseType_t xRaiseFromHandler = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+void vBenchISRPaths( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	vPortSetInterruptHandler( benchIP_INTERRUPT, prvPathInterruptHandler );
+
+	xPathQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+	xPathStream = xStreamBufferCreate( sizeof( uint32_t ) * 4, sizeof( uint32_t ) );
+	benchCHECK( ( xPathQueue != NULL ) && ( xPathStream != NULL ) );
+
+	prvTimeISRPath( ePathQueue, "xQueueSendFromISR():" );
+	prvTimeISRPath( ePathNotify, "vTaskNotifyGiveFromISR():" );
+	prvTimeISRPath( ePathStreamBuffer, "xStreamBufferSendFromISR():" );
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeISRPath( ISRPath_t eNewPath, const char *pcName )
+{
+pthread_t xThread;
+int iError;
+
+	ePath = eNewPath;
+	ulPathRaised = 0;
+	ulPathReceived = 0;
+	ulPathErrors = 0;
+	ullPathLatencyTotal = 0;
+	ullPathLatencyMax = 0;
+	xHostDone = pdFALSE;
+	xLoadStop = pdFALSE;
+
+	benchCHECK( xTaskCreate( prvPathWaiterTask, "Waiter", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY + 1, &xPathWaiter ) == pdPASS );
+	benchCHECK( xTaskCreate( prvLoadTask, "Load", benchSTACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL ) == pdPASS );
+
+	/* Signals are blocked in a critical section, so the host thread starts
+	with all of them blocked, as the port requires, and the tick cannot switch
+	this task out while the C library is creating the thread. */
+	taskENTER_CRITICAL();
+	iError = pthread_create( &xThread, NULL, prvRaiseThread, NULL );
+	taskEXIT_CRITICAL();
+	benchCHECK( iError == 0 );
+
+	while( xHostDone == pdFALSE )
+	{
+		vTaskDelay( pdMS_TO_TICKS( 10 ) );
+	}
+
+	taskENTER_CRITICAL();
+	iError = pthread_join( xThread, NULL );
+	taskEXIT_CRITICAL();
+	benchCHECK( iError == 0 );
+
+	xLoadStop = pdTRUE;
+	vTaskDelete( xPathWaiter );
+
+	/* Let the load task and the idle task finish. */
+	vTaskDelay( 2 );
+
+	benchCHECK( ulPathErrors == 0 );
+	benchCHECK( ulPathRaised == benchIP_ROUNDS );
+	benchCHECK( ulPathReceived == benchIP_ROUNDS );
+
+	printf( "  %-28s interrupt to task %6.1f us average, %7.1f us max\n",
+			pcName,
+			( double ) ullPathLatencyTotal / ( double ) benchIP_ROUNDS / 1000.0,
+			( double ) ullPathLatencyMax / 1000.0 );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvRaiseThread( void *pvParameters )
+{
+struct timespec xGap = { 0, 0 };
+uint32_t ulRound, ulRandom = 0x2545f491UL;
+uint64_t ullStart;
+
+	( void ) pvParameters;
+
+	for( ulRound = 0; ulRound < benchIP_ROUNDS; ulRound++ )
+	{
+		ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+		xGap.tv_nsec = ( benchIP_MIN_GAP_US + ( long ) ( ( ulRandom >> 16 ) % ( benchIP_MAX_GAP_US - benchIP_MIN_GAP_US ) ) ) * 1000L;
+		nanosleep( &xGap, NULL );
+
+		vPortGenerateSimulatedInterrupt( benchIP_INTERRUPT );
+
+		/* Wait for the task to take it.  This thread must sleep, not spin, as
+		the host may only have one CPU for it and the tasks. */
+		ullStart = ullBenchNow();
+
+		while( ulPathReceived == ulRound )
+		{
+			if( ( ullBenchNow() - ullStart ) > benchIP_WAKE_LIMIT_NS )
+			{
+				ulPathErrors++;
+				xHostDone = pdTRUE;
+				return NULL;
+			}
+
+			xGap.tv_nsec = 10000L;
+			nanosleep( &xGap, NULL );
+		}
+	}
+
+	xHostDone = pdTRUE;
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvPathInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+uint32_t ulSequence = ulPathRaised;
+
+	ulPathRaised = ulSequence + 1;
+	ullPathSetTime = ullBenchNow();
+
+	switch( ePath )
+	{
+		case ePathQueue:
+			if( xQueueSendFromISR( xPathQueue, &ulSequence, &xHigherPriorityTaskWoken ) != pdPASS )
+			{
+				ulPathErrors++;
+			}
+			break;
+
+		case ePathNotify:
+			vTaskNotifyGiveFromISR( xPathWaiter, &xHigherPriorityTaskWoken );
+			break;
+
+		default:
+			if( xStreamBufferSendFromISR( xPathStream, &ulSequence, sizeof( ulSequence ), &xHigherPriorityTaskWoken ) != sizeof( ulSequence ) )
+			{
+				ulPathErrors++;
+			}
+			break;
+	}
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPathWaiterTask( void *pvParameters )
+{
+uint32_t ulSequence;
+uint64_t ullLatency;
+
+	( void ) pvParameters;
+
+	for( ;; )
+	{
+		switch( ePath )
+		{
+			case ePathQueue:
+				benchCHECK( xQueueReceive( xPathQueue, &ulSequence, portMAX_DELAY ) == pdPASS );
+				break;
+
+			case ePathNotify:
+				/* One give per interrupt, and each is taken before the next
+				interrupt is raised. */
+				benchCHECK( ulTaskNotifyTake( pdTRUE, portMAX_DELAY ) == 1 );
+				ulSequence = ulPathReceived;
+				break;
+
+			default:
+				benchCHECK( xStreamBufferReceive( xPathStream, &ulSequence, sizeof( ulSequence ), portMAX_DELAY ) == sizeof( ulSequence ) );
+				break;
+		}
+
+		ullLatency = ullBenchNow() - ullPathSetTime;
+
+		if( ulSequence != ulPathReceived )
+		{
+			ulPathErrors++;
+		}
+
+		ullPathLatencyTotal += ullLatency;
+
+		if( ullLatency > ullPathLatencyMax )
+		{
+			ullPathLatencyMax = ullLatency;
+		}
+
+		ulPathReceived++;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvLoadTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	while( xLoadStop == pdFALSE )
+	{
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchISRMasking( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	vPortSetInterruptHandler( benchIM_LOW_INTERRUPT, prvLowInterruptHandler );
+	vPortSetInterruptPriority( benchIM_LOW_INTERRUPT, benchIM_LOW_PRIORITY );
+	vPortSetInterruptHandler( benchIM_HIGH_INTERRUPT, prvHighInterruptHandler );
+	vPortSetInterruptPriority( benchIM_HIGH_INTERRUPT, benchIM_HIGH_PRIORITY );
+
+	prvCheckCriticalSectionHold();
+	prvCheckInterruptMask();
+	prvCheckNesting();
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckCriticalSectionHold( void )
+{
+uint64_t ullStart;
+UBaseType_t uxEvents;
+
+	uxEventNext = 0;
+	xRaiseFromHandler = pdFALSE;
+
+	taskENTER_CRITICAL();
+	{
+		vPortGenerateSimulatedInterrupt( benchIM_HIGH_INTERRUPT );
+
+		/* Long enough for a signal that was not held to have been taken. */
+		ullStart = ullBenchNow();
+
+		while( ( ullBenchNow() - ullStart ) < benchIM_HOLD_NS )
+		{
+		}
+
+		uxEvents = uxEventNext;
+	}
+	taskEXIT_CRITICAL();
+
+	/* Not read inside the critical section by benchCHECK(), which would leave
+	the run with the interrupt still held. */
+	benchCHECK( uxEvents == 0 );
+	benchCHECK( ( uxEventNext == 1 ) && ( cEvents[ 0 ] == 'H' ) );
+
+	printf( "  interrupt held until portEXIT_CRITICAL(): ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckInterruptMask( void )
+{
+UBaseType_t uxSavedMask, uxEvents;
+
+	uxEventNext = 0;
+	xRaiseFromHandler = pdFALSE;
+
+	uxSavedMask = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		vPortGenerateSimulatedInterrupt( benchIM_LOW_INTERRUPT );
+		vPortGenerateSimulatedInterrupt( benchIM_HIGH_INTERRUPT );
+		uxEvents = uxEventNext;
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedMask );
+
+	benchCHECK( ( uxEvents == 1 ) && ( cEvents[ 0 ] == 'H' ) );
+	benchCHECK( ( uxEventNext == 2 ) && ( cEvents[ 1 ] == 'L' ) );
+
+	printf( "  mask holds interrupts up to the syscall priority only: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckNesting( void )
+{
+	/* The low priority handler raises the high priority interrupt, which must
+	run before the low priority handler ends. */
+	uxEventNext = 0;
+	xRaiseFromHandler = pdTRUE;
+	vPortGenerateSimulatedInterrupt( benchIM_LOW_INTERRUPT );
+	xRaiseFromHandler = pdFALSE;
+
+	benchCHECK( uxEventNext == 3 );
+	benchCHECK( ( cEvents[ 0 ] == 'L' ) && ( cEvents[ 1 ] == 'H' ) && ( cEvents[ 2 ] == 'l' ) );
+	printf( "  higher priority interrupt nests inside a handler: ok\n" );
+
+	/* The other way round, the low priority interrupt waits for the high
+	priority handler to return. */
+	uxEventNext = 0;
+	xRaiseFromHandler = pdTRUE;
+	vPortGenerateSimulatedInterrupt( benchIM_HIGH_INTERRUPT );
+	xRaiseFromHandler = pdFALSE;
+
+	benchCHECK( uxEventNext == 3 );
+	benchCHECK( ( cEvents[ 0 ] == 'H' ) && ( cEvents[ 1 ] == 'h' ) && ( cEvents[ 2 ] == 'L' ) );
+	printf( "  lower priority interrupt waits for the handler to return: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvLowInterruptHandler( void )
+{
+	prvRecordEvent( 'L' );
+
+	if( xRaiseFromHandler != pdFALSE )
+	{
+		xRaiseFromHandler = pdFALSE;
+		vPortGenerateSimulatedInterrupt( benchIM_HIGH_INTERRUPT );
+		prvRecordEvent( 'l' );
+	}
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvHighInterruptHandler( void )
+{
+	prvRecordEvent( 'H' );
+
+	if( xRaiseFromHandler != pdFALSE )
+	{
+		xRaiseFromHandler = pdFALSE;
+		vPortGenerateSimulatedInterrupt( benchIM_LOW_INTERRUPT );
+		prvRecordEvent( 'h' );
+	}
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordEvent( char cEvent )
+{
+	if( uxEventNext < sizeof( cEvents ) )
+	{
+		cEvents[ uxEventNext ] = cEvent;
+		uxEventNext++;
+	}
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,1598 @@
+/******************************************************************************
+ * Queue benchmarks, see main_bench.c.
+ *
+ * queue_batch: moves the same number of 4 byte items through a queue one item
+ * per xQueueSend()/xQueueReceive() call, and a burst per xQueueSendMultiple()/
+ * xQueueReceiveMultiple() call, for bursts of benchBATCH_SMALL_BURST and
+ * benchBATCH_LARGE_BURST items.  It does so twice: once with the controller
+ * both sending and receiving, which measures the cost of the calls themselves,
+ * and once to a receiving task of higher priority that is blocked on the
+ * queue, which adds the wake up and context switch that each call causes.
+ * Every item carries its sequence number, so the order and the count of the
+ * items received are checked as well.
+ *
+ * queue_pingpong: measures xQueueSend() followed by xQueueReceive() for items
+ * of 4 and 8 bytes, which the queue copies with a fixed size copy, and of 12
+ * and 16 bytes, which it copies with memcpy() of the item size.  Again once
+ * within the controller, where the copies are a large part of the cost, and
+ * once as a round trip to an echo task of higher priority through a pair of
+ * queues.  Each item carries its sequence number and a pattern that is
+ * checked on the way back.  pcp_bench_memcpy runs the same case against a
+ * kernel built with configQUEUE_FIXED_SIZE_COPY set to 0, which copies items
+ * of every size with memcpy(), so each size can be compared with and without
+ * the fixed size copy.
+ *
+ * spsc_throughput: the measurements of queue_pingpong, with the same item
+ * sizes and numbers of items, made with xSPSCQueueSend()/xSPSCQueueReceive()
+ * through single producer single consumer queues, and again with
+ * xQueueSend()/xQueueReceive() to compare against.  In the round trip the
+ * controller is the producer of the ping queue and the consumer of the pong
+ * queue, and the echo task the other way round, so each queue still has only
+ * one of each.
+ *
+ * queue_handoff: sends items to a task of higher priority that is blocked in
+ * xQueueReceive(), and measures the time from each send until the receive
+ * returns.  With configUSE_QUEUE_DIRECT_HANDOFF set to 1 the items are copied
+ * straight into the receiver's buffer; pcp_bench_no_handoff runs the same case
+ * against a kernel built without the handoff, where they are copied into the
+ * queue storage area and back out.  Each item is checked on both paths.  It
+ * first checks the receivers that the handoff must not lose items to: one
+ * whose block time expires just before the send, or just after it but before
+ * it runs, and one blocked with its buffer set beside another task that is
+ * blocked in xQueuePeek(), with either of the two waiting first.
+ *
+ * queue_zero_copy: moves items of 16 and 256 bytes through a queue with
+ * pvQueueReserve()/vQueueCommit() and pvQueueAcquire()/vQueueRelease(), with
+ * the controller writing and checking each item in place, against
+ * xQueueSend()/xQueueReceive() of the same items to and from a buffer of the
+ * controller.  It then checks that the slot in front of the queue is left
+ * alone while it is in use: xQueueSendToFront() and xQueueOverwrite() find
+ * the queue full while an item is acquired or a slot reserved, a task blocked
+ * in xQueueSendToFront() for that reason sends as soon as the item is
+ * released or the slot committed, and xQueueSend() to the back still sends.
+ *
+ * queue_set: checks the order in which xQueueSelectFromSet() returns members
+ * that hold items, and that a member that was emptied by a receive can be
+ * deleted while it is still in the set.  It then fills each member of sets of
+ * 4, 16 and 64 queues with benchSET_ITEMS_PER_MEMBER items and times emptying
+ * them with xQueueSelectFromSet() followed by xQueueReceive() from the member
+ * returned, against receiving the same items from the members directly.
+ * Building the kernel with configUSE_QUEUE_SET_READY_LIST set to 0 in
+ * FreeRTOSConfig.h measures the sets that copy member handles instead.
+ *
+ * priority_queue: sends items with keys out of order, equal keys among them,
+ * to a queue created by xQueueCreatePriority(), and checks that
+ * xQueueReceiveWithKey() returns them by key, and in the order they were sent
+ * among equal keys, both for a short known sequence and for a long pseudo
+ * random one received while it is still being sent.  It then times sending
+ * and receiving the same items with 4 and 16 different keys through the
+ * priority queue, against one queue per key in a queue set, where the receiver
+ * selects from the set and then receives from the member of the lowest key
+ * that holds an item.
+ *
+ * queue_registry: registers more queues than the queue registry has buckets,
+ * and checks that each is found by name and by handle.  With
+ * configQUEUE_REGISTRY_HASHED set to 1 it then picks three names that hash to
+ * the same bucket, unregisters them from the middle, the head and the tail of
+ * the bucket's chain in turn, checking that only those are missing, and adds
+ * them again.  Renaming a queue, two queues with the same name and deleting a
+ * registered queue are checked too, then xQueueGetHandle() is timed.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "spsc_queue.h"
+
+#include "main_bench.h"
+
+#define benchBATCH_QUEUE_LENGTH		( 256 )
+#define benchBATCH_SMALL_BURST		( 32 )
+#define benchBATCH_LARGE_BURST		( 256 )
+
+/* Items moved by each measurement in the controller alone, and to the
+receiving task.  The latter is smaller as each item may cost a context
+switch, which is slow on the Posix port. */
+#define benchBATCH_LOCAL_ITEMS		( 256UL * 1024UL )
+#define benchBATCH_TASK_ITEMS		( 16UL * 1024UL )
+
+/* The largest item size measured by queue_pingpong, the number of send and
+receive pairs made in the controller alone, and the number of round trips to
+the echo task. */
+#define benchPINGPONG_MAX_ITEM_SIZE	( 16 )
+#define benchPINGPONG_LOCAL_ITEMS	( 256UL * 1024UL )
+#define benchPINGPONG_ROUND_TRIPS	( 8UL * 1024UL )
+
+/* The block time of the receivers queue_handoff lets expire, and the item it
+sends them. */
+#define benchHANDOFF_TIMEOUT_TICKS		( ( TickType_t ) 5 )
+#define benchHANDOFF_ITEM				( 0x12345678UL )
+
+/* The largest item size measured by queue_zero_copy, and the item sent to the
+front by its task. */
+#define benchZERO_COPY_MAX_ITEM_SIZE	( 256 )
+#define benchZERO_COPY_QUEUE_LENGTH		( 4 )
+#define benchZERO_COPY_FRONT_ITEM		( 0xF0F0F0F0UL )
+
+/* The most keys measured by priority_queue, the items sent in each round, and
+the number of rounds. */
+#define benchPRIORITY_MAX_LEVELS		( 16 )
+#define benchPRIORITY_ITEMS				( 64 )
+#define benchPRIORITY_ROUNDS			( 256UL )
+
+/* The queues queue_registry registers, the longest of their names, the queues
+it unregisters from one bucket, and the number of times it looks up each of
+them. */
+#if ( configQUEUE_REGISTRY_HASHED == 1 )
+	#define benchREGISTRY_QUEUES		( configQUEUE_REGISTRY_SIZE * 3 )
+#else
+	#define benchREGISTRY_QUEUES		( configQUEUE_REGISTRY_SIZE - 4 )
+#endif
+#define benchREGISTRY_NAME_SIZE			( 16 )
+#define benchREGISTRY_CHAIN				( 3 )
+#define benchREGISTRY_ROUNDS			( 1024UL )
+
+/* The largest set measured by queue_set, the items each member holds, and the
+number of times the members are filled and emptied for each measurement. */
+#define benchSET_MAX_MEMBERS		( 64 )
+#define benchSET_ITEMS_PER_MEMBER	( 4 )
+#define benchSET_ROUNDS				( 1024UL )
+
+/*-----------------------------------------------------------*/
+
+typedef struct BatchReceiver
+{
+	QueueHandle_t xQueue;
+	TaskHandle_t xController;
+	uint32_t ulItems;
+	UBaseType_t uxBurst;
+} BatchReceiver_t;
+
+static uint64_t prvMoveLocally( QueueHandle_t xQueue, uint32_t ulItems, UBaseType_t uxBurst );
+static uint64_t prvMoveToTask( QueueHandle_t xQueue, uint32_t ulItems, UBaseType_t uxBurst );
+static void prvReceiverTask( void *pvParameters );
+static void prvPrintResult( const char *pcHow, UBaseType_t uxBurst, uint32_t ulItems, uint64_t ullNanoseconds );
+
+typedef struct PingPong
+{
+	QueueHandle_t xPing;
+	QueueHandle_t xPong;
+} PingPong_t;
+
+typedef struct SPSCPingPong
+{
+	SPSCQueueHandle_t xPing;
+	SPSCQueueHandle_t xPong;
+} SPSCPingPong_t;
+
+static void prvTimeQueue( size_t xItemSize, uint64_t *pullLocal, uint64_t *pullRoundTrip );
+static void prvTimeSPSCQueue( size_t xItemSize, uint64_t *pullLocal, uint64_t *pullRoundTrip );
+static void prvFillItem( uint8_t *pucItem, size_t xItemSize, uint32_t ulSequence );
+static BaseType_t prvItemIsValid( const uint8_t *pucItem, size_t xItemSize, uint32_t ulSequence );
+static void prvEchoTask( void *pvParameters );
+static void prvSPSCEchoTask( void *pvParameters );
+
+typedef struct HandoffReceiver
+{
+	QueueHandle_t xQueue;
+	TaskHandle_t xController;
+	BaseType_t xPeek;
+	TickType_t xTicksToWait;
+	volatile BaseType_t xResult;
+	volatile uint32_t ulItem;
+} HandoffReceiver_t;
+
+typedef struct HandoffLatency
+{
+	QueueHandle_t xQueue;
+	TaskHandle_t xController;
+	volatile uint64_t ullSent;
+	uint64_t ullTotal;
+	uint64_t ullMax;
+} HandoffLatency_t;
+
+static void prvCheckHandoffTimeout( BaseType_t xSendFirst );
+static void prvCheckHandoffPeek( BaseType_t xPeekerFirst );
+static void prvSpinTicks( TickType_t xTicks );
+static void prvHandoffReceiverTask( void *pvParameters );
+static void prvHandoffLatencyTask( void *pvParameters );
+
+static uint64_t prvTimeZeroCopy( size_t xItemSize );
+static uint64_t prvTimeCopy( size_t xItemSize );
+static void prvCheckFrontSender( BaseType_t xAcquire );
+static void prvCheckOverwrite( void );
+static void prvFrontSenderTask( void *pvParameters );
+
+static volatile BaseType_t xFrontSent = pdFALSE;
+
+static void prvCheckSetOrder( void );
+static void prvCheckSetMemberDelete( void );
+static void prvTimeSet( UBaseType_t uxMembers );
+static void prvFillMembers( QueueHandle_t *pxMembers, UBaseType_t uxMembers );
+
+static void prvCheckPriorityOrder( void );
+static void prvSendAndCheckKeys( QueueHandle_t xQueue, UBaseType_t uxItems );
+static void prvTimePriorityQueue( UBaseType_t uxLevels );
+
+static void prvCheckRegistryCollisions( QueueHandle_t *pxQueues, char ( *pcNames )[ benchREGISTRY_NAME_SIZE ] );
+#if ( configQUEUE_REGISTRY_HASHED == 1 )
+	static uint32_t prvRegistryBucket( const char *pcName );
+#endif
+
+/*-----------------------------------------------------------*/
+
+void vBenchQueueBatch( void *pvParameters )
+{
+QueueHandle_t xQueue;
+const UBaseType_t uxBursts[] = { 1, benchBATCH_SMALL_BURST, benchBATCH_LARGE_BURST };
+size_t x;
+
+	( void ) pvParameters;
+
+	xQueue = xQueueCreate( benchBATCH_QUEUE_LENGTH, sizeof( uint32_t ) );
+	benchCHECK( xQueue != NULL );
+
+	for( x = 0; x < ( sizeof( uxBursts ) / sizeof( uxBursts[ 0 ] ) ); x++ )
+	{
+		prvPrintResult( "one task", uxBursts[ x ], benchBATCH_LOCAL_ITEMS, prvMoveLocally( xQueue, benchBATCH_LOCAL_ITEMS, uxBursts[ x ] ) );
+	}
+
+	for( x = 0; x < ( sizeof( uxBursts ) / sizeof( uxBursts[ 0 ] ) ); x++ )
+	{
+		prvPrintResult( "two tasks", uxBursts[ x ], benchBATCH_TASK_ITEMS, prvMoveToTask( xQueue, benchBATCH_TASK_ITEMS, uxBursts[ x ] ) );
+	}
+
+	vQueueDelete( xQueue );
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvMoveLocally( QueueHandle_t xQueue, uint32_t ulItems, UBaseType_t uxBurst )
+{
+uint32_t ulItemsOut[ benchBATCH_LARGE_BURST ], ulItemsIn[ benchBATCH_LARGE_BURST ];
+uint32_t ulSent = 0, ulReceived = 0;
+uint64_t ullStart;
+UBaseType_t x;
+
+	ullStart = ullBenchNow();
+
+	while( ulSent < ulItems )
+	{
+		for( x = 0; x < uxBurst; x++ )
+		{
+			ulItemsOut[ x ] = ulSent + ( uint32_t ) x;
+		}
+
+		if( uxBurst == 1 )
+		{
+			benchCHECK( xQueueSend( xQueue, ulItemsOut, 0 ) == pdPASS );
+			benchCHECK( xQueueReceive( xQueue, ulItemsIn, 0 ) == pdPASS );
+		}
+		else
+		{
+			benchCHECK( xQueueSendMultiple( xQueue, ulItemsOut, uxBurst, 0 ) == uxBurst );
+			benchCHECK( xQueueReceiveMultiple( xQueue, ulItemsIn, uxBurst, 0 ) == uxBurst );
+		}
+
+		for( x = 0; x < uxBurst; x++ )
+		{
+			benchCHECK( ulItemsIn[ x ] == ulReceived );
+			ulReceived++;
+		}
+
+		ulSent += ( uint32_t ) uxBurst;
+	}
+
+	return ullBenchNow() - ullStart;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvMoveToTask( QueueHandle_t xQueue, uint32_t ulItems, UBaseType_t uxBurst )
+{
+uint32_t ulItemsOut[ benchBATCH_LARGE_BURST ];
+uint32_t ulSent = 0;
+uint64_t ullStart, ullEnd;
+UBaseType_t x;
+BatchReceiver_t xReceiver;
+
+	xReceiver.xQueue = xQueue;
+	xReceiver.xController = xTaskGetCurrentTaskHandle();
+	xReceiver.ulItems = ulItems;
+	xReceiver.uxBurst = uxBurst;
+
+	/* The receiver runs at once and blocks on the empty queue. */
+	benchCHECK( xTaskCreate( prvReceiverTask, "Receiver", benchSTACK_SIZE, &xReceiver, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+
+	ullStart = ullBenchNow();
+
+	while( ulSent < ulItems )
+	{
+		for( x = 0; x < uxBurst; x++ )
+		{
+			ulItemsOut[ x ] = ulSent + ( uint32_t ) x;
+		}
+
+		if( uxBurst == 1 )
+		{
+			benchCHECK( xQueueSend( xQueue, ulItemsOut, portMAX_DELAY ) == pdPASS );
+		}
+		else
+		{
+			benchCHECK( xQueueSendMultiple( xQueue, ulItemsOut, uxBurst, portMAX_DELAY ) == uxBurst );
+		}
+
+		ulSent += ( uint32_t ) uxBurst;
+	}
+
+	/* The receiver checks the items and gives the notification once it has
+	all of them. */
+	benchCHECK( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 10000 ) ) == 1 );
+	ullEnd = ullBenchNow();
+
+	/* Let the idle task free the receiver. */
+	vTaskDelay( 1 );
+
+	return ullEnd - ullStart;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceiverTask( void *pvParameters )
+{
+BatchReceiver_t *pxReceiver = ( BatchReceiver_t * ) pvParameters;
+uint32_t ulItemsIn[ benchBATCH_LARGE_BURST ];
+uint32_t ulReceived = 0;
+UBaseType_t x, uxCount;
+
+	while( ulReceived < pxReceiver->ulItems )
+	{
+		if( pxReceiver->uxBurst == 1 )
+		{
+			uxCount = ( xQueueReceive( pxReceiver->xQueue, ulItemsIn, portMAX_DELAY ) == pdPASS ) ? 1 : 0;
+		}
+		else
+		{
+			/* Blocks until the whole burst has been sent. */
+			uxCount = xQueueReceiveMultiple( pxReceiver->xQueue, ulItemsIn, pxReceiver->uxBurst, portMAX_DELAY );
+		}
+
+		benchCHECK( uxCount > 0 );
+
+		for( x = 0; x < uxCount; x++ )
+		{
+			benchCHECK( ulItemsIn[ x ] == ulReceived );
+			ulReceived++;
+		}
+	}
+
+	benchCHECK( uxQueueMessagesWaiting( pxReceiver->xQueue ) == 0 );
+
+	xTaskNotifyGive( pxReceiver->xController );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvPrintResult( const char *pcHow, UBaseType_t uxBurst, uint32_t ulItems, uint64_t ullNanoseconds )
+{
+	printf( "  %-9s burst %3u: %8lu items %10.1f ns/item\n",
+			pcHow,
+			( unsigned ) uxBurst,
+			( unsigned long ) ulItems,
+			( double ) ullNanoseconds / ( double ) ulItems );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchQueuePingPong( void *pvParameters )
+{
+const size_t xItemSizes[] = { 4, 8, 12, 16 };
+uint64_t ullLocal, ullRoundTrip;
+size_t x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < ( sizeof( xItemSizes ) / sizeof( xItemSizes[ 0 ] ) ); x++ )
+	{
+		prvTimeQueue( xItemSizes[ x ], &ullLocal, &ullRoundTrip );
+
+		printf( "  item %2u bytes (%s): send+receive %7.1f ns, round trip %9.1f ns\n",
+				( unsigned ) xItemSizes[ x ],
+				( ( configQUEUE_FIXED_SIZE_COPY == 1 ) && ( ( xItemSizes[ x ] == 4 ) || ( xItemSizes[ x ] == 8 ) ) ) ? "fixed " : "memcpy",
+				( double ) ullLocal / ( double ) benchPINGPONG_LOCAL_ITEMS,
+				( double ) ullRoundTrip / ( double ) benchPINGPONG_ROUND_TRIPS );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+void vBenchSPSCThroughput( void *pvParameters )
+{
+const size_t xItemSizes[] = { 4, 8, 12, 16 };
+uint64_t ullLocal, ullRoundTrip, ullSPSCLocal, ullSPSCRoundTrip;
+size_t x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < ( sizeof( xItemSizes ) / sizeof( xItemSizes[ 0 ] ) ); x++ )
+	{
+		prvTimeSPSCQueue( xItemSizes[ x ], &ullSPSCLocal, &ullSPSCRoundTrip );
+		prvTimeQueue( xItemSizes[ x ], &ullLocal, &ullRoundTrip );
+
+		printf( "  item %2u bytes: send+receive %6.1f ns SPSC, %6.1f ns queue; round trip %8.1f ns SPSC, %8.1f ns queue\n",
+				( unsigned ) xItemSizes[ x ],
+				( double ) ullSPSCLocal / ( double ) benchPINGPONG_LOCAL_ITEMS,
+				( double ) ullLocal / ( double ) benchPINGPONG_LOCAL_ITEMS,
+				( double ) ullSPSCRoundTrip / ( double ) benchPINGPONG_ROUND_TRIPS,
+				( double ) ullRoundTrip / ( double ) benchPINGPONG_ROUND_TRIPS );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeQueue( size_t xItemSize, uint64_t *pullLocal, uint64_t *pullRoundTrip )
+{
+uint8_t ucItemOut[ benchPINGPONG_MAX_ITEM_SIZE ], ucItemIn[ benchPINGPONG_MAX_ITEM_SIZE ];
+PingPong_t xPingPong;
+TaskHandle_t xEcho;
+uint64_t ullStart;
+uint32_t ulSequence;
+
+	xPingPong.xPing = xQueueCreate( 1, xItemSize );
+	xPingPong.xPong = xQueueCreate( 1, xItemSize );
+	benchCHECK( ( xPingPong.xPing != NULL ) && ( xPingPong.xPong != NULL ) );
+
+	/* Send and receive in the controller alone. */
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_LOCAL_ITEMS; ulSequence++ )
+	{
+		prvFillItem( ucItemOut, xItemSize, ulSequence );
+		benchCHECK( xQueueSend( xPingPong.xPing, ucItemOut, 0 ) == pdPASS );
+		benchCHECK( xQueueReceive( xPingPong.xPing, ucItemIn, 0 ) == pdPASS );
+		benchCHECK( prvItemIsValid( ucItemIn, xItemSize, ulSequence ) != pdFALSE );
+	}
+
+	*pullLocal = ullBenchNow() - ullStart;
+
+	/* Round trips through the echo task, which runs at once and blocks on the
+	empty ping queue. */
+	benchCHECK( xTaskCreate( prvEchoTask, "Echo", benchSTACK_SIZE, &xPingPong, benchCONTROL_PRIORITY + 1, &xEcho ) == pdPASS );
+
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_ROUND_TRIPS; ulSequence++ )
+	{
+		prvFillItem( ucItemOut, xItemSize, ulSequence );
+		benchCHECK( xQueueSend( xPingPong.xPing, ucItemOut, portMAX_DELAY ) == pdPASS );
+		benchCHECK( xQueueReceive( xPingPong.xPong, ucItemIn, portMAX_DELAY ) == pdPASS );
+		benchCHECK( prvItemIsValid( ucItemIn, xItemSize, ulSequence ) != pdFALSE );
+	}
+
+	*pullRoundTrip = ullBenchNow() - ullStart;
+
+	/* The echo task is blocked on the ping queue again, so can be deleted
+	before the queues are. */
+	vTaskDelete( xEcho );
+	vQueueDelete( xPingPong.xPing );
+	vQueueDelete( xPingPong.xPong );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeSPSCQueue( size_t xItemSize, uint64_t *pullLocal, uint64_t *pullRoundTrip )
+{
+uint8_t ucItemOut[ benchPINGPONG_MAX_ITEM_SIZE ], ucItemIn[ benchPINGPONG_MAX_ITEM_SIZE ];
+SPSCPingPong_t xPingPong;
+TaskHandle_t xEcho;
+uint64_t ullStart;
+uint32_t ulSequence;
+
+	xPingPong.xPing = xSPSCQueueCreate( 1, xItemSize );
+	xPingPong.xPong = xSPSCQueueCreate( 1, xItemSize );
+	benchCHECK( ( xPingPong.xPing != NULL ) && ( xPingPong.xPong != NULL ) );
+
+	/* The controller is both the producer and the consumer of the ping queue
+	here, which is allowed as it never does both at once. */
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_LOCAL_ITEMS; ulSequence++ )
+	{
+		prvFillItem( ucItemOut, xItemSize, ulSequence );
+		benchCHECK( xSPSCQueueSend( xPingPong.xPing, ucItemOut, 0 ) == pdPASS );
+		benchCHECK( xSPSCQueueReceive( xPingPong.xPing, ucItemIn, 0 ) == pdPASS );
+		benchCHECK( prvItemIsValid( ucItemIn, xItemSize, ulSequence ) != pdFALSE );
+	}
+
+	*pullLocal = ullBenchNow() - ullStart;
+
+	benchCHECK( xTaskCreate( prvSPSCEchoTask, "SPSCEcho", benchSTACK_SIZE, &xPingPong, benchCONTROL_PRIORITY + 1, &xEcho ) == pdPASS );
+
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_ROUND_TRIPS; ulSequence++ )
+	{
+		prvFillItem( ucItemOut, xItemSize, ulSequence );
+		benchCHECK( xSPSCQueueSend( xPingPong.xPing, ucItemOut, portMAX_DELAY ) == pdPASS );
+		benchCHECK( xSPSCQueueReceive( xPingPong.xPong, ucItemIn, portMAX_DELAY ) == pdPASS );
+		benchCHECK( prvItemIsValid( ucItemIn, xItemSize, ulSequence ) != pdFALSE );
+	}
+
+	*pullRoundTrip = ullBenchNow() - ullStart;
+
+	/* As for the queues, the echo task is blocked on the ping queue. */
+	vTaskDelete( xEcho );
+	vSPSCQueueDelete( xPingPong.xPing );
+	vSPSCQueueDelete( xPingPong.xPong );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillItem( uint8_t *pucItem, size_t xItemSize, uint32_t ulSequence )
+{
+size_t x;
+
+	/* The sequence number, then a pattern derived from it, so an item that
+	was copied short or from the wrong slot is noticed. */
+	memcpy( pucItem, &ulSequence, sizeof( ulSequence ) );
+
+	for( x = sizeof( ulSequence ); x < xItemSize; x++ )
+	{
+		pucItem[ x ] = ( uint8_t ) ( ulSequence + x );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvItemIsValid( const uint8_t *pucItem, size_t xItemSize, uint32_t ulSequence )
+{
+size_t x;
+
+	if( memcmp( pucItem, &ulSequence, sizeof( ulSequence ) ) != 0 )
+	{
+		return pdFALSE;
+	}
+
+	for( x = sizeof( ulSequence ); x < xItemSize; x++ )
+	{
+		if( pucItem[ x ] != ( uint8_t ) ( ulSequence + x ) )
+		{
+			return pdFALSE;
+		}
+	}
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEchoTask( void *pvParameters )
+{
+PingPong_t *pxPingPong = ( PingPong_t * ) pvParameters;
+uint8_t ucItem[ benchPINGPONG_MAX_ITEM_SIZE ];
+
+	for( ;; )
+	{
+		benchCHECK( xQueueReceive( pxPingPong->xPing, ucItem, portMAX_DELAY ) == pdPASS );
+		benchCHECK( xQueueSend( pxPingPong->xPong, ucItem, portMAX_DELAY ) == pdPASS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvSPSCEchoTask( void *pvParameters )
+{
+SPSCPingPong_t *pxPingPong = ( SPSCPingPong_t * ) pvParameters;
+uint8_t ucItem[ benchPINGPONG_MAX_ITEM_SIZE ];
+
+	for( ;; )
+	{
+		benchCHECK( xSPSCQueueReceive( pxPingPong->xPing, ucItem, portMAX_DELAY ) == pdPASS );
+		benchCHECK( xSPSCQueueSend( pxPingPong->xPong, ucItem, portMAX_DELAY ) == pdPASS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchQueueHandoff( void *pvParameters )
+{
+HandoffLatency_t xLatency;
+TaskHandle_t xReceiver;
+uint8_t ucItem[ benchPINGPONG_MAX_ITEM_SIZE ];
+uint32_t ulSequence;
+
+	( void ) pvParameters;
+
+	prvCheckHandoffTimeout( pdFALSE );
+	prvCheckHandoffTimeout( pdTRUE );
+	prvCheckHandoffPeek( pdTRUE );
+	prvCheckHandoffPeek( pdFALSE );
+
+	/* The receiver runs at once and blocks on the empty queue, so each item is
+	sent to a receiver that is blocked in xQueueReceive(). */
+	xLatency.xQueue = xQueueCreate( 1, benchPINGPONG_MAX_ITEM_SIZE );
+	benchCHECK( xLatency.xQueue != NULL );
+	xLatency.xController = xTaskGetCurrentTaskHandle();
+	xLatency.ullTotal = 0;
+	xLatency.ullMax = 0;
+	benchCHECK( xTaskCreate( prvHandoffLatencyTask, "Latency", benchSTACK_SIZE, &xLatency, benchCONTROL_PRIORITY + 1, &xReceiver ) == pdPASS );
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_ROUND_TRIPS; ulSequence++ )
+	{
+		prvFillItem( ucItem, benchPINGPONG_MAX_ITEM_SIZE, ulSequence );
+		xLatency.ullSent = ullBenchNow();
+		benchCHECK( xQueueSend( xLatency.xQueue, ucItem, portMAX_DELAY ) == pdPASS );
+	}
+
+	/* The receiver checks the items and gives the notification once it has
+	all of them. */
+	benchCHECK( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 10000 ) ) == 1 );
+	benchCHECK( uxQueueMessagesWaiting( xLatency.xQueue ) == 0 );
+
+	printf( "  %s: send to receive %7.1f ns average, %7.1f us max\n",
+			( configUSE_QUEUE_DIRECT_HANDOFF == 1 ) ? "handoff  " : "ring copy",
+			( double ) xLatency.ullTotal / ( double ) benchPINGPONG_ROUND_TRIPS,
+			( double ) xLatency.ullMax / 1000.0 );
+
+	/* Let the idle task free the receiver before the queue goes. */
+	vTaskDelay( 1 );
+	vQueueDelete( xLatency.xQueue );
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckHandoffTimeout( BaseType_t xSendFirst )
+{
+HandoffReceiver_t xReceiver;
+TaskHandle_t xTask;
+uint32_t ulItem = benchHANDOFF_ITEM;
+
+	xReceiver.xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+	benchCHECK( xReceiver.xQueue != NULL );
+	xReceiver.xController = xTaskGetCurrentTaskHandle();
+	xReceiver.xPeek = pdFALSE;
+	xReceiver.xTicksToWait = benchHANDOFF_TIMEOUT_TICKS;
+	xReceiver.ulItem = 0;
+
+	/* The receiver has a lower priority than the controller, so runs and
+	blocks on the empty queue while the controller delays. */
+	benchCHECK( xTaskCreate( prvHandoffReceiverTask, "Receiver", benchSTACK_SIZE, &xReceiver, benchCONTROL_PRIORITY - 1, &xTask ) == pdPASS );
+	vTaskDelay( 1 );
+	benchCHECK( eTaskGetState( xTask ) == eBlocked );
+
+	if( xSendFirst != pdFALSE )
+	{
+		/* Hand the item over, then let the receiver's block time expire
+		before it gets to run. */
+		benchCHECK( xQueueSend( xReceiver.xQueue, &ulItem, 0 ) == pdPASS );
+		benchCHECK( eTaskGetState( xTask ) == eReady );
+
+		/* A handed off item never enters the queue. */
+		benchCHECK( uxQueueMessagesWaiting( xReceiver.xQueue ) == ( ( configUSE_QUEUE_DIRECT_HANDOFF == 1 ) ? 0U : 1U ) );
+		prvSpinTicks( benchHANDOFF_TIMEOUT_TICKS * 2 );
+	}
+	else
+	{
+		/* Let the receiver's block time expire, then send while it is ready
+		but not yet running, so it is no longer waiting for the item. */
+		prvSpinTicks( benchHANDOFF_TIMEOUT_TICKS * 2 );
+		benchCHECK( eTaskGetState( xTask ) == eReady );
+		benchCHECK( xQueueSend( xReceiver.xQueue, &ulItem, 0 ) == pdPASS );
+	}
+
+	/* Either way the receiver gets the item exactly once. */
+	benchCHECK( ulTaskNotifyTake( pdTRUE, pdMS_TO_TICKS( 1000 ) ) == 1 );
+	benchCHECK( xReceiver.xResult == pdPASS );
+	benchCHECK( xReceiver.ulItem == benchHANDOFF_ITEM );
+	benchCHECK( uxQueueMessagesWaiting( xReceiver.xQueue ) == 0 );
+
+	printf( "  receiver timed out %s the send: item received once\n", ( xSendFirst != pdFALSE ) ? "after " : "before" );
+
+	vTaskDelay( 1 );
+	vQueueDelete( xReceiver.xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckHandoffPeek( BaseType_t xPeekerFirst )
+{
+HandoffReceiver_t xReceiver, xPeeker;
+TaskHandle_t xPeekerTask;
+uint32_t ulItem;
+QueueHandle_t xQueue;
+
+	xQueue = xQueueCreate( 2, sizeof( uint32_t ) );
+	benchCHECK( xQueue != NULL );
+
+	xReceiver.xQueue = xQueue;
+	xReceiver.xController = xTaskGetCurrentTaskHandle();
+	xReceiver.xPeek = pdFALSE;
+	xReceiver.xTicksToWait = pdMS_TO_TICKS( 1000 );
+	xReceiver.ulItem = 0;
+	xPeeker = xReceiver;
+	xPeeker.xPeek = pdTRUE;
+
+	/* Both run at once and block on the empty queue, the receiver with a
+	buffer set for the handoff and the peeker without. */
+	benchCHECK( xTaskCreate( prvHandoffReceiverTask, "Receiver", benchSTACK_SIZE, &xReceiver, benchCONTROL_PRIORITY + ( ( xPeekerFirst != pdFALSE ) ? 1 : 2 ), NULL ) == pdPASS );
+	benchCHECK( xTaskCreate( prvHandoffReceiverTask, "Peeker", benchSTACK_SIZE, &xPeeker, benchCONTROL_PRIORITY + ( ( xPeekerFirst != pdFALSE ) ? 2 : 1 ), &xPeekerTask ) == pdPASS );
+
+	ulItem = benchHANDOFF_ITEM;
+	benchCHECK( xQueueSend( xQueue, &ulItem, 0 ) == pdPASS );
+
+	if( xPeekerFirst != pdFALSE )
+	{
+		/* The peeker is at the head of the waiting tasks, so the item goes
+		into the queue.  The peeker sees it, leaves it, and wakes the
+		receiver, which takes it. */
+		benchCHECK( ulTaskNotifyTake( pdTRUE, 0 ) == 2 );
+		benchCHECK( xPeeker.ulItem == benchHANDOFF_ITEM );
+	}
+	else
+	{
+		/* The receiver takes the item, handed off or not, and the peeker is
+		still waiting for one. */
+		benchCHECK( ulTaskNotifyTake( pdTRUE, 0 ) == 1 );
+		benchCHECK( eTaskGetState( xPeekerTask ) == eBlocked );
+
+		ulItem = benchHANDOFF_ITEM + 1;
+		benchCHECK( xQueueSend( xQueue, &ulItem, 0 ) == pdPASS );
+		benchCHECK( ulTaskNotifyTake( pdTRUE, 0 ) == 1 );
+		benchCHECK( xPeeker.ulItem == benchHANDOFF_ITEM + 1 );
+
+		/* What the peeker saw is still in the queue. */
+		benchCHECK( xQueueReceive( xQueue, &ulItem, 0 ) == pdPASS );
+		benchCHECK( ulItem == benchHANDOFF_ITEM + 1 );
+	}
+
+	benchCHECK( ( xReceiver.xResult == pdPASS ) && ( xPeeker.xResult == pdPASS ) );
+	benchCHECK( xReceiver.ulItem == benchHANDOFF_ITEM );
+	benchCHECK( uxQueueMessagesWaiting( xQueue ) == 0 );
+
+	printf( "  %s waiting first beside a %s: each saw its item\n",
+			( xPeekerFirst != pdFALSE ) ? "peeker" : "receiver",
+			( xPeekerFirst != pdFALSE ) ? "receiver" : "peeker" );
+
+	vTaskDelay( 1 );
+	vQueueDelete( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSpinTicks( TickType_t xTicks )
+{
+const TickType_t xStartTick = xTaskGetTickCount();
+
+	/* The tick still moves tasks whose block time expires to the ready list,
+	but none of them runs before the controller blocks. */
+	while( ( xTaskGetTickCount() - xStartTick ) < xTicks )
+	{
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandoffReceiverTask( void *pvParameters )
+{
+HandoffReceiver_t *pxReceiver = ( HandoffReceiver_t * ) pvParameters;
+uint32_t ulItem = 0;
+
+	if( pxReceiver->xPeek != pdFALSE )
+	{
+		pxReceiver->xResult = xQueuePeek( pxReceiver->xQueue, &ulItem, pxReceiver->xTicksToWait );
+	}
+	else
+	{
+		pxReceiver->xResult = xQueueReceive( pxReceiver->xQueue, &ulItem, pxReceiver->xTicksToWait );
+	}
+
+	pxReceiver->ulItem = ulItem;
+	xTaskNotifyGive( pxReceiver->xController );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHandoffLatencyTask( void *pvParameters )
+{
+HandoffLatency_t *pxLatency = ( HandoffLatency_t * ) pvParameters;
+uint8_t ucItem[ benchPINGPONG_MAX_ITEM_SIZE ];
+uint64_t ullLatency;
+uint32_t ulSequence;
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_ROUND_TRIPS; ulSequence++ )
+	{
+		/* Copied from the sender's buffer or from the queue storage area,
+		the item must arrive whole and in order either way. */
+		benchCHECK( xQueueReceive( pxLatency->xQueue, ucItem, portMAX_DELAY ) == pdPASS );
+		ullLatency = ullBenchNow() - pxLatency->ullSent;
+		benchCHECK( prvItemIsValid( ucItem, benchPINGPONG_MAX_ITEM_SIZE, ulSequence ) != pdFALSE );
+
+		pxLatency->ullTotal += ullLatency;
+
+		if( ullLatency > pxLatency->ullMax )
+		{
+			pxLatency->ullMax = ullLatency;
+		}
+	}
+
+	xTaskNotifyGive( pxLatency->xController );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchQueueZeroCopy( void *pvParameters )
+{
+const size_t xItemSizes[] = { 16, benchZERO_COPY_MAX_ITEM_SIZE };
+uint64_t ullZeroCopy, ullCopy;
+size_t x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < ( sizeof( xItemSizes ) / sizeof( xItemSizes[ 0 ] ) ); x++ )
+	{
+		ullZeroCopy = prvTimeZeroCopy( xItemSizes[ x ] );
+		ullCopy = prvTimeCopy( xItemSizes[ x ] );
+
+		printf( "  item %3u bytes: reserve+commit+acquire+release %7.1f ns, send+receive %7.1f ns\n",
+				( unsigned ) xItemSizes[ x ],
+				( double ) ullZeroCopy / ( double ) benchPINGPONG_LOCAL_ITEMS,
+				( double ) ullCopy / ( double ) benchPINGPONG_LOCAL_ITEMS );
+	}
+
+	prvCheckFrontSender( pdTRUE );
+	prvCheckFrontSender( pdFALSE );
+	prvCheckOverwrite();
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeZeroCopy( size_t xItemSize )
+{
+QueueHandle_t xQueue;
+uint8_t *pucSlot;
+uint64_t ullStart, ullElapsed;
+uint32_t ulSequence;
+
+	xQueue = xQueueCreate( benchZERO_COPY_QUEUE_LENGTH, xItemSize );
+	benchCHECK( xQueue != NULL );
+
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_LOCAL_ITEMS; ulSequence++ )
+	{
+		pucSlot = ( uint8_t * ) pvQueueReserve( xQueue, 0 );
+		benchCHECK( pucSlot != NULL );
+		prvFillItem( pucSlot, xItemSize, ulSequence );
+		vQueueCommit( xQueue, pucSlot );
+
+		pucSlot = ( uint8_t * ) pvQueueAcquire( xQueue, 0 );
+		benchCHECK( pucSlot != NULL );
+		benchCHECK( prvItemIsValid( pucSlot, xItemSize, ulSequence ) != pdFALSE );
+		vQueueRelease( xQueue, pucSlot );
+	}
+
+	ullElapsed = ullBenchNow() - ullStart;
+
+	benchCHECK( uxQueueMessagesWaiting( xQueue ) == 0 );
+	vQueueDelete( xQueue );
+
+	return ullElapsed;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeCopy( size_t xItemSize )
+{
+static uint8_t ucItemOut[ benchZERO_COPY_MAX_ITEM_SIZE ], ucItemIn[ benchZERO_COPY_MAX_ITEM_SIZE ];
+QueueHandle_t xQueue;
+uint64_t ullStart, ullElapsed;
+uint32_t ulSequence;
+
+	xQueue = xQueueCreate( benchZERO_COPY_QUEUE_LENGTH, xItemSize );
+	benchCHECK( xQueue != NULL );
+
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchPINGPONG_LOCAL_ITEMS; ulSequence++ )
+	{
+		prvFillItem( ucItemOut, xItemSize, ulSequence );
+		benchCHECK( xQueueSend( xQueue, ucItemOut, 0 ) == pdPASS );
+
+		benchCHECK( xQueueReceive( xQueue, ucItemIn, 0 ) == pdPASS );
+		benchCHECK( prvItemIsValid( ucItemIn, xItemSize, ulSequence ) != pdFALSE );
+	}
+
+	ullElapsed = ullBenchNow() - ullStart;
+
+	vQueueDelete( xQueue );
+
+	return ullElapsed;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckFrontSender( BaseType_t xAcquire )
+{
+QueueHandle_t xQueue;
+uint32_t *pulSlot;
+uint32_t ulItem, ulExpected;
+
+	xQueue = xQueueCreate( benchZERO_COPY_QUEUE_LENGTH, sizeof( uint32_t ) );
+	benchCHECK( xQueue != NULL );
+
+	/* Either the item at the front is acquired, or a slot is reserved behind
+	the item already queued. */
+	ulItem = 1;
+	benchCHECK( xQueueSend( xQueue, &ulItem, 0 ) == pdPASS );
+
+	if( xAcquire != pdFALSE )
+	{
+		pulSlot = ( uint32_t * ) pvQueueAcquire( xQueue, 0 );
+		benchCHECK( ( pulSlot != NULL ) && ( *pulSlot == 1 ) );
+	}
+	else
+	{
+		pulSlot = ( uint32_t * ) pvQueueReserve( xQueue, 0 );
+		benchCHECK( pulSlot != NULL );
+		*pulSlot = 2;
+	}
+
+	/* The queue has space, but not at the front. */
+	ulItem = benchZERO_COPY_FRONT_ITEM;
+	benchCHECK( xQueueSendToFront( xQueue, &ulItem, 0 ) == errQUEUE_FULL );
+	benchCHECK( xQueueSendToFront( xQueue, &ulItem, pdMS_TO_TICKS( 10 ) ) == errQUEUE_FULL );
+	benchCHECK( xQueueSendToFrontFromISR( xQueue, &ulItem, NULL ) == errQUEUE_FULL );
+
+	/* A reserved slot makes the queue full to every sender, an acquired item
+	only to those that write to the front. */
+	ulItem = 3;
+
+	if( xAcquire != pdFALSE )
+	{
+		benchCHECK( xQueueSend( xQueue, &ulItem, 0 ) == pdPASS );
+	}
+	else
+	{
+		benchCHECK( xQueueSend( xQueue, &ulItem, 0 ) == errQUEUE_FULL );
+	}
+
+	/* The task runs at once, and blocks until the slot in front is free. */
+	xFrontSent = pdFALSE;
+	benchCHECK( xTaskCreate( prvFrontSenderTask, "Front", benchSTACK_SIZE, xQueue, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xFrontSent == pdFALSE );
+
+	if( xAcquire != pdFALSE )
+	{
+		vQueueRelease( xQueue, pulSlot );
+	}
+	else
+	{
+		vQueueCommit( xQueue, pulSlot );
+	}
+
+	benchCHECK( xFrontSent != pdFALSE );
+
+	/* The item sent to the front comes first, then the others in order. */
+	benchCHECK( xQueueReceive( xQueue, &ulItem, 0 ) == pdPASS );
+	benchCHECK( ulItem == benchZERO_COPY_FRONT_ITEM );
+
+	for( ulExpected = ( xAcquire != pdFALSE ) ? 3 : 1; ulExpected <= ( ( xAcquire != pdFALSE ) ? 3 : 2 ); ulExpected++ )
+	{
+		benchCHECK( xQueueReceive( xQueue, &ulItem, 0 ) == pdPASS );
+		benchCHECK( ulItem == ulExpected );
+	}
+
+	benchCHECK( uxQueueMessagesWaiting( xQueue ) == 0 );
+	printf( "  send to front while %s: blocked until %s\n",
+			( xAcquire != pdFALSE ) ? "acquired" : "reserved",
+			( xAcquire != pdFALSE ) ? "released" : "committed" );
+
+	/* Let the idle task free the sender before the queue goes. */
+	vTaskDelay( 1 );
+	vQueueDelete( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckOverwrite( void )
+{
+QueueHandle_t xQueue;
+uint32_t *pulSlot;
+uint32_t ulItem;
+
+	xQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+	benchCHECK( xQueue != NULL );
+
+	/* A reserved slot is not overwritten, and is received once committed. */
+	pulSlot = ( uint32_t * ) pvQueueReserve( xQueue, 0 );
+	benchCHECK( pulSlot != NULL );
+	*pulSlot = 1;
+	ulItem = 2;
+	benchCHECK( xQueueOverwrite( xQueue, &ulItem ) == errQUEUE_FULL );
+	benchCHECK( xQueueOverwriteFromISR( xQueue, &ulItem, NULL ) == errQUEUE_FULL );
+	vQueueCommit( xQueue, pulSlot );
+	benchCHECK( xQueuePeek( xQueue, &ulItem, 0 ) == pdPASS );
+	benchCHECK( ulItem == 1 );
+
+	/* Nor is an acquired item, until it is released. */
+	pulSlot = ( uint32_t * ) pvQueueAcquire( xQueue, 0 );
+	benchCHECK( ( pulSlot != NULL ) && ( *pulSlot == 1 ) );
+	ulItem = 3;
+	benchCHECK( xQueueOverwrite( xQueue, &ulItem ) == errQUEUE_FULL );
+	benchCHECK( xQueueOverwriteFromISR( xQueue, &ulItem, NULL ) == errQUEUE_FULL );
+	benchCHECK( *pulSlot == 1 );
+	vQueueRelease( xQueue, pulSlot );
+	benchCHECK( xQueueOverwrite( xQueue, &ulItem ) == pdPASS );
+	benchCHECK( xQueueReceive( xQueue, &ulItem, 0 ) == pdPASS );
+	benchCHECK( ulItem == 3 );
+
+	printf( "  overwrite while reserved or acquired: queue full\n" );
+
+	vQueueDelete( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFrontSenderTask( void *pvParameters )
+{
+QueueHandle_t xQueue = ( QueueHandle_t ) pvParameters;
+uint32_t ulItem = benchZERO_COPY_FRONT_ITEM;
+
+	benchCHECK( xQueueSendToFront( xQueue, &ulItem, portMAX_DELAY ) == pdPASS );
+	xFrontSent = pdTRUE;
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchQueueSet( void *pvParameters )
+{
+const UBaseType_t uxMembers[] = { 4, 16, benchSET_MAX_MEMBERS };
+size_t x;
+
+	( void ) pvParameters;
+
+	printf( "  %s\n", ( configUSE_QUEUE_SET_READY_LIST == 1 ) ? "members linked into a ready list" : "member handles copied into the set" );
+
+	prvCheckSetOrder();
+	prvCheckSetMemberDelete();
+
+	for( x = 0; x < ( sizeof( uxMembers ) / sizeof( uxMembers[ 0 ] ) ); x++ )
+	{
+		prvTimeSet( uxMembers[ x ] );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSetOrder( void )
+{
+QueueSetHandle_t xSet;
+QueueHandle_t xMembers[ 3 ];
+QueueSetMemberHandle_t xSelected;
+uint32_t ulItem = 0;
+UBaseType_t x;
+
+	xSet = xQueueCreateSet( 3 * 2 );
+	benchCHECK( xSet != NULL );
+
+	for( x = 0; x < 3; x++ )
+	{
+		xMembers[ x ] = xQueueCreate( 2, sizeof( uint32_t ) );
+		benchCHECK( xMembers[ x ] != NULL );
+		benchCHECK( xQueueAddToSet( xMembers[ x ], xSet ) == pdPASS );
+	}
+
+	/* Two items to each member in turn. */
+	for( x = 0; x < 3; x++ )
+	{
+		benchCHECK( xQueueSend( xMembers[ x ], &ulItem, 0 ) == pdPASS );
+		benchCHECK( xQueueSend( xMembers[ x ], &ulItem, 0 ) == pdPASS );
+	}
+
+	/* Members linked into a ready list are returned in turn, while copied
+	handles come back in the order the items were sent. */
+	for( x = 0; x < 6; x++ )
+	{
+		xSelected = xQueueSelectFromSet( xSet, 0 );
+
+		#if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+			benchCHECK( xSelected == xMembers[ x % 3 ] );
+		#else
+			benchCHECK( xSelected == xMembers[ x / 2 ] );
+		#endif
+
+		benchCHECK( xQueueReceive( xSelected, &ulItem, 0 ) == pdPASS );
+	}
+
+	benchCHECK( xQueueSelectFromSet( xSet, 0 ) == NULL );
+	printf( "  members selected in order: ok\n" );
+
+	for( x = 0; x < 3; x++ )
+	{
+		benchCHECK( xQueueRemoveFromSet( xMembers[ x ], xSet ) == pdPASS );
+		vQueueDelete( xMembers[ x ] );
+	}
+
+	vQueueDelete( xSet );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckSetMemberDelete( void )
+{
+QueueSetHandle_t xSet;
+QueueHandle_t xDeleted, xKept, xReplacement;
+uint32_t ulItem = 0;
+
+	xSet = xQueueCreateSet( 2 );
+	xDeleted = xQueueCreate( 1, sizeof( uint32_t ) );
+	xKept = xQueueCreate( 1, sizeof( uint32_t ) );
+	benchCHECK( ( xSet != NULL ) && ( xDeleted != NULL ) && ( xKept != NULL ) );
+	benchCHECK( xQueueAddToSet( xDeleted, xSet ) == pdPASS );
+	benchCHECK( xQueueAddToSet( xKept, xSet ) == pdPASS );
+
+	/* Empty the member, then delete it while it is still in the set.  A
+	member that is linked into a ready list stays in the list until a select
+	finds it empty.  A queue created next is likely to reuse its memory. */
+	benchCHECK( xQueueSend( xDeleted, &ulItem, 0 ) == pdPASS );
+	benchCHECK( xQueueSelectFromSet( xSet, 0 ) == xDeleted );
+	benchCHECK( xQueueReceive( xDeleted, &ulItem, 0 ) == pdPASS );
+	vQueueDelete( xDeleted );
+	xReplacement = xQueueCreate( 1, sizeof( uint32_t ) );
+	benchCHECK( xReplacement != NULL );
+
+	benchCHECK( xQueueSend( xKept, &ulItem, 0 ) == pdPASS );
+	benchCHECK( xQueueSelectFromSet( xSet, 0 ) == xKept );
+	benchCHECK( xQueueReceive( xKept, &ulItem, 0 ) == pdPASS );
+	benchCHECK( xQueueSelectFromSet( xSet, 0 ) == NULL );
+	benchCHECK( uxQueueMessagesWaiting( xSet ) == 0 );
+	printf( "  emptied member deleted while in the set: ok\n" );
+
+	benchCHECK( xQueueRemoveFromSet( xKept, xSet ) == pdPASS );
+	vQueueDelete( xReplacement );
+	vQueueDelete( xKept );
+	vQueueDelete( xSet );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeSet( UBaseType_t uxMembers )
+{
+static QueueHandle_t xMembers[ benchSET_MAX_MEMBERS ];
+QueueSetHandle_t xSet;
+QueueSetMemberHandle_t xSelected;
+uint64_t ullStart, ullSelect = 0, ullDirect = 0;
+uint32_t ulRound, ulItem;
+UBaseType_t x, y;
+
+	xSet = xQueueCreateSet( uxMembers * benchSET_ITEMS_PER_MEMBER );
+	benchCHECK( xSet != NULL );
+
+	for( x = 0; x < uxMembers; x++ )
+	{
+		xMembers[ x ] = xQueueCreate( benchSET_ITEMS_PER_MEMBER, sizeof( uint32_t ) );
+		benchCHECK( xMembers[ x ] != NULL );
+		benchCHECK( xQueueAddToSet( xMembers[ x ], xSet ) == pdPASS );
+	}
+
+	for( ulRound = 0; ulRound < benchSET_ROUNDS; ulRound++ )
+	{
+		prvFillMembers( xMembers, uxMembers );
+		ullStart = ullBenchNow();
+
+		for( x = 0; x < ( uxMembers * benchSET_ITEMS_PER_MEMBER ); x++ )
+		{
+			xSelected = xQueueSelectFromSet( xSet, 0 );
+			benchCHECK( xQueueReceive( xSelected, &ulItem, 0 ) == pdPASS );
+		}
+
+		ullSelect += ullBenchNow() - ullStart;
+		benchCHECK( xQueueSelectFromSet( xSet, 0 ) == NULL );
+
+		/* The same items received from the members directly.  The handle
+		copying sets still hold the members' handles afterwards, so they are
+		emptied without being timed. */
+		prvFillMembers( xMembers, uxMembers );
+		ullStart = ullBenchNow();
+
+		for( x = 0; x < uxMembers; x++ )
+		{
+			for( y = 0; y < benchSET_ITEMS_PER_MEMBER; y++ )
+			{
+				benchCHECK( xQueueReceive( xMembers[ x ], &ulItem, 0 ) == pdPASS );
+			}
+		}
+
+		ullDirect += ullBenchNow() - ullStart;
+
+		while( xQueueSelectFromSet( xSet, 0 ) != NULL )
+		{
+		}
+	}
+
+	for( x = 0; x < uxMembers; x++ )
+	{
+		benchCHECK( xQueueRemoveFromSet( xMembers[ x ], xSet ) == pdPASS );
+		vQueueDelete( xMembers[ x ] );
+	}
+
+	vQueueDelete( xSet );
+
+	printf( "  %2u members: select+receive %6.1f ns, receive alone %6.1f ns\n",
+			( unsigned ) uxMembers,
+			( double ) ullSelect / ( double ) ( benchSET_ROUNDS * uxMembers * benchSET_ITEMS_PER_MEMBER ),
+			( double ) ullDirect / ( double ) ( benchSET_ROUNDS * uxMembers * benchSET_ITEMS_PER_MEMBER ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillMembers( QueueHandle_t *pxMembers, UBaseType_t uxMembers )
+{
+uint32_t ulItem = 0;
+UBaseType_t x, y;
+
+	/* An item to each member in turn, so the members become ready in order. */
+	for( y = 0; y < benchSET_ITEMS_PER_MEMBER; y++ )
+	{
+		for( x = 0; x < uxMembers; x++ )
+		{
+			benchCHECK( xQueueSend( pxMembers[ x ], &ulItem, 0 ) == pdPASS );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchPriorityQueue( void *pvParameters )
+{
+const UBaseType_t uxLevels[] = { 4, benchPRIORITY_MAX_LEVELS };
+size_t x;
+
+	( void ) pvParameters;
+
+	prvCheckPriorityOrder();
+
+	for( x = 0; x < ( sizeof( uxLevels ) / sizeof( uxLevels[ 0 ] ) ); x++ )
+	{
+		prvTimePriorityQueue( uxLevels[ x ] );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPriorityOrder( void )
+{
+/* Sent in this order, so equal keys must come back in the order of their
+items. */
+const UBaseType_t uxKeys[] = { 5, 1, 3, 1, 5, 0, 3, 1 };
+const uint32_t ulExpectedItems[] = { 5, 1, 3, 7, 2, 6, 0, 4 };
+QueueHandle_t xQueue;
+UBaseType_t uxKey;
+uint32_t ulItem;
+size_t x;
+
+	xQueue = xQueueCreatePriority( benchPRIORITY_ITEMS, sizeof( uint32_t ) );
+	benchCHECK( xQueue != NULL );
+
+	for( x = 0; x < ( sizeof( uxKeys ) / sizeof( uxKeys[ 0 ] ) ); x++ )
+	{
+		ulItem = ( uint32_t ) x;
+		benchCHECK( xQueueSendWithKey( xQueue, &ulItem, uxKeys[ x ], 0 ) == pdPASS );
+	}
+
+	for( x = 0; x < ( sizeof( ulExpectedItems ) / sizeof( ulExpectedItems[ 0 ] ) ); x++ )
+	{
+		benchCHECK( xQueueReceiveWithKey( xQueue, &ulItem, &uxKey, 0 ) == pdPASS );
+		benchCHECK( ulItem == ulExpectedItems[ x ] );
+		benchCHECK( uxKey == uxKeys[ ulItem ] );
+	}
+
+	benchCHECK( xQueueReceiveWithKey( xQueue, &ulItem, &uxKey, 0 ) == errQUEUE_EMPTY );
+
+	/* Keys in a pseudo random order, received while more are sent, from a
+	full queue and down to empty. */
+	prvSendAndCheckKeys( xQueue, benchPRIORITY_ITEMS );
+	printf( "  keys sent out of order, equal keys among them: received in order\n" );
+
+	vQueueDelete( xQueue );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendAndCheckKeys( QueueHandle_t xQueue, UBaseType_t uxItems )
+{
+uint32_t ulRandom = 0x2545f491UL, ulItem, ulLastItem[ benchPRIORITY_MAX_LEVELS ];
+UBaseType_t uxKey, uxLastKey = 0, x;
+
+	for( x = 0; x < benchPRIORITY_MAX_LEVELS; x++ )
+	{
+		ulLastItem[ x ] = 0;
+	}
+
+	/* Half the items, then one received for each one sent, then the rest
+	received.  Items count from 1, so 0 is before all of them. */
+	for( x = 0; x < ( uxItems + ( uxItems / 2U ) ); x++ )
+	{
+		if( x < uxItems )
+		{
+			ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+			ulItem = ( uint32_t ) x + 1U;
+			benchCHECK( xQueueSendWithKey( xQueue, &ulItem, ( UBaseType_t ) ( ( ulRandom >> 16 ) % benchPRIORITY_MAX_LEVELS ), 0 ) == pdPASS );
+		}
+
+		if( x >= ( uxItems / 2U ) )
+		{
+			benchCHECK( xQueueReceiveWithKey( xQueue, &ulItem, &uxKey, 0 ) == pdPASS );
+			benchCHECK( uxKey < benchPRIORITY_MAX_LEVELS );
+
+			/* Once no more are sent the keys can only rise, and an item never
+			overtakes one sent before it with the same key. */
+			if( x >= uxItems )
+			{
+				benchCHECK( uxKey >= uxLastKey );
+			}
+
+			benchCHECK( ulItem > ulLastItem[ uxKey ] );
+			ulLastItem[ uxKey ] = ulItem;
+			uxLastKey = uxKey;
+		}
+	}
+
+	benchCHECK( uxQueueMessagesWaiting( xQueue ) == 0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimePriorityQueue( UBaseType_t uxLevels )
+{
+static QueueHandle_t xMembers[ benchPRIORITY_MAX_LEVELS ];
+QueueHandle_t xQueue;
+QueueSetHandle_t xSet;
+UBaseType_t uxKeys[ benchPRIORITY_ITEMS ], uxKey, x;
+uint64_t ullStart, ullPriority = 0, ullSet = 0;
+uint32_t ulRound, ulItem, ulRandom = 0x2545f491UL;
+
+	xQueue = xQueueCreatePriority( benchPRIORITY_ITEMS, sizeof( uint32_t ) );
+	xSet = xQueueCreateSet( uxLevels * benchPRIORITY_ITEMS );
+	benchCHECK( ( xQueue != NULL ) && ( xSet != NULL ) );
+
+	for( x = 0; x < uxLevels; x++ )
+	{
+		xMembers[ x ] = xQueueCreate( benchPRIORITY_ITEMS, sizeof( uint32_t ) );
+		benchCHECK( xMembers[ x ] != NULL );
+		benchCHECK( xQueueAddToSet( xMembers[ x ], xSet ) == pdPASS );
+	}
+
+	for( ulRound = 0; ulRound < benchPRIORITY_ROUNDS; ulRound++ )
+	{
+		for( x = 0; x < benchPRIORITY_ITEMS; x++ )
+		{
+			ulRandom = ( ulRandom * 1103515245UL ) + 12345UL;
+			uxKeys[ x ] = ( UBaseType_t ) ( ( ulRandom >> 16 ) % uxLevels );
+		}
+
+		/* The items with their keys through the priority queue. */
+		ullStart = ullBenchNow();
+
+		for( x = 0; x < benchPRIORITY_ITEMS; x++ )
+		{
+			ulItem = ( uint32_t ) x;
+			benchCHECK( xQueueSendWithKey( xQueue, &ulItem, uxKeys[ x ], 0 ) == pdPASS );
+		}
+
+		for( x = 0; x < benchPRIORITY_ITEMS; x++ )
+		{
+			benchCHECK( xQueueReceiveWithKey( xQueue, &ulItem, &uxKey, 0 ) == pdPASS );
+			benchCHECK( uxKey == uxKeys[ ulItem ] );
+		}
+
+		ullPriority += ullBenchNow() - ullStart;
+
+		/* The same items through one queue per key.  A receiver would block
+		on the set, then take the item from the member of the lowest key that
+		holds one. */
+		ullStart = ullBenchNow();
+
+		for( x = 0; x < benchPRIORITY_ITEMS; x++ )
+		{
+			ulItem = ( uint32_t ) x;
+			benchCHECK( xQueueSend( xMembers[ uxKeys[ x ] ], &ulItem, 0 ) == pdPASS );
+		}
+
+		for( x = 0; x < benchPRIORITY_ITEMS; x++ )
+		{
+			benchCHECK( xQueueSelectFromSet( xSet, 0 ) != NULL );
+
+			for( uxKey = 0; xQueueReceive( xMembers[ uxKey ], &ulItem, 0 ) != pdPASS; uxKey++ )
+			{
+				benchCHECK( uxKey < ( uxLevels - 1U ) );
+			}
+
+			benchCHECK( uxKey == uxKeys[ ulItem ] );
+		}
+
+		ullSet += ullBenchNow() - ullStart;
+
+		/* A set that copies member handles still holds one for each item. */
+		while( xQueueSelectFromSet( xSet, 0 ) != NULL )
+		{
+		}
+	}
+
+	for( x = 0; x < uxLevels; x++ )
+	{
+		benchCHECK( xQueueRemoveFromSet( xMembers[ x ], xSet ) == pdPASS );
+		vQueueDelete( xMembers[ x ] );
+	}
+
+	vQueueDelete( xSet );
+	vQueueDelete( xQueue );
+
+	printf( "  %2u keys: priority queue %6.1f ns/item, %2u queues and a set %6.1f ns/item\n",
+			( unsigned ) uxLevels,
+			( double ) ullPriority / ( double ) ( benchPRIORITY_ROUNDS * benchPRIORITY_ITEMS ),
+			( unsigned ) uxLevels,
+			( double ) ullSet / ( double ) ( benchPRIORITY_ROUNDS * benchPRIORITY_ITEMS ) );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchQueueRegistry( void *pvParameters )
+{
+static QueueHandle_t xQueues[ benchREGISTRY_QUEUES ];
+static char cNames[ benchREGISTRY_QUEUES ][ benchREGISTRY_NAME_SIZE ];
+QueueHandle_t xOther, xFound;
+uint64_t ullStart, ullElapsed;
+uint32_t ulRound;
+UBaseType_t x;
+
+	( void ) pvParameters;
+
+	/* More queues than the registry has buckets, or slots when it is not
+	hashed, so several share each bucket. */
+	for( x = 0; x < benchREGISTRY_QUEUES; x++ )
+	{
+		snprintf( cNames[ x ], benchREGISTRY_NAME_SIZE, "Registered%02u", ( unsigned ) x );
+		xQueues[ x ] = xQueueCreate( 1, sizeof( uint32_t ) );
+		benchCHECK( xQueues[ x ] != NULL );
+		vQueueAddToRegistry( xQueues[ x ], cNames[ x ] );
+	}
+
+	for( x = 0; x < benchREGISTRY_QUEUES; x++ )
+	{
+		benchCHECK( xQueueGetHandle( cNames[ x ] ) == xQueues[ x ] );
+		benchCHECK( pcQueueGetName( xQueues[ x ] ) == cNames[ x ] );
+	}
+
+	benchCHECK( xQueueGetHandle( "NotRegistered" ) == NULL );
+	printf( "  %u queues added and looked up by name and by handle: ok\n", ( unsigned ) benchREGISTRY_QUEUES );
+
+	prvCheckRegistryCollisions( xQueues, cNames );
+
+	/* Adding a queue again replaces its name. */
+	vQueueAddToRegistry( xQueues[ 0 ], "Renamed" );
+	benchCHECK( xQueueGetHandle( cNames[ 0 ] ) == NULL );
+	benchCHECK( xQueueGetHandle( "Renamed" ) == xQueues[ 0 ] );
+	benchCHECK( pcQueueGetName( xQueues[ 0 ] ) != cNames[ 0 ] );
+	vQueueAddToRegistry( xQueues[ 0 ], cNames[ 0 ] );
+	benchCHECK( xQueueGetHandle( "Renamed" ) == NULL );
+
+	/* Two queues with the same name are both found, one after the other. */
+	xOther = xQueueCreate( 1, sizeof( uint32_t ) );
+	benchCHECK( xOther != NULL );
+	vQueueAddToRegistry( xOther, cNames[ 1 ] );
+	xFound = xQueueGetHandle( cNames[ 1 ] );
+	benchCHECK( ( xFound == xOther ) || ( xFound == xQueues[ 1 ] ) );
+	vQueueUnregisterQueue( xFound );
+	benchCHECK( xQueueGetHandle( cNames[ 1 ] ) == ( ( xFound == xOther ) ? xQueues[ 1 ] : xOther ) );
+
+	/* Deleting a queue unregisters it. */
+	vQueueAddToRegistry( xOther, "Deleted" );
+	vQueueDelete( xOther );
+	benchCHECK( xQueueGetHandle( "Deleted" ) == NULL );
+	vQueueAddToRegistry( xQueues[ 1 ], cNames[ 1 ] );
+	benchCHECK( xQueueGetHandle( cNames[ 1 ] ) == xQueues[ 1 ] );
+	printf( "  renamed, duplicate name and deleted queues: ok\n" );
+
+	ullStart = ullBenchNow();
+
+	for( ulRound = 0; ulRound < benchREGISTRY_ROUNDS; ulRound++ )
+	{
+		for( x = 0; x < benchREGISTRY_QUEUES; x++ )
+		{
+			benchCHECK( xQueueGetHandle( cNames[ x ] ) == xQueues[ x ] );
+		}
+	}
+
+	ullElapsed = ullBenchNow() - ullStart;
+	printf( "  xQueueGetHandle() with %u queues registered: %6.1f ns\n",
+			( unsigned ) benchREGISTRY_QUEUES,
+			( double ) ullElapsed / ( double ) ( benchREGISTRY_ROUNDS * benchREGISTRY_QUEUES ) );
+
+	for( x = 0; x < benchREGISTRY_QUEUES; x++ )
+	{
+		vQueueDelete( xQueues[ x ] );
+		benchCHECK( xQueueGetHandle( cNames[ x ] ) == NULL );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckRegistryCollisions( QueueHandle_t *pxQueues, char ( *pcNames )[ benchREGISTRY_NAME_SIZE ] )
+{
+	#if ( configQUEUE_REGISTRY_HASHED == 1 )
+	{
+	const UBaseType_t uxOrder[ benchREGISTRY_CHAIN ] = { 1, 2, 0 };
+	UBaseType_t uxChain[ benchREGISTRY_CHAIN ], uxFound = 0, x, y, z;
+	BaseType_t xRegistered;
+
+		/* Three of the queues whose names hash to the same bucket, in the
+		order they were added, so the last is at the head of the chain. */
+		for( x = 0; ( x < benchREGISTRY_QUEUES ) && ( uxFound < benchREGISTRY_CHAIN ); x++ )
+		{
+			if( prvRegistryBucket( pcNames[ x ] ) == prvRegistryBucket( pcNames[ 0 ] ) )
+			{
+				uxChain[ uxFound ] = x;
+				uxFound++;
+			}
+		}
+
+		benchCHECK( uxFound == benchREGISTRY_CHAIN );
+
+		/* Unregister the one in the middle of the chain, then the head, then
+		the tail, checking each time that only those unregistered are missing.
+		Unregistering one that is not registered does nothing. */
+		for( x = 0; x < benchREGISTRY_CHAIN; x++ )
+		{
+			vQueueUnregisterQueue( pxQueues[ uxChain[ uxOrder[ x ] ] ] );
+			vQueueUnregisterQueue( pxQueues[ uxChain[ uxOrder[ x ] ] ] );
+			benchCHECK( pcQueueGetName( pxQueues[ uxChain[ uxOrder[ x ] ] ] ) == NULL );
+
+			for( y = 0; y < benchREGISTRY_QUEUES; y++ )
+			{
+				xRegistered = pdTRUE;
+
+				for( z = 0; z <= x; z++ )
+				{
+					if( y == uxChain[ uxOrder[ z ] ] )
+					{
+						xRegistered = pdFALSE;
+					}
+				}
+
+				benchCHECK( xQueueGetHandle( pcNames[ y ] ) == ( ( xRegistered != pdFALSE ) ? pxQueues[ y ] : NULL ) );
+			}
+		}
+
+		/* And added again, in a different order. */
+		for( x = 0; x < benchREGISTRY_CHAIN; x++ )
+		{
+			vQueueAddToRegistry( pxQueues[ uxChain[ x ] ], pcNames[ uxChain[ x ] ] );
+		}
+
+		for( y = 0; y < benchREGISTRY_QUEUES; y++ )
+		{
+			benchCHECK( xQueueGetHandle( pcNames[ y ] ) == pxQueues[ y ] );
+			benchCHECK( pcQueueGetName( pxQueues[ y ] ) == pcNames[ y ] );
+		}
+
+		printf( "  names in the same bucket unregistered and added again: ok\n" );
+	}
+	#else
+	{
+		( void ) pxQueues;
+		( void ) pcNames;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configQUEUE_REGISTRY_HASHED == 1 )
+
+	static uint32_t prvRegistryBucket( const char *pcName )
+	{
+	uint32_t ulHash = 2166136261UL;
+
+		/* The hash queue.c uses, 32-bit FNV-1a of the name. */
+		while( *pcName != '\0' )
+		{
+			ulHash ^= ( uint32_t ) ( uint8_t ) *pcName;
+			ulHash *= 16777619UL;
+			pcName++;
+		}
+
+		return ulHash % ( uint32_t ) configQUEUE_REGISTRY_SIZE;
+	}
+
+#endif /* configQUEUE_REGISTRY_HASHED */
+/*-----------------------------------------------------------*/
@@ -0,0 +1,990 @@
+/******************************************************************************
+ * Stream and message buffer benchmarks, see main_bench.c.
+ *
+ * stream_zero_copy: checks writing and reading stream and message buffers in
+ * place.  Space reserved in a stream buffer across the end of its storage area
+ * is described as two spans, is not seen by the reader until it is committed,
+ * and reads back the same through xStreamBufferPeek() and through
+ * xStreamBufferReceive().  A message reserved where it would wrap is placed at
+ * the start of the storage area instead, and reads back whole, through
+ * xMessageBufferPeek() and through xMessageBufferReceive(), which must both
+ * skip the end of the storage area it left unused.  A task blocked in
+ * xStreamBufferPeek() must be woken by the commit.
+ *
+ * mrmw_order: checks that a write to an MRMW stream buffer is not committed
+ * before a write that reserved space ahead of it.  Each round the controller
+ * writes benchMRMW_LONG_WRITE bytes, which takes several tick periods to copy
+ * in, while a writer task of higher priority polls once a tick.  When the
+ * writer sees the long write under way it writes benchMRMW_SHORT_WRITE bytes,
+ * which must then wait for the long write to be committed, and reads all the
+ * bytes back at once, before the controller runs again.  They must be whole
+ * and in the order in which their space was reserved.  A round in
+ * which the writer only runs after the long write was committed does not test
+ * the wait, but must still read back whole, and at least one round must test
+ * it.
+ *
+ * broadcast_overflow: checks what a full broadcast buffer does to each kind of
+ * subscriber.  With only an eBroadcastDropOldest subscriber the writer never
+ * waits, and the subscriber receives the newest messages, in order, and counts
+ * the ones it missed.  An eBroadcastBlockWriter subscriber makes a write to a
+ * full buffer fail, or wait until the subscriber receives, and receives every
+ * message written after it subscribed, while the other subscriber keeps
+ * missing messages.
+ *
+ * message_batch: compares xMessageBufferReceive() with
+ * xMessageBufferReceiveMany() for 16, 64 and 1024 byte messages, sent by a
+ * task of higher priority through a message buffer with room for
+ * benchMB_BATCH messages, so the sender blocks whenever the buffer is full and
+ * is woken by each call that makes space.  Also compares sending a message
+ * gathered from a header and a body with xMessageBufferSendVector() against
+ * assembling it with memcpy() and sending it with xMessageBufferSend().  Every
+ * message is checked as it is received.
+ *
+ * stream_host_writer: checks that a host thread writing to a stream buffer
+ * with xStreamBufferSendFromHost() never loses a wake-up of the reading task.
+ * For benchHW_ROUNDS rounds the host thread writes while the reader is blocked
+ * in xStreamBufferReceive(), and each write must ring the doorbell interrupt
+ * once and wake the reader with the value written.  It then has the host
+ * thread write while the reading task, in xStreamBufferReceive() and then in
+ * xStreamBufferPeek(), is between finding the buffer empty and blocking.  A
+ * write before the task registers as waiting rings no doorbell, and the task's
+ * second look for data must find it.  A write just before the task blocks
+ * rings the doorbell, which must wake the task at once.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+#include "mrmw_stream_buffer.h"
+#include "broadcast_buffer.h"
+
+#include "main_bench.h"
+
+/* Sizes for the zero copy checks.  The stream buffer's storage area is one
+byte longer than its size, so 40 bytes written and read leave 25 bytes before
+the end of the storage area. */
+#define benchZC_STREAM_SIZE			( 64 )
+#define benchZC_STREAM_OFFSET		( 40 )
+#define benchZC_STREAM_RESERVE		( 50 )
+#define benchZC_MESSAGE_SIZE		( 128 )
+
+/* The MRMW stream buffer and its storage are statically allocated, so the long
+write can be long enough to take several tick periods. */
+#define benchMRMW_SIZE				( 16UL * 1024UL * 1024UL )
+#define benchMRMW_LONG_WRITE		( 8UL * 1024UL * 1024UL )
+#define benchMRMW_SHORT_WRITE		( 64UL )
+#define benchMRMW_ROUNDS			( 10 )
+
+/* Room for benchBC_CAPACITY messages, each a sequence number. */
+#define benchBC_CAPACITY			( 10 )
+#define benchBC_SIZE				( benchBC_CAPACITY * ( sizeof( UBaseType_t ) + broadcastBYTES_PER_MESSAGE ) )
+#define benchBC_SENDS				( benchBC_CAPACITY * 3 )
+
+#define benchMB_BATCH				( 8 )
+#define benchMB_MAX_PAYLOAD			( 1024 )
+#define benchMB_MESSAGES			( 10000UL )
+#define benchMB_GATHER_LOOPS		( 50000UL )
+
+#define benchHW_INTERRUPT			( 7UL )
+#define benchHW_BUFFER_SIZE			( 64 )
+#define benchHW_ROUNDS				( 1000UL )
+#define benchHW_WAIT_MS				( 1000 )
+#define benchHW_WAKE_LIMIT_NS		( 100000000ULL )
+
+/*-----------------------------------------------------------*/
+
+typedef struct ZeroCopyReader
+{
+	StreamBufferHandle_t xStreamBuffer;
+	volatile size_t xPeeked;
+} ZeroCopyReader_t;
+
+static void prvCheckStreamWrap( void );
+static void prvCheckMessageWrap( void );
+static void prvCheckPeekWakes( void );
+static void prvMoveHead( StreamBufferHandle_t xBuffer, size_t xLength, BaseType_t xIsMessageBuffer );
+static void prvFillSpans( const StreamBufferSpans_t *pxSpans, uint8_t ucFirst );
+static BaseType_t prvSpansAreValid( const StreamBufferSpans_t *pxSpans, uint8_t ucFirst );
+static BaseType_t prvBytesAreValid( const uint8_t *pucBytes, size_t xLength, uint8_t ucFirst );
+static void prvPeekingTask( void *pvParameters );
+
+static void prvShortWriterTask( void *pvParameters );
+
+static MRMWStreamBufferHandle_t xMRMWBuffer = NULL;
+
+/* Set by the controller as it starts the long write, and cleared by the short
+writer once it has written. */
+static volatile BaseType_t xLongWriteStarted = pdFALSE;
+
+/* The long write of the current round, and the number of rounds in which the
+short write had to wait for it. */
+static uint8_t ucLongWrite[ benchMRMW_LONG_WRITE ];
+static volatile UBaseType_t uxMRMWRound = 0;
+static volatile UBaseType_t uxShortWriteWaits = 0;
+
+static void prvCheckDropOnly( BroadcastBufferHandle_t xBuffer );
+static void prvCheckBlockWriter( BroadcastBufferHandle_t xBuffer );
+static void prvSendSequence( BroadcastBufferHandle_t xBuffer, UBaseType_t uxFirst, UBaseType_t uxCount );
+static void prvReceiveSequence( BroadcastSubscriberHandle_t xSubscriber, UBaseType_t uxFirst, UBaseType_t uxLast );
+static void prvBroadcastReceiverTask( void *pvParameters );
+
+/* The message the receiver task received. */
+static volatile UBaseType_t uxBroadcastReceived = 0;
+
+typedef struct BatchHeader
+{
+	uint32_t ulSequence;
+	uint32_t ulBodyLength;
+} BatchHeader_t;
+
+static uint64_t prvTimeBatchReceive( size_t xPayload, BaseType_t xReceiveMany );
+static uint64_t prvTimeGatherSend( size_t xPayload, BaseType_t xGather );
+static void prvFillBatchMessage( uint8_t *pucMessage, size_t xPayload, uint32_t ulSequence );
+static BaseType_t prvBatchMessageIsValid( const uint8_t *pucMessage, size_t xLength, size_t xPayload, uint32_t ulSequence );
+static void prvBatchSenderTask( void *pvParameters );
+
+static MessageBufferHandle_t xBatchBuffer = NULL;
+static size_t xBatchPayload = 0;
+
+static void prvCheckBlockedReader( void );
+static void prvCheckWriteInWait( BaseType_t xPeek, BaseType_t xBeforeBlocking, const char *pcName );
+static void prvStreamBufferWaitHook( void *pvStreamBuffer, int iBlocking );
+static uint32_t prvDoorbellInterruptHandler( void );
+static void prvHostReaderTask( void *pvParameters );
+static void *prvHostWriterThread( void *pvParameters );
+
+static StreamBufferHandle_t xHostBuffer = NULL;
+static volatile uint32_t ulHostRequest = 0;		/* The value for the host thread to write, or 0. */
+static volatile uint32_t ulHostReceived = 0;	/* The last round the reader received. */
+static volatile uint32_t ulHostErrors = 0;
+static volatile uint32_t ulDoorbells = 0;		/* Doorbell interrupts taken. */
+static volatile uint64_t ullHostReceivedTime = 0;
+static volatile BaseType_t xHostStop = pdFALSE;
+
+/* The value the wait hook has the host thread write, or 0 once it has, and
+whether it writes just before the task blocks or before it registers. */
+static volatile uint32_t ulHookValue = 0;
+static volatile int iHookBlocking = 0;
+
+/*-----------------------------------------------------------*/
+
+void vBenchStreamZeroCopy( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	prvCheckStreamWrap();
+	prvCheckMessageWrap();
+	prvCheckPeekWakes();
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckStreamWrap( void )
+{
+StreamBufferHandle_t xStreamBuffer;
+StreamBufferSpans_t xReserved, xPeeked;
+uint8_t ucData[ benchZC_STREAM_SIZE ];
+
+	xStreamBuffer = xStreamBufferCreate( benchZC_STREAM_SIZE, 1 );
+	benchCHECK( xStreamBuffer != NULL );
+	prvMoveHead( xStreamBuffer, benchZC_STREAM_OFFSET, pdFALSE );
+
+	benchCHECK( xStreamBufferReserve( xStreamBuffer, benchZC_STREAM_RESERVE, &xReserved, 0 ) == benchZC_STREAM_RESERVE );
+	benchCHECK( xReserved.xFirstLength == ( benchZC_STREAM_SIZE + 1 - benchZC_STREAM_OFFSET ) );
+	benchCHECK( xReserved.pucSecond != NULL );
+	benchCHECK( ( xReserved.xFirstLength + xReserved.xSecondLength ) == benchZC_STREAM_RESERVE );
+
+	prvFillSpans( &xReserved, 0 );
+	benchCHECK( xStreamBufferBytesAvailable( xStreamBuffer ) == 0 );
+	vStreamBufferCommit( xStreamBuffer, benchZC_STREAM_RESERVE );
+	benchCHECK( xStreamBufferBytesAvailable( xStreamBuffer ) == benchZC_STREAM_RESERVE );
+
+	/* The reader sees the bytes where the writer put them. */
+	benchCHECK( xStreamBufferPeek( xStreamBuffer, &xPeeked, 0 ) == benchZC_STREAM_RESERVE );
+	benchCHECK( ( xPeeked.pucFirst == xReserved.pucFirst ) && ( xPeeked.pucSecond == xReserved.pucSecond ) );
+	benchCHECK( prvSpansAreValid( &xPeeked, 0 ) != pdFALSE );
+
+	/* Consume part of them, then copy the rest out, which starts past the
+	end of the storage area. */
+	vStreamBufferConsume( xStreamBuffer, 30 );
+	benchCHECK( xStreamBufferReceive( xStreamBuffer, ucData, sizeof( ucData ), 0 ) == ( benchZC_STREAM_RESERVE - 30 ) );
+	benchCHECK( prvBytesAreValid( ucData, benchZC_STREAM_RESERVE - 30, 30 ) != pdFALSE );
+	benchCHECK( xStreamBufferIsEmpty( xStreamBuffer ) != pdFALSE );
+
+	vStreamBufferDelete( xStreamBuffer );
+	printf( "  stream reserved across the end of the storage area: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckMessageWrap( void )
+{
+MessageBufferHandle_t xMessageBuffer;
+StreamBufferSpans_t xPeeked;
+uint8_t *pucMessage;
+uint8_t ucData[ benchZC_MESSAGE_SIZE ];
+size_t x;
+
+	xMessageBuffer = xMessageBufferCreate( benchZC_MESSAGE_SIZE );
+	benchCHECK( xMessageBuffer != NULL );
+
+	/* Leave the head 41 bytes before the end of the storage area, too few for
+	a 40 byte message and its length. */
+	prvMoveHead( xMessageBuffer, 80, pdTRUE );
+	pucMessage = ( uint8_t * ) pvMessageBufferReserve( xMessageBuffer, 40, 0 );
+	benchCHECK( pucMessage != NULL );
+
+	for( x = 0; x < 40; x++ )
+	{
+		pucMessage[ x ] = ( uint8_t ) x;
+	}
+
+	vMessageBufferCommit( xMessageBuffer, pucMessage, 40 );
+	benchCHECK( xStreamBufferNextMessageLengthBytes( xMessageBuffer ) == 40 );
+	benchCHECK( xMessageBufferPeek( xMessageBuffer, &xPeeked, 0 ) == 40 );
+	benchCHECK( ( xPeeked.pucFirst == pucMessage ) && ( xPeeked.xSecondLength == 0 ) );
+	benchCHECK( prvSpansAreValid( &xPeeked, 0 ) != pdFALSE );
+	vMessageBufferConsume( xMessageBuffer, 40 );
+	benchCHECK( xMessageBufferIsEmpty( xMessageBuffer ) != pdFALSE );
+
+	/* Again, this time copying the message out. */
+	prvMoveHead( xMessageBuffer, 60, pdTRUE );
+	pucMessage = ( uint8_t * ) pvMessageBufferReserve( xMessageBuffer, 30, 0 );
+	benchCHECK( pucMessage != NULL );
+
+	for( x = 0; x < 30; x++ )
+	{
+		pucMessage[ x ] = ( uint8_t ) ( 100 + x );
+	}
+
+	vMessageBufferCommit( xMessageBuffer, pucMessage, 30 );
+	benchCHECK( xMessageBufferReceive( xMessageBuffer, ucData, sizeof( ucData ), 0 ) == 30 );
+	benchCHECK( prvBytesAreValid( ucData, 30, 100 ) != pdFALSE );
+	benchCHECK( xMessageBufferIsEmpty( xMessageBuffer ) != pdFALSE );
+
+	vMessageBufferDelete( xMessageBuffer );
+	printf( "  message reserved at the start of the storage area: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckPeekWakes( void )
+{
+static ZeroCopyReader_t xReader;
+StreamBufferSpans_t xReserved;
+
+	xReader.xStreamBuffer = xStreamBufferCreate( benchZC_STREAM_SIZE, 1 );
+	benchCHECK( xReader.xStreamBuffer != NULL );
+	xReader.xPeeked = 0;
+
+	/* The reader runs at once and blocks, as the buffer is empty. */
+	benchCHECK( xTaskCreate( prvPeekingTask, "Peek", benchSTACK_SIZE, &xReader, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xStreamBufferReserve( xReader.xStreamBuffer, 10, &xReserved, 0 ) == 10 );
+	prvFillSpans( &xReserved, 0 );
+	benchCHECK( xReader.xPeeked == 0 );
+
+	/* The commit unblocks the reader, which has the higher priority. */
+	vStreamBufferCommit( xReader.xStreamBuffer, 10 );
+	benchCHECK( xReader.xPeeked == 10 );
+	benchCHECK( xStreamBufferIsEmpty( xReader.xStreamBuffer ) != pdFALSE );
+
+	/* Let the idle task free the reader. */
+	vTaskDelay( 2 );
+	vStreamBufferDelete( xReader.xStreamBuffer );
+	printf( "  commit wakes a task blocked in xStreamBufferPeek(): ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvMoveHead( StreamBufferHandle_t xBuffer, size_t xLength, BaseType_t xIsMessageBuffer )
+{
+uint8_t ucData[ benchZC_MESSAGE_SIZE ] = { 0 };
+
+	/* Write and read back xLength bytes, which leaves the buffer empty with
+	its head and tail moved on. */
+	if( xIsMessageBuffer != pdFALSE )
+	{
+		benchCHECK( xMessageBufferSend( xBuffer, ucData, xLength, 0 ) == xLength );
+		benchCHECK( xMessageBufferReceive( xBuffer, ucData, sizeof( ucData ), 0 ) == xLength );
+	}
+	else
+	{
+		benchCHECK( xStreamBufferSend( xBuffer, ucData, xLength, 0 ) == xLength );
+		benchCHECK( xStreamBufferReceive( xBuffer, ucData, sizeof( ucData ), 0 ) == xLength );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillSpans( const StreamBufferSpans_t *pxSpans, uint8_t ucFirst )
+{
+size_t x;
+
+	for( x = 0; x < pxSpans->xFirstLength; x++ )
+	{
+		pxSpans->pucFirst[ x ] = ( uint8_t ) ( ucFirst + x );
+	}
+
+	for( x = 0; x < pxSpans->xSecondLength; x++ )
+	{
+		pxSpans->pucSecond[ x ] = ( uint8_t ) ( ucFirst + pxSpans->xFirstLength + x );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvSpansAreValid( const StreamBufferSpans_t *pxSpans, uint8_t ucFirst )
+{
+BaseType_t xValid;
+
+	xValid = prvBytesAreValid( pxSpans->pucFirst, pxSpans->xFirstLength, ucFirst );
+
+	if( ( xValid != pdFALSE ) && ( pxSpans->xSecondLength != 0 ) )
+	{
+		xValid = prvBytesAreValid( pxSpans->pucSecond, pxSpans->xSecondLength, ( uint8_t ) ( ucFirst + pxSpans->xFirstLength ) );
+	}
+
+	return xValid;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBytesAreValid( const uint8_t *pucBytes, size_t xLength, uint8_t ucFirst )
+{
+size_t x;
+
+	for( x = 0; x < xLength; x++ )
+	{
+		if( pucBytes[ x ] != ( uint8_t ) ( ucFirst + x ) )
+		{
+			return pdFALSE;
+		}
+	}
+
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPeekingTask( void *pvParameters )
+{
+ZeroCopyReader_t *pxReader = ( ZeroCopyReader_t * ) pvParameters;
+StreamBufferSpans_t xSpans;
+size_t xLength;
+
+	xLength = xStreamBufferPeek( pxReader->xStreamBuffer, &xSpans, pdMS_TO_TICKS( 1000 ) );
+	benchCHECK( prvSpansAreValid( &xSpans, 0 ) != pdFALSE );
+	vStreamBufferConsume( pxReader->xStreamBuffer, xLength );
+	pxReader->xPeeked = xLength;
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchMRMWOrder( void *pvParameters )
+{
+static StaticMRMWStreamBuffer_t xStaticBuffer;
+static uint8_t ucStorage[ benchMRMW_SIZE ];
+size_t x;
+
+	( void ) pvParameters;
+
+	xMRMWBuffer = xMRMWStreamBufferCreateStatic( benchMRMW_SIZE, ucStorage, &xStaticBuffer );
+	benchCHECK( xMRMWBuffer != NULL );
+	benchCHECK( xTaskCreate( prvShortWriterTask, "Short", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+
+	for( uxMRMWRound = 0; uxMRMWRound < benchMRMW_ROUNDS; uxMRMWRound++ )
+	{
+		for( x = 0; x < benchMRMW_LONG_WRITE; x++ )
+		{
+			ucLongWrite[ x ] = ( uint8_t ) ( x + uxMRMWRound );
+		}
+
+		xLongWriteStarted = pdTRUE;
+		benchCHECK( xMRMWStreamBufferSend( xMRMWBuffer, ucLongWrite, benchMRMW_LONG_WRITE, 0 ) == benchMRMW_LONG_WRITE );
+
+		while( xLongWriteStarted != pdFALSE )
+		{
+			vTaskDelay( 1 );
+		}
+	}
+
+	benchCHECK( uxShortWriteWaits > 0 );
+	printf( "  short write waited for the long write to be committed in %u of %d rounds: ok\n", ( unsigned ) uxShortWriteWaits, benchMRMW_ROUNDS );
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvShortWriterTask( void *pvParameters )
+{
+static uint8_t ucRead[ benchMRMW_LONG_WRITE + benchMRMW_SHORT_WRITE ];
+uint8_t ucShort[ benchMRMW_SHORT_WRITE ];
+const uint8_t *pucShort;
+size_t x, xBytesInFlight;
+
+	( void ) pvParameters;
+	memset( ucShort, 0xa5, sizeof( ucShort ) );
+
+	for( ;; )
+	{
+		/* Preempts the controller, usually part way through the long write. */
+		vTaskDelay( 1 );
+
+		if( xLongWriteStarted == pdFALSE )
+		{
+			continue;
+		}
+
+		/* Space reserved but not yet committed, which can only be the long
+		write's as nothing is being read. */
+		xBytesInFlight = benchMRMW_SIZE - xMRMWStreamBufferSpacesAvailable( xMRMWBuffer ) - xMRMWStreamBufferBytesAvailable( xMRMWBuffer );
+
+		benchCHECK( xMRMWStreamBufferSend( xMRMWBuffer, ucShort, sizeof( ucShort ), 0 ) == sizeof( ucShort ) );
+
+		/* Read back at once, while the controller is still preempted.  Had the
+		short write been committed without waiting, the end of the long write
+		would not have been copied in yet. */
+		benchCHECK( xMRMWStreamBufferReceive( xMRMWBuffer, ucRead, sizeof( ucRead ), 0 ) == sizeof( ucRead ) );
+
+		/* The short write is all 0xa5, so it is either first or last. */
+		if( ucRead[ 0 ] == ( uint8_t ) uxMRMWRound )
+		{
+			pucShort = &( ucRead[ benchMRMW_LONG_WRITE ] );
+			benchCHECK( memcmp( ucRead, ucLongWrite, benchMRMW_LONG_WRITE ) == 0 );
+		}
+		else
+		{
+			/* The short write reserved its space first, so it cannot have
+			waited for the long one. */
+			benchCHECK( xBytesInFlight == 0 );
+			pucShort = ucRead;
+			benchCHECK( memcmp( &( ucRead[ benchMRMW_SHORT_WRITE ] ), ucLongWrite, benchMRMW_LONG_WRITE ) == 0 );
+		}
+
+		for( x = 0; x < benchMRMW_SHORT_WRITE; x++ )
+		{
+			benchCHECK( pucShort[ x ] == 0xa5 );
+		}
+
+		if( xBytesInFlight != 0 )
+		{
+			uxShortWriteWaits++;
+		}
+
+		xLongWriteStarted = pdFALSE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchBroadcastOverflow( void *pvParameters )
+{
+BroadcastBufferHandle_t xBuffer;
+
+	( void ) pvParameters;
+
+	xBuffer = xBroadcastBufferCreate( benchBC_SIZE );
+	benchCHECK( xBuffer != NULL );
+
+	prvCheckDropOnly( xBuffer );
+	prvCheckBlockWriter( xBuffer );
+
+	vBroadcastBufferDelete( xBuffer );
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckDropOnly( BroadcastBufferHandle_t xBuffer )
+{
+BroadcastSubscriberHandle_t xDrop;
+UBaseType_t uxMessage;
+
+	xDrop = xBroadcastBufferSubscribe( xBuffer, eBroadcastDropOldest );
+	benchCHECK( xDrop != NULL );
+
+	/* Three buffers full are written without waiting, so the subscriber can
+	only receive the last buffer full, and has missed the rest. */
+	prvSendSequence( xBuffer, 0, benchBC_SENDS );
+	benchCHECK( uxBroadcastBufferGetOverflowCount( xDrop ) == 0 );
+	prvReceiveSequence( xDrop, benchBC_SENDS - benchBC_CAPACITY, benchBC_SENDS - 1 );
+	benchCHECK( uxBroadcastBufferGetOverflowCount( xDrop ) == ( benchBC_SENDS - benchBC_CAPACITY ) );
+	benchCHECK( xBroadcastBufferReceive( xDrop, &uxMessage, sizeof( uxMessage ), 0 ) == 0 );
+
+	printf( "  drop oldest subscriber missed %u of %u messages: ok\n", ( unsigned ) uxBroadcastBufferGetOverflowCount( xDrop ), ( unsigned ) benchBC_SENDS );
+
+	vBroadcastBufferUnsubscribe( xDrop );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckBlockWriter( BroadcastBufferHandle_t xBuffer )
+{
+BroadcastSubscriberHandle_t xDrop, xBlock;
+UBaseType_t uxMessage = benchBC_SENDS;
+
+	xDrop = xBroadcastBufferSubscribe( xBuffer, eBroadcastDropOldest );
+	xBlock = xBroadcastBufferSubscribe( xBuffer, eBroadcastBlockWriter );
+	benchCHECK( ( xDrop != NULL ) && ( xBlock != NULL ) );
+
+	/* The buffer fills, and the next write fails without waiting. */
+	prvSendSequence( xBuffer, benchBC_SENDS, benchBC_CAPACITY );
+	uxMessage = benchBC_SENDS + benchBC_CAPACITY;
+	benchCHECK( xBroadcastBufferSend( xBuffer, &uxMessage, sizeof( uxMessage ), 0 ) == 0 );
+	printf( "  write to a buffer full for a block writer subscriber fails: ok\n" );
+
+	/* A write that waits gets the space once the subscriber receives, from a
+	task of lower priority that only runs when the write blocks. */
+	uxBroadcastReceived = 0;
+	benchCHECK( xTaskCreate( prvBroadcastReceiverTask, "BcRx", benchSTACK_SIZE, xBlock, benchCONTROL_PRIORITY - 1, NULL ) == pdPASS );
+	benchCHECK( xBroadcastBufferSend( xBuffer, &uxMessage, sizeof( uxMessage ), pdMS_TO_TICKS( 100 ) ) == sizeof( uxMessage ) );
+
+	/* The receiver is preempted by this task as it receives, so let it finish. */
+	vTaskDelay( 1 );
+	benchCHECK( uxBroadcastReceived == benchBC_SENDS );
+	printf( "  waiting write gets the space the subscriber received: ok\n" );
+
+	/* Writes go on failing until the subscriber receives the rest, which it
+	does in order and without a gap.  The other subscriber still loses the
+	message discarded for the last write. */
+	uxMessage++;
+	benchCHECK( xBroadcastBufferSend( xBuffer, &uxMessage, sizeof( uxMessage ), 0 ) == 0 );
+	prvReceiveSequence( xBlock, benchBC_SENDS + 1, benchBC_SENDS + benchBC_CAPACITY );
+	benchCHECK( uxBroadcastBufferGetOverflowCount( xBlock ) == 0 );
+	prvReceiveSequence( xDrop, benchBC_SENDS + 1, benchBC_SENDS + benchBC_CAPACITY );
+	benchCHECK( uxBroadcastBufferGetOverflowCount( xDrop ) == 1 );
+	printf( "  block writer subscriber received every message: ok\n" );
+
+	vBroadcastBufferUnsubscribe( xDrop );
+	vBroadcastBufferUnsubscribe( xBlock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSendSequence( BroadcastBufferHandle_t xBuffer, UBaseType_t uxFirst, UBaseType_t uxCount )
+{
+UBaseType_t uxMessage;
+
+	for( uxMessage = uxFirst; uxMessage < ( uxFirst + uxCount ); uxMessage++ )
+	{
+		benchCHECK( xBroadcastBufferSend( xBuffer, &uxMessage, sizeof( uxMessage ), 0 ) == sizeof( uxMessage ) );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvReceiveSequence( BroadcastSubscriberHandle_t xSubscriber, UBaseType_t uxFirst, UBaseType_t uxLast )
+{
+UBaseType_t uxExpected, uxMessage;
+
+	for( uxExpected = uxFirst; uxExpected <= uxLast; uxExpected++ )
+	{
+		benchCHECK( xBroadcastBufferReceive( xSubscriber, &uxMessage, sizeof( uxMessage ), 0 ) == sizeof( uxMessage ) );
+		benchCHECK( uxMessage == uxExpected );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvBroadcastReceiverTask( void *pvParameters )
+{
+UBaseType_t uxMessage;
+
+	benchCHECK( xBroadcastBufferReceive( ( BroadcastSubscriberHandle_t ) pvParameters, &uxMessage, sizeof( uxMessage ), 0 ) == sizeof( uxMessage ) );
+	uxBroadcastReceived = uxMessage;
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchMessageBatch( void *pvParameters )
+{
+const size_t xPayloads[] = { 16, 64, benchMB_MAX_PAYLOAD };
+uint64_t ullOne, ullMany, ullAssembled, ullGathered;
+size_t x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < ( sizeof( xPayloads ) / sizeof( xPayloads[ 0 ] ) ); x++ )
+	{
+		ullOne = prvTimeBatchReceive( xPayloads[ x ], pdFALSE );
+		ullMany = prvTimeBatchReceive( xPayloads[ x ], pdTRUE );
+		ullAssembled = prvTimeGatherSend( xPayloads[ x ], pdFALSE );
+		ullGathered = prvTimeGatherSend( xPayloads[ x ], pdTRUE );
+
+		printf( "  %4u bytes: receive %7.1f ns, receive many %7.1f ns, assembled send %6.1f ns, gather send %6.1f ns\n",
+				( unsigned ) xPayloads[ x ],
+				( double ) ullOne / ( double ) benchMB_MESSAGES,
+				( double ) ullMany / ( double ) benchMB_MESSAGES,
+				( double ) ullAssembled / ( double ) benchMB_GATHER_LOOPS,
+				( double ) ullGathered / ( double ) benchMB_GATHER_LOOPS );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeBatchReceive( size_t xPayload, BaseType_t xReceiveMany )
+{
+static uint8_t ucRead[ benchMB_BATCH * benchMB_MAX_PAYLOAD ];
+size_t xLengths[ benchMB_BATCH ], xReceived, xOffset, x;
+uint32_t ulNext = 0;
+uint64_t ullStart, ullTime;
+
+	/* Room for exactly benchMB_BATCH messages with their lengths. */
+	xBatchPayload = xPayload;
+	xBatchBuffer = xMessageBufferCreate( benchMB_BATCH * ( xPayload + sizeof( size_t ) ) );
+	benchCHECK( xBatchBuffer != NULL );
+
+	/* The sender fills the buffer before it first blocks. */
+	benchCHECK( xTaskCreate( prvBatchSenderTask, "Batch", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xMessageBufferIsFull( xBatchBuffer ) != pdFALSE );
+
+	ullStart = ullBenchNow();
+
+	while( ulNext < benchMB_MESSAGES )
+	{
+		if( xReceiveMany != pdFALSE )
+		{
+			xReceived = xMessageBufferReceiveMany( xBatchBuffer, ucRead, sizeof( ucRead ), xLengths, benchMB_BATCH, portMAX_DELAY );
+		}
+		else
+		{
+			xLengths[ 0 ] = xMessageBufferReceive( xBatchBuffer, ucRead, sizeof( ucRead ), portMAX_DELAY );
+			xReceived = 1;
+		}
+
+		for( x = 0, xOffset = 0; x < xReceived; x++ )
+		{
+			benchCHECK( prvBatchMessageIsValid( &( ucRead[ xOffset ] ), xLengths[ x ], xPayload, ulNext ) );
+			xOffset += xLengths[ x ];
+			ulNext++;
+		}
+	}
+
+	ullTime = ullBenchNow() - ullStart;
+
+	/* The sender has deleted itself after its last send. */
+	benchCHECK( xMessageBufferIsEmpty( xBatchBuffer ) != pdFALSE );
+	vMessageBufferDelete( xBatchBuffer );
+	vTaskDelay( 1 );
+
+	return ullTime;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeGatherSend( size_t xPayload, BaseType_t xGather )
+{
+static uint8_t ucAssembled[ benchMB_MAX_PAYLOAD ], ucRead[ benchMB_MAX_PAYLOAD ];
+static uint8_t ucBody[ benchMB_MAX_PAYLOAD ];
+StreamBufferFragment_t xFragments[ 2 ];
+BatchHeader_t xHeader;
+MessageBufferHandle_t xBuffer;
+uint32_t ulSequence;
+uint64_t ullStart, ullTime;
+
+	xBuffer = xMessageBufferCreate( xPayload + sizeof( size_t ) );
+	benchCHECK( xBuffer != NULL );
+
+	/* The body is the same for every message, and the header gives the
+	sequence number, as prvFillBatchMessage() would. */
+	prvFillBatchMessage( ucAssembled, xPayload, 0 );
+	memcpy( ucBody, &( ucAssembled[ sizeof( xHeader ) ] ), xPayload - sizeof( xHeader ) );
+	xHeader.ulBodyLength = ( uint32_t ) ( xPayload - sizeof( xHeader ) );
+	xFragments[ 0 ].pvData = &xHeader;
+	xFragments[ 0 ].xLength = sizeof( xHeader );
+	xFragments[ 1 ].pvData = ucBody;
+	xFragments[ 1 ].xLength = xPayload - sizeof( xHeader );
+
+	ullStart = ullBenchNow();
+
+	for( ulSequence = 0; ulSequence < benchMB_GATHER_LOOPS; ulSequence++ )
+	{
+		xHeader.ulSequence = ulSequence;
+
+		if( xGather != pdFALSE )
+		{
+			benchCHECK( xMessageBufferSendVector( xBuffer, xFragments, 2, 0 ) == xPayload );
+		}
+		else
+		{
+			memcpy( ucAssembled, &xHeader, sizeof( xHeader ) );
+			memcpy( &( ucAssembled[ sizeof( xHeader ) ] ), ucBody, xPayload - sizeof( xHeader ) );
+			benchCHECK( xMessageBufferSend( xBuffer, ucAssembled, xPayload, 0 ) == xPayload );
+		}
+
+		benchCHECK( xMessageBufferReceive( xBuffer, ucRead, sizeof( ucRead ), 0 ) == xPayload );
+	}
+
+	ullTime = ullBenchNow() - ullStart;
+
+	benchCHECK( prvBatchMessageIsValid( ucRead, xPayload, xPayload, benchMB_GATHER_LOOPS - 1 ) );
+	vMessageBufferDelete( xBuffer );
+
+	return ullTime;
+}
+/*-----------------------------------------------------------*/
+
+static void prvFillBatchMessage( uint8_t *pucMessage, size_t xPayload, uint32_t ulSequence )
+{
+BatchHeader_t xHeader;
+size_t x;
+
+	xHeader.ulSequence = ulSequence;
+	xHeader.ulBodyLength = ( uint32_t ) ( xPayload - sizeof( xHeader ) );
+	memcpy( pucMessage, &xHeader, sizeof( xHeader ) );
+
+	for( x = sizeof( xHeader ); x < xPayload; x++ )
+	{
+		pucMessage[ x ] = ( uint8_t ) x;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvBatchMessageIsValid( const uint8_t *pucMessage, size_t xLength, size_t xPayload, uint32_t ulSequence )
+{
+BatchHeader_t xHeader;
+
+	if( xLength != xPayload )
+	{
+		return pdFALSE;
+	}
+
+	memcpy( &xHeader, pucMessage, sizeof( xHeader ) );
+
+	return ( ( xHeader.ulSequence == ulSequence ) &&
+			 ( xHeader.ulBodyLength == ( uint32_t ) ( xPayload - sizeof( xHeader ) ) ) &&
+			 ( pucMessage[ xPayload - 1 ] == ( uint8_t ) ( xPayload - 1 ) ) ) ? pdTRUE : pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvBatchSenderTask( void *pvParameters )
+{
+static uint8_t ucMessage[ benchMB_MAX_PAYLOAD ];
+uint32_t ulSequence;
+
+	( void ) pvParameters;
+
+	for( ulSequence = 0; ulSequence < benchMB_MESSAGES; ulSequence++ )
+	{
+		prvFillBatchMessage( ucMessage, xBatchPayload, ulSequence );
+		benchCHECK( xMessageBufferSend( xBatchBuffer, ucMessage, xBatchPayload, portMAX_DELAY ) == xBatchPayload );
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchStreamHostWriter( void *pvParameters )
+{
+pthread_t xThread;
+int iError;
+
+	( void ) pvParameters;
+
+	vPortSetInterruptHandler( benchHW_INTERRUPT, prvDoorbellInterruptHandler );
+
+	xHostBuffer = xStreamBufferCreate( benchHW_BUFFER_SIZE, sizeof( uint32_t ) );
+	benchCHECK( xHostBuffer != NULL );
+	vStreamBufferSetHostDoorbell( xHostBuffer, benchHW_INTERRUPT );
+
+	/* Signals are blocked in a critical section, so the host thread starts
+	with all of them blocked, as the port requires. */
+	xHostStop = pdFALSE;
+	taskENTER_CRITICAL();
+	iError = pthread_create( &xThread, NULL, prvHostWriterThread, NULL );
+	taskEXIT_CRITICAL();
+	benchCHECK( iError == 0 );
+
+	prvCheckBlockedReader();
+
+	prvCheckWriteInWait( pdFALSE, pdFALSE, "receive, write before registering:" );
+	prvCheckWriteInWait( pdFALSE, pdTRUE, "receive, write before blocking:" );
+	prvCheckWriteInWait( pdTRUE, pdFALSE, "peek, write before registering:" );
+	prvCheckWriteInWait( pdTRUE, pdTRUE, "peek, write before blocking:" );
+
+	xHostStop = pdTRUE;
+	taskENTER_CRITICAL();
+	iError = pthread_join( xThread, NULL );
+	taskEXIT_CRITICAL();
+	benchCHECK( iError == 0 );
+	benchCHECK( ulHostErrors == 0 );
+
+	vStreamBufferDelete( xHostBuffer );
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckBlockedReader( void )
+{
+uint32_t ulRound;
+uint64_t ullStart, ullLatencyTotal = 0;
+
+	ulHostReceived = 0;
+	ulDoorbells = 0;
+	benchCHECK( xTaskCreate( prvHostReaderTask, "HostRx", benchSTACK_SIZE, NULL, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+
+	for( ulRound = 1; ulRound <= benchHW_ROUNDS; ulRound++ )
+	{
+		/* The reader has the higher priority and only waits in
+		xStreamBufferReceive(), so whenever this task runs it is blocked
+		there. */
+		ullStart = ullBenchNow();
+		ulHostRequest = ulRound;
+
+		while( ulHostReceived != ulRound )
+		{
+			benchCHECK( ( ullBenchNow() - ullStart ) < benchHW_WAKE_LIMIT_NS );
+			vTaskDelay( 1 );
+		}
+
+		ullLatencyTotal += ullHostReceivedTime - ullStart;
+	}
+
+	/* Every write found the reader waiting, so rang the doorbell once. */
+	benchCHECK( ulHostErrors == 0 );
+	benchCHECK( ulDoorbells == benchHW_ROUNDS );
+
+	printf( "  %-36s %lu rounds, %lu doorbells, request to receive %6.1f us average\n",
+			"blocked reader:",
+			( unsigned long ) benchHW_ROUNDS,
+			( unsigned long ) ulDoorbells,
+			( double ) ullLatencyTotal / ( double ) benchHW_ROUNDS / 1000.0 );
+
+	/* The reader has deleted itself. */
+	vTaskDelay( 2 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckWriteInWait( BaseType_t xPeek, BaseType_t xBeforeBlocking, const char *pcName )
+{
+StreamBufferSpans_t xSpans;
+uint32_t ulValue = 0, ulDoorbellsBefore;
+uint64_t ullStart, ullElapsed;
+size_t xReceived;
+
+	/* The reader, this task, finds the buffer empty and would block for
+	benchHW_WAIT_MS, but the hook has the host thread write first.  Before the
+	task registers as waiting the writer rings no doorbell, and the task's
+	second look must find the data.  After it registers the writer rings the
+	doorbell, which must wake the task as soon as it blocks.  A lost wake-up
+	only returns when the wait times out. */
+	ulDoorbellsBefore = ulDoorbells;
+	ulHookValue = ulDoorbellsBefore + benchHW_ROUNDS + 1UL;
+	iHookBlocking = ( xBeforeBlocking != pdFALSE ) ? 1 : 0;
+	pxStreamBufferWaitHook = prvStreamBufferWaitHook;
+
+	ullStart = ullBenchNow();
+
+	if( xPeek != pdFALSE )
+	{
+		xReceived = xStreamBufferPeek( xHostBuffer, &xSpans, pdMS_TO_TICKS( benchHW_WAIT_MS ) );
+	}
+	else
+	{
+		xReceived = xStreamBufferReceive( xHostBuffer, &ulValue, sizeof( ulValue ), pdMS_TO_TICKS( benchHW_WAIT_MS ) );
+	}
+
+	ullElapsed = ullBenchNow() - ullStart;
+	pxStreamBufferWaitHook = NULL;
+
+	/* The hook ran, once, and the host thread wrote. */
+	benchCHECK( ulHookValue == 0 );
+	benchCHECK( ulHostErrors == 0 );
+
+	benchCHECK( xReceived == sizeof( ulValue ) );
+
+	if( xPeek != pdFALSE )
+	{
+		benchCHECK( xStreamBufferReceive( xHostBuffer, &ulValue, sizeof( ulValue ), 0 ) == sizeof( ulValue ) );
+	}
+
+	benchCHECK( ulValue == ulDoorbellsBefore + benchHW_ROUNDS + 1UL );
+	benchCHECK( ulDoorbells == ulDoorbellsBefore + ( ( xBeforeBlocking != pdFALSE ) ? 1UL : 0UL ) );
+	benchCHECK( ullElapsed < benchHW_WAKE_LIMIT_NS );
+
+	printf( "  %-36s %lu doorbell, received in %6.1f us\n",
+			pcName,
+			( unsigned long ) ( ulDoorbells - ulDoorbellsBefore ),
+			( double ) ullElapsed / 1000.0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvStreamBufferWaitHook( void *pvStreamBuffer, int iBlocking )
+{
+struct timespec xGap = { 0, 10000L };
+
+	/* Runs on the reading task, the first time inside the critical section in
+	which it looks for data, the second just before it blocks. */
+	if( ( pvStreamBuffer == ( void * ) xHostBuffer ) && ( iBlocking == iHookBlocking ) && ( ulHookValue != 0 ) )
+	{
+		ulHostRequest = ulHookValue;
+		ulHookValue = 0;
+
+		/* The host thread may only have the task's CPU, so sleep, not spin. */
+		while( ulHostRequest != 0 )
+		{
+			( void ) nanosleep( &xGap, NULL );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvDoorbellInterruptHandler( void )
+{
+BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	ulDoorbells++;
+	( void ) xStreamBufferHostDoorbellFromISR( xHostBuffer, &xHigherPriorityTaskWoken );
+
+	return ( uint32_t ) xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHostReaderTask( void *pvParameters )
+{
+uint32_t ulValue, ulRound;
+
+	( void ) pvParameters;
+
+	for( ulRound = 1; ulRound <= benchHW_ROUNDS; ulRound++ )
+	{
+		benchCHECK( xStreamBufferReceive( xHostBuffer, &ulValue, sizeof( ulValue ), portMAX_DELAY ) == sizeof( ulValue ) );
+		ullHostReceivedTime = ullBenchNow();
+		benchCHECK( ulValue == ulRound );
+		ulHostReceived = ulRound;
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void *prvHostWriterThread( void *pvParameters )
+{
+struct timespec xGap = { 0, 10000L };
+uint32_t ulValue;
+
+	( void ) pvParameters;
+
+	/* Not a task, so only xStreamBufferSendFromHost() is called, and errors
+	are counted for the controller to check. */
+	while( xHostStop == pdFALSE )
+	{
+		ulValue = ulHostRequest;
+
+		if( ulValue != 0 )
+		{
+			if( xStreamBufferSendFromHost( xHostBuffer, &ulValue, sizeof( ulValue ) ) != sizeof( ulValue ) )
+			{
+				ulHostErrors++;
+			}
+
+			ulHostRequest = 0;
+		}
+		else
+		{
+			( void ) nanosleep( &xGap, NULL );
+		}
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
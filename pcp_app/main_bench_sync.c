@@ -0,0 +1,955 @@
+/******************************************************************************
+ * Synchronisation benchmarks, see main_bench.c.
+ *
+ * rwlock: first checks the order in which a readers-writer lock is handed on.
+ * When the last holder gives the lock back, a waiting reader with a higher
+ * priority than every waiting writer must get it before the writers, and a
+ * waiting writer must get it before readers with the same or a lower priority.
+ * A writer that took the lock without contention must still have its priority
+ * raised by the tasks that block on it.  It then times taking and giving the
+ * lock without contention, against a mutex, and runs 1, 4 and 16 reader tasks
+ * against one writer task for benchRW_RUN_MS each, first with the lock and
+ * then with a mutex in its place.
+ * The readers yield while they hold the lock, so readers that can share it do,
+ * while readers that cannot queue up behind each other.  Readers check that
+ * the data the writer updates is never seen half written.
+ *
+ * mutex_chain: checks priority inheritance along chains of mutex holders, where
+ * each holder but the last is blocked on the mutex held by the next.  A task
+ * that blocks on the first mutex must raise every holder in the chain to its
+ * priority, and when it times out every holder must drop back to the priority
+ * of the highest task still waiting.  A holder whose own wait times out must
+ * no longer pass priority on to the holder after it.  It then times how long a
+ * task waits for the first mutex of chains of 1, 2 and 3 holders, each of which
+ * works for benchMC_HOLD_US before giving its mutexes back, while a task with a
+ * priority above the holders' own keeps the CPU busy.  Without inheritance
+ * along the chain that task would starve the last holder, and the wait would
+ * not end.
+ *
+ * barrier: checks that each release of a barrier starts a new generation, with
+ * the task that arrived last, and only that task, told that it released the
+ * barrier, and that the other participants are held again on their next
+ * arrival.  A task whose wait times out, or that does not wait at all, must
+ * withdraw its arrival, so a barrier of two is not released by one more
+ * arrival after it.  It then times rounds of 2, 4, 16 and
+ * benchBA_MAX_PARTICIPANTS participants, and the same rounds of up to
+ * benchBA_MAX_SYNC_PARTICIPANTS participants with xEventGroupSync() in place of
+ * the barrier.
+ *******************************************************************************
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+
+/* FreeRTOS kernel includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "rwlock.h"
+#include "barrier.h"
+#include "event_groups.h"
+
+#include "main_bench.h"
+
+#define benchRW_UNCONTENDED_LOOPS	( 256UL * 1024UL )
+#define benchRW_RUN_MS				( 200 )
+#define benchRW_MAX_READERS			( 16 )
+
+#define benchMC_MAX_DEPTH			( 3 )
+#define benchMC_LINK_PRIORITY		( benchCONTROL_PRIORITY - 8 )
+#define benchMC_HOG_PRIORITY		( benchCONTROL_PRIORITY - 4 )
+#define benchMC_HOLD_US				( 100 )
+#define benchMC_RUNS				( 50 )
+#define benchMC_SETTLE_TICKS		( 100 )
+
+/* Long enough for the inherited priorities to be checked before the higher
+priority waiter gives up, even if the host stalls the process for a while. */
+#define benchMC_HIGH_TIMEOUT		( 20 )
+
+#define benchBA_CHECK_PARTICIPANTS	( 4 )
+#define benchBA_CHECK_ROUNDS		( 5 )
+#define benchBA_TIMEOUT				( 5 )
+#define benchBA_MAX_PARTICIPANTS	( 64 )
+#define benchBA_MAX_SYNC_PARTICIPANTS	( 16 )
+#define benchBA_TIMED_ROUNDS		( 2000 )
+
+/*-----------------------------------------------------------*/
+
+/* What the reader and writer tasks share.  The writer increments ulFirst and
+ulSecond in turn, yielding in between, so they only differ while it holds the
+lock for writing. */
+typedef struct RWShared
+{
+	RWLockHandle_t xLock;				/* The lock, or NULL to use xMutex. */
+	SemaphoreHandle_t xMutex;
+	volatile uint32_t ulFirst;
+	volatile uint32_t ulSecond;
+	volatile uint32_t ulReads;
+	volatile uint32_t ulWrites;
+	volatile uint32_t ulTornReads;
+	volatile BaseType_t xStop;
+	volatile UBaseType_t uxRunning;
+} RWShared_t;
+
+/* One holder in a chain of mutex holders. */
+typedef struct ChainLink
+{
+	SemaphoreHandle_t xHeld;
+	SemaphoreHandle_t xNext;			/* Held by the next link, or NULL for the last link, which waits for a notification instead. */
+	TickType_t xNextTimeout;
+	TaskHandle_t xTask;
+	volatile BaseType_t xTookNext;
+	volatile UBaseType_t uxNextHolderPriority;	/* The priority of the next link when the wait for xNext timed out. */
+	volatile UBaseType_t uxFinalPriority;		/* The link's priority once it has given its mutexes back. */
+} ChainLink_t;
+
+/* A task that waits for the first mutex of a chain. */
+typedef struct ChainWaiter
+{
+	SemaphoreHandle_t xMutex;
+	TickType_t xTimeout;
+	volatile BaseType_t xResult;
+} ChainWaiter_t;
+
+/* A task that arrives at a barrier, or syncs on an event group when xBarrier
+is NULL, uxRounds times.  Its memory is static, as the heap does not have room
+for benchBA_MAX_PARTICIPANTS tasks. */
+typedef struct BarrierWorker
+{
+	BarrierHandle_t xBarrier;
+	EventGroupHandle_t xGroup;
+	EventBits_t uxBit;					/* The worker's own bit in xGroup. */
+	EventBits_t uxAllBits;
+	UBaseType_t uxRounds;
+	volatile UBaseType_t uxPassed;		/* Rounds released by another task. */
+	volatile UBaseType_t uxLast;		/* Rounds released by this task. */
+	volatile UBaseType_t uxFailed;		/* Waits that timed out. */
+	volatile BaseType_t xDone;
+	StaticTask_t xTCB;
+	StackType_t xStack[ benchSTACK_SIZE ];
+} BarrierWorker_t;
+
+static ChainLink_t xLinks[ benchMC_MAX_DEPTH ];
+static BarrierWorker_t xBarrierWorkers[ benchBA_MAX_PARTICIPANTS - 1 ];
+static SemaphoreHandle_t xChainMutexes[ benchMC_MAX_DEPTH ];
+static volatile uint64_t ullHoldNs = 0;
+static volatile BaseType_t xHogStop = pdFALSE;
+
+/* The order tasks took the lock in, for the hand on checks. */
+static volatile char cOrder[ 4 ];
+static volatile UBaseType_t uxOrderNext = 0;
+
+static void prvCheckHandOn( void );
+static void prvOrderedReader( void *pvParameters );
+static void prvOrderedWriter( void *pvParameters );
+static void prvRecordOrder( char cTask );
+static void prvTimeUncontended( void );
+static void prvRunContended( RWShared_t *pxShared, UBaseType_t uxReaders );
+static void prvReaderTask( void *pvParameters );
+static void prvWriterTask( void *pvParameters );
+static void prvTakeShared( RWShared_t *pxShared, BaseType_t xForWriting );
+static void prvGiveShared( RWShared_t *pxShared, BaseType_t xForWriting );
+static void prvBuildChain( UBaseType_t uxDepth, UBaseType_t uxTimeoutLink, TickType_t xTimeout );
+static void prvCheckChainInheritance( void );
+static void prvCheckChainLinkTimeout( void );
+static void prvWaitForChainEnd( UBaseType_t uxFirst, UBaseType_t uxDepth );
+static void prvTimeChainWait( UBaseType_t uxDepth );
+static void prvChainLinkTask( void *pvParameters );
+static void prvChainWaiterTask( void *pvParameters );
+static void prvHogTask( void *pvParameters );
+static void prvCheckBarrierGenerations( void );
+static void prvCheckBarrierTimeout( void );
+static void prvTimeBarrierRounds( UBaseType_t uxParticipants, BaseType_t xUseEventGroup );
+static void prvStartBarrierWorker( BarrierWorker_t *pxWorker, UBaseType_t uxRounds, UBaseType_t uxPriority );
+static void prvBarrierWorkerTask( void *pvParameters );
+
+/*-----------------------------------------------------------*/
+
+void vBenchRWLock( void *pvParameters )
+{
+const UBaseType_t uxReaders[] = { 1, 4, benchRW_MAX_READERS };
+static RWShared_t xShared;
+size_t x;
+
+	( void ) pvParameters;
+
+	prvCheckHandOn();
+	prvTimeUncontended();
+
+	xShared.xMutex = xSemaphoreCreateMutex();
+	benchCHECK( xShared.xMutex != NULL );
+
+	for( x = 0; x < ( sizeof( uxReaders ) / sizeof( uxReaders[ 0 ] ) ); x++ )
+	{
+		xShared.xLock = xRWLockCreate();
+		benchCHECK( xShared.xLock != NULL );
+		prvRunContended( &xShared, uxReaders[ x ] );
+		vRWLockDelete( xShared.xLock );
+
+		xShared.xLock = NULL;
+		prvRunContended( &xShared, uxReaders[ x ] );
+	}
+
+	vSemaphoreDelete( xShared.xMutex );
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckHandOn( void )
+{
+RWLockHandle_t xLock;
+
+	xLock = xRWLockCreate();
+	benchCHECK( xLock != NULL );
+
+	/* The controller holds the lock for writing while a writer and a reader
+	with a higher priority than the writer block on it.  The reader must get
+	the lock first.  The tasks run at once, as they have a higher priority than
+	the controller. */
+	uxOrderNext = 0;
+	benchCHECK( xRWLockTakeWrite( xLock, 0 ) == pdPASS );
+	benchCHECK( xTaskCreate( prvOrderedWriter, "W", benchSTACK_SIZE, xLock, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xTaskCreate( prvOrderedReader, "R", benchSTACK_SIZE, xLock, benchCONTROL_PRIORITY + 2, NULL ) == pdPASS );
+	benchCHECK( uxOrderNext == 0 );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchCONTROL_PRIORITY + 2 );
+	benchCHECK( xRWLockGiveWrite( xLock ) == pdPASS );
+	benchCHECK( uxTaskPriorityGet( NULL ) == benchCONTROL_PRIORITY );
+	vTaskDelay( 2 );
+	benchCHECK( ( uxOrderNext == 2 ) && ( cOrder[ 0 ] == 'R' ) && ( cOrder[ 1 ] == 'W' ) );
+	printf( "  higher priority reader before writer: ok\n" );
+
+	/* The same with the reader's priority equal to the writer's, when the
+	writer must get the lock first. */
+	uxOrderNext = 0;
+	benchCHECK( xRWLockTakeWrite( xLock, 0 ) == pdPASS );
+	benchCHECK( xTaskCreate( prvOrderedWriter, "W", benchSTACK_SIZE, xLock, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xTaskCreate( prvOrderedReader, "R", benchSTACK_SIZE, xLock, benchCONTROL_PRIORITY + 1, NULL ) == pdPASS );
+	benchCHECK( xRWLockGiveWrite( xLock ) == pdPASS );
+	vTaskDelay( 2 );
+	benchCHECK( ( uxOrderNext == 2 ) && ( cOrder[ 0 ] == 'W' ) && ( cOrder[ 1 ] == 'R' ) );
+	printf( "  writer before equal priority reader: ok\n" );
+
+	/* The tasks have deleted themselves. */
+	benchCHECK( xRWLockTakeWrite( xLock, 0 ) == pdPASS );
+	benchCHECK( xRWLockGiveWrite( xLock ) == pdPASS );
+	vRWLockDelete( xLock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvOrderedReader( void *pvParameters )
+{
+RWLockHandle_t xLock = ( RWLockHandle_t ) pvParameters;
+
+	benchCHECK( xRWLockTakeRead( xLock, pdMS_TO_TICKS( 1000 ) ) == pdPASS );
+	prvRecordOrder( 'R' );
+	benchCHECK( xRWLockGiveRead( xLock ) == pdPASS );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvOrderedWriter( void *pvParameters )
+{
+RWLockHandle_t xLock = ( RWLockHandle_t ) pvParameters;
+
+	benchCHECK( xRWLockTakeWrite( xLock, pdMS_TO_TICKS( 1000 ) ) == pdPASS );
+	prvRecordOrder( 'W' );
+	benchCHECK( xRWLockGiveWrite( xLock ) == pdPASS );
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecordOrder( char cTask )
+{
+	benchCHECK( uxOrderNext < sizeof( cOrder ) );
+	cOrder[ uxOrderNext ] = cTask;
+	uxOrderNext++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeUncontended( void )
+{
+RWLockHandle_t xLock;
+SemaphoreHandle_t xMutex;
+uint64_t ullStart, ullRead, ullWrite, ullMutex;
+uint32_t ul;
+
+	xLock = xRWLockCreate();
+	xMutex = xSemaphoreCreateMutex();
+	benchCHECK( ( xLock != NULL ) && ( xMutex != NULL ) );
+
+	ullStart = ullBenchNow();
+
+	for( ul = 0; ul < benchRW_UNCONTENDED_LOOPS; ul++ )
+	{
+		benchCHECK( xRWLockTakeRead( xLock, 0 ) == pdPASS );
+		benchCHECK( xRWLockGiveRead( xLock ) == pdPASS );
+	}
+
+	ullRead = ullBenchNow() - ullStart;
+	ullStart = ullBenchNow();
+
+	for( ul = 0; ul < benchRW_UNCONTENDED_LOOPS; ul++ )
+	{
+		benchCHECK( xRWLockTakeWrite( xLock, 0 ) == pdPASS );
+		benchCHECK( xRWLockGiveWrite( xLock ) == pdPASS );
+	}
+
+	ullWrite = ullBenchNow() - ullStart;
+	ullStart = ullBenchNow();
+
+	for( ul = 0; ul < benchRW_UNCONTENDED_LOOPS; ul++ )
+	{
+		benchCHECK( xSemaphoreTake( xMutex, 0 ) == pdPASS );
+		benchCHECK( xSemaphoreGive( xMutex ) == pdPASS );
+	}
+
+	ullMutex = ullBenchNow() - ullStart;
+
+	printf( "  uncontended take+give: read %.1f ns, write %.1f ns, mutex %.1f ns\n",
+			( double ) ullRead / ( double ) benchRW_UNCONTENDED_LOOPS,
+			( double ) ullWrite / ( double ) benchRW_UNCONTENDED_LOOPS,
+			( double ) ullMutex / ( double ) benchRW_UNCONTENDED_LOOPS );
+
+	vRWLockDelete( xLock );
+	vSemaphoreDelete( xMutex );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunContended( RWShared_t *pxShared, UBaseType_t uxReaders )
+{
+UBaseType_t x;
+
+	pxShared->ulFirst = 0;
+	pxShared->ulSecond = 0;
+	pxShared->ulReads = 0;
+	pxShared->ulWrites = 0;
+	pxShared->ulTornReads = 0;
+	pxShared->xStop = pdFALSE;
+	pxShared->uxRunning = uxReaders + 1;
+
+	/* The readers share a priority, so take turns, and the writer has a higher
+	one, so runs as soon as its delay ends. */
+	for( x = 0; x < uxReaders; x++ )
+	{
+		benchCHECK( xTaskCreate( prvReaderTask, "Reader", benchSTACK_SIZE, pxShared, benchCONTROL_PRIORITY - 2, NULL ) == pdPASS );
+	}
+
+	benchCHECK( xTaskCreate( prvWriterTask, "Writer", benchSTACK_SIZE, pxShared, benchCONTROL_PRIORITY - 1, NULL ) == pdPASS );
+
+	vTaskDelay( pdMS_TO_TICKS( benchRW_RUN_MS ) );
+	pxShared->xStop = pdTRUE;
+
+	while( pxShared->uxRunning > 0 )
+	{
+		vTaskDelay( 1 );
+	}
+
+	/* Let the idle task free the tasks. */
+	vTaskDelay( 2 );
+
+	benchCHECK( pxShared->ulTornReads == 0 );
+	benchCHECK( ( pxShared->ulReads > 0 ) && ( pxShared->ulWrites > 0 ) );
+	benchCHECK( pxShared->ulFirst == pxShared->ulSecond );
+
+	printf( "  %2u readers, %s: %8lu reads/s, %5lu writes/s\n",
+			( unsigned ) uxReaders,
+			( pxShared->xLock != NULL ) ? "rwlock" : "mutex ",
+			( unsigned long ) ( ( ( uint64_t ) pxShared->ulReads * 1000ULL ) / benchRW_RUN_MS ),
+			( unsigned long ) ( ( ( uint64_t ) pxShared->ulWrites * 1000ULL ) / benchRW_RUN_MS ) );
+}
+/*-----------------------------------------------------------*/
+
+static void prvReaderTask( void *pvParameters )
+{
+RWShared_t *pxShared = ( RWShared_t * ) pvParameters;
+uint32_t ulFirst;
+
+	while( pxShared->xStop == pdFALSE )
+	{
+		prvTakeShared( pxShared, pdFALSE );
+		{
+			ulFirst = pxShared->ulFirst;
+
+			/* Let the other readers in while this one holds the lock. */
+			taskYIELD();
+
+			if( pxShared->ulSecond != ulFirst )
+			{
+				pxShared->ulTornReads++;
+			}
+
+			pxShared->ulReads++;
+		}
+		prvGiveShared( pxShared, pdFALSE );
+	}
+
+	taskENTER_CRITICAL();
+	pxShared->uxRunning--;
+	taskEXIT_CRITICAL();
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriterTask( void *pvParameters )
+{
+RWShared_t *pxShared = ( RWShared_t * ) pvParameters;
+
+	while( pxShared->xStop == pdFALSE )
+	{
+		prvTakeShared( pxShared, pdTRUE );
+		{
+			pxShared->ulFirst++;
+			taskYIELD();
+			pxShared->ulSecond++;
+			pxShared->ulWrites++;
+		}
+		prvGiveShared( pxShared, pdTRUE );
+
+		vTaskDelay( 1 );
+	}
+
+	taskENTER_CRITICAL();
+	pxShared->uxRunning--;
+	taskEXIT_CRITICAL();
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeShared( RWShared_t *pxShared, BaseType_t xForWriting )
+{
+	if( pxShared->xLock == NULL )
+	{
+		benchCHECK( xSemaphoreTake( pxShared->xMutex, portMAX_DELAY ) == pdPASS );
+	}
+	else if( xForWriting != pdFALSE )
+	{
+		benchCHECK( xRWLockTakeWrite( pxShared->xLock, portMAX_DELAY ) == pdPASS );
+	}
+	else
+	{
+		benchCHECK( xRWLockTakeRead( pxShared->xLock, portMAX_DELAY ) == pdPASS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvGiveShared( RWShared_t *pxShared, BaseType_t xForWriting )
+{
+	if( pxShared->xLock == NULL )
+	{
+		benchCHECK( xSemaphoreGive( pxShared->xMutex ) == pdPASS );
+	}
+	else if( xForWriting != pdFALSE )
+	{
+		benchCHECK( xRWLockGiveWrite( pxShared->xLock ) == pdPASS );
+	}
+	else
+	{
+		benchCHECK( xRWLockGiveRead( pxShared->xLock ) == pdPASS );
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vBenchMutexChain( void *pvParameters )
+{
+UBaseType_t x;
+
+	( void ) pvParameters;
+
+	for( x = 0; x < benchMC_MAX_DEPTH; x++ )
+	{
+		xChainMutexes[ x ] = xSemaphoreCreateMutex();
+		benchCHECK( xChainMutexes[ x ] != NULL );
+	}
+
+	prvCheckChainInheritance();
+	prvCheckChainLinkTimeout();
+
+	for( x = 1; x <= benchMC_MAX_DEPTH; x++ )
+	{
+		prvTimeChainWait( x );
+	}
+
+	for( x = 0; x < benchMC_MAX_DEPTH; x++ )
+	{
+		vSemaphoreDelete( xChainMutexes[ x ] );
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvBuildChain( UBaseType_t uxDepth, UBaseType_t uxTimeoutLink, TickType_t xTimeout )
+{
+UBaseType_t x;
+TickType_t xWait;
+
+	/* The links are created last first, and each runs until it blocks before
+	the next is created, so each link holds its mutex before the link before it
+	blocks on it.  Link uxTimeoutLink waits for the next mutex for xTimeout
+	ticks, the others for long enough not to time out.  A new link can also
+	take more than a tick to block on a loaded host. */
+	for( x = uxDepth; x > 0; x-- )
+	{
+		xLinks[ x - 1 ].xHeld = xChainMutexes[ x - 1 ];
+		xLinks[ x - 1 ].xNext = ( x < uxDepth ) ? xChainMutexes[ x ] : NULL;
+		xLinks[ x - 1 ].xNextTimeout = ( ( x - 1 ) == uxTimeoutLink ) ? xTimeout : pdMS_TO_TICKS( 1000 );
+		xLinks[ x - 1 ].xTookNext = pdFALSE;
+		xLinks[ x - 1 ].uxNextHolderPriority = 0;
+		xLinks[ x - 1 ].uxFinalPriority = 0;
+
+		benchCHECK( xTaskCreate( prvChainLinkTask, "Link", benchSTACK_SIZE, &( xLinks[ x - 1 ] ), benchMC_LINK_PRIORITY, &( xLinks[ x - 1 ].xTask ) ) == pdPASS );
+		for( xWait = 0; ( xWait < benchMC_SETTLE_TICKS ) && ( eTaskGetState( xLinks[ x - 1 ].xTask ) != eBlocked ); xWait++ )
+		{
+			vTaskDelay( 1 );
+		}
+
+		benchCHECK( eTaskGetState( xLinks[ x - 1 ].xTask ) == eBlocked );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitForChainEnd( UBaseType_t uxFirst, UBaseType_t uxDepth )
+{
+TickType_t xWait;
+UBaseType_t x = uxFirst;
+
+	/* Links uxFirst to uxDepth - 1 run at the lowest priority once they have
+	given their mutexes back, so on a loaded host can take more than a tick or
+	two to record their final priority. */
+	for( xWait = 0; ( xWait < benchMC_SETTLE_TICKS ) && ( x < uxDepth ); xWait++ )
+	{
+		vTaskDelay( 1 );
+
+		while( ( x < uxDepth ) && ( xLinks[ x ].uxFinalPriority != 0 ) )
+		{
+			x++;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckChainInheritance( void )
+{
+static ChainWaiter_t xHigh, xLow;
+UBaseType_t x;
+
+	prvBuildChain( benchMC_MAX_DEPTH, benchMC_MAX_DEPTH, 0 );
+
+	/* Two tasks wait for the first mutex.  The one with the higher priority
+	gives up first. */
+	xHigh.xMutex = xChainMutexes[ 0 ];
+	xHigh.xTimeout = benchMC_HIGH_TIMEOUT;
+	xLow.xMutex = xChainMutexes[ 0 ];
+	xLow.xTimeout = pdMS_TO_TICKS( 1000 );
+	benchCHECK( xTaskCreate( prvChainWaiterTask, "High", benchSTACK_SIZE, &xHigh, benchCONTROL_PRIORITY - 1, NULL ) == pdPASS );
+	benchCHECK( xTaskCreate( prvChainWaiterTask, "Low", benchSTACK_SIZE, &xLow, benchCONTROL_PRIORITY - 3, NULL ) == pdPASS );
+	vTaskDelay( 1 );
+
+	for( x = 0; x < benchMC_MAX_DEPTH; x++ )
+	{
+		benchCHECK( uxTaskPriorityGet( xLinks[ x ].xTask ) == ( benchCONTROL_PRIORITY - 1 ) );
+	}
+
+	printf( "  %d holders inherit the waiting task's priority: ok\n", benchMC_MAX_DEPTH );
+
+	vTaskDelay( benchMC_HIGH_TIMEOUT * 2 );
+	benchCHECK( xHigh.xResult == pdFAIL );
+
+	for( x = 0; x < benchMC_MAX_DEPTH; x++ )
+	{
+		benchCHECK( uxTaskPriorityGet( xLinks[ x ].xTask ) == ( benchCONTROL_PRIORITY - 3 ) );
+	}
+
+	printf( "  holders drop to the next waiting task's priority on timeout: ok\n" );
+
+	/* Let the last link go, so the chain unwinds and the remaining waiter gets
+	the mutex. */
+	xTaskNotifyGive( xLinks[ benchMC_MAX_DEPTH - 1 ].xTask );
+	prvWaitForChainEnd( 0, benchMC_MAX_DEPTH );
+	benchCHECK( xLow.xResult == pdPASS );
+
+	for( x = 0; x < benchMC_MAX_DEPTH; x++ )
+	{
+		benchCHECK( xLinks[ x ].uxFinalPriority == benchMC_LINK_PRIORITY );
+	}
+
+	printf( "  holders drop to their own priority once the chain unwinds: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckChainLinkTimeout( void )
+{
+	/* The middle link gives up waiting for the last link's mutex. */
+	prvBuildChain( benchMC_MAX_DEPTH, 1, 3 );
+
+	/* Keep the CPU until the middle link has timed out, so it is ready but has
+	not run again when this task blocks on the first mutex.  The chain must end
+	at the middle link, which then runs at this task's priority and records the
+	last link's priority. */
+	while( eTaskGetState( xLinks[ 1 ].xTask ) == eBlocked )
+	{
+	}
+
+	benchCHECK( xSemaphoreTake( xChainMutexes[ 0 ], pdMS_TO_TICKS( 100 ) ) == pdPASS );
+	benchCHECK( xLinks[ 1 ].xTookNext == pdFALSE );
+	benchCHECK( xLinks[ 1 ].uxNextHolderPriority == benchMC_LINK_PRIORITY );
+	benchCHECK( xSemaphoreGive( xChainMutexes[ 0 ] ) == pdPASS );
+
+	xTaskNotifyGive( xLinks[ benchMC_MAX_DEPTH - 1 ].xTask );
+	prvWaitForChainEnd( benchMC_MAX_DEPTH - 1, benchMC_MAX_DEPTH );
+	benchCHECK( xLinks[ benchMC_MAX_DEPTH - 1 ].uxFinalPriority == benchMC_LINK_PRIORITY );
+
+	printf( "  a holder that timed out ends the chain: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeChainWait( UBaseType_t uxDepth )
+{
+uint64_t ullStart, ullWait, ullTotal = 0, ullMax = 0;
+UBaseType_t x, uxRun;
+
+	ullHoldNs = benchMC_HOLD_US * 1000ULL;
+
+	for( uxRun = 0; uxRun < benchMC_RUNS; uxRun++ )
+	{
+		prvBuildChain( uxDepth, uxDepth, 0 );
+
+		xHogStop = pdFALSE;
+		benchCHECK( xTaskCreate( prvHogTask, "Hog", benchSTACK_SIZE, NULL, benchMC_HOG_PRIORITY, NULL ) == pdPASS );
+
+		/* The last link is now ready, but only runs if it inherits this task's
+		priority along the chain once this task blocks. */
+		xTaskNotifyGive( xLinks[ uxDepth - 1 ].xTask );
+
+		ullStart = ullBenchNow();
+		benchCHECK( xSemaphoreTake( xChainMutexes[ 0 ], pdMS_TO_TICKS( 1000 ) ) == pdPASS );
+		ullWait = ullBenchNow() - ullStart;
+		benchCHECK( xSemaphoreGive( xChainMutexes[ 0 ] ) == pdPASS );
+
+		xHogStop = pdTRUE;
+		prvWaitForChainEnd( 0, uxDepth );
+
+		for( x = 0; x < uxDepth; x++ )
+		{
+			benchCHECK( xLinks[ x ].uxFinalPriority == benchMC_LINK_PRIORITY );
+		}
+
+		ullTotal += ullWait;
+
+		if( ullWait > ullMax )
+		{
+			ullMax = ullWait;
+		}
+	}
+
+	ullHoldNs = 0;
+
+	printf( "  %u holders, %u us of work: wait %.1f us average, %.1f us max\n",
+			( unsigned ) uxDepth,
+			( unsigned ) ( uxDepth * benchMC_HOLD_US ),
+			( double ) ullTotal / ( double ) benchMC_RUNS / 1000.0,
+			( double ) ullMax / 1000.0 );
+}
+/*-----------------------------------------------------------*/
+
+static void prvChainLinkTask( void *pvParameters )
+{
+ChainLink_t *pxLink = ( ChainLink_t * ) pvParameters;
+uint64_t ullStart;
+
+	benchCHECK( xSemaphoreTake( pxLink->xHeld, 0 ) == pdPASS );
+
+	if( pxLink->xNext != NULL )
+	{
+		if( xSemaphoreTake( pxLink->xNext, pxLink->xNextTimeout ) == pdPASS )
+		{
+			pxLink->xTookNext = pdTRUE;
+		}
+		else
+		{
+			pxLink->uxNextHolderPriority = uxTaskPriorityGet( ( pxLink + 1 )->xTask );
+		}
+	}
+	else
+	{
+		( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+	}
+
+	ullStart = ullBenchNow();
+
+	while( ( ullBenchNow() - ullStart ) < ullHoldNs )
+	{
+	}
+
+	if( pxLink->xTookNext != pdFALSE )
+	{
+		benchCHECK( xSemaphoreGive( pxLink->xNext ) == pdPASS );
+	}
+
+	benchCHECK( xSemaphoreGive( pxLink->xHeld ) == pdPASS );
+	pxLink->uxFinalPriority = uxTaskPriorityGet( NULL );
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvChainWaiterTask( void *pvParameters )
+{
+ChainWaiter_t *pxWaiter = ( ChainWaiter_t * ) pvParameters;
+
+	pxWaiter->xResult = xSemaphoreTake( pxWaiter->xMutex, pxWaiter->xTimeout );
+
+	if( pxWaiter->xResult == pdPASS )
+	{
+		benchCHECK( xSemaphoreGive( pxWaiter->xMutex ) == pdPASS );
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvHogTask( void *pvParameters )
+{
+	( void ) pvParameters;
+
+	while( xHogStop == pdFALSE )
+	{
+	}
+
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+void vBenchBarrier( void *pvParameters )
+{
+const UBaseType_t uxParticipants[] = { 2, 4, 16, benchBA_MAX_PARTICIPANTS };
+size_t x;
+
+	( void ) pvParameters;
+
+	prvCheckBarrierGenerations();
+	prvCheckBarrierTimeout();
+
+	for( x = 0; x < ( sizeof( uxParticipants ) / sizeof( uxParticipants[ 0 ] ) ); x++ )
+	{
+		prvTimeBarrierRounds( uxParticipants[ x ], pdFALSE );
+
+		if( uxParticipants[ x ] <= benchBA_MAX_SYNC_PARTICIPANTS )
+		{
+			prvTimeBarrierRounds( uxParticipants[ x ], pdTRUE );
+		}
+	}
+
+	vBenchEnd();
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckBarrierGenerations( void )
+{
+BarrierHandle_t xBarrier;
+UBaseType_t x, uxRound;
+
+	xBarrier = xBarrierCreate( benchBA_CHECK_PARTICIPANTS );
+	benchCHECK( xBarrier != NULL );
+	benchCHECK( uxBarrierGetGeneration( xBarrier ) == 0 );
+
+	/* The workers have a higher priority than this task, so arrive first,
+	and arrive again as soon as they are released. */
+	for( x = 0; x < ( benchBA_CHECK_PARTICIPANTS - 1 ); x++ )
+	{
+		xBarrierWorkers[ x ].xBarrier = xBarrier;
+		prvStartBarrierWorker( &( xBarrierWorkers[ x ] ), benchBA_CHECK_ROUNDS, benchCONTROL_PRIORITY + 1 );
+	}
+
+	for( uxRound = 0; uxRound < benchBA_CHECK_ROUNDS; uxRound++ )
+	{
+		for( x = 0; x < ( benchBA_CHECK_PARTICIPANTS - 1 ); x++ )
+		{
+			benchCHECK( xBarrierWorkers[ x ].uxPassed == uxRound );
+		}
+
+		benchCHECK( xBarrierWait( xBarrier, portMAX_DELAY ) == barrierLAST_TO_ARRIVE );
+		benchCHECK( uxBarrierGetGeneration( xBarrier ) == ( uxRound + 1 ) );
+	}
+
+	for( x = 0; x < ( benchBA_CHECK_PARTICIPANTS - 1 ); x++ )
+	{
+		benchCHECK( xBarrierWorkers[ x ].xDone != pdFALSE );
+		benchCHECK( xBarrierWorkers[ x ].uxPassed == benchBA_CHECK_ROUNDS );
+		benchCHECK( xBarrierWorkers[ x ].uxLast == 0 );
+	}
+
+	/* Let the idle task free the workers before their memory is reused. */
+	vTaskDelay( 2 );
+	vBarrierDelete( xBarrier );
+
+	printf( "  each release starts a generation, last arrival released it: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvCheckBarrierTimeout( void )
+{
+BarrierHandle_t xBarrier;
+BarrierWorker_t *pxWorker = &( xBarrierWorkers[ 0 ] );
+
+	xBarrier = xBarrierCreate( 2 );
+	benchCHECK( xBarrier != NULL );
+
+	benchCHECK( xBarrierWait( xBarrier, 0 ) == pdFAIL );
+	benchCHECK( xBarrierWait( xBarrier, benchBA_TIMEOUT ) == pdFAIL );
+	benchCHECK( uxBarrierGetGeneration( xBarrier ) == 0 );
+
+	/* Had either arrival above not been withdrawn, the worker would release
+	the barrier rather than wait at it. */
+	pxWorker->xBarrier = xBarrier;
+	prvStartBarrierWorker( pxWorker, 1, benchCONTROL_PRIORITY + 1 );
+	benchCHECK( pxWorker->xDone == pdFALSE );
+	benchCHECK( uxBarrierGetGeneration( xBarrier ) == 0 );
+
+	benchCHECK( xBarrierWait( xBarrier, portMAX_DELAY ) == barrierLAST_TO_ARRIVE );
+	benchCHECK( ( pxWorker->xDone != pdFALSE ) && ( pxWorker->uxPassed == 1 ) );
+	benchCHECK( uxBarrierGetGeneration( xBarrier ) == 1 );
+	printf( "  arrivals that timed out are withdrawn: ok\n" );
+	vTaskDelay( 2 );
+
+	/* A worker with a lower priority only arrives once this task waits, so
+	is the one to release the barrier. */
+	prvStartBarrierWorker( pxWorker, 1, benchCONTROL_PRIORITY - 1 );
+	benchCHECK( xBarrierWait( xBarrier, portMAX_DELAY ) == pdPASS );
+
+	while( pxWorker->xDone == pdFALSE )
+	{
+		vTaskDelay( 1 );
+	}
+
+	benchCHECK( ( pxWorker->uxLast == 1 ) && ( pxWorker->uxPassed == 0 ) && ( pxWorker->uxFailed == 0 ) );
+	benchCHECK( uxBarrierGetGeneration( xBarrier ) == 2 );
+
+	vTaskDelay( 2 );
+	vBarrierDelete( xBarrier );
+
+	printf( "  a waiting task is released by a later arrival: ok\n" );
+}
+/*-----------------------------------------------------------*/
+
+static void prvTimeBarrierRounds( UBaseType_t uxParticipants, BaseType_t xUseEventGroup )
+{
+BarrierHandle_t xBarrier = NULL;
+EventGroupHandle_t xGroup = NULL;
+EventBits_t uxAllBits = 0;
+uint64_t ullStart, ullTime;
+UBaseType_t x, uxRound;
+
+	if( xUseEventGroup == pdFALSE )
+	{
+		xBarrier = xBarrierCreate( uxParticipants );
+		benchCHECK( xBarrier != NULL );
+	}
+	else
+	{
+		xGroup = xEventGroupCreate();
+		benchCHECK( xGroup != NULL );
+		uxAllBits = ( ( EventBits_t ) 1 << uxParticipants ) - 1;
+	}
+
+	/* Bit 0 is this task's own. */
+	for( x = 0; x < ( uxParticipants - 1 ); x++ )
+	{
+		xBarrierWorkers[ x ].xBarrier = xBarrier;
+		xBarrierWorkers[ x ].xGroup = xGroup;
+		xBarrierWorkers[ x ].uxBit = ( EventBits_t ) 1 << ( x + 1 );
+		xBarrierWorkers[ x ].uxAllBits = uxAllBits;
+		prvStartBarrierWorker( &( xBarrierWorkers[ x ] ), benchBA_TIMED_ROUNDS, benchCONTROL_PRIORITY + 1 );
+	}
+
+	ullStart = ullBenchNow();
+
+	for( uxRound = 0; uxRound < benchBA_TIMED_ROUNDS; uxRound++ )
+	{
+		if( xBarrier != NULL )
+		{
+			benchCHECK( xBarrierWait( xBarrier, portMAX_DELAY ) == barrierLAST_TO_ARRIVE );
+		}
+		else
+		{
+			benchCHECK( ( xEventGroupSync( xGroup, 1, uxAllBits, portMAX_DELAY ) & uxAllBits ) == uxAllBits );
+		}
+	}
+
+	ullTime = ullBenchNow() - ullStart;
+
+	for( x = 0; x < ( uxParticipants - 1 ); x++ )
+	{
+		benchCHECK( xBarrierWorkers[ x ].xDone != pdFALSE );
+		benchCHECK( xBarrierWorkers[ x ].uxPassed == benchBA_TIMED_ROUNDS );
+	}
+
+	printf( "  %2u participants, %-17s %8.1f ns a round, %6.1f ns an arrival\n",
+			( unsigned ) uxParticipants,
+			( xBarrier != NULL ) ? "barrier:" : "event group sync:",
+			( double ) ullTime / ( double ) benchBA_TIMED_ROUNDS,
+			( double ) ullTime / ( double ) ( benchBA_TIMED_ROUNDS * uxParticipants ) );
+
+	/* Let the idle task free the workers. */
+	vTaskDelay( 2 );
+
+	if( xBarrier != NULL )
+	{
+		vBarrierDelete( xBarrier );
+	}
+	else
+	{
+		vEventGroupDelete( xGroup );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvStartBarrierWorker( BarrierWorker_t *pxWorker, UBaseType_t uxRounds, UBaseType_t uxPriority )
+{
+	pxWorker->uxRounds = uxRounds;
+	pxWorker->uxPassed = 0;
+	pxWorker->uxLast = 0;
+	pxWorker->uxFailed = 0;
+	pxWorker->xDone = pdFALSE;
+
+	benchCHECK( xTaskCreateStatic( prvBarrierWorkerTask, "Worker", benchSTACK_SIZE, pxWorker, uxPriority, pxWorker->xStack, &( pxWorker->xTCB ) ) != NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvBarrierWorkerTask( void *pvParameters )
+{
+BarrierWorker_t *pxWorker = ( BarrierWorker_t * ) pvParameters;
+BaseType_t xResult;
+UBaseType_t uxRound;
+
+	for( uxRound = 0; uxRound < pxWorker->uxRounds; uxRound++ )
+	{
+		if( pxWorker->xBarrier != NULL )
+		{
+			xResult = xBarrierWait( pxWorker->xBarrier, portMAX_DELAY );
+		}
+		else
+		{
+			xResult = ( ( xEventGroupSync( pxWorker->xGroup, pxWorker->uxBit, pxWorker->uxAllBits, portMAX_DELAY ) & pxWorker->uxAllBits ) == pxWorker->uxAllBits ) ? pdPASS : pdFAIL;
+		}
+
+		if( xResult == barrierLAST_TO_ARRIVE )
+		{
+			pxWorker->uxLast++;
+		}
+		else if( xResult == pdPASS )
+		{
+			pxWorker->uxPassed++;
+		}
+		else
+		{
+			pxWorker->uxFailed++;
+		}
+	}
+
+	pxWorker->xDone = pdTRUE;
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
@@ -43,6 +43,8 @@
 
 /* Standard includes. */
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Kernel includes. */
 #include "FreeRTOS.h"
@@ -50,6 +52,8 @@
 #include "timers.h"
 #include "semphr.h"
 
+#include "main_exercise.h"
+
 #define mainNUMBER_OF_SEMAPHORS (3)
 #define RESOURCE_NOT_NEEDED     (255)
 
@@ -59,7 +63,8 @@
 #define PRIORITY_CEILING_C  5
 
 #define DEFAULT 255
-#define NUM_TASKS 4
+#define NUM_TASKS exerciseMAX_TASKS
+#define SYS_TASK_INDEX NUM_TASKS // The "SYS" entry of taskList, which owns the floor of the system ceiling
 #define MAX_SEM_NESTING 4
 
 // Semaphore structure with priority ceiling
@@ -94,19 +99,21 @@ typedef struct {
     int stackTop;                           // Index of the top of the stack
     uint8_t priorityStack[MAX_SEM_NESTING]; // Stack to store priorities
     Semaphore_t* BlockedOnSemaphore;        // Semaphore that the task is blocked on due to priority ceiling 
+    uint16_t period;                        // Only used by task-set runs, in time units
+    uint16_t deadline;                      // Only used by task-set runs, in time units after each release
 }Task_t;
 
 //Array of Tasks
 //Index 0 = Task 1; Index 1 = Task 2; Index 2 = Task 3; Index 3 = Task 4
-Task_t taskList[5] = {
+Task_t taskList[NUM_TASKS + 1] = {
 	{"T1", 0, 5, 10, 5,RESOURCE_NOT_NEEDED, RESOURCE_NOT_NEEDED,1, 2, 3, 4, 5, 0, -1},
 	{"T2", 1, 4, 3, 7, 5, 6, RESOURCE_NOT_NEEDED, RESOURCE_NOT_NEEDED, 1, 3, 4, 0, -1},
 	{"T3", 2, 3, 5, 8, 3, 5, 2, 7, RESOURCE_NOT_NEEDED, RESOURCE_NOT_NEEDED, 3, 0, -1},
 	{"T4", 3, 2, 0, 9, 2, 8, 4, 6, RESOURCE_NOT_NEEDED, RESOURCE_NOT_NEEDED, 2, 0, -1},
-	{"SYS",4, 1, 0, 0, RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,1,0}
+	[SYS_TASK_INDEX] = {"SYS",SYS_TASK_INDEX, 1, 0, 0, RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,RESOURCE_NOT_NEEDED,1,0}
 };
 
-TaskHandle_t Tasks_Handle[4];
+TaskHandle_t Tasks_Handle[NUM_TASKS];
 
 Semaphore_t A;
 Semaphore_t B;
@@ -162,6 +169,25 @@ uint32_t getCurrentTimeInSeconds() {
 void main_exercise(void)
 {   
 
+    initializeSemaphores();
+
+    xTaskCreate(prvTask4, "Task4", CUSTOM_STACK_SIZE, (void*)&taskList[task4Index], taskList[task4Index].priority, &Tasks_Handle[task4Index]);
+    xTaskCreate(prvTask3, "Task3", configMINIMAL_STACK_SIZE, (void*)&taskList[task3Index], taskList[task3Index].priority, &Tasks_Handle[task3Index]);
+    xTaskCreate(prvTask2, "Task2", CUSTOM_STACK_SIZE, (void*)&taskList[task2Index], taskList[task2Index].priority, &Tasks_Handle[task2Index]);
+    xTaskCreate(prvTask1, "Task1", configMINIMAL_STACK_SIZE, (void*)&taskList[task1Index], taskList[task1Index].priority, &Tasks_Handle[task1Index]);
+
+    vTaskStartScheduler();
+    printf("After starting the scheduler (this point should not be reached)\n");
+
+    for (;;)
+    {
+        printf("Inside infinite loop (this point should not be reached)\n");
+    }
+}
+/*-----------------------------------------------------------*/
+
+void initializeSemaphores(void)
+{
     /*Initialization
     A mutex type semaphore that will be  used to control access to a shared resource, ensuring that only one task can access the resource at a time.*/
     A.resourceLock = xSemaphoreCreateMutex();
@@ -209,18 +235,446 @@ void main_exercise(void)
     {
         blockedSemaphoreTracker[i].isBlocked = 0;
     }
+}
+/*-----------------------------------------------------------*/
 
-    xTaskCreate(prvTask4, "Task4", CUSTOM_STACK_SIZE, (void*)&taskList[task4Index], taskList[task4Index].priority, &Tasks_Handle[task4Index]);
-    xTaskCreate(prvTask3, "Task3", configMINIMAL_STACK_SIZE, (void*)&taskList[task3Index], taskList[task3Index].priority, &Tasks_Handle[task3Index]);
-    xTaskCreate(prvTask2, "Task2", CUSTOM_STACK_SIZE, (void*)&taskList[task2Index], taskList[task2Index].priority, &Tasks_Handle[task2Index]);
-    xTaskCreate(prvTask1, "Task1", configMINIMAL_STACK_SIZE, (void*)&taskList[task1Index], taskList[task1Index].priority, &Tasks_Handle[task1Index]);
+/*
+ * Task-set runs.  Instead of the hand written tasks above, each task of a
+ * task set loaded by xExerciseLoadTaskSet() runs prvTaskSetTask(), which
+ * locks and unlocks the resources at the times given in its row of taskList
+ * and records the metrics returned by main_exercise_task_set().
+ */
+
+#define exerciseDEFAULT_TICKS_PER_UNIT	( 10U )
+#define exerciseSUPERVISOR_PRIORITY		( configMAX_PRIORITIES - 1 )
+
+static uint8_t numberOfTasks = NUM_TASKS;
+static TickType_t xTicksPerUnit = exerciseDEFAULT_TICKS_PER_UNIT;
+static TickType_t xHorizonUnits = 0;
+static ExerciseResult_t xTaskSetResult;
+
+/* The absolute deadline of the job each task is executing, 0 when idle. */
+static TickType_t xJobDeadline[ NUM_TASKS ];
+
+/* Written by the traceTASK_SWITCHED_IN() hook in FreeRTOSConfig.h. */
+static volatile uint32_t ulContextSwitches = 0;
+static void * volatile pvLastSwitchedIn = NULL;
+
+static void prvTaskSetTask( void *pvParameters );
+static void prvSupervisorTask( void *pvParameters );
+static void prvExecuteTicks( TickType_t xTicks );
+
+static void prvGetResourceTimes( const Task_t *task, int resource, uint8_t *lockTime, uint8_t *unlockTime )
+{
+    switch( resource )
+    {
+        case 0:  *lockTime = task->a_lock; *unlockTime = task->a_unlock; break;
+        case 1:  *lockTime = task->b_lock; *unlockTime = task->b_unlock; break;
+        default: *lockTime = task->c_lock; *unlockTime = task->c_unlock; break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+/* Parse a time in time units, or '-' for RESOURCE_NOT_NEEDED. */
+static BaseType_t prvParseTime( const char *pcToken, long lMaximum, long *plValue )
+{
+    char *pcEnd;
+
+    if( ( pcToken == NULL ) || ( strcmp( pcToken, "-" ) == 0 ) )
+    {
+        *plValue = RESOURCE_NOT_NEEDED;
+        return pdPASS;
+    }
+
+    *plValue = strtol( pcToken, &pcEnd, 10 );
+
+    return ( ( *pcEnd == '\0' ) && ( *plValue >= 0 ) && ( *plValue <= lMaximum ) ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xExerciseLoadTaskSet( const char *pcFileName, char *pcError, size_t xErrorLength )
+{
+    FILE *pxFile;
+    char cLine[ 256 ];
+    char *pcToken[ 13 ];
+    long lValue[ 11 ];
+    int iLine = 0;
+    int iTokens;
+    uint8_t ceiling[ mainNUMBER_OF_SEMAPHORS ] = { 1, 1, 1 };
+    TickType_t xLatestRelease = 0, xLongestPeriod = 0;
+
+    pxFile = fopen( pcFileName, "r" );
+
+    if( pxFile == NULL )
+    {
+        snprintf( pcError, xErrorLength, "cannot open %s", pcFileName );
+        return pdFAIL;
+    }
+
+    pcError[ 0 ] = '\0';
+    numberOfTasks = 0;
+    xTicksPerUnit = exerciseDEFAULT_TICKS_PER_UNIT;
+    xHorizonUnits = 0;
+
+    while( fgets( cLine, sizeof( cLine ), pxFile ) != NULL )
+    {
+        iLine++;
+        cLine[ strcspn( cLine, "#\r\n" ) ] = '\0';
+
+        for( iTokens = 0; iTokens < 13; iTokens++ )
+        {
+            pcToken[ iTokens ] = strtok( ( iTokens == 0 ) ? cLine : NULL, " \t" );
+
+            if( pcToken[ iTokens ] == NULL )
+            {
+                break;
+            }
+        }
+
+        if( iTokens == 0 )
+        {
+            continue;
+        }
+
+        if( ( strcmp( pcToken[ 0 ], "unit" ) == 0 ) || ( strcmp( pcToken[ 0 ], "horizon" ) == 0 ) )
+        {
+            if( ( iTokens != 2 ) || ( prvParseTime( pcToken[ 1 ], 1000000L, &lValue[ 0 ] ) != pdPASS ) || ( lValue[ 0 ] == 0 ) )
+            {
+                snprintf( pcError, xErrorLength, "%s:%d: expected '%s <positive number>'", pcFileName, iLine, pcToken[ 0 ] );
+                break;
+            }
+
+            if( pcToken[ 0 ][ 0 ] == 'u' )
+            {
+                xTicksPerUnit = ( TickType_t ) lValue[ 0 ];
+            }
+            else
+            {
+                xHorizonUnits = ( TickType_t ) lValue[ 0 ];
+            }
+
+            continue;
+        }
+
+        if( ( iTokens < 11 ) || ( iTokens > 12 ) )
+        {
+            snprintf( pcError, xErrorLength, "%s:%d: expected 11 or 12 fields", pcFileName, iLine );
+            break;
+        }
+
+        if( numberOfTasks == NUM_TASKS )
+        {
+            snprintf( pcError, xErrorLength, "%s:%d: more than %d tasks", pcFileName, iLine, NUM_TASKS );
+            break;
+        }
+
+        /* priority, release, exetime, 3 x (lock, unlock), period, deadline. */
+        int iField;
+        for( iField = 1; iField < 12; iField++ )
+        {
+            long lMaximum = ( iField == 1 ) ? ( exerciseSUPERVISOR_PRIORITY - 1 ) : ( iField >= 10 ) ? 65535L : 254L;
+
+            if( prvParseTime( ( iField < iTokens ) ? pcToken[ iField ] : NULL, lMaximum, &lValue[ iField - 1 ] ) != pdPASS )
+            {
+                break;
+            }
+        }
+
+        if( iField < 12 )
+        {
+            snprintf( pcError, xErrorLength, "%s:%d: field %d is not valid", pcFileName, iLine, iField + 1 );
+            break;
+        }
+
+        Task_t *task = &taskList[ numberOfTasks ];
+
+        memset( task, 0, sizeof( *task ) );
+        strncpy( task->TaskName, pcToken[ 0 ], sizeof( task->TaskName ) - 1 );
+        task->taskIndex = numberOfTasks;
+        task->priority = ( uint8_t ) lValue[ 0 ];
+        task->release = ( uint8_t ) lValue[ 1 ];
+        task->exetime = ( uint8_t ) lValue[ 2 ];
+        task->a_lock = ( uint8_t ) lValue[ 3 ];
+        task->a_unlock = ( uint8_t ) lValue[ 4 ];
+        task->b_lock = ( uint8_t ) lValue[ 5 ];
+        task->b_unlock = ( uint8_t ) lValue[ 6 ];
+        task->c_lock = ( uint8_t ) lValue[ 7 ];
+        task->c_unlock = ( uint8_t ) lValue[ 8 ];
+        task->period = ( uint16_t ) lValue[ 9 ];
+        task->deadline = ( lValue[ 10 ] == RESOURCE_NOT_NEEDED ) ? task->period : ( uint16_t ) lValue[ 10 ];
+        task->originalPriority = task->priority;
+        task->stackTop = -1;
+        task->BlockedOnSemaphore = NULL;
+
+        /* Priority 1 is the floor of the system ceiling, and a period is
+        needed to release more than one job. */
+        if( ( task->priority < 2 ) || ( task->release == RESOURCE_NOT_NEEDED ) || ( task->exetime == RESOURCE_NOT_NEEDED ) ||
+            ( lValue[ 9 ] == RESOURCE_NOT_NEEDED ) || ( task->period == 0 ) )
+        {
+            snprintf( pcError, xErrorLength, "%s:%d: priority must be 2 or more, and release, exetime and period are needed", pcFileName, iLine );
+            break;
+        }
+
+        /* The priority stack of usPrioritySemaphoreSignal() needs the
+        resources to be released in the reverse order to which they were
+        locked. */
+        int resource, other;
+        uint8_t lockTime, unlockTime, otherLock, otherUnlock;
+        for( resource = 0; resource < mainNUMBER_OF_SEMAPHORS; resource++ )
+        {
+            prvGetResourceTimes( task, resource, &lockTime, &unlockTime );
+
+            if( ( lockTime == RESOURCE_NOT_NEEDED ) != ( unlockTime == RESOURCE_NOT_NEEDED ) )
+            {
+                break;
+            }
+
+            if( lockTime == RESOURCE_NOT_NEEDED )
+            {
+                continue;
+            }
+
+            if( ( lockTime >= unlockTime ) || ( unlockTime > task->exetime ) )
+            {
+                break;
+            }
+
+            for( other = 0; other < resource; other++ )
+            {
+                prvGetResourceTimes( task, other, &otherLock, &otherUnlock );
+
+                if( ( otherLock != RESOURCE_NOT_NEEDED ) &&
+                    ( ( lockTime == otherLock ) || ( unlockTime == otherUnlock ) ||
+                      ( ( lockTime < otherLock ) && ( unlockTime > otherLock ) && ( unlockTime < otherUnlock ) ) ||
+                      ( ( otherLock < lockTime ) && ( otherUnlock > lockTime ) && ( otherUnlock < unlockTime ) ) ) )
+                {
+                    break;
+                }
+            }
+
+            if( other < resource )
+            {
+                break;
+            }
+
+            if( task->priority > ceiling[ resource ] )
+            {
+                ceiling[ resource ] = task->priority;
+            }
+        }
+
+        if( resource < mainNUMBER_OF_SEMAPHORS )
+        {
+            snprintf( pcError, xErrorLength, "%s:%d: resource %c is not locked and unlocked within the job in nested order", pcFileName, iLine, 'A' + resource );
+            break;
+        }
+
+        if( task->release > xLatestRelease )
+        {
+            xLatestRelease = task->release;
+        }
+
+        if( task->period > xLongestPeriod )
+        {
+            xLongestPeriod = task->period;
+        }
+
+        numberOfTasks++;
+    }
+
+    if( ferror( pxFile ) && ( pcError[ 0 ] == '\0' ) )
+    {
+        snprintf( pcError, xErrorLength, "%s: read error", pcFileName );
+    }
+
+    fclose( pxFile );
+
+    if( ( pcError[ 0 ] == '\0' ) && ( numberOfTasks == 0 ) )
+    {
+        snprintf( pcError, xErrorLength, "%s: no tasks", pcFileName );
+    }
+
+    if( pcError[ 0 ] != '\0' )
+    {
+        return pdFAIL;
+    }
+
+    A.priorityCeiling = ceiling[ 0 ];
+    B.priorityCeiling = ceiling[ 1 ];
+    C.priorityCeiling = ceiling[ 2 ];
+
+    if( xHorizonUnits == 0 )
+    {
+        xHorizonUnits = xLatestRelease + ( 2 * xLongestPeriod );
+    }
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void main_exercise_task_set( ExerciseResult_t *pxResult )
+{
+    uint8_t ceilingA = A.priorityCeiling, ceilingB = B.priorityCeiling, ceilingC = C.priorityCeiling;
+
+    /* initializeSemaphores() sets the ceilings of the built in task table, so
+    restore the ones calculated from the task set. */
+    initializeSemaphores();
+    A.priorityCeiling = A.elevatedPrioCeiling = ceilingA;
+    B.priorityCeiling = B.elevatedPrioCeiling = ceilingB;
+    C.priorityCeiling = C.elevatedPrioCeiling = ceilingC;
+
+    memset( &xTaskSetResult, 0, sizeof( xTaskSetResult ) );
+    xTaskSetResult.ulNumberOfTasks = numberOfTasks;
+
+    for( uint8_t i = 0; i < numberOfTasks; i++ )
+    {
+        strncpy( xTaskSetResult.xTasks[ i ].cName, taskList[ i ].TaskName, sizeof( xTaskSetResult.xTasks[ i ].cName ) - 1 );
+        xTaskCreate( prvTaskSetTask, taskList[ i ].TaskName, CUSTOM_STACK_SIZE, ( void * ) &taskList[ i ], taskList[ i ].priority, &Tasks_Handle[ i ] );
+    }
+
+    xTaskCreate( prvSupervisorTask, "Super", configMINIMAL_STACK_SIZE, NULL, exerciseSUPERVISOR_PRIORITY, NULL );
 
     vTaskStartScheduler();
-    printf("After starting the scheduler (this point should not be reached)\n");
 
-    for (;;)
+    /* Returns when prvSupervisorTask() ends the scheduler. */
+    xTaskSetResult.ulContextSwitches = ulContextSwitches;
+    *pxResult = xTaskSetResult;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskSetTask( void *pvParameters )
+{
+    Task_t *task = ( Task_t * ) pvParameters;
+    ExerciseTaskResult_t *result = &xTaskSetResult.xTasks[ task->taskIndex ];
+    TickType_t xLastWakeTime = 0;
+    TickType_t xJobRelease, xWaitStart, xElapsed;
+    Semaphore_t *semaphores[ mainNUMBER_OF_SEMAPHORS ] = { &A, &B, &C };
+    int held[ mainNUMBER_OF_SEMAPHORS ];
+    int heldCount, resource;
+    uint8_t lockTime, unlockTime, unit;
+
+    if( task->release > 0 )
     {
-        printf("Inside infinite loop (this point should not be reached)\n");
+        vTaskDelayUntil( &xLastWakeTime, task->release * xTicksPerUnit );
+    }
+
+    for( ;; )
+    {
+        xJobRelease = xLastWakeTime;
+        xJobDeadline[ task->taskIndex ] = xJobRelease + ( task->deadline * xTicksPerUnit );
+        heldCount = 0;
+
+        for( unit = 0; unit <= task->exetime; unit++ )
+        {
+            /* Release first, in the reverse order to locking. */
+            while( heldCount > 0 )
+            {
+                prvGetResourceTimes( task, held[ heldCount - 1 ], &lockTime, &unlockTime );
+
+                if( unlockTime != unit )
+                {
+                    break;
+                }
+
+                usPrioritySemaphoreSignal( semaphores[ held[ --heldCount ] ], task );
+            }
+
+            for( resource = 0; resource < mainNUMBER_OF_SEMAPHORS; resource++ )
+            {
+                prvGetResourceTimes( task, resource, &lockTime, &unlockTime );
+
+                if( lockTime == unit )
+                {
+                    xWaitStart = xTaskGetTickCount();
+                    usPrioritySemaphoreWait( semaphores[ resource ], task );
+                    xElapsed = xTaskGetTickCount() - xWaitStart;
+
+                    if( xElapsed > result->xMaxBlocking )
+                    {
+                        result->xMaxBlocking = xElapsed;
+                    }
+
+                    held[ heldCount++ ] = resource;
+                }
+            }
+
+            if( unit < task->exetime )
+            {
+                prvExecuteTicks( xTicksPerUnit );
+            }
+        }
+
+        xElapsed = xTaskGetTickCount() - xJobRelease;
+        result->ulJobs++;
+
+        if( xElapsed > result->xMaxResponse )
+        {
+            result->xMaxResponse = xElapsed;
+        }
+
+        if( xElapsed > ( TickType_t ) ( task->deadline * xTicksPerUnit ) )
+        {
+            result->ulDeadlineMisses++;
+        }
+
+        xJobDeadline[ task->taskIndex ] = 0;
+
+        vTaskDelayUntil( &xLastWakeTime, task->period * xTicksPerUnit );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSupervisorTask( void *pvParameters )
+{
+    TickType_t xLastWakeTime = 0;
+
+    ( void ) pvParameters;
+
+    vTaskDelayUntil( &xLastWakeTime, xHorizonUnits * xTicksPerUnit );
+
+    /* Jobs still running past their deadline at the horizon have missed it. */
+    for( uint8_t i = 0; i < numberOfTasks; i++ )
+    {
+        if( ( xJobDeadline[ i ] != 0 ) && ( xJobDeadline[ i ] < xLastWakeTime ) )
+        {
+            xTaskSetResult.xTasks[ i ].ulDeadlineMisses++;
+        }
+    }
+
+    xTaskSetResult.xSimulatedTicks = xLastWakeTime;
+
+    vTaskEndScheduler();
+
+    for( ;; );
+}
+/*-----------------------------------------------------------*/
+
+/* Busy for xTicks ticks of execution.  Ticks that pass while the task is
+preempted count as one, so the time spent executing is accurate to a tick
+per preemption. */
+static void prvExecuteTicks( TickType_t xTicks )
+{
+    TickType_t xLastTick = xTaskGetTickCount(), xNow;
+
+    while( xTicks > 0 )
+    {
+        xNow = xTaskGetTickCount();
+
+        if( xNow != xLastTick )
+        {
+            xLastTick = xNow;
+            xTicks--;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vExerciseTaskSwitchedIn( void *pvTask )
+{
+    if( pvTask != pvLastSwitchedIn )
+    {
+        pvLastSwitchedIn = pvTask;
+        ulContextSwitches++;
     }
 }
 /*-----------------------------------------------------------*/
@@ -513,7 +967,7 @@ UBaseType_t usPrioritySemaphoreWait(Semaphore_t *semaphore, Task_t *task)
 {  
     uint8_t restoredPriority = task->originalPriority;
     uint8_t lostPriority = DEFAULT;
-    boolean TaskCausedSysCeilFlg = pdFALSE;
+    BaseType_t TaskCausedSysCeilFlg = pdFALSE;
     uint8_t dummyVarForDebug = 4U;
 
     if (semaphore->resourceLock == NULL)                           // Check for valid semaphore
@@ -551,7 +1005,7 @@ UBaseType_t usPrioritySemaphoreWait(Semaphore_t *semaphore, Task_t *task)
             // If the stack is now empty, restore to the original priority
             restoredPriority = task->originalPriority;
             systemCeiling =  1U;
-		    sysCeilByTask =  4U;
+		    sysCeilByTask =  SYS_TASK_INDEX;
 		  
         }
     }
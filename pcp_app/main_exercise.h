@@ -0,0 +1,65 @@
+#ifndef MAIN_EXERCISE_H
+#define MAIN_EXERCISE_H
+
+#include "FreeRTOS.h"
+
+/* The most tasks a task-set description can hold (the built in task table of
+the ICPP exercise has four), and the number of resources. */
+#define exerciseMAX_TASKS		( 16 )
+#define exerciseMAX_RESOURCES	( 3 )
+
+/*
+ * Task-set descriptions run by main_exercise_task_set() are text files.
+ * Blank lines and anything following a '#' are ignored.  Each remaining line
+ * is either a setting:
+ *
+ *   unit <ticks>       Ticks in one time unit, default 10.
+ *   horizon <units>    Time units to simulate, default the latest release
+ *                      plus two of the longest period.
+ *
+ * or a task, with all times in time units and '-' for a resource that is not
+ * used:
+ *
+ *   <name> <priority> <release> <exetime> <A lock> <A unlock> <B lock>
+ *          <B unlock> <C lock> <C unlock> <period> [<deadline>]
+ *
+ * Lock and unlock times count the time units the task has executed in the
+ * current job, as in the task table of main_exercise.c.  Resources must be
+ * locked and unlocked in nested order.  The deadline is relative to each
+ * release and defaults to the period.  The ceiling of each resource is the
+ * highest priority of the tasks that lock it.
+ */
+
+/* Metrics for one task of a task-set run. */
+typedef struct ExerciseTaskResult
+{
+	char cName[ 5 ];
+	uint32_t ulJobs;				/* Jobs completed. */
+	uint32_t ulDeadlineMisses;		/* Jobs that completed, or were still running at the horizon, after their deadline. */
+	TickType_t xMaxBlocking;		/* Longest time spent in one call to usPrioritySemaphoreWait(). */
+	TickType_t xMaxResponse;		/* Longest time from release to completion of a job. */
+} ExerciseTaskResult_t;
+
+/* Metrics for one task-set run. */
+typedef struct ExerciseResult
+{
+	uint32_t ulNumberOfTasks;
+	uint32_t ulContextSwitches;
+	TickType_t xSimulatedTicks;
+	ExerciseTaskResult_t xTasks[ exerciseMAX_TASKS ];
+} ExerciseResult_t;
+
+/*
+ * Load the task-set description pcFileName in place of the built in task
+ * table.  Returns pdFAIL, with a message in pcError, if the file cannot be read
+ * or is not valid.
+ */
+BaseType_t xExerciseLoadTaskSet( const char *pcFileName, char *pcError, size_t xErrorLength );
+
+/*
+ * Run the loaded task set until its horizon, then end the scheduler and
+ * return the metrics in pxResult.  Can only be called once per process.
+ */
+void main_exercise_task_set( ExerciseResult_t *pxResult );
+
+#endif /* MAIN_EXERCISE_H */
@@ -0,0 +1,331 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "barrier.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include barrier functionality.  This #if is closed at the very bottom of
+ * this file.  If you want to include barriers then ensure configUSE_BARRIERS is
+ * set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_BARRIERS == 1 )
+
+/*
+ * Every member is only accessed with the scheduler suspended.  Arriving at the
+ * barrier increments uxArrived and, unless the calling task is the last of the
+ * participants to arrive, appends the task to the end of xTasksWaitingToLeave,
+ * so an arrival is constant time however many tasks are already waiting.  The
+ * last task to arrive starts a new generation and readies every waiting task in
+ * a single pass of the list.  A task that wakes finds it was released, rather
+ * than timed out, by seeing that the generation has moved on from the one it
+ * arrived in.
+ */
+    typedef struct BarrierDefinition
+    {
+        UBaseType_t uxParticipants;     /**< The number of tasks that must arrive to release the barrier. */
+        UBaseType_t uxArrived;          /**< The number of tasks that have arrived in the current generation. */
+        UBaseType_t uxGeneration;       /**< Incremented each time the barrier is released. */
+        List_t xTasksWaitingToLeave;    /**< Tasks blocked at the barrier, in the order they arrived. */
+        uint8_t ucStaticallyAllocated;  /**< Set to pdTRUE if the barrier was created by xBarrierCreateStatic(). */
+    } Barrier_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by both the create functions to initialise a new barrier.
+ */
+    static void prvInitialiseNewBarrier( Barrier_t * const pxBarrier,
+                                         UBaseType_t uxParticipants ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by the last task to arrive.  Starts a new generation and readies every
+ * task waiting at the barrier.  Must be called with the scheduler suspended.
+ */
+    static void prvReleaseBarrier( Barrier_t * const pxBarrier ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        BarrierHandle_t xBarrierCreate( UBaseType_t uxParticipants )
+        {
+            Barrier_t * pxNewBarrier = NULL;
+
+            configASSERT( uxParticipants > ( UBaseType_t ) 0 );
+
+            if( uxParticipants > ( UBaseType_t ) 0 )
+            {
+                pxNewBarrier = ( Barrier_t * ) pvPortMalloc( sizeof( Barrier_t ) ); /*lint !e9087 !e9079 Barrier_t is the real type of the allocated memory. */
+
+                if( pxNewBarrier != NULL )
+                {
+                    prvInitialiseNewBarrier( pxNewBarrier, uxParticipants );
+                    pxNewBarrier->ucStaticallyAllocated = pdFALSE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewBarrier;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        BarrierHandle_t xBarrierCreateStatic( UBaseType_t uxParticipants,
+                                              StaticBarrier_t * pxBarrierBuffer )
+        {
+            Barrier_t * pxNewBarrier = NULL;
+
+            configASSERT( uxParticipants > ( UBaseType_t ) 0 );
+            configASSERT( pxBarrierBuffer );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticBarrier_t equals the size of the real
+                 * barrier structure. */
+                volatile size_t xSize = sizeof( StaticBarrier_t );
+                configASSERT( xSize == sizeof( Barrier_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( ( uxParticipants > ( UBaseType_t ) 0 ) && ( pxBarrierBuffer != NULL ) )
+            {
+                pxNewBarrier = ( Barrier_t * ) pxBarrierBuffer; /*lint !e740 !e9087 Barrier_t and StaticBarrier_t are deliberately aliased, and checked by an assert. */
+                prvInitialiseNewBarrier( pxNewBarrier, uxParticipants );
+                pxNewBarrier->ucStaticallyAllocated = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewBarrier;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vBarrierDelete( BarrierHandle_t xBarrier )
+    {
+        Barrier_t * pxBarrier = xBarrier;
+
+        configASSERT( pxBarrier );
+        configASSERT( listLIST_IS_EMPTY( &( pxBarrier->xTasksWaitingToLeave ) ) != pdFALSE );
+
+        if( pxBarrier->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                vPortFree( ( void * ) pxBarrier );
+            }
+            #endif
+        }
+        else
+        {
+            /* The structure was not allocated dynamically and cannot be freed -
+             * just scrub it so future use will assert. */
+            ( void ) memset( ( void * ) pxBarrier, 0x00, sizeof( Barrier_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xBarrierWait( BarrierHandle_t xBarrier,
+                             TickType_t xTicksToWait )
+    {
+        Barrier_t * const pxBarrier = xBarrier;
+        BaseType_t xReturn;
+        UBaseType_t uxGeneration;
+        TimeOut_t xTimeOut;
+
+        configASSERT( pxBarrier );
+        configASSERT( pxBarrier->uxParticipants > ( UBaseType_t ) 0 );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        vTaskSuspendAll();
+        {
+            uxGeneration = pxBarrier->uxGeneration;
+
+            if( ( pxBarrier->uxArrived + ( UBaseType_t ) 1 ) >= pxBarrier->uxParticipants )
+            {
+                /* The calling task is the last to arrive, so releases the
+                 * others and continues without blocking. */
+                prvReleaseBarrier( pxBarrier );
+                xReturn = barrierLAST_TO_ARRIVE;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The other participants have not all arrived and the calling
+                 * task cannot wait for them, so it does not count as having
+                 * arrived. */
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                /* The tick count cannot change while the scheduler is
+                 * suspended. */
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                ( pxBarrier->uxArrived )++;
+
+                for( ; ; )
+                {
+                    /* Appending to an unordered list does not depend on how
+                     * many tasks are already waiting. */
+                    vTaskPlaceOnUnorderedEventList( &( pxBarrier->xTasksWaitingToLeave ), ( TickType_t ) 0, xTicksToWait );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    vTaskSuspendAll();
+
+                    if( pxBarrier->uxGeneration != uxGeneration )
+                    {
+                        /* Released.  The remaining participants cannot complete
+                         * another generation without the calling task, so the
+                         * generation has moved on by exactly one. */
+                        xReturn = pdPASS;
+                        break;
+                    }
+                    else if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) != pdFALSE )
+                    {
+                        /* Timed out, or the delay was aborted, before the last
+                         * participant arrived.  The task has already been
+                         * removed from xTasksWaitingToLeave, so only its
+                         * arrival has to be withdrawn. */
+                        ( pxBarrier->uxArrived )--;
+                        xReturn = pdFAIL;
+                        break;
+                    }
+                    else
+                    {
+                        /* Woken for another reason - wait again for the time
+                         * remaining. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+
+                /* The unordered event list overwrote the event list item value,
+                 * which holds the task's priority while it is not waiting on an
+                 * unordered event list. */
+                ( void ) uxTaskResetEventItemValue();
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxBarrierGetGeneration( BarrierHandle_t xBarrier )
+    {
+        Barrier_t const * const pxBarrier = xBarrier;
+        UBaseType_t uxReturn;
+
+        configASSERT( pxBarrier );
+
+        vTaskSuspendAll();
+        {
+            uxReturn = pxBarrier->uxGeneration;
+        }
+        ( void ) xTaskResumeAll();
+
+        return uxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewBarrier( Barrier_t * const pxBarrier,
+                                         UBaseType_t uxParticipants )
+    {
+        pxBarrier->uxParticipants = uxParticipants;
+        pxBarrier->uxArrived = ( UBaseType_t ) 0;
+        pxBarrier->uxGeneration = ( UBaseType_t ) 0;
+        vListInitialise( &( pxBarrier->xTasksWaitingToLeave ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvReleaseBarrier( Barrier_t * const pxBarrier )
+    {
+        List_t const * const pxList = &( pxBarrier->xTasksWaitingToLeave );
+
+        /* Start the new generation before any waiting task can run, so every
+         * task that arrives from now on waits for the next release. */
+        ( pxBarrier->uxGeneration )++;
+        pxBarrier->uxArrived = ( UBaseType_t ) 0;
+
+        /* A task that has timed out but not yet run is no longer in the list,
+         * but is still counted in uxArrived, so it finds the generation has
+         * moved on and is released with the others. */
+        while( listLIST_IS_EMPTY( pxList ) == pdFALSE )
+        {
+            vTaskRemoveFromUnorderedEventList( listGET_HEAD_ENTRY( pxList ), ( TickType_t ) 0 );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include barrier functionality.  If you want to include barriers then
+ * ensure configUSE_BARRIERS is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_BARRIERS == 1 */
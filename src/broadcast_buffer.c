@@ -0,0 +1,929 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "broadcast_buffer.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include broadcast buffer functionality.  This #if is closed at the very
+ * bottom of this file.  If you want to include broadcast buffers then ensure
+ * configUSE_BROADCAST_BUFFERS is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_BROADCAST_BUFFERS == 1 )
+
+    #include <stdatomic.h>
+
+/* Bits used in the ucFlags member of a subscriber. */
+    #define bbFLAGS_DROP_OLDEST             ( ( uint8_t ) 1 ) /* Set if the subscriber's policy is eBroadcastDropOldest. */
+    #define bbFLAGS_STATICALLY_ALLOCATED    ( ( uint8_t ) 2 ) /* Set if the subscriber was created by xBroadcastBufferSubscribeStatic(). */
+
+/*
+ * Messages are stored one after another, each preceded by its length and its
+ * sequence number.  Positions run from 0 to xWrap - 1, where xWrap is the
+ * largest multiple of xLength that fits in a size_t, and the byte a position
+ * refers to is the position modulo xLength, as in MRMW stream buffers.
+ *
+ * The writer owns xHead, the end of the newest message, and xTail, the start of
+ * the oldest.  Each subscriber owns xCursor, the start of the next message it
+ * will receive.  To make space the writer discards messages from the tail, but
+ * never past the cursor of an eBroadcastBlockWriter subscriber.  Finding the
+ * slowest of those means scanning the subscribers, so the writer remembers the
+ * result in xReclaimLimit - cursors only move forward, so it stays safe to
+ * discard up to it - and only scans again once the tail reaches it.
+ *
+ * An eBroadcastDropOldest subscriber's cursor can be left behind the tail, in
+ * which case it continues from the tail, and a message can be discarded and
+ * overwritten while such a subscriber is copying it out.  The writer therefore
+ * publishes the new tail before overwriting anything, and a subscriber checks
+ * the tail again after copying a message, copying again from the new tail if
+ * its message was discarded.  The gap in the sequence numbers of the messages
+ * it does receive gives the number it missed.
+ *
+ * The subscriber list and event lists are only changed with the scheduler
+ * suspended.  A task that cannot proceed checks again with the scheduler
+ * suspended before it blocks, and the task that lets it proceed checks the
+ * event list after doing so, so one of them always sees the other's change.
+ */
+    typedef struct BroadcastBufferDefinition
+    {
+        uint8_t * pucBuffer;           /**< The storage area. */
+        size_t xLength;                /**< The size of the storage area. */
+        size_t xWrap;                  /**< The position at which positions return to zero. */
+        atomic_size_t xHead;           /**< The end of the newest message. */
+        atomic_size_t xTail;           /**< The start of the oldest message. */
+        size_t xReclaimLimit;          /**< The writer can discard messages up to this position without checking the subscribers. */
+        UBaseType_t uxNextSequence;    /**< The sequence number of the next message written. */
+        List_t xSubscribers;           /**< All the subscribers. */
+        List_t xTasksWaitingToReceive; /**< Subscriber tasks waiting for a message. */
+        List_t xTasksWaitingToSend;    /**< The writer, if it is waiting for eBroadcastBlockWriter subscribers. */
+        uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the buffer was created by xBroadcastBufferCreateStatic(). */
+    } BroadcastBuffer_t;
+
+    typedef struct BroadcastSubscriberDefinition
+    {
+        ListItem_t xSubscriberListItem; /**< Links the subscriber into its buffer's xSubscribers list. */
+        BroadcastBuffer_t * pxBuffer;   /**< The buffer subscribed to. */
+        atomic_size_t xCursor;          /**< The start of the next message to receive. */
+        UBaseType_t uxNextSequence;     /**< The sequence number expected next. */
+        UBaseType_t uxOverflowCount;    /**< The number of messages missed. */
+        uint8_t ucFlags;                /**< bbFLAGS_... bits. */
+    } BroadcastSubscriber_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by both the create functions to initialise a new buffer, and by both
+ * the subscribe functions to initialise and add a new subscriber.
+ */
+    static void prvInitialiseNewBroadcastBuffer( BroadcastBuffer_t * const pxBuffer,
+                                                 uint8_t * const pucStorage,
+                                                 size_t xBufferSizeBytes ) PRIVILEGED_FUNCTION;
+    static void prvAddSubscriber( BroadcastBuffer_t * const pxBuffer,
+                                  BroadcastSubscriber_t * const pxSubscriber,
+                                  eBroadcastOverflowPolicy ePolicy ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the position xCount bytes after xPosition, and the number of bytes
+ * from xFrom to xTo.
+ */
+    static size_t prvAdvance( const BroadcastBuffer_t * const pxBuffer,
+                              size_t xPosition,
+                              size_t xCount ) PRIVILEGED_FUNCTION;
+    static size_t prvBytesBetween( const BroadcastBuffer_t * const pxBuffer,
+                                   size_t xFrom,
+                                   size_t xTo ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copy xCount bytes into or out of the storage area starting at xPosition,
+ * wrapping back to the start of the storage area if necessary.  Both return the
+ * position after the last byte copied.
+ */
+    static size_t prvWriteBytes( BroadcastBuffer_t * const pxBuffer,
+                                 size_t xPosition,
+                                 const void * pvData,
+                                 size_t xCount ) PRIVILEGED_FUNCTION;
+    static size_t prvReadBytes( const BroadcastBuffer_t * const pxBuffer,
+                                size_t xPosition,
+                                void * pvData,
+                                size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Discard messages from the tail until there are xRequired bytes free.  Returns
+ * pdFALSE if an eBroadcastBlockWriter subscriber has not received the oldest
+ * message, so it cannot be discarded.
+ */
+    static BaseType_t prvMakeSpace( BroadcastBuffer_t * const pxBuffer,
+                                    size_t xRequired ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the cursor of the eBroadcastBlockWriter subscriber furthest behind
+ * xTail, or the head if there are none.
+ */
+    static size_t prvSlowestCursor( BroadcastBuffer_t * const pxBuffer,
+                                    size_t xTail ) PRIVILEGED_FUNCTION;
+
+/*
+ * If there is a message for pxSubscriber return pdTRUE and set *pxCursor to its
+ * position, which is the tail if the subscriber has fallen behind it.
+ */
+    static BaseType_t prvNextMessage( const BroadcastSubscriber_t * const pxSubscriber,
+                                      size_t * const pxCursor ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock every task in pxEventList, to try again.
+ */
+    static void prvUnblockAll( List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        BroadcastBufferHandle_t xBroadcastBufferCreate( size_t xBufferSizeBytes )
+        {
+            BroadcastBuffer_t * pxNewBuffer = NULL;
+
+            configASSERT( xBufferSizeBytes > broadcastBYTES_PER_MESSAGE );
+
+            /* Check there is room for a message, that positions can run over at
+             * least two laps, and for addition overflow. */
+            if( ( xBufferSizeBytes > broadcastBYTES_PER_MESSAGE ) &&
+                ( xBufferSizeBytes <= ( SIZE_MAX / 2U ) ) &&
+                ( ( SIZE_MAX - sizeof( BroadcastBuffer_t ) ) >= xBufferSizeBytes ) )
+            {
+                /* The structure and the storage area are allocated in one block,
+                 * the storage area immediately after the structure. */
+                pxNewBuffer = ( BroadcastBuffer_t * ) pvPortMalloc( sizeof( BroadcastBuffer_t ) + xBufferSizeBytes ); /*lint !e9087 !e9079 see comment above. */
+
+                if( pxNewBuffer != NULL )
+                {
+                    prvInitialiseNewBroadcastBuffer( pxNewBuffer, ( ( uint8_t * ) pxNewBuffer ) + sizeof( BroadcastBuffer_t ), xBufferSizeBytes ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+                    pxNewBuffer->ucStaticallyAllocated = pdFALSE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewBuffer;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        BroadcastBufferHandle_t xBroadcastBufferCreateStatic( size_t xBufferSizeBytes,
+                                                              uint8_t * pucStorage,
+                                                              StaticBroadcastBuffer_t * pxStaticBuffer )
+        {
+            BroadcastBuffer_t * pxNewBuffer = NULL;
+
+            configASSERT( pucStorage );
+            configASSERT( pxStaticBuffer );
+            configASSERT( xBufferSizeBytes > broadcastBYTES_PER_MESSAGE );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticBroadcastBuffer_t equals the size of the
+                 * real buffer structure. */
+                volatile size_t xSize = sizeof( StaticBroadcastBuffer_t );
+                configASSERT( xSize == sizeof( BroadcastBuffer_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( ( pucStorage != NULL ) &&
+                ( pxStaticBuffer != NULL ) &&
+                ( xBufferSizeBytes > broadcastBYTES_PER_MESSAGE ) &&
+                ( xBufferSizeBytes <= ( SIZE_MAX / 2U ) ) )
+            {
+                pxNewBuffer = ( BroadcastBuffer_t * ) pxStaticBuffer; /*lint !e740 !e9087 BroadcastBuffer_t and StaticBroadcastBuffer_t are deliberately aliased, and checked by an assert. */
+                prvInitialiseNewBroadcastBuffer( pxNewBuffer, pucStorage, xBufferSizeBytes );
+                pxNewBuffer->ucStaticallyAllocated = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewBuffer;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vBroadcastBufferDelete( BroadcastBufferHandle_t xBuffer )
+    {
+        BroadcastBuffer_t * pxBuffer = xBuffer;
+
+        configASSERT( pxBuffer );
+        configASSERT( listLIST_IS_EMPTY( &( pxBuffer->xSubscribers ) ) != pdFALSE );
+        configASSERT( listLIST_IS_EMPTY( &( pxBuffer->xTasksWaitingToSend ) ) != pdFALSE );
+
+        if( pxBuffer->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                /* Both the structure and the storage area were allocated using
+                 * a single call to pvPortMalloc(), hence only one call to
+                 * vPortFree() is required. */
+                vPortFree( ( void * ) pxBuffer );
+            }
+            #endif
+        }
+        else
+        {
+            /* The structure and storage area were not allocated dynamically and
+             * cannot be freed - just scrub the structure so future use will
+             * assert. */
+            ( void ) memset( ( void * ) pxBuffer, 0x00, sizeof( BroadcastBuffer_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        BroadcastSubscriberHandle_t xBroadcastBufferSubscribe( BroadcastBufferHandle_t xBuffer,
+                                                               eBroadcastOverflowPolicy ePolicy )
+        {
+            BroadcastSubscriber_t * pxNewSubscriber;
+
+            configASSERT( xBuffer );
+
+            pxNewSubscriber = ( BroadcastSubscriber_t * ) pvPortMalloc( sizeof( BroadcastSubscriber_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the subscriber structure. */
+
+            if( pxNewSubscriber != NULL )
+            {
+                pxNewSubscriber->ucFlags = 0;
+                prvAddSubscriber( xBuffer, pxNewSubscriber, ePolicy );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewSubscriber;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        BroadcastSubscriberHandle_t xBroadcastBufferSubscribeStatic( BroadcastBufferHandle_t xBuffer,
+                                                                     eBroadcastOverflowPolicy ePolicy,
+                                                                     StaticBroadcastSubscriber_t * pxStaticSubscriber )
+        {
+            BroadcastSubscriber_t * pxNewSubscriber = NULL;
+
+            configASSERT( xBuffer );
+            configASSERT( pxStaticSubscriber );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticBroadcastSubscriber_t equals the size of
+                 * the real subscriber structure. */
+                volatile size_t xSize = sizeof( StaticBroadcastSubscriber_t );
+                configASSERT( xSize == sizeof( BroadcastSubscriber_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( pxStaticSubscriber != NULL )
+            {
+                pxNewSubscriber = ( BroadcastSubscriber_t * ) pxStaticSubscriber; /*lint !e740 !e9087 BroadcastSubscriber_t and StaticBroadcastSubscriber_t are deliberately aliased, and checked by an assert. */
+                pxNewSubscriber->ucFlags = bbFLAGS_STATICALLY_ALLOCATED;
+                prvAddSubscriber( xBuffer, pxNewSubscriber, ePolicy );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewSubscriber;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vBroadcastBufferUnsubscribe( BroadcastSubscriberHandle_t xSubscriber )
+    {
+        BroadcastSubscriber_t * const pxSubscriber = xSubscriber;
+        BroadcastBuffer_t * pxBuffer;
+
+        configASSERT( pxSubscriber );
+
+        pxBuffer = pxSubscriber->pxBuffer;
+
+        vTaskSuspendAll();
+        {
+            ( void ) uxListRemove( &( pxSubscriber->xSubscriberListItem ) );
+        }
+        ( void ) xTaskResumeAll();
+
+        /* The writer may have been waiting for this subscriber. */
+        prvUnblockAll( &( pxBuffer->xTasksWaitingToSend ) );
+
+        if( ( pxSubscriber->ucFlags & bbFLAGS_STATICALLY_ALLOCATED ) == 0U )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                vPortFree( ( void * ) pxSubscriber );
+            }
+            #endif
+        }
+        else
+        {
+            ( void ) memset( ( void * ) pxSubscriber, 0x00, sizeof( BroadcastSubscriber_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xBroadcastBufferSend( BroadcastBufferHandle_t xBuffer,
+                                 const void * pvTxData,
+                                 size_t xDataLengthBytes,
+                                 TickType_t xTicksToWait )
+    {
+        BroadcastBuffer_t * const pxBuffer = xBuffer;
+        size_t xRequired, xHead, xReturn = 0;
+        BaseType_t xHaveSpace = pdFALSE, xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+
+        configASSERT( pxBuffer );
+        configASSERT( pvTxData );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /* A message larger than the buffer could never fit, so don't wait for
+         * space.  Written so as not to overflow. */
+        if( ( xDataLengthBytes != ( size_t ) 0 ) && ( xDataLengthBytes <= ( pxBuffer->xLength - broadcastBYTES_PER_MESSAGE ) ) )
+        {
+            xRequired = xDataLengthBytes + broadcastBYTES_PER_MESSAGE;
+            xHaveSpace = prvMakeSpace( pxBuffer, xRequired );
+
+            while( ( xHaveSpace == pdFALSE ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+            {
+                vTaskSuspendAll();
+                {
+                    /* Try again now a subscriber cannot receive without seeing
+                     * this task in the event list. */
+                    xHaveSpace = prvMakeSpace( pxBuffer, xRequired );
+
+                    if( xHaveSpace != pdFALSE )
+                    {
+                        ( void ) xTaskResumeAll();
+                        break;
+                    }
+
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The tick count cannot change while the scheduler is
+                         * suspended. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                    {
+                        vTaskPlaceOnEventList( &( pxBuffer->xTasksWaitingToSend ), xTicksToWait );
+                    }
+                    else
+                    {
+                        ( void ) xTaskResumeAll();
+                        break;
+                    }
+                }
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xHaveSpace != pdFALSE )
+        {
+            xHead = atomic_load_explicit( &( pxBuffer->xHead ), memory_order_relaxed );
+            xHead = prvWriteBytes( pxBuffer, xHead, &xDataLengthBytes, sizeof( xDataLengthBytes ) );
+            xHead = prvWriteBytes( pxBuffer, xHead, &( pxBuffer->uxNextSequence ), sizeof( pxBuffer->uxNextSequence ) );
+            xHead = prvWriteBytes( pxBuffer, xHead, pvTxData, xDataLengthBytes );
+
+            /* Publish the message, then wake every subscriber waiting for it.
+             * The sequence number is moved on first - see prvAddSubscriber(). */
+            pxBuffer->uxNextSequence++;
+            atomic_store_explicit( &( pxBuffer->xHead ), xHead, memory_order_release );
+            prvUnblockAll( &( pxBuffer->xTasksWaitingToReceive ) );
+
+            xReturn = xDataLengthBytes;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xBroadcastBufferReceive( BroadcastSubscriberHandle_t xSubscriber,
+                                    void * pvRxData,
+                                    size_t xBufferLengthBytes,
+                                    TickType_t xTicksToWait )
+    {
+        BroadcastSubscriber_t * const pxSubscriber = xSubscriber;
+        BroadcastBuffer_t * pxBuffer;
+        size_t xCursor = 0, xNext, xLength = 0, xReturn = 0;
+        UBaseType_t uxSequence = 0;
+        BaseType_t xHaveMessage = pdFALSE, xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+
+        configASSERT( pxSubscriber );
+        configASSERT( pvRxData );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        pxBuffer = pxSubscriber->pxBuffer;
+
+        for( ; ; )
+        {
+            xHaveMessage = prvNextMessage( pxSubscriber, &xCursor );
+
+            if( xHaveMessage == pdFALSE )
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    break;
+                }
+
+                vTaskSuspendAll();
+                {
+                    /* Check again now the writer cannot publish a message
+                     * without seeing this task in the event list. */
+                    if( prvNextMessage( pxSubscriber, &xCursor ) != pdFALSE )
+                    {
+                        ( void ) xTaskResumeAll();
+                        continue;
+                    }
+
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The tick count cannot change while the scheduler is
+                         * suspended. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                    {
+                        vTaskPlaceOnEventList( &( pxBuffer->xTasksWaitingToReceive ), xTicksToWait );
+                    }
+                    else
+                    {
+                        ( void ) xTaskResumeAll();
+                        break;
+                    }
+                }
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                continue;
+            }
+
+            /* Copy the message out.  The length is not trusted until the copy
+             * has been checked, so only copy the body if it could be real and
+             * fits. */
+            xNext = prvReadBytes( pxBuffer, xCursor, &xLength, sizeof( xLength ) );
+            xNext = prvReadBytes( pxBuffer, xNext, &uxSequence, sizeof( uxSequence ) );
+
+            if( ( xLength <= xBufferLengthBytes ) && ( xLength <= ( pxBuffer->xLength - broadcastBYTES_PER_MESSAGE ) ) )
+            {
+                xNext = prvReadBytes( pxBuffer, xNext, pvRxData, xLength );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* If the tail has not passed the message it was not overwritten
+             * while it was being copied.  Otherwise start again from the new
+             * tail. */
+            atomic_thread_fence( memory_order_acquire );
+
+            if( prvBytesBetween( pxBuffer, atomic_load_explicit( &( pxBuffer->xTail ), memory_order_relaxed ), xCursor ) <= pxBuffer->xLength )
+            {
+                break;
+            }
+        }
+
+        if( xHaveMessage != pdFALSE )
+        {
+            if( xLength <= xBufferLengthBytes )
+            {
+                /* Only the first message received can be one behind the
+                 * expected sequence number - see prvAddSubscriber(). */
+                if( uxSequence != ( pxSubscriber->uxNextSequence - ( UBaseType_t ) 1 ) )
+                {
+                    pxSubscriber->uxOverflowCount += uxSequence - pxSubscriber->uxNextSequence;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxSubscriber->uxNextSequence = uxSequence + ( UBaseType_t ) 1;
+                xReturn = xLength;
+            }
+            else
+            {
+                /* As with message buffers, leave a message that does not fit
+                 * for a later call. */
+                xNext = xCursor;
+            }
+
+            atomic_store_explicit( &( pxSubscriber->xCursor ), xNext, memory_order_release );
+
+            if( ( pxSubscriber->ucFlags & bbFLAGS_DROP_OLDEST ) == 0U )
+            {
+                /* The writer may be waiting for this subscriber. */
+                prvUnblockAll( &( pxBuffer->xTasksWaitingToSend ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxBroadcastBufferGetOverflowCount( BroadcastSubscriberHandle_t xSubscriber )
+    {
+        const BroadcastSubscriber_t * const pxSubscriber = xSubscriber;
+
+        configASSERT( pxSubscriber );
+
+        return pxSubscriber->uxOverflowCount;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewBroadcastBuffer( BroadcastBuffer_t * const pxBuffer,
+                                                 uint8_t * const pucStorage,
+                                                 size_t xBufferSizeBytes )
+    {
+        pxBuffer->pucBuffer = pucStorage;
+        pxBuffer->xLength = xBufferSizeBytes;
+        pxBuffer->xWrap = ( SIZE_MAX / xBufferSizeBytes ) * xBufferSizeBytes;
+        atomic_init( &( pxBuffer->xHead ), ( size_t ) 0 );
+        atomic_init( &( pxBuffer->xTail ), ( size_t ) 0 );
+        pxBuffer->xReclaimLimit = 0;
+        pxBuffer->uxNextSequence = 0;
+        vListInitialise( &( pxBuffer->xSubscribers ) );
+        vListInitialise( &( pxBuffer->xTasksWaitingToReceive ) );
+        vListInitialise( &( pxBuffer->xTasksWaitingToSend ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvAddSubscriber( BroadcastBuffer_t * const pxBuffer,
+                                  BroadcastSubscriber_t * const pxSubscriber,
+                                  eBroadcastOverflowPolicy ePolicy )
+    {
+        vListInitialiseItem( &( pxSubscriber->xSubscriberListItem ) );
+        listSET_LIST_ITEM_OWNER( &( pxSubscriber->xSubscriberListItem ), pxSubscriber );
+        pxSubscriber->pxBuffer = pxBuffer;
+        pxSubscriber->uxOverflowCount = 0;
+
+        if( ePolicy == eBroadcastDropOldest )
+        {
+            pxSubscriber->ucFlags |= bbFLAGS_DROP_OLDEST;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        vTaskSuspendAll();
+        {
+            /* Start at the head, which is never behind the writer's reclaim
+             * limit, so the limit stays safe.  The writer can have been
+             * preempted after moving on the sequence number but before
+             * publishing its message, in which case the first message received
+             * is one before the sequence number read here. */
+            atomic_init( &( pxSubscriber->xCursor ), atomic_load_explicit( &( pxBuffer->xHead ), memory_order_relaxed ) );
+            pxSubscriber->uxNextSequence = pxBuffer->uxNextSequence;
+            vListInsertEnd( &( pxBuffer->xSubscribers ), &( pxSubscriber->xSubscriberListItem ) );
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvAdvance( const BroadcastBuffer_t * const pxBuffer,
+                              size_t xPosition,
+                              size_t xCount )
+    {
+        size_t xReturn;
+
+        /* Written so as not to overflow, as xWrap can be close to SIZE_MAX. */
+        if( xCount >= ( pxBuffer->xWrap - xPosition ) )
+        {
+            xReturn = xCount - ( pxBuffer->xWrap - xPosition );
+        }
+        else
+        {
+            xReturn = xPosition + xCount;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvBytesBetween( const BroadcastBuffer_t * const pxBuffer,
+                                   size_t xFrom,
+                                   size_t xTo )
+    {
+        size_t xReturn;
+
+        if( xTo >= xFrom )
+        {
+            xReturn = xTo - xFrom;
+        }
+        else
+        {
+            xReturn = ( pxBuffer->xWrap - xFrom ) + xTo;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvWriteBytes( BroadcastBuffer_t * const pxBuffer,
+                                 size_t xPosition,
+                                 const void * pvData,
+                                 size_t xCount )
+    {
+        const uint8_t * const pucData = ( const uint8_t * ) pvData;
+        size_t xIndex, xFirstLength;
+
+        xIndex = xPosition % pxBuffer->xLength;
+        xFirstLength = configMIN( pxBuffer->xLength - xIndex, xCount );
+        ( void ) memcpy( ( void * ) &( pxBuffer->pucBuffer[ xIndex ] ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+        if( xCount > xFirstLength )
+        {
+            ( void ) memcpy( ( void * ) pxBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return prvAdvance( pxBuffer, xPosition, xCount );
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvReadBytes( const BroadcastBuffer_t * const pxBuffer,
+                                size_t xPosition,
+                                void * pvData,
+                                size_t xCount )
+    {
+        uint8_t * const pucData = ( uint8_t * ) pvData;
+        size_t xIndex, xFirstLength;
+
+        xIndex = xPosition % pxBuffer->xLength;
+        xFirstLength = configMIN( pxBuffer->xLength - xIndex, xCount );
+        ( void ) memcpy( ( void * ) pucData, ( const void * ) &( pxBuffer->pucBuffer[ xIndex ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+        if( xCount > xFirstLength )
+        {
+            ( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( const void * ) pxBuffer->pucBuffer, xCount - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return prvAdvance( pxBuffer, xPosition, xCount );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvMakeSpace( BroadcastBuffer_t * const pxBuffer,
+                                    size_t xRequired )
+    {
+        size_t xHead, xTail, xLength;
+        BaseType_t xReturn = pdTRUE;
+
+        /* Only the writer changes the head and the tail. */
+        xHead = atomic_load_explicit( &( pxBuffer->xHead ), memory_order_relaxed );
+        xTail = atomic_load_explicit( &( pxBuffer->xTail ), memory_order_relaxed );
+
+        if( ( pxBuffer->xLength - prvBytesBetween( pxBuffer, xTail, xHead ) ) < xRequired )
+        {
+            do
+            {
+                if( xTail == pxBuffer->xReclaimLimit )
+                {
+                    pxBuffer->xReclaimLimit = prvSlowestCursor( pxBuffer, xTail );
+
+                    if( xTail == pxBuffer->xReclaimLimit )
+                    {
+                        xReturn = pdFALSE;
+                        break;
+                    }
+                }
+
+                /* Discard the oldest message. */
+                ( void ) prvReadBytes( pxBuffer, xTail, &xLength, sizeof( xLength ) );
+                xTail = prvAdvance( pxBuffer, xTail, xLength + broadcastBYTES_PER_MESSAGE );
+            } while( ( pxBuffer->xLength - prvBytesBetween( pxBuffer, xTail, xHead ) ) < xRequired );
+
+            /* Publish the new tail before any of the space it frees is
+             * overwritten, so a subscriber still copying a discarded message
+             * sees it has been discarded. */
+            atomic_store_explicit( &( pxBuffer->xTail ), xTail, memory_order_relaxed );
+            atomic_thread_fence( memory_order_release );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvSlowestCursor( BroadcastBuffer_t * const pxBuffer,
+                                    size_t xTail )
+    {
+        const ListItem_t * pxIterator;
+        const ListItem_t * pxEnd;
+        const BroadcastSubscriber_t * pxSubscriber;
+        size_t xCursor, xDistance, xSlowest;
+
+        xSlowest = prvBytesBetween( pxBuffer, xTail, atomic_load_explicit( &( pxBuffer->xHead ), memory_order_relaxed ) );
+
+        vTaskSuspendAll();
+        {
+            pxEnd = listGET_END_MARKER( &( pxBuffer->xSubscribers ) );
+
+            for( pxIterator = listGET_HEAD_ENTRY( &( pxBuffer->xSubscribers ) ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                pxSubscriber = ( const BroadcastSubscriber_t * ) listGET_LIST_ITEM_OWNER( pxIterator );
+
+                if( ( pxSubscriber->ucFlags & bbFLAGS_DROP_OLDEST ) == 0U )
+                {
+                    /* Acquire so the subscriber has finished copying out the
+                     * messages before its cursor. */
+                    xCursor = atomic_load_explicit( &( pxSubscriber->xCursor ), memory_order_acquire );
+                    xDistance = prvBytesBetween( pxBuffer, xTail, xCursor );
+                    xSlowest = configMIN( xSlowest, xDistance );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return prvAdvance( pxBuffer, xTail, xSlowest );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvNextMessage( const BroadcastSubscriber_t * const pxSubscriber,
+                                      size_t * const pxCursor )
+    {
+        const BroadcastBuffer_t * const pxBuffer = pxSubscriber->pxBuffer;
+        size_t xCursor, xTail;
+
+        xCursor = atomic_load_explicit( &( pxSubscriber->xCursor ), memory_order_relaxed );
+        xTail = atomic_load_explicit( &( pxBuffer->xTail ), memory_order_acquire );
+
+        /* A cursor behind the tail is more than a buffer length ahead of it
+         * when measured from the tail.  Only eBroadcastDropOldest subscribers
+         * can fall behind. */
+        if( prvBytesBetween( pxBuffer, xTail, xCursor ) > pxBuffer->xLength )
+        {
+            xCursor = xTail;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        *pxCursor = xCursor;
+
+        /* The head is read after the tail, so every position between the cursor
+         * and the head holds a published message. */
+        return ( xCursor != atomic_load_explicit( &( pxBuffer->xHead ), memory_order_acquire ) ) ? pdTRUE : pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnblockAll( List_t * const pxEventList )
+    {
+        if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+        {
+            vTaskSuspendAll();
+            {
+                while( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+                {
+                    ( void ) xTaskRemoveFromEventList( pxEventList );
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include broadcast buffer functionality.  If you want to include broadcast
+ * buffers then ensure configUSE_BROADCAST_BUFFERS is set to 1 in
+ * FreeRTOSConfig.h. */
+#endif /* configUSE_BROADCAST_BUFFERS == 1 */
@@ -28,6 +28,11 @@
 
 /* Standard includes. */
 #include <stdlib.h>
+#include <string.h>
+
+#if ( ( configUSE_EVENT_GROUP_STATS == 1 ) && ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+    #include <stdio.h>
+#endif
 
 /* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
  * all the API functions to use the MPU wrappers.  That should only be done when
@@ -46,11 +51,94 @@
  * correct privileged Vs unprivileged linkage and placement. */
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
 
+/* 64-bit event groups keep the bits a task waits for in its TCB, as they do
+ * not fit in the value of the task's event list item unless TickType_t is also
+ * 64 bits wide. */
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    #define eventPLACE_ON_LIST( pxList, uxBitsWaitedFor, xTicksToWait )    vTaskPlaceOnEventBitsList( ( pxList ), ( uxBitsWaitedFor ), ( xTicksToWait ) )
+    #define eventGET_BITS_WAITED_FOR( pxListItem )                          ullTaskGetEventBits( pxListItem )
+    #define eventREMOVE_FROM_LIST( pxListItem, uxEventBits )               vTaskRemoveFromEventBitsList( ( pxListItem ), ( uxEventBits ) )
+    #define eventRESET_BITS_WAITED_FOR()                                    ullTaskResetEventBits()
+#else
+    #define eventPLACE_ON_LIST( pxList, uxBitsWaitedFor, xTicksToWait )    vTaskPlaceOnUnorderedEventList( ( pxList ), ( uxBitsWaitedFor ), ( xTicksToWait ) )
+    #define eventGET_BITS_WAITED_FOR( pxListItem )                          listGET_LIST_ITEM_VALUE( pxListItem )
+    #define eventREMOVE_FROM_LIST( pxListItem, uxEventBits )               vTaskRemoveFromUnorderedEventList( ( pxListItem ), ( uxEventBits ) )
+    #define eventRESET_BITS_WAITED_FOR()                                    uxTaskResetEventItemValue()
+#endif
+
+/* When bits can be set directly from an interrupt, tasks must update the event
+ * bits in a critical section, as suspending the scheduler does not stop an
+ * interrupt changing them part way through.  The waiting lists are still only
+ * accessed with the scheduler suspended. */
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+    #define eventSET_BITS( pxEventBits, uxBits )      \
+    do {                                              \
+        taskENTER_CRITICAL();                         \
+        ( pxEventBits )->uxEventBits |= ( uxBits );   \
+        taskEXIT_CRITICAL();                          \
+    } while( 0 )
+    #define eventCLEAR_BITS( pxEventBits, uxBits )    \
+    do {                                              \
+        taskENTER_CRITICAL();                         \
+        ( pxEventBits )->uxEventBits &= ~( uxBits );  \
+        taskEXIT_CRITICAL();                          \
+    } while( 0 )
+#else
+    #define eventSET_BITS( pxEventBits, uxBits )      ( ( pxEventBits )->uxEventBits |= ( uxBits ) )
+    #define eventCLEAR_BITS( pxEventBits, uxBits )    ( ( pxEventBits )->uxEventBits &= ~( uxBits ) )
+#endif
+
+/* Statistics are only updated by code that either runs with the scheduler
+ * suspended or is in a critical section, except for counting sets, which can
+ * also be done by an interrupt when bits are set directly from interrupts. */
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+    #define eventSTATS_INCREMENT( pxEventBits, xCounter )    ( ( pxEventBits )->xStats.xCounter++ )
+
+    #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+        #define eventSTATS_COUNT_SET( pxEventBits )    \
+    do {                                               \
+        taskENTER_CRITICAL();                          \
+        eventSTATS_INCREMENT( pxEventBits, ulSets );   \
+        taskEXIT_CRITICAL();                           \
+    } while( 0 )
+    #else
+        #define eventSTATS_COUNT_SET( pxEventBits )    eventSTATS_INCREMENT( pxEventBits, ulSets )
+    #endif
+
+    #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+        #define eventGET_STATS_TIME( ulTime )    portALT_GET_RUN_TIME_COUNTER_VALUE( ulTime )
+    #else
+        #define eventGET_STATS_TIME( ulTime )    ( ulTime ) = ( configRUN_TIME_COUNTER_TYPE ) portGET_RUN_TIME_COUNTER_VALUE()
+    #endif
+#else
+    #define eventSTATS_INCREMENT( pxEventBits, xCounter )
+    #define eventSTATS_COUNT_SET( pxEventBits )
+#endif /* configUSE_EVENT_GROUP_STATS */
+
+/* The number of event bits that are available to the application, which is
+ * the number of bits below the control byte. */
+#define eventNUMBER_OF_USABLE_BITS    ( ( sizeof( EventBits_t ) * ( size_t ) 8 ) - ( size_t ) 8 )
+
 typedef struct EventGroupDef_t
 {
     EventBits_t uxEventBits;
     List_t xTasksWaitingForBits; /**< List of tasks waiting for a bit to be set. */
 
+    #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+        EventBits_t uxIndexedBits;                                 /**< Bit n is set if xTasksWaitingForBit[ n ] might not be empty. */
+        EventBits_t uxListedBits;                                  /**< Includes every bit waited for by a task in xTasksWaitingForBits. */
+        List_t xTasksWaitingForBit[ eventNUMBER_OF_USABLE_BITS ]; /**< xTasksWaitingForBit[ n ] holds tasks that cannot unblock until bit n is set. */
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+        EventBits_t uxBitsToWalk;         /**< Bits set from interrupts that the waiting tasks have not yet been checked against.  Not zero while xDeferredWalk is queued. */
+        TaskDeferredWork_t xDeferredWalk; /**< Queued with the kernel to check the waiting tasks after bits are set from an interrupt. */
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        EventGroupStats_t xStats;
+    #endif
+
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxEventGroupNumber;
     #endif
@@ -74,6 +162,85 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
                                         const EventBits_t uxBitsToWaitFor,
                                         const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
+/*
+ * Initialise the lists of tasks waiting for bits in a new event group, and
+ * anything else used to unblock them.
+ */
+static void prvInitialiseWaitingLists( EventGroup_t * pxEventBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Block the calling task until uxBitsToWaitFor, qualified by uxControlBits,
+ * are set.  uxCurrentEventBits is the value of the event group, which does not
+ * yet meet the wait condition.  Must be called with the scheduler suspended.
+ */
+static void prvPlaceOnWaitingList( EventGroup_t * pxEventBits,
+                                   const EventBits_t uxCurrentEventBits,
+                                   const EventBits_t uxBitsToWaitFor,
+                                   const EventBits_t uxControlBits,
+                                   const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks in pxList whose wait condition is met by the current event
+ * bits.  The bits that must be cleared because a task that waited for them
+ * specified eventCLEAR_EVENTS_ON_EXIT_BIT are added to *puxBitsToClear.
+ * Returns the bits waited for by the tasks that remain in pxList.
+ */
+static EventBits_t prvUnblockMatchingTasks( EventGroup_t * pxEventBits,
+                                            List_t * pxList,
+                                            EventBits_t * puxBitsToClear ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks whose wait condition is met now that uxBitsSet have been
+ * set.  Returns the bits that must be cleared because a task that waited for
+ * them specified eventCLEAR_EVENTS_ON_EXIT_BIT.  Must be called with the
+ * scheduler suspended.
+ */
+static EventBits_t prvUnblockTasksAfterSet( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsSet ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+
+/*
+ * Update the statistics with the time an xEventGroupSetBits() call that
+ * suspended the scheduler at ulStartTime kept it suspended.
+ */
+    static void prvRecordSetBitsTime( EventGroup_t * pxEventBits,
+                                      const configRUN_TIME_COUNTER_TYPE ulStartTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Add the time the calling task, which blocked at ulStartTime, waited for the
+ * bits it waited for to be set to the histogram of wait times.  uxBitsReturned
+ * are the bits the task was unblocked with - the event group is not accessed if
+ * none of uxBitsWaitedFor are set, as the task was then unblocked because the
+ * event group was deleted.
+ */
+    static void prvRecordWaitTime( EventGroup_t * pxEventBits,
+                                   const EventBits_t uxBitsReturned,
+                                   const EventBits_t uxBitsWaitedFor,
+                                   const configRUN_TIME_COUNTER_TYPE ulStartTime ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+/*
+ * Run by the kernel, with interrupts masked and the scheduler suspended, to
+ * unblock the tasks that might be waiting for bits set from an interrupt.
+ */
+    static void prvDeferredWalk( TaskDeferredWork_t * pxWork ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+
+/*
+ * Returns the number of the lowest bit that is set in uxBits, which must not
+ * be zero.
+ */
+    static UBaseType_t prvLowestBit( EventBits_t uxBits ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
@@ -101,7 +268,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
         if( pxEventBits != NULL )
         {
             pxEventBits->uxEventBits = 0;
-            vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+            prvInitialiseWaitingLists( pxEventBits );
 
             #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
             {
@@ -152,7 +319,7 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
         if( pxEventBits != NULL )
         {
             pxEventBits->uxEventBits = 0;
-            vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+            prvInitialiseWaitingLists( pxEventBits );
 
             #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
             {
@@ -186,6 +353,10 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
     BaseType_t xAlreadyYielded;
     BaseType_t xTimeoutOccurred = pdFALSE;
 
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulWaitStartTime = 0;
+    #endif
+
     configASSERT( ( uxBitsToWaitFor & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
     configASSERT( uxBitsToWaitFor != 0 );
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -207,7 +378,7 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
 
             /* Rendezvous always clear the bits.  They will have been cleared
              * already unless this is the only task in the rendezvous. */
-            pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+            eventCLEAR_BITS( pxEventBits, uxBitsToWaitFor );
 
             xTicksToWait = 0;
         }
@@ -217,10 +388,16 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
             {
                 traceEVENT_GROUP_SYNC_BLOCK( xEventGroup, uxBitsToSet, uxBitsToWaitFor );
 
+                #if ( configUSE_EVENT_GROUP_STATS == 1 )
+                {
+                    eventGET_STATS_TIME( ulWaitStartTime );
+                }
+                #endif
+
                 /* Store the bits that the calling task is waiting for in the
                  * task's event list item so the kernel knows when a match is
                  * found.  Then enter the blocked state. */
-                vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
+                prvPlaceOnWaitingList( pxEventBits, pxEventBits->uxEventBits, uxBitsToWaitFor, ( eventCLEAR_EVENTS_ON_EXIT_BIT | eventWAIT_FOR_ALL_BITS ), xTicksToWait );
 
                 /* This assignment is obsolete as uxReturn will get set after
                  * the task unblocks, but some compilers mistakenly generate a
@@ -254,7 +431,7 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
          * point either the required bits were set or the block time expired.  If
          * the required bits were set they will have been stored in the task's
          * event list item, and they should now be retrieved then cleared. */
-        uxReturn = uxTaskResetEventItemValue();
+        uxReturn = eventRESET_BITS_WAITED_FOR();
 
         if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) == ( EventBits_t ) 0 )
         {
@@ -275,6 +452,8 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
+
+                eventSTATS_INCREMENT( pxEventBits, ulTimeouts );
             }
             taskEXIT_CRITICAL();
 
@@ -283,6 +462,11 @@ EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup,
         else
         {
             /* The task unblocked because the bits were set. */
+            #if ( configUSE_EVENT_GROUP_STATS == 1 )
+            {
+                prvRecordWaitTime( pxEventBits, uxReturn, uxBitsToWaitFor, ulWaitStartTime );
+            }
+            #endif
         }
 
         /* Control bits might be set as the task had blocked should not be
@@ -310,6 +494,10 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
     BaseType_t xWaitConditionMet, xAlreadyYielded;
     BaseType_t xTimeoutOccurred = pdFALSE;
 
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulWaitStartTime = 0;
+    #endif
+
     /* Check the user is not attempting to wait on the bits used by the kernel
      * itself, and that at least one bit is being requested. */
     configASSERT( xEventGroup );
@@ -338,7 +526,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
             /* Clear the wait bits if requested to do so. */
             if( xClearOnExit != pdFALSE )
             {
-                pxEventBits->uxEventBits &= ~uxBitsToWaitFor;
+                eventCLEAR_BITS( pxEventBits, uxBitsToWaitFor );
             }
             else
             {
@@ -376,10 +564,16 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_EVENT_GROUP_STATS == 1 )
+            {
+                eventGET_STATS_TIME( ulWaitStartTime );
+            }
+            #endif
+
             /* Store the bits that the calling task is waiting for in the
              * task's event list item so the kernel knows when a match is
              * found.  Then enter the blocked state. */
-            vTaskPlaceOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+            prvPlaceOnWaitingList( pxEventBits, uxCurrentEventBits, uxBitsToWaitFor, uxControlBits, xTicksToWait );
 
             /* This is obsolete as it will get set after the task unblocks, but
              * some compilers mistakenly generate a warning about the variable
@@ -406,7 +600,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
          * point either the required bits were set or the block time expired.  If
          * the required bits were set they will have been stored in the task's
          * event list item, and they should now be retrieved then cleared. */
-        uxReturn = uxTaskResetEventItemValue();
+        uxReturn = eventRESET_BITS_WAITED_FOR();
 
         if( ( uxReturn & eventUNBLOCKED_DUE_TO_BIT_SET ) == ( EventBits_t ) 0 )
         {
@@ -433,6 +627,7 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
                     mtCOVERAGE_TEST_MARKER();
                 }
 
+                eventSTATS_INCREMENT( pxEventBits, ulTimeouts );
                 xTimeoutOccurred = pdTRUE;
             }
             taskEXIT_CRITICAL();
@@ -440,6 +635,11 @@ EventBits_t xEventGroupWaitBits( EventGroupHandle_t xEventGroup,
         else
         {
             /* The task unblocked because the bits were set. */
+            #if ( configUSE_EVENT_GROUP_STATS == 1 )
+            {
+                prvRecordWaitTime( pxEventBits, uxReturn, uxBitsToWaitFor, ulWaitStartTime );
+            }
+            #endif
         }
 
         /* The task blocked so control bits may have been set. */
@@ -476,6 +676,7 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
 
         /* Clear the bits. */
         pxEventBits->uxEventBits &= ~uxBitsToClear;
+        eventSTATS_INCREMENT( pxEventBits, ulClears );
     }
     taskEXIT_CRITICAL();
 
@@ -483,20 +684,47 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+    BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
+                                            const EventBits_t uxBitsToClear )
+    {
+        EventGroup_t * pxEventBits = xEventGroup;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( xEventGroup );
+        configASSERT( ( uxBitsToClear & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+        traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
+
+        /* Clearing bits cannot unblock a task, so no walk is needed. */
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            pxEventBits->uxEventBits &= ~uxBitsToClear;
+            eventSTATS_INCREMENT( pxEventBits, ulClears );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        return pdPASS;
+    }
+
+#elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
     BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                             const EventBits_t uxBitsToClear )
     {
         BaseType_t xReturn;
 
+        /* The bits are passed to the timer task as a uint32_t. */
+        configASSERT( ( uxBitsToClear & ~( EventBits_t ) 0xffffffffUL ) == 0 );
+
         traceEVENT_GROUP_CLEAR_BITS_FROM_ISR( xEventGroup, uxBitsToClear );
         xReturn = xTimerPendFunctionCallFromISR( vEventGroupClearBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToClear, NULL ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
 
         return xReturn;
     }
 
-#endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+#endif /* if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 ) */
 /*-----------------------------------------------------------*/
 
 EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup )
@@ -518,92 +746,44 @@ EventBits_t xEventGroupGetBitsFromISR( EventGroupHandle_t xEventGroup )
 EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
                                 const EventBits_t uxBitsToSet )
 {
-    ListItem_t * pxListItem;
-    ListItem_t * pxNext;
-    ListItem_t const * pxListEnd;
-    List_t const * pxList;
-    EventBits_t uxBitsToClear = 0, uxBitsWaitedFor, uxControlBits;
+    EventBits_t uxBitsToClear;
     EventGroup_t * pxEventBits = xEventGroup;
-    BaseType_t xMatchFound = pdFALSE;
+
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulStartTime;
+    #endif
 
     /* Check the user is not attempting to set the bits used by the kernel
      * itself. */
     configASSERT( xEventGroup );
     configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
 
-    pxList = &( pxEventBits->xTasksWaitingForBits );
-    pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
     vTaskSuspendAll();
     {
-        traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
+        #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        {
+            eventGET_STATS_TIME( ulStartTime );
+        }
+        #endif
 
-        pxListItem = listGET_HEAD_ENTRY( pxList );
+        traceEVENT_GROUP_SET_BITS( xEventGroup, uxBitsToSet );
 
         /* Set the bits. */
-        pxEventBits->uxEventBits |= uxBitsToSet;
+        eventSET_BITS( pxEventBits, uxBitsToSet );
+        eventSTATS_COUNT_SET( pxEventBits );
 
         /* See if the new bit value should unblock any tasks. */
-        while( pxListItem != pxListEnd )
-        {
-            pxNext = listGET_NEXT( pxListItem );
-            uxBitsWaitedFor = listGET_LIST_ITEM_VALUE( pxListItem );
-            xMatchFound = pdFALSE;
-
-            /* Split the bits waited for from the control bits. */
-            uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
-            uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
-
-            if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
-            {
-                /* Just looking for single bit being set. */
-                if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
-                {
-                    xMatchFound = pdTRUE;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
-            }
-            else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
-            {
-                /* All bits are set. */
-                xMatchFound = pdTRUE;
-            }
-            else
-            {
-                /* Need all bits to be set, but not all the bits were set. */
-            }
-
-            if( xMatchFound != pdFALSE )
-            {
-                /* The bits match.  Should the bits be cleared on exit? */
-                if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
-                {
-                    uxBitsToClear |= uxBitsWaitedFor;
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
-
-                /* Store the actual event flag value in the task's event list
-                 * item before removing the task from the event list.  The
-                 * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
-                 * that is was unblocked due to its required bits matching, rather
-                 * than because it timed out. */
-                vTaskRemoveFromUnorderedEventList( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
-            }
-
-            /* Move onto the next list item.  Note pxListItem->pxNext is not
-             * used here as the list item may have been removed from the event list
-             * and inserted into the ready/pending reading list. */
-            pxListItem = pxNext;
-        }
+        uxBitsToClear = prvUnblockTasksAfterSet( pxEventBits, uxBitsToSet );
 
         /* Clear any bits that matched when the eventCLEAR_EVENTS_ON_EXIT_BIT
          * bit was set in the control word. */
-        pxEventBits->uxEventBits &= ~uxBitsToClear;
+        eventCLEAR_BITS( pxEventBits, uxBitsToClear );
+
+        #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        {
+            prvRecordSetBitsTime( pxEventBits, ulStartTime );
+        }
+        #endif
     }
     ( void ) xTaskResumeAll();
 
@@ -615,6 +795,7 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
 {
     EventGroup_t * pxEventBits = xEventGroup;
     const List_t * pxTasksWaitingForBits;
+    UBaseType_t uxList = 0;
 
     configASSERT( pxEventBits );
 
@@ -624,13 +805,55 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
     {
         traceEVENT_GROUP_DELETE( xEventGroup );
 
-        while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+        for( ; ; )
+        {
+            while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
+            {
+                /* Unblock the task, returning 0 as the event list is being deleted
+                 * and cannot therefore have any bits set. */
+                configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
+                eventREMOVE_FROM_LIST( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+            }
+
+            #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+            {
+                /* Then empty the list of each bit in turn. */
+                if( uxList < ( UBaseType_t ) eventNUMBER_OF_USABLE_BITS )
+                {
+                    pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBit[ uxList ] );
+                    uxList++;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            #else
+            {
+                ( void ) uxList;
+                break;
+            }
+            #endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+        }
+
+        #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
         {
-            /* Unblock the task, returning 0 as the event list is being deleted
-             * and cannot therefore have any bits set. */
-            configASSERT( pxTasksWaitingForBits->xListEnd.pxNext != ( const ListItem_t * ) &( pxTasksWaitingForBits->xListEnd ) );
-            vTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
+            /* Forget a walk deferred by an interrupt that has not run yet. */
+            taskENTER_CRITICAL();
+            {
+                if( pxEventBits->uxBitsToWalk != ( EventBits_t ) 0 )
+                {
+                    vTaskCancelDeferredWork( &( pxEventBits->xDeferredWalk ) );
+                    pxEventBits->uxBitsToWalk = 0;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
         }
+        #endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
     }
     ( void ) xTaskResumeAll();
 
@@ -748,7 +971,376 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
 }
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
+static void prvInitialiseWaitingLists( EventGroup_t * pxEventBits )
+{
+    vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+    {
+        ( void ) memset( &( pxEventBits->xStats ), 0x00, sizeof( EventGroupStats_t ) );
+    }
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+    {
+        pxEventBits->uxBitsToWalk = 0;
+        pxEventBits->xDeferredWalk.pxNext = NULL;
+        pxEventBits->xDeferredWalk.pxFunction = prvDeferredWalk;
+        pxEventBits->xDeferredWalk.pvOwner = pxEventBits;
+    }
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+    {
+        UBaseType_t uxBit;
+
+        pxEventBits->uxIndexedBits = 0;
+        pxEventBits->uxListedBits = 0;
+
+        for( uxBit = 0; uxBit < ( UBaseType_t ) eventNUMBER_OF_USABLE_BITS; uxBit++ )
+        {
+            vListInitialise( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ) );
+        }
+    }
+    #endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+}
+/*-----------------------------------------------------------*/
+
+static void prvPlaceOnWaitingList( EventGroup_t * pxEventBits,
+                                   const EventBits_t uxCurrentEventBits,
+                                   const EventBits_t uxBitsToWaitFor,
+                                   const EventBits_t uxControlBits,
+                                   const TickType_t xTicksToWait )
+{
+    List_t * pxList = &( pxEventBits->xTasksWaitingForBits );
+
+    #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+    {
+        UBaseType_t uxBit;
+
+        /* A task waiting for all its bits cannot unblock until a bit it does
+         * not yet have is set, and a task waiting for a single bit cannot
+         * unblock until that bit is set, so either is held in the list of
+         * that bit.  A task waiting for any of several bits could be unblocked
+         * by any of them, so is held in xTasksWaitingForBits. */
+        if( ( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 ) ||
+            ( ( uxBitsToWaitFor & ( uxBitsToWaitFor - ( EventBits_t ) 1 ) ) == ( EventBits_t ) 0 ) )
+        {
+            uxBit = prvLowestBit( uxBitsToWaitFor & ~uxCurrentEventBits );
+            pxList = &( pxEventBits->xTasksWaitingForBit[ uxBit ] );
+            pxEventBits->uxIndexedBits |= ( EventBits_t ) 1 << uxBit;
+        }
+        else
+        {
+            pxEventBits->uxListedBits |= uxBitsToWaitFor;
+        }
+    }
+    #else /* if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) */
+    {
+        ( void ) uxCurrentEventBits;
+    }
+    #endif /* if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) */
+
+    eventSTATS_INCREMENT( pxEventBits, ulWaits );
+    eventPLACE_ON_LIST( pxList, ( uxBitsToWaitFor | uxControlBits ), xTicksToWait );
+}
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvUnblockTasksAfterSet( EventGroup_t * pxEventBits,
+                                            const EventBits_t uxBitsSet )
+{
+    EventBits_t uxBitsToClear = 0;
+
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        const uint32_t ulTasksVisitedBefore = pxEventBits->xStats.ulTasksVisited;
+        const uint32_t ulTasksWokenBefore = pxEventBits->xStats.ulTasksWoken;
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+    {
+        EventBits_t uxBitsToWalk;
+        UBaseType_t uxBit;
+
+        /* Bits are only ever set here, so the wait condition of a blocked
+         * task can only have become true if one of the bits it waits for
+         * is being set now.  Only visit the lists of such tasks - if no
+         * task waits for any of uxBitsSet no list is visited at all. */
+        uxBitsToWalk = uxBitsSet & pxEventBits->uxIndexedBits;
+
+        while( uxBitsToWalk != ( EventBits_t ) 0 )
+        {
+            uxBit = prvLowestBit( uxBitsToWalk );
+            uxBitsToWalk &= uxBitsToWalk - ( EventBits_t ) 1;
+
+            /* The tasks in this list that are still blocked afterwards
+             * have been moved to the list of another bit. */
+            ( void ) prvUnblockMatchingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBit[ uxBit ] ), &uxBitsToClear );
+            pxEventBits->uxIndexedBits &= ~( ( EventBits_t ) 1 << uxBit );
+        }
+
+        if( ( uxBitsSet & pxEventBits->uxListedBits ) != ( EventBits_t ) 0 )
+        {
+            pxEventBits->uxListedBits = prvUnblockMatchingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), &uxBitsToClear );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #else /* if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) */
+    {
+        ( void ) uxBitsSet;
+        ( void ) prvUnblockMatchingTasks( pxEventBits, &( pxEventBits->xTasksWaitingForBits ), &uxBitsToClear );
+    }
+    #endif /* if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) */
+
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+    {
+        /* The counters are only updated with the scheduler suspended and
+         * interrupts cannot walk the lists, so the difference is the cost of
+         * this walk alone. */
+        const uint32_t ulTasksVisited = pxEventBits->xStats.ulTasksVisited - ulTasksVisitedBefore;
+        const uint32_t ulTasksWoken = pxEventBits->xStats.ulTasksWoken - ulTasksWokenBefore;
+
+        if( ulTasksVisited > pxEventBits->xStats.ulMaxTasksVisitedByWalk )
+        {
+            pxEventBits->xStats.ulMaxTasksVisitedByWalk = ulTasksVisited;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( ulTasksWoken > pxEventBits->xStats.ulMaxTasksWokenByWalk )
+        {
+            pxEventBits->xStats.ulMaxTasksWokenByWalk = ulTasksWoken;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* configUSE_EVENT_GROUP_STATS */
+
+    return uxBitsToClear;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+    static void prvDeferredWalk( TaskDeferredWork_t * pxWork )
+    {
+        EventGroup_t * pxEventBits = ( EventGroup_t * ) pxWork->pvOwner;
+        EventBits_t uxBitsSet = pxEventBits->uxBitsToWalk;
+
+        /* Interrupts are masked, so the bits can be updated directly. */
+        pxEventBits->uxBitsToWalk = 0;
+        pxEventBits->uxEventBits &= ~prvUnblockTasksAfterSet( pxEventBits, uxBitsSet );
+    }
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+/*-----------------------------------------------------------*/
+
+static EventBits_t prvUnblockMatchingTasks( EventGroup_t * pxEventBits,
+                                            List_t * pxList,
+                                            EventBits_t * puxBitsToClear )
+{
+    ListItem_t * pxListItem;
+    ListItem_t * pxNext;
+    ListItem_t const * pxListEnd;
+    EventBits_t uxBitsWaitedFor, uxControlBits, uxBitsStillWaitedFor = 0;
+    BaseType_t xMatchFound;
+
+    pxListEnd = listGET_END_MARKER( pxList ); /*lint !e826 !e740 !e9087 The mini list structure is used as the list end to save RAM.  This is checked and valid. */
+    pxListItem = listGET_HEAD_ENTRY( pxList );
+
+    while( pxListItem != pxListEnd )
+    {
+        pxNext = listGET_NEXT( pxListItem );
+        uxBitsWaitedFor = eventGET_BITS_WAITED_FOR( pxListItem );
+        xMatchFound = pdFALSE;
+        eventSTATS_INCREMENT( pxEventBits, ulTasksVisited );
+
+        /* Split the bits waited for from the control bits. */
+        uxControlBits = uxBitsWaitedFor & eventEVENT_BITS_CONTROL_BYTES;
+        uxBitsWaitedFor &= ~eventEVENT_BITS_CONTROL_BYTES;
+
+        if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) == ( EventBits_t ) 0 )
+        {
+            /* Just looking for single bit being set. */
+            if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) != ( EventBits_t ) 0 )
+            {
+                xMatchFound = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else if( ( uxBitsWaitedFor & pxEventBits->uxEventBits ) == uxBitsWaitedFor )
+        {
+            /* All bits are set. */
+            xMatchFound = pdTRUE;
+        }
+        else
+        {
+            /* Need all bits to be set, but not all the bits were set. */
+        }
+
+        if( xMatchFound != pdFALSE )
+        {
+            /* The bits match.  Should the bits be cleared on exit? */
+            if( ( uxControlBits & eventCLEAR_EVENTS_ON_EXIT_BIT ) != ( EventBits_t ) 0 )
+            {
+                *puxBitsToClear |= uxBitsWaitedFor;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Store the actual event flag value in the task's event list
+             * item before removing the task from the event list.  The
+             * eventUNBLOCKED_DUE_TO_BIT_SET bit is set so the task knows
+             * that is was unblocked due to its required bits matching, rather
+             * than because it timed out. */
+            eventREMOVE_FROM_LIST( pxListItem, pxEventBits->uxEventBits | eventUNBLOCKED_DUE_TO_BIT_SET );
+            eventSTATS_INCREMENT( pxEventBits, ulTasksWoken );
+        }
+        else
+        {
+            #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+            {
+                if( ( uxControlBits & eventWAIT_FOR_ALL_BITS ) != ( EventBits_t ) 0 )
+                {
+                    /* The task still needs a bit that is not set, and is not
+                     * being set now, so move it to the list of that bit. */
+                    UBaseType_t uxBit = prvLowestBit( uxBitsWaitedFor & ~( pxEventBits->uxEventBits ) );
+
+                    ( void ) uxListRemove( pxListItem );
+                    vListInsertEnd( &( pxEventBits->xTasksWaitingForBit[ uxBit ] ), pxListItem );
+                    pxEventBits->uxIndexedBits |= ( EventBits_t ) 1 << uxBit;
+                }
+                else
+                {
+                    uxBitsStillWaitedFor |= uxBitsWaitedFor;
+                }
+            }
+            #else /* if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) */
+            {
+                uxBitsStillWaitedFor |= uxBitsWaitedFor;
+            }
+            #endif /* if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 ) */
+        }
+
+        /* Move onto the next list item.  Note pxListItem->pxNext is not
+         * used here as the list item may have been removed from the event list
+         * and inserted into the ready/pending reading list. */
+        pxListItem = pxNext;
+    }
+
+    return uxBitsStillWaitedFor;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+
+    static UBaseType_t prvLowestBit( EventBits_t uxBits )
+    {
+        UBaseType_t uxBit = 0;
+
+        configASSERT( uxBits != ( EventBits_t ) 0 );
+
+        while( ( uxBits & ( EventBits_t ) 1 ) == ( EventBits_t ) 0 )
+        {
+            uxBits >>= 1;
+            uxBit++;
+        }
+
+        return uxBit;
+    }
+
+#endif /* configUSE_EVENT_GROUP_WAITER_INDEX */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+    BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
+                                          const EventBits_t uxBitsToSet,
+                                          BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        EventGroup_t * pxEventBits = xEventGroup;
+        UBaseType_t uxSavedInterruptStatus;
+        BaseType_t xMustWalk;
+
+        configASSERT( xEventGroup );
+        configASSERT( ( uxBitsToSet & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+
+        traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            pxEventBits->uxEventBits |= uxBitsToSet;
+            eventSTATS_INCREMENT( pxEventBits, ulSets );
+
+            if( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED )
+            {
+                /* A task might be part way between testing the bits and
+                 * joining a waiting list, so the lists cannot be trusted.
+                 * Always walk them when the scheduler is resumed. */
+                xMustWalk = pdTRUE;
+            }
+            else
+            {
+                /* No task is part way through an event group operation, so
+                 * the walk can be skipped if no task waits for these bits. */
+                #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+                {
+                    xMustWalk = ( ( uxBitsToSet & ( pxEventBits->uxIndexedBits | pxEventBits->uxListedBits ) ) != ( EventBits_t ) 0 ) ? pdTRUE : pdFALSE;
+                }
+                #else
+                {
+                    xMustWalk = ( listLIST_IS_EMPTY( &( pxEventBits->xTasksWaitingForBits ) ) == pdFALSE ) ? pdTRUE : pdFALSE;
+                }
+                #endif
+
+                if( ( xMustWalk != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                {
+                    /* The walk runs when the interrupt switches context. */
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( ( xMustWalk != pdFALSE ) && ( uxBitsToSet != ( EventBits_t ) 0 ) )
+            {
+                /* Bits set by later interrupts are added to a walk that is
+                 * already queued. */
+                if( pxEventBits->uxBitsToWalk == ( EventBits_t ) 0 )
+                {
+                    vTaskDeferFromISR( &( pxEventBits->xDeferredWalk ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxEventBits->uxBitsToWalk |= uxBitsToSet;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        return pdPASS;
+    }
+
+#elif ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) )
 
     BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                           const EventBits_t uxBitsToSet,
@@ -756,13 +1348,165 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
     {
         BaseType_t xReturn;
 
+        /* The bits are passed to the timer task as a uint32_t. */
+        configASSERT( ( uxBitsToSet & ~( EventBits_t ) 0xffffffffUL ) == 0 );
+
         traceEVENT_GROUP_SET_BITS_FROM_ISR( xEventGroup, uxBitsToSet );
         xReturn = xTimerPendFunctionCallFromISR( vEventGroupSetBitsCallback, ( void * ) xEventGroup, ( uint32_t ) uxBitsToSet, pxHigherPriorityTaskWoken ); /*lint !e9087 Can't avoid cast to void* as a generic callback function not specific to this use case. Callback casts back to original type so safe. */
 
         return xReturn;
     }
 
-#endif /* if ( ( configUSE_TRACE_FACILITY == 1 ) && ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 1 ) ) */
+#endif /* if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+
+    static void prvRecordSetBitsTime( EventGroup_t * pxEventBits,
+                                      const configRUN_TIME_COUNTER_TYPE ulStartTime )
+    {
+        configRUN_TIME_COUNTER_TYPE ulTime;
+
+        eventGET_STATS_TIME( ulTime );
+        ulTime -= ulStartTime;
+
+        pxEventBits->xStats.ulTotalSetBitsTime += ulTime;
+
+        if( ulTime > pxEventBits->xStats.ulMaxSetBitsTime )
+        {
+            pxEventBits->xStats.ulMaxSetBitsTime = ulTime;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_EVENT_GROUP_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+
+    static void prvRecordWaitTime( EventGroup_t * pxEventBits,
+                                   const EventBits_t uxBitsReturned,
+                                   const EventBits_t uxBitsWaitedFor,
+                                   const configRUN_TIME_COUNTER_TYPE ulStartTime )
+    {
+        configRUN_TIME_COUNTER_TYPE ulTime;
+        UBaseType_t uxBucket = 0;
+
+        if( ( uxBitsReturned & uxBitsWaitedFor ) != ( EventBits_t ) 0 )
+        {
+            eventGET_STATS_TIME( ulTime );
+            ulTime = ( ulTime - ulStartTime ) >> configEVENT_GROUP_STATS_WAIT_SHIFT;
+
+            /* Bucket n holds times below 2^n, so is one more than the index of
+             * the most significant bit set in the time. */
+            while( ( ulTime != ( configRUN_TIME_COUNTER_TYPE ) 0 ) && ( uxBucket < ( UBaseType_t ) ( configEVENT_GROUP_STATS_WAIT_BUCKETS - 1 ) ) )
+            {
+                ulTime >>= 1;
+                uxBucket++;
+            }
+
+            taskENTER_CRITICAL();
+            {
+                pxEventBits->xStats.ulWaitTimes[ uxBucket ]++;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_EVENT_GROUP_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+
+    void vEventGroupGetStats( EventGroupHandle_t xEventGroup,
+                              EventGroupStats_t * pxStats )
+    {
+        EventGroup_t const * pxEventBits = xEventGroup;
+
+        configASSERT( pxEventBits );
+        configASSERT( pxStats );
+
+        /* The statistics are otherwise only changed with the scheduler
+         * suspended or from a critical section, so a critical section gives a
+         * consistent copy. */
+        taskENTER_CRITICAL();
+        {
+            *pxStats = pxEventBits->xStats;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_EVENT_GROUP_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+
+    void vEventGroupResetStats( EventGroupHandle_t xEventGroup )
+    {
+        EventGroup_t * pxEventBits = xEventGroup;
+
+        configASSERT( pxEventBits );
+
+        taskENTER_CRITICAL();
+        {
+            ( void ) memset( &( pxEventBits->xStats ), 0x00, sizeof( EventGroupStats_t ) );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_EVENT_GROUP_STATS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_EVENT_GROUP_STATS == 1 ) && ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+
+    void vEventGroupListStats( EventGroupHandle_t xEventGroup,
+                               char * pcWriteBuffer )
+    {
+        EventGroupStats_t xStats;
+        UBaseType_t uxBucket;
+
+        /*
+         * PLEASE NOTE:
+         *
+         * This function is provided for convenience only, and is used by many
+         * of the demo applications.  Do not consider it to be part of the
+         * scheduler.
+         *
+         * vEventGroupListStats() has a dependency on the sprintf() C library
+         * function that might bloat the code size, use a lot of stack, and
+         * provide different results on different platforms.
+         */
+
+        configASSERT( pcWriteBuffer );
+
+        vEventGroupGetStats( xEventGroup, &xStats );
+
+        sprintf( pcWriteBuffer, "%u\t%llu\t%llu\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u",                                           /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                 ( unsigned int ) uxEventGroupGetNumber( xEventGroup ),
+                 ( unsigned long long ) xStats.ulMaxSetBitsTime, ( unsigned long long ) xStats.ulTotalSetBitsTime,
+                 ( unsigned int ) xStats.ulSets, ( unsigned int ) xStats.ulClears,
+                 ( unsigned int ) xStats.ulTasksWoken, ( unsigned int ) xStats.ulMaxTasksWokenByWalk,
+                 ( unsigned int ) xStats.ulTasksVisited, ( unsigned int ) xStats.ulMaxTasksVisitedByWalk,
+                 ( unsigned int ) xStats.ulWaits, ( unsigned int ) xStats.ulTimeouts );
+        pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+
+        for( uxBucket = 0; uxBucket < ( UBaseType_t ) configEVENT_GROUP_STATS_WAIT_BUCKETS; uxBucket++ )
+        {
+            sprintf( pcWriteBuffer, "\t%u", ( unsigned int ) xStats.ulWaitTimes[ uxBucket ] ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+            pcWriteBuffer += strlen( pcWriteBuffer );                                          /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+        }
+
+        sprintf( pcWriteBuffer, "\r\n" ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+    }
+
+#endif /* ( ( configUSE_EVENT_GROUP_STATS == 1 ) && ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -394,10 +394,15 @@
     #define configQUEUE_REGISTRY_SIZE    0U
 #endif
 
+#ifndef configQUEUE_REGISTRY_HASHED
+    #define configQUEUE_REGISTRY_HASHED    0
+#endif
+
 #if ( configQUEUE_REGISTRY_SIZE < 1 )
     #define vQueueAddToRegistry( xQueue, pcName )
     #define vQueueUnregisterQueue( xQueue )
-    #define pcQueueGetName( xQueue )
+    #define pcQueueGetName( xQueue )          ( NULL )
+    #define xQueueGetHandle( pcQueueName )    ( NULL )
 #endif
 
 #ifndef configUSE_MINI_LIST_ITEM
@@ -806,6 +811,10 @@
     #define traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xBytesSent )
 #endif
 
+#ifndef traceSTREAM_BUFFER_RECEIVE_EMPTY
+    #define traceSTREAM_BUFFER_RECEIVE_EMPTY( xStreamBuffer )
+#endif
+
 #ifndef traceBLOCKING_ON_STREAM_BUFFER_RECEIVE
     #define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer )
 #endif
@@ -888,6 +897,58 @@
     #define configUSE_QUEUE_SETS    0
 #endif
 
+#ifndef configUSE_QUEUE_ZERO_COPY
+    #define configUSE_QUEUE_ZERO_COPY    0
+#endif
+
+#ifndef configQUEUE_FIXED_SIZE_COPY
+    #define configQUEUE_FIXED_SIZE_COPY    1
+#endif
+
+#ifndef configUSE_SPSC_QUEUES
+    #define configUSE_SPSC_QUEUES    0
+#endif
+
+#ifndef configUSE_QUEUE_DIRECT_HANDOFF
+    #define configUSE_QUEUE_DIRECT_HANDOFF    0
+#endif
+
+#ifndef configUSE_PRIORITY_QUEUES
+    #define configUSE_PRIORITY_QUEUES    0
+#endif
+
+#ifndef configUSE_RW_LOCKS
+    #define configUSE_RW_LOCKS    0
+#endif
+
+#ifndef configUSE_MRMW_STREAM_BUFFERS
+    #define configUSE_MRMW_STREAM_BUFFERS    0
+#endif
+
+#ifndef configUSE_BROADCAST_BUFFERS
+    #define configUSE_BROADCAST_BUFFERS    0
+#endif
+
+#ifndef configUSE_BARRIERS
+    #define configUSE_BARRIERS    0
+#endif
+
+#ifndef configUSE_QUEUE_SET_READY_LIST
+    #define configUSE_QUEUE_SET_READY_LIST    0
+#endif
+
+#if ( ( configUSE_QUEUE_SET_READY_LIST == 1 ) && ( configUSE_QUEUE_SETS != 1 ) )
+    #error configUSE_QUEUE_SETS must be set to 1 to use configUSE_QUEUE_SET_READY_LIST
+#endif
+
+#ifndef configMAX_PRIORITY_INHERITANCE_DEPTH
+    #define configMAX_PRIORITY_INHERITANCE_DEPTH    1
+#endif
+
+#if ( configMAX_PRIORITY_INHERITANCE_DEPTH < 1 )
+    #error configMAX_PRIORITY_INHERITANCE_DEPTH must be at least 1
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
     #define portTASK_USES_FLOATING_POINT()
 #endif
@@ -962,6 +1023,50 @@
     #define configUSE_SB_COMPLETED_CALLBACK    0
 #endif
 
+#ifndef configUSE_STREAM_BUFFER_ZERO_COPY
+    #define configUSE_STREAM_BUFFER_ZERO_COPY    0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_SCATTER_GATHER
+    #define configUSE_STREAM_BUFFER_SCATTER_GATHER    0
+#endif
+
+#ifndef configUSE_STREAM_BUFFER_HOST_WRITER
+    #define configUSE_STREAM_BUFFER_HOST_WRITER    0
+#endif
+
+#if ( ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 ) && !defined( portHOST_RAISE_INTERRUPT ) )
+    #error configUSE_STREAM_BUFFER_HOST_WRITER is set to 1 but the port does not define portHOST_RAISE_INTERRUPT().
+#endif
+
+#ifndef configUSE_EVENT_GROUP_WAITER_INDEX
+    #define configUSE_EVENT_GROUP_WAITER_INDEX    0
+#endif
+
+#ifndef configUSE_64_BIT_EVENT_GROUPS
+    #define configUSE_64_BIT_EVENT_GROUPS    0
+#endif
+
+#ifndef configUSE_EVENT_GROUP_DIRECT_ISR_SET
+    #define configUSE_EVENT_GROUP_DIRECT_ISR_SET    0
+#endif
+
+#ifndef configUSE_EVENT_GROUP_STATS
+    #define configUSE_EVENT_GROUP_STATS    0
+#endif
+
+#ifndef configEVENT_GROUP_STATS_WAIT_BUCKETS
+    #define configEVENT_GROUP_STATS_WAIT_BUCKETS    16
+#endif
+
+#ifndef configEVENT_GROUP_STATS_WAIT_SHIFT
+    #define configEVENT_GROUP_STATS_WAIT_SHIFT    0
+#endif
+
+#if ( ( configUSE_EVENT_GROUP_STATS == 1 ) && ( configGENERATE_RUN_TIME_STATS != 1 ) )
+    #error configUSE_EVENT_GROUP_STATS is set to 1 but configGENERATE_RUN_TIME_STATS, which provides the clock the statistics are timed with, is not.
+#endif
+
 #ifndef portTICK_TYPE_IS_ATOMIC
     #define portTICK_TYPE_IS_ATOMIC    0
 #endif
@@ -1022,6 +1127,28 @@
     #define configINITIAL_TICK_COUNT    0
 #endif
 
+/* The number of independent kernel instances that can run concurrently in one
+ * process, each on its own host threads.  Only simulator ports can run more
+ * than one.  The heap is shared by all the instances, so must be heap_3 or
+ * heap_5. */
+#ifndef configNUMBER_OF_KERNEL_INSTANCES
+    #define configNUMBER_OF_KERNEL_INSTANCES    1
+#endif
+
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    #ifndef portGET_KERNEL_INSTANCE
+        #error configNUMBER_OF_KERNEL_INSTANCES is greater than 1 but the port does not define portGET_KERNEL_INSTANCE() and portSET_KERNEL_INSTANCE()
+    #endif
+
+    #if ( configUSE_CO_ROUTINES != 0 )
+        #error Co-routines cannot be used when configNUMBER_OF_KERNEL_INSTANCES is greater than 1
+    #endif
+#endif
+
+#ifndef portGET_KERNEL_INSTANCE
+    #define portGET_KERNEL_INSTANCE()    ( 0 )
+#endif
+
 #if ( portTICK_TYPE_IS_ATOMIC == 0 )
 
 /* Either variables of tick type cannot be read atomically, or
@@ -1316,6 +1443,16 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+        void * pvDummy23;
+        uint8_t ucDummy24;
+    #endif
+    #if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+        void * pvDummy25;
+    #endif
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t ullDummy26;
+    #endif
 } StaticTask_t;
 
 /*
@@ -1358,6 +1495,24 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+        void * pvDummy10[ 2 ];
+        uint8_t ucDummy10;
+    #endif
+
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+        uint8_t ucDummy11;
+    #endif
+
+    #if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+        void * pvDummy12[ 3 ];
+    #endif
+
+    #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+        StaticListItem_t xDummy13;
+        StaticList_t xDummy14;
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1377,9 +1532,40 @@ typedef StaticQueue_t StaticSemaphore_t;
  */
 typedef struct xSTATIC_EVENT_GROUP
 {
-    TickType_t xDummy1;
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t xDummy1;
+    #else
+        TickType_t xDummy1;
+    #endif
     StaticList_t xDummy2;
 
+    #if ( configUSE_EVENT_GROUP_WAITER_INDEX == 1 )
+        #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+            uint64_t xDummy5[ 2 ];
+            StaticList_t xDummy6[ 56 ];
+        #else
+            TickType_t xDummy5[ 2 ];
+            StaticList_t xDummy6[ ( sizeof( TickType_t ) * 8 ) - 8 ];
+        #endif
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+        #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+            uint64_t xDummy7;
+        #else
+            TickType_t xDummy7;
+        #endif
+        void * pvDummy8[ 3 ];
+    #endif
+
+    #if ( configUSE_EVENT_GROUP_STATS == 1 )
+        struct
+        {
+            configRUN_TIME_COUNTER_TYPE ulDummy9[ 2 ];
+            uint32_t ulDummy10[ 8 + configEVENT_GROUP_STATS_WAIT_BUCKETS ];
+        } xDummy9;
+    #endif
+
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy3;
     #endif
@@ -1441,11 +1627,111 @@ typedef struct xSTATIC_STREAM_BUFFER
     #if ( configUSE_SB_COMPLETED_CALLBACK == 1 )
         void * pvDummy5[ 2 ];
     #endif
+    #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+        UBaseType_t uxDummy6[ 2 ];
+        size_t uxDummy7;
+    #endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
 typedef StaticStreamBuffer_t StaticMessageBuffer_t;
 
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the SPSC queue structure used internally by FreeRTOS
+ * is not accessible to application code.  The StaticSPSCQueue_t structure below
+ * is provided so an SPSC queue can be statically allocated.  Its size and
+ * alignment requirements match those of the genuine structure, which is checked
+ * by an assert when the queue is created.
+ */
+typedef struct xSTATIC_SPSC_QUEUE
+{
+    size_t uxDummy1[ 2 ];
+    BaseType_t xDummy2[ 2 ];
+    StaticList_t xDummy3[ 2 ];
+    void * pvDummy4;
+    size_t uxDummy5[ 2 ];
+    uint8_t ucDummy6;
+} StaticSPSCQueue_t;
+
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the readers-writer lock structure used internally by
+ * FreeRTOS is not accessible to application code.  The StaticRWLock_t structure
+ * below is provided so a readers-writer lock can be statically allocated.  Its
+ * size and alignment requirements match those of the genuine structure, which
+ * is checked by an assert when the lock is created.
+ */
+typedef struct xSTATIC_RW_LOCK
+{
+    size_t uxDummy1;
+    void * pvDummy2;
+    StaticList_t xDummy3[ 2 ];
+    uint8_t ucDummy4;
+} StaticRWLock_t;
+
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the barrier structure used internally by FreeRTOS is
+ * not accessible to application code.  The StaticBarrier_t structure below is
+ * provided so a barrier can be statically allocated.  Its size and alignment
+ * requirements match those of the genuine structure, which is checked by an
+ * assert when the barrier is created.
+ */
+typedef struct xSTATIC_BARRIER
+{
+    UBaseType_t uxDummy1[ 3 ];
+    StaticList_t xDummy2;
+    uint8_t ucDummy3;
+} StaticBarrier_t;
+
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the MRMW stream buffer structure used internally by
+ * FreeRTOS is not accessible to application code.  The
+ * StaticMRMWStreamBuffer_t structure below is provided so an MRMW stream buffer
+ * can be statically allocated.  Its size and alignment requirements match those
+ * of the genuine structure, which is checked by an assert when the buffer is
+ * created.
+ */
+typedef struct xSTATIC_MRMW_STREAM_BUFFER
+{
+    void * pvDummy1;
+    size_t uxDummy2[ 2 ];
+    size_t uxDummy3[ 2 ];
+    StaticList_t xDummy4[ 2 ];
+    size_t uxDummy5[ 2 ];
+    StaticList_t xDummy6[ 2 ];
+    uint8_t ucDummy7;
+} StaticMRMWStreamBuffer_t;
+
+/*
+ * In line with software engineering best practice, FreeRTOS implements a strict
+ * data hiding policy, so the broadcast buffer and subscriber structures used
+ * internally by FreeRTOS are not accessible to application code.  The
+ * StaticBroadcastBuffer_t and StaticBroadcastSubscriber_t structures below are
+ * provided so they can be statically allocated.  Their size and alignment
+ * requirements match those of the genuine structures, which is checked by an
+ * assert when they are created.
+ */
+typedef struct xSTATIC_BROADCAST_BUFFER
+{
+    void * pvDummy1;
+    size_t uxDummy2[ 5 ];
+    UBaseType_t uxDummy3;
+    StaticList_t xDummy4[ 3 ];
+    uint8_t ucDummy5;
+} StaticBroadcastBuffer_t;
+
+typedef struct xSTATIC_BROADCAST_SUBSCRIBER
+{
+    StaticListItem_t xDummy1;
+    void * pvDummy2;
+    size_t uxDummy3;
+    UBaseType_t uxDummy4[ 2 ];
+    uint8_t ucDummy5;
+} StaticBroadcastSubscriber_t;
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
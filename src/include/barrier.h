@@ -0,0 +1,222 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Barriers.
+ *
+ * A barrier holds each task that arrives at it until a fixed number of tasks,
+ * the participants, have arrived, then releases them all together - for
+ * example so a group of worker tasks all finish one control frame before any of
+ * them starts the next.  Unlike xEventGroupSync(), which needs one event bit
+ * per participant and re-evaluates every waiting task each time a bit is set, a
+ * barrier only counts arrivals, so the number of participants is not limited
+ * by the width of EventBits_t, arriving takes the same time however many tasks
+ * are already waiting, and the last task to arrive readies all the others in a
+ * single pass.
+ *
+ * A barrier is reused as soon as it is released - each release starts a new
+ * generation, and a task that arrives again waits for the next release.  A task
+ * that times out waiting at a barrier withdraws its arrival, so the barrier
+ * then waits for another task to arrive in its place.
+ *
+ * Barriers cannot be used from an interrupt.
+ *
+ * configUSE_BARRIERS must be set to 1 in FreeRTOSConfig.h for barriers to be
+ * available.
+ */
+
+#ifndef BARRIER_H
+#define BARRIER_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include barrier.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Returned by xBarrierWait() to the task that released the barrier by being the
+ * last of the participants to arrive.
+ */
+#define barrierLAST_TO_ARRIVE    ( ( BaseType_t ) 2 )
+
+/**
+ * Type by which barriers are referenced.  For example, a call to
+ * xBarrierCreate() returns a BarrierHandle_t variable that can then be used as
+ * a parameter to xBarrierWait(), vBarrierDelete(), etc.
+ */
+struct BarrierDefinition;
+typedef struct BarrierDefinition * BarrierHandle_t;
+
+/**
+ * barrier.h
+ *
+ * @code{c}
+ * BarrierHandle_t xBarrierCreate( UBaseType_t uxParticipants );
+ * @endcode
+ *
+ * Creates a barrier using dynamically allocated memory.  See
+ * xBarrierCreateStatic() for a version that uses statically allocated memory.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xBarrierCreate() to be available.
+ *
+ * @param uxParticipants The number of tasks that must arrive at the barrier to
+ * release it.  Must be at least 1.
+ *
+ * @return If the barrier is successfully created then a handle to the created
+ * barrier is returned.  If the barrier cannot be created then NULL is returned.
+ *
+ * \defgroup xBarrierCreate xBarrierCreate
+ * \ingroup Barriers
+ */
+BarrierHandle_t xBarrierCreate( UBaseType_t uxParticipants ) PRIVILEGED_FUNCTION;
+
+/**
+ * barrier.h
+ *
+ * @code{c}
+ * BarrierHandle_t xBarrierCreateStatic( UBaseType_t uxParticipants,
+ *                                       StaticBarrier_t *pxBarrierBuffer );
+ * @endcode
+ *
+ * Creates a barrier using statically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xBarrierCreateStatic() to be available.
+ *
+ * @param uxParticipants The number of tasks that must arrive at the barrier to
+ * release it.  Must be at least 1.
+ *
+ * @param pxBarrierBuffer Must point to a variable of type StaticBarrier_t,
+ * which will be used to hold the barrier's data structure.
+ *
+ * @return If pxBarrierBuffer is not NULL then a handle to the created barrier
+ * is returned, otherwise NULL is returned.
+ *
+ * \defgroup xBarrierCreateStatic xBarrierCreateStatic
+ * \ingroup Barriers
+ */
+BarrierHandle_t xBarrierCreateStatic( UBaseType_t uxParticipants,
+                                      StaticBarrier_t * pxBarrierBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * barrier.h
+ *
+ * @code{c}
+ * void vBarrierDelete( BarrierHandle_t xBarrier );
+ * @endcode
+ *
+ * Deletes a barrier.  No task may be blocked at the barrier when it is deleted.
+ *
+ * \defgroup vBarrierDelete vBarrierDelete
+ * \ingroup Barriers
+ */
+void vBarrierDelete( BarrierHandle_t xBarrier ) PRIVILEGED_FUNCTION;
+
+/**
+ * barrier.h
+ *
+ * @code{c}
+ * BaseType_t xBarrierWait( BarrierHandle_t xBarrier, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Arrive at a barrier, and wait for the rest of its participants to arrive.
+ *
+ * @param xBarrier The handle of the barrier.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for the rest of the participants to arrive.  If
+ * the time expires first then the calling task's arrival is withdrawn.  The
+ * calling task will not block if xTicksToWait is zero, in which case it only
+ * arrives if it is the last participant to do so.
+ *
+ * @return barrierLAST_TO_ARRIVE if the calling task released the barrier by
+ * being the last participant to arrive, pdPASS if the calling task was
+ * released by another task, or pdFAIL if the calling task timed out.  Exactly
+ * one task receives barrierLAST_TO_ARRIVE each time the barrier is released,
+ * so it can be used to choose a task to do work once per generation.
+ *
+ * Example usage:
+ * @code{c}
+ * #define NUM_WORKERS    32
+ *
+ * BarrierHandle_t xFrameBarrier;
+ *
+ * void vWorkerTask( void *pvParameters )
+ * {
+ *  for( ;; )
+ *  {
+ *      vProcessFrameSlice( pvParameters );
+ *
+ *      // Wait for every worker to finish the frame.
+ *      if( xBarrierWait( xFrameBarrier, pdMS_TO_TICKS( 5 ) ) == barrierLAST_TO_ARRIVE )
+ *      {
+ *          vPublishFrame();
+ *      }
+ *  }
+ * }
+ *
+ * void vCreateWorkers( void )
+ * {
+ *  xFrameBarrier = xBarrierCreate( NUM_WORKERS );
+ *  // Create NUM_WORKERS instances of vWorkerTask here.
+ * }
+ * @endcode
+ * \defgroup xBarrierWait xBarrierWait
+ * \ingroup Barriers
+ */
+BaseType_t xBarrierWait( BarrierHandle_t xBarrier,
+                         TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * barrier.h
+ *
+ * @code{c}
+ * UBaseType_t uxBarrierGetGeneration( BarrierHandle_t xBarrier );
+ * @endcode
+ *
+ * Returns the number of times the barrier has been released since it was
+ * created, wrapping on overflow.
+ *
+ * \defgroup uxBarrierGetGeneration uxBarrierGetGeneration
+ * \ingroup Barriers
+ */
+UBaseType_t uxBarrierGetGeneration( BarrierHandle_t xBarrier ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( BARRIER_H ) */
@@ -0,0 +1,305 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Broadcast buffers.
+ *
+ * A broadcast buffer holds variable length messages, like a message buffer,
+ * but every message written to it is received by every subscriber.  There is
+ * one copy of each message, in one storage area, and each subscriber has its
+ * own read position, so the cost of a write does not depend on the number of
+ * subscribers.
+ *
+ * When the buffer is full the writer makes space by discarding the oldest
+ * messages.  Each subscriber chooses what happens if it has not yet received
+ * one of those messages:
+ *
+ * - eBroadcastBlockWriter subscribers never miss a message.  The writer waits
+ *   for the subscriber to receive the oldest message before discarding it.
+ *
+ * - eBroadcastDropOldest subscribers never hold the writer up.  Messages the
+ *   subscriber has not received are discarded, and counted by
+ *   uxBroadcastBufferGetOverflowCount().
+ *
+ * As with stream buffers only one task may write to a broadcast buffer, and
+ * each subscriber must only be used by one task.  The functions must not be
+ * called from an interrupt service routine.
+ *
+ * configUSE_BROADCAST_BUFFERS must be set to 1 in FreeRTOSConfig.h, and the
+ * compiler must support C11 <stdatomic.h>, for broadcast buffers to be
+ * available.
+ */
+
+#ifndef BROADCAST_BUFFER_H
+#define BROADCAST_BUFFER_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include broadcast_buffer.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Types by which broadcast buffers and their subscribers are referenced.  For
+ * example, a call to xBroadcastBufferCreate() returns a
+ * BroadcastBufferHandle_t variable that can then be used as a parameter to
+ * xBroadcastBufferSend() and xBroadcastBufferSubscribe().
+ */
+struct BroadcastBufferDefinition;
+typedef struct BroadcastBufferDefinition * BroadcastBufferHandle_t;
+struct BroadcastSubscriberDefinition;
+typedef struct BroadcastSubscriberDefinition * BroadcastSubscriberHandle_t;
+
+/**
+ * What happens to a message a subscriber has not received when the writer
+ * needs its space.  See the description at the top of this file.
+ */
+typedef enum
+{
+    eBroadcastBlockWriter = 0, /* The writer waits for the subscriber. */
+    eBroadcastDropOldest       /* The subscriber misses the message. */
+} eBroadcastOverflowPolicy;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * BroadcastBufferHandle_t xBroadcastBufferCreate( size_t xBufferSizeBytes );
+ * @endcode
+ *
+ * Creates a new broadcast buffer using dynamically allocated memory.  See
+ * xBroadcastBufferCreateStatic() for a version that uses statically allocated
+ * memory.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xBroadcastBufferCreate() to be available.
+ *
+ * @param xBufferSizeBytes The total number of bytes the buffer will be able to
+ * hold at any one time.  Each message also takes up
+ * broadcastBYTES_PER_MESSAGE bytes for its length and sequence number.
+ *
+ * @return If the buffer is successfully created then a handle to the created
+ * buffer is returned.  If the buffer cannot be created then NULL is returned.
+ *
+ * \defgroup xBroadcastBufferCreate xBroadcastBufferCreate
+ * \ingroup BroadcastBufferManagement
+ */
+BroadcastBufferHandle_t xBroadcastBufferCreate( size_t xBufferSizeBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * BroadcastBufferHandle_t xBroadcastBufferCreateStatic( size_t xBufferSizeBytes,
+ *                                                       uint8_t *pucStorage,
+ *                                                       StaticBroadcastBuffer_t *pxStaticBuffer );
+ * @endcode
+ *
+ * Creates a new broadcast buffer using statically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xBroadcastBufferCreateStatic() to be available.
+ *
+ * @param xBufferSizeBytes The total number of bytes the buffer will be able to
+ * hold at any one time.
+ *
+ * @param pucStorage Must point to a uint8_t array that is at least
+ * xBufferSizeBytes big.
+ *
+ * @param pxStaticBuffer Must point to a variable of type
+ * StaticBroadcastBuffer_t, which will be used to hold the buffer's data
+ * structure.
+ *
+ * @return If neither pucStorage or pxStaticBuffer are NULL then a handle to the
+ * created buffer is returned, otherwise NULL is returned.
+ *
+ * \defgroup xBroadcastBufferCreateStatic xBroadcastBufferCreateStatic
+ * \ingroup BroadcastBufferManagement
+ */
+BroadcastBufferHandle_t xBroadcastBufferCreateStatic( size_t xBufferSizeBytes,
+                                                      uint8_t * pucStorage,
+                                                      StaticBroadcastBuffer_t * pxStaticBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * void vBroadcastBufferDelete( BroadcastBufferHandle_t xBuffer );
+ * @endcode
+ *
+ * Deletes a broadcast buffer.  Every subscriber must have been removed with
+ * vBroadcastBufferUnsubscribe() first.
+ *
+ * \defgroup vBroadcastBufferDelete vBroadcastBufferDelete
+ * \ingroup BroadcastBufferManagement
+ */
+void vBroadcastBufferDelete( BroadcastBufferHandle_t xBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * BroadcastSubscriberHandle_t xBroadcastBufferSubscribe( BroadcastBufferHandle_t xBuffer,
+ *                                                        eBroadcastOverflowPolicy ePolicy );
+ * BroadcastSubscriberHandle_t xBroadcastBufferSubscribeStatic( BroadcastBufferHandle_t xBuffer,
+ *                                                              eBroadcastOverflowPolicy ePolicy,
+ *                                                              StaticBroadcastSubscriber_t *pxStaticSubscriber );
+ * void vBroadcastBufferUnsubscribe( BroadcastSubscriberHandle_t xSubscriber );
+ * @endcode
+ *
+ * Add a subscriber to, or remove a subscriber from, a broadcast buffer.  A new
+ * subscriber receives the messages written after it subscribed.
+ * xBroadcastBufferSubscribe() allocates the subscriber dynamically, and
+ * xBroadcastBufferSubscribeStatic() uses the memory pointed to by
+ * pxStaticSubscriber.
+ *
+ * A subscriber must not be removed while a task is blocked receiving from it.
+ *
+ * @param xBuffer The handle of the buffer to subscribe to.
+ *
+ * @param ePolicy eBroadcastBlockWriter or eBroadcastDropOldest, as described
+ * at the top of this file.
+ *
+ * @param pxStaticSubscriber Must point to a variable of type
+ * StaticBroadcastSubscriber_t, which will be used to hold the subscriber's data
+ * structure.
+ *
+ * @return The handle of the new subscriber, or NULL if it could not be
+ * allocated.
+ *
+ * \defgroup xBroadcastBufferSubscribe xBroadcastBufferSubscribe
+ * \ingroup BroadcastBufferManagement
+ */
+BroadcastSubscriberHandle_t xBroadcastBufferSubscribe( BroadcastBufferHandle_t xBuffer,
+                                                       eBroadcastOverflowPolicy ePolicy ) PRIVILEGED_FUNCTION;
+BroadcastSubscriberHandle_t xBroadcastBufferSubscribeStatic( BroadcastBufferHandle_t xBuffer,
+                                                             eBroadcastOverflowPolicy ePolicy,
+                                                             StaticBroadcastSubscriber_t * pxStaticSubscriber ) PRIVILEGED_FUNCTION;
+void vBroadcastBufferUnsubscribe( BroadcastSubscriberHandle_t xSubscriber ) PRIVILEGED_FUNCTION;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * size_t xBroadcastBufferSend( BroadcastBufferHandle_t xBuffer,
+ *                              const void *pvTxData,
+ *                              size_t xDataLengthBytes,
+ *                              TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Writes a message to a broadcast buffer, for every subscriber to receive.
+ * The message is copied once.  If there is not enough free space the oldest
+ * messages are discarded, unless an eBroadcastBlockWriter subscriber has not
+ * received them yet.
+ *
+ * @param xBuffer The handle of the buffer to write to.
+ *
+ * @param pvTxData A pointer to the message to copy into the buffer.
+ *
+ * @param xDataLengthBytes The length of the message.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state waiting for eBroadcastBlockWriter subscribers to receive
+ * enough messages for there to be space.
+ *
+ * @return xDataLengthBytes if the message was written, otherwise zero.
+ *
+ * \defgroup xBroadcastBufferSend xBroadcastBufferSend
+ * \ingroup BroadcastBufferManagement
+ */
+size_t xBroadcastBufferSend( BroadcastBufferHandle_t xBuffer,
+                             const void * pvTxData,
+                             size_t xDataLengthBytes,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * size_t xBroadcastBufferReceive( BroadcastSubscriberHandle_t xSubscriber,
+ *                                 void *pvRxData,
+ *                                 size_t xBufferLengthBytes,
+ *                                 TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Receives the next message for a subscriber.  Receiving does not remove the
+ * message from the buffer, so other subscribers can still receive it.
+ *
+ * @param xSubscriber The subscriber to receive for.
+ *
+ * @param pvRxData A pointer to the buffer into which the message is copied.
+ *
+ * @param xBufferLengthBytes The length of the buffer pointed to by pvRxData.
+ * If the next message is longer it is left for a later call, in the same way
+ * as xMessageBufferReceive().
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for a message.
+ *
+ * @return The length of the message received, or zero.
+ *
+ * \defgroup xBroadcastBufferReceive xBroadcastBufferReceive
+ * \ingroup BroadcastBufferManagement
+ */
+size_t xBroadcastBufferReceive( BroadcastSubscriberHandle_t xSubscriber,
+                                void * pvRxData,
+                                size_t xBufferLengthBytes,
+                                TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * broadcast_buffer.h
+ *
+ * @code{c}
+ * UBaseType_t uxBroadcastBufferGetOverflowCount( BroadcastSubscriberHandle_t xSubscriber );
+ * @endcode
+ *
+ * Returns the number of messages an eBroadcastDropOldest subscriber has missed
+ * because they were discarded before it received them.  Missed messages are
+ * counted when the subscriber next receives a message.  Always zero for
+ * eBroadcastBlockWriter subscribers.
+ *
+ * \defgroup uxBroadcastBufferGetOverflowCount uxBroadcastBufferGetOverflowCount
+ * \ingroup BroadcastBufferManagement
+ */
+UBaseType_t uxBroadcastBufferGetOverflowCount( BroadcastSubscriberHandle_t xSubscriber ) PRIVILEGED_FUNCTION;
+
+/* The number of bytes of buffer space each message uses in addition to its
+ * own length. */
+#define broadcastBYTES_PER_MESSAGE    ( sizeof( size_t ) + sizeof( UBaseType_t ) )
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( BROADCAST_BUFFER_H ) */
@@ -38,8 +38,15 @@
 
 /* The following bit fields convey control information in a task's event list
  * item value.  It is important they don't clash with the
- * taskEVENT_LIST_ITEM_VALUE_IN_USE definition. */
-#if ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
+ * taskEVENT_LIST_ITEM_VALUE_IN_USE definition.  64-bit event groups keep the
+ * bits a task waits for in the task's TCB rather than in its event list item,
+ * so are not limited by the width of TickType_t. */
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    #define eventCLEAR_EVENTS_ON_EXIT_BIT    0x0100000000000000ULL
+    #define eventUNBLOCKED_DUE_TO_BIT_SET    0x0200000000000000ULL
+    #define eventWAIT_FOR_ALL_BITS           0x0400000000000000ULL
+    #define eventEVENT_BITS_CONTROL_BYTES    0xff00000000000000ULL
+#elif ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS )
     #define eventCLEAR_EVENTS_ON_EXIT_BIT    0x0100U
     #define eventUNBLOCKED_DUE_TO_BIT_SET    0x0200U
     #define eventWAIT_FOR_ALL_BITS           0x0400U
@@ -103,14 +110,46 @@ struct EventGroupDef_t;
 typedef struct EventGroupDef_t   * EventGroupHandle_t;
 
 /*
- * The type that holds event bits always matches TickType_t - therefore the
- * number of bits it holds is set by configTICK_TYPE_WIDTH_IN_BITS (16 bits if set to 0,
- * 32 bits if set to 1, 64 bits if set to 2.
+ * The type that holds event bits matches TickType_t - therefore the number of
+ * bits it holds is set by configTICK_TYPE_WIDTH_IN_BITS (16 bits if set to 0,
+ * 32 bits if set to 1, 64 bits if set to 2) - unless
+ * configUSE_64_BIT_EVENT_GROUPS is set to 1, in which case it is always 64
+ * bits.
  *
  * \defgroup EventBits_t EventBits_t
  * \ingroup EventGroup
  */
-typedef TickType_t               EventBits_t;
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+    typedef uint64_t             EventBits_t;
+#else
+    typedef TickType_t           EventBits_t;
+#endif
+
+/*
+ * Statistics kept for each event group when configUSE_EVENT_GROUP_STATS is set
+ * to 1 in FreeRTOSConfig.h - see vEventGroupGetStats().  Times are measured
+ * with the run time stats clock, so are in the same units as the task run time
+ * counters.
+ *
+ * \defgroup EventGroupStats_t EventGroupStats_t
+ * \ingroup EventGroup
+ */
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+    typedef struct xEVENT_GROUP_STATS
+    {
+        configRUN_TIME_COUNTER_TYPE ulMaxSetBitsTime;                       /**< The longest time a single xEventGroupSetBits() call kept the scheduler suspended. */
+        configRUN_TIME_COUNTER_TYPE ulTotalSetBitsTime;                     /**< The total time xEventGroupSetBits() has kept the scheduler suspended. */
+        uint32_t ulSets;                                                    /**< The number of times bits were set, by a task or an interrupt. */
+        uint32_t ulClears;                                                  /**< The number of times bits were cleared by xEventGroupClearBits() or xEventGroupClearBitsFromISR(). */
+        uint32_t ulTasksWoken;                                              /**< The number of waiting tasks unblocked by bits being set. */
+        uint32_t ulMaxTasksWokenByWalk;                                     /**< The most tasks unblocked by one walk of the waiting tasks. */
+        uint32_t ulTasksVisited;                                            /**< The number of waiting tasks checked against the bits, whether unblocked or not. */
+        uint32_t ulMaxTasksVisitedByWalk;                                   /**< The most waiting tasks checked by one walk of the waiting tasks. */
+        uint32_t ulWaits;                                                   /**< The number of times a task blocked on the event group. */
+        uint32_t ulTimeouts;                                                /**< The number of times a blocked task timed out. */
+        uint32_t ulWaitTimes[ configEVENT_GROUP_STATS_WAIT_BUCKETS ];       /**< Histogram of the time tasks were blocked before bits unblocked them - see vEventGroupGetStats(). */
+    } EventGroupStats_t;
+#endif /* configUSE_EVENT_GROUP_STATS */
 
 /**
  * event_groups.h
@@ -136,8 +175,10 @@ typedef TickType_t               EventBits_t;
  * configTICK_TYPE_WIDTH_IN_BITS is 0 then each event group contains 8 usable bits (bit
  * 0 to bit 7).  If configTICK_TYPE_WIDTH_IN_BITS is set to 1 then each event group has
  * 24 usable bits (bit 0 to bit 23).  If configTICK_TYPE_WIDTH_IN_BITS is set to 2 then
- * each event group has 56 usable bits (bit 0 to bit 53). The EventBits_t type
- * is used to store event bits within an event group.
+ * each event group has 56 usable bits (bit 0 to bit 55).  Set
+ * configUSE_64_BIT_EVENT_GROUPS to 1 in FreeRTOSConfig.h to get 56 usable bits
+ * whatever the width of the tick type.  The EventBits_t type is used to store
+ * event bits within an event group.
  *
  * @return If the event group was created then a handle to the event group is
  * returned.  If there was insufficient FreeRTOS heap available to create the
@@ -193,8 +234,10 @@ typedef TickType_t               EventBits_t;
  * configTICK_TYPE_WIDTH_IN_BITS is 0 then each event group contains 8 usable bits (bit
  * 0 to bit 7).  If configTICK_TYPE_WIDTH_IN_BITS is set to 1 then each event group has
  * 24 usable bits (bit 0 to bit 23).  If configTICK_TYPE_WIDTH_IN_BITS is set to 2 then
- * each event group has 56 usable bits (bit 0 to bit 53).  The EventBits_t type
- * is used to store event bits within an event group.
+ * each event group has 56 usable bits (bit 0 to bit 55).  Set
+ * configUSE_64_BIT_EVENT_GROUPS to 1 in FreeRTOSConfig.h to get 56 usable bits
+ * whatever the width of the tick type.  The EventBits_t type is used to store
+ * event bits within an event group.
  *
  * @param pxEventGroupBuffer pxEventGroupBuffer must point to a variable of type
  * StaticEventGroup_t, which will be then be used to hold the event group's data
@@ -398,6 +441,11 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * timer task to have the clear operation performed in the context of the timer
  * task.
  *
+ * If configUSE_EVENT_GROUP_DIRECT_ISR_SET is set to 1 in FreeRTOSConfig.h then
+ * the timer task is not used.  Clearing bits cannot unblock a task, so the bits
+ * are cleared directly, pdPASS is always returned, and any of the event bits
+ * can be cleared.
+ *
  * @note If this function returns pdPASS then the timer task is ready to run
  * and a portYIELD_FROM_ISR(pdTRUE) should be executed to perform the needed
  * clear on the event group.  This behavior is different from
@@ -408,7 +456,8 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  *
  * @param uxBitsToClear A bitwise value that indicates the bit or bits to clear.
  * For example, to clear bit 3 only, set uxBitsToClear to 0x08.  To clear bit 3
- * and bit 0 set uxBitsToClear to 0x09.
+ * and bit 0 set uxBitsToClear to 0x09.  The request is passed to the timer
+ * task as a uint32_t, so only bits 0 to 31 can be cleared from an interrupt.
  *
  * @return If the request to execute the function was posted successfully then
  * pdPASS is returned, otherwise pdFALSE is returned.  pdFALSE will be returned
@@ -440,7 +489,7 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * \defgroup xEventGroupClearBitsFromISR xEventGroupClearBitsFromISR
  * \ingroup EventGroup
  */
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 ) )
     BaseType_t xEventGroupClearBitsFromISR( EventGroupHandle_t xEventGroup,
                                             const EventBits_t uxBitsToClear ) PRIVILEGED_FUNCTION;
 #else
@@ -461,6 +510,13 @@ EventBits_t xEventGroupClearBits( EventGroupHandle_t xEventGroup,
  * Setting bits in an event group will automatically unblock tasks that are
  * blocked waiting for the bits.
  *
+ * By default every task blocked on the event group is tested each time bits
+ * are set.  If configUSE_EVENT_GROUP_WAITER_INDEX is set to 1 in
+ * FreeRTOSConfig.h then blocked tasks are indexed by the bits they wait for,
+ * so only tasks that wait for one of uxBitsToSet are tested, and setting bits
+ * that no task waits for takes constant time.  This costs one list per event
+ * bit in each event group.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
@@ -539,11 +595,26 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * context of the timer task - where a scheduler lock is used in place of a
  * critical section.
  *
+ * If configUSE_EVENT_GROUP_DIRECT_ISR_SET is set to 1 in FreeRTOSConfig.h then
+ * the timer task is not used, and any of the event bits can be set.  The bits
+ * are set directly, in a short critical section.  If a task might be waiting
+ * for them, the non-deterministic part - checking the waiting tasks - is
+ * deferred to the context switch performed at the end of the interrupt, or,
+ * if the interrupt occurred while the scheduler was suspended, to when the
+ * scheduler is resumed.  *pxHigherPriorityTaskWoken is set to pdTRUE to
+ * request that context switch, and pdPASS is always returned.  The check runs
+ * with interrupts masked up to configMAX_SYSCALL_INTERRUPT_PRIORITY, so its
+ * length adds to the latency of those interrupts - setting
+ * configUSE_EVENT_GROUP_WAITER_INDEX to 1 keeps it short by only visiting the
+ * tasks waiting for the bits that were set.  Tasks also update the event bits
+ * in short critical sections when this option is used.
+ *
  * @param xEventGroup The event group in which the bits are to be set.
  *
  * @param uxBitsToSet A bitwise value that indicates the bit or bits to set.
  * For example, to set bit 3 only, set uxBitsToSet to 0x08.  To set bit 3
- * and bit 0 set uxBitsToSet to 0x09.
+ * and bit 0 set uxBitsToSet to 0x09.  The request is passed to the timer task
+ * as a uint32_t, so only bits 0 to 31 can be set from an interrupt.
  *
  * @param pxHigherPriorityTaskWoken As mentioned above, calling this function
  * will result in a message being sent to the timer daemon task.  If the
@@ -553,7 +624,13 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * xEventGroupSetBitsFromISR(), indicating that a context switch should be
  * requested before the interrupt exits.  For that reason
  * *pxHigherPriorityTaskWoken must be initialised to pdFALSE.  See the
- * example code below.
+ * example code below.  If configUSE_EVENT_GROUP_DIRECT_ISR_SET is set to 1
+ * then *pxHigherPriorityTaskWoken is instead set to pdTRUE whenever a task
+ * might be waiting for the bits, as the check of the waiting tasks runs in the
+ * context switch that it requests.  Passing pxHigherPriorityTaskWoken as NULL
+ * then delays that check, and so the unblocking of any task waiting for the
+ * bits, until the next context switch or, if configUSE_PREEMPTION is 1, the
+ * next tick interrupt.
  *
  * @return If the request to execute the function was posted successfully then
  * pdPASS is returned, otherwise pdFALSE is returned.  pdFALSE will be returned
@@ -595,7 +672,7 @@ EventBits_t xEventGroupSetBits( EventGroupHandle_t xEventGroup,
  * \defgroup xEventGroupSetBitsFromISR xEventGroupSetBitsFromISR
  * \ingroup EventGroup
  */
-#if ( configUSE_TRACE_FACILITY == 1 )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 ) )
     BaseType_t xEventGroupSetBitsFromISR( EventGroupHandle_t xEventGroup,
                                           const EventBits_t uxBitsToSet,
                                           BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
@@ -805,6 +882,87 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup ) PRIVILEGED_FUNCTION;
                                            StaticEventGroup_t ** ppxEventGroupBuffer ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * event_groups.h
+ * @code{c}
+ *  void vEventGroupGetStats( EventGroupHandle_t xEventGroup, EventGroupStats_t *pxStats );
+ *  void vEventGroupResetStats( EventGroupHandle_t xEventGroup );
+ * @endcode
+ *
+ * Read, or reset to zero, the statistics kept for an event group.  The
+ * statistics show how much scheduler suspended time and list walking an event
+ * group costs, which is otherwise hidden inside the kernel.
+ *
+ * Every call to xEventGroupSetBits(), and every set from an interrupt, counts
+ * as a set.  Each set is followed by a walk of the tasks that might be waiting
+ * for the bits, which is what unblocks them - except that, when
+ * configUSE_EVENT_GROUP_DIRECT_ISR_SET is 1, sets made from interrupts before
+ * the deferred walk runs share a single walk.  Bits cleared on exit by a task
+ * that waited for them do not count as a clear.
+ *
+ * ulWaitTimes is a histogram of how long a task was blocked before the bits it
+ * waited for were set, not counting timeouts.  Each wait time, in run time
+ * stats clock units, is first shifted right by
+ * configEVENT_GROUP_STATS_WAIT_SHIFT bits.  Bucket 0 counts the shifted times
+ * of 0, bucket n counts those from 2^(n-1) up to but not including 2^n, and
+ * the last of the configEVENT_GROUP_STATS_WAIT_BUCKETS buckets also counts
+ * everything longer.  The counters wrap on overflow.
+ *
+ * configUSE_EVENT_GROUP_STATS and configGENERATE_RUN_TIME_STATS must both be
+ * set to 1 in FreeRTOSConfig.h for these functions to be available.  The
+ * statistics of an event group that is being deleted can be read by the
+ * traceEVENT_GROUP_DELETE() trace macro.
+ *
+ * @param xEventGroup The event group.
+ *
+ * @param pxStats Where to write the statistics.
+ *
+ * \defgroup vEventGroupGetStats vEventGroupGetStats
+ * \ingroup EventGroup
+ */
+#if ( configUSE_EVENT_GROUP_STATS == 1 )
+    void vEventGroupGetStats( EventGroupHandle_t xEventGroup,
+                              EventGroupStats_t * pxStats ) PRIVILEGED_FUNCTION;
+    void vEventGroupResetStats( EventGroupHandle_t xEventGroup ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * event_groups.h
+ * @code{c}
+ *  void vEventGroupListStats( EventGroupHandle_t xEventGroup, char *pcWriteBuffer );
+ * @endcode
+ *
+ * Writes the statistics of an event group to pcWriteBuffer as a single line of
+ * text, for trace and debug output.  The line holds, separated by tabs, the
+ * event group's trace facility number (see vEventGroupSetNumber()), then the
+ * members of EventGroupStats_t in the order they are declared, ending with the
+ * ulWaitTimes buckets.
+ *
+ * configUSE_EVENT_GROUP_STATS, configUSE_TRACE_FACILITY and
+ * configUSE_STATS_FORMATTING_FUNCTIONS must be defined as 1 in FreeRTOSConfig.h
+ * for this function to be available.
+ *
+ * NOTE 1: This function is provided for convenience only, and has a dependency
+ * on sprintf() - as does vTaskList().  Production code should call
+ * vEventGroupGetStats() directly.
+ *
+ * NOTE 2: pcWriteBuffer must be large enough to hold the line.  Allowing 21
+ * characters for each of the two times, 12 for each other value, plus 3 for
+ * the line ending, is sufficient.
+ *
+ * @param xEventGroup The event group.
+ *
+ * @param pcWriteBuffer A buffer into which the statistics will be written, in
+ * ASCII form.
+ *
+ * \defgroup vEventGroupListStats vEventGroupListStats
+ * \ingroup EventGroup
+ */
+#if ( ( configUSE_EVENT_GROUP_STATS == 1 ) && ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
+    void vEventGroupListStats( EventGroupHandle_t xEventGroup,
+                               char * pcWriteBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
 /* For internal use only. */
 void vEventGroupSetBitsCallback( void * pvEventGroup,
                                  const uint32_t ulBitsToSet ) PRIVILEGED_FUNCTION;
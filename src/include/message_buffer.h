@@ -797,6 +797,249 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
 #define xMessageBufferNextLengthBytes( xMessageBuffer ) \
     xStreamBufferNextMessageLengthBytes( xMessageBuffer ) PRIVILEGED_FUNCTION;
 
+/**
+ * message_buffer.h
+ * @code{c}
+ * void * pvMessageBufferReserve( MessageBufferHandle_t xMessageBuffer,
+ *                                size_t xMessageLength,
+ *                                TickType_t xTicksToWait );
+ * void vMessageBufferCommit( MessageBufferHandle_t xMessageBuffer,
+ *                            void * const pvReservedMessage,
+ *                            size_t xMessageLength );
+ * @endcode
+ *
+ * Write a message to a message buffer without copying it.
+ * pvMessageBufferReserve() returns a pointer to xMessageLength contiguous
+ * bytes in the message buffer's own storage area, the writer builds the
+ * message in place, then vMessageBufferCommit() makes the message available to
+ * the reader.  The message can be committed with a length shorter than the
+ * length reserved.
+ *
+ * A reserved message is never split across the end of the storage area.  If
+ * it would be, it is placed at the start of the storage area instead and the
+ * bytes it skipped are unusable until the message is received, so a reserved
+ * message can need up to twice the space of one sent with
+ * xMessageBufferSend().  For the same reason the largest value that can be
+ * held in configMESSAGE_BUFFER_LENGTH_TYPE is reserved, and cannot be used as a
+ * message length.
+ *
+ * Reserving does not claim the space, so the writer must not otherwise write
+ * to the message buffer between the two calls.  A reserved message that is not
+ * needed is simply not committed.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these macros to be available.  They must not be called from an interrupt
+ * service routine.  Use xMessageBufferPeek() and vMessageBufferConsume() to
+ * read messages without copying them.
+ *
+ * @param xMessageBuffer The handle of the message buffer to write to.
+ *
+ * @param xMessageLength The length of the message in bytes.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for enough space, in the same way as
+ * xMessageBufferSend().
+ *
+ * @param pvReservedMessage The pointer returned by pvMessageBufferReserve().
+ *
+ * @return pvMessageBufferReserve() returns a pointer to the space reserved for
+ * the message, or NULL if the block time expired first.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( MessageBufferHandle_t xMessageBuffer )
+ * {
+ * uint8_t *pucFrame;
+ *
+ *  pucFrame = pvMessageBufferReserve( xMessageBuffer, 1500, portMAX_DELAY );
+ *
+ *  if( pucFrame != NULL )
+ *  {
+ *      // Build the frame directly in pucFrame, then post it.
+ *      vMessageBufferCommit( xMessageBuffer, pucFrame, 1500 );
+ *  }
+ * }
+ * @endcode
+ * \defgroup pvMessageBufferReserve pvMessageBufferReserve
+ * \ingroup MessageBufferManagement
+ */
+#define pvMessageBufferReserve( xMessageBuffer, xMessageLength, xTicksToWait ) \
+    pvStreamBufferReserveMessage( ( xMessageBuffer ), ( xMessageLength ), ( xTicksToWait ) )
+#define vMessageBufferCommit( xMessageBuffer, pvReservedMessage, xMessageLength ) \
+    vStreamBufferCommitMessage( ( xMessageBuffer ), ( pvReservedMessage ), ( xMessageLength ) )
+
+/**
+ * message_buffer.h
+ * @code{c}
+ * size_t xMessageBufferPeek( MessageBufferHandle_t xMessageBuffer,
+ *                            StreamBufferSpans_t * const pxSpans,
+ *                            TickType_t xTicksToWait );
+ * void vMessageBufferConsume( MessageBufferHandle_t xMessageBuffer,
+ *                             size_t xMessageLength );
+ * @endcode
+ *
+ * Read a message from a message buffer without copying it.
+ * xMessageBufferPeek() describes the next message in place, and
+ * vMessageBufferConsume() removes it from the message buffer once the reader
+ * has finished with it.  Messages written with pvMessageBufferReserve() are
+ * always described by pxSpans->pucFirst alone.  Messages written with
+ * xMessageBufferSend() may wrap, in which case the remainder of the message is
+ * at pxSpans->pucSecond.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these macros to be available.  See xStreamBufferPeek().
+ *
+ * @param xMessageBuffer The handle of the message buffer to read from.
+ *
+ * @param pxSpans Set to describe the next message.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for a message, in the same way as
+ * xMessageBufferReceive().
+ *
+ * @param xMessageLength The length returned by xMessageBufferPeek().
+ *
+ * @return xMessageBufferPeek() returns the length of the next message, or zero
+ * if the block time expired before a message became available.
+ *
+ * \defgroup xMessageBufferPeek xMessageBufferPeek
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferPeek( xMessageBuffer, pxSpans, xTicksToWait ) \
+    xStreamBufferPeek( ( xMessageBuffer ), ( pxSpans ), ( xTicksToWait ) )
+#define vMessageBufferConsume( xMessageBuffer, xMessageLength ) \
+    vStreamBufferConsume( ( xMessageBuffer ), ( xMessageLength ) )
+
+/**
+ * message_buffer.h
+ * @code{c}
+ * size_t xMessageBufferSendVector( MessageBufferHandle_t xMessageBuffer,
+ *                                  const StreamBufferFragment_t * pxFragments,
+ *                                  size_t xFragmentCount,
+ *                                  TickType_t xTicksToWait );
+ * size_t xMessageBufferSendVectorFromISR( MessageBufferHandle_t xMessageBuffer,
+ *                                         const StreamBufferFragment_t * pxFragments,
+ *                                         size_t xFragmentCount,
+ *                                         BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Sends one message made up of xFragmentCount fragments, without first
+ * assembling it in a temporary buffer.  The length of the message is the total
+ * length of the fragments.  Otherwise the same as xMessageBufferSend() and
+ * xMessageBufferSendFromISR().
+ *
+ * configUSE_STREAM_BUFFER_SCATTER_GATHER must be set to 1 in FreeRTOSConfig.h
+ * for these macros to be available.  See xStreamBufferSendVector().
+ *
+ * \defgroup xMessageBufferSendVector xMessageBufferSendVector
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendVector( xMessageBuffer, pxFragments, xFragmentCount, xTicksToWait ) \
+    xStreamBufferSendVector( ( xMessageBuffer ), ( pxFragments ), ( xFragmentCount ), ( xTicksToWait ) )
+#define xMessageBufferSendVectorFromISR( xMessageBuffer, pxFragments, xFragmentCount, pxHigherPriorityTaskWoken ) \
+    xStreamBufferSendVectorFromISR( ( xMessageBuffer ), ( pxFragments ), ( xFragmentCount ), ( pxHigherPriorityTaskWoken ) )
+
+/**
+ * message_buffer.h
+ * @code{c}
+ * size_t xMessageBufferReceiveMany( MessageBufferHandle_t xMessageBuffer,
+ *                                   void * pvRxData,
+ *                                   size_t xBufferLengthBytes,
+ *                                   size_t * const pxMessageLengths,
+ *                                   size_t xMaxMessages,
+ *                                   TickType_t xTicksToWait );
+ * size_t xMessageBufferReceiveManyFromISR( MessageBufferHandle_t xMessageBuffer,
+ *                                          void * pvRxData,
+ *                                          size_t xBufferLengthBytes,
+ *                                          size_t * const pxMessageLengths,
+ *                                          size_t xMaxMessages,
+ *                                          BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Receives as many messages as are available, up to xMaxMessages, in one call.
+ * The messages are copied one after another into pvRxData and the length of
+ * each is stored in pxMessageLengths.  Receiving stops early at the first
+ * message that does not fit in the remaining space, which is left in the
+ * message buffer.  A task waiting to send is notified once, after all the
+ * messages have been received, rather than once per message.
+ *
+ * Only the first message is waited for - xMessageBufferReceiveMany() blocks
+ * in the same way as xMessageBufferReceive() when the message buffer is empty,
+ * then returns whatever is available.
+ *
+ * configUSE_STREAM_BUFFER_SCATTER_GATHER must be set to 1 in FreeRTOSConfig.h
+ * for these macros to be available.
+ *
+ * @param xMessageBuffer The handle of the message buffer to read from.
+ *
+ * @param pvRxData A pointer to the buffer into which the messages are copied.
+ *
+ * @param xBufferLengthBytes The length of the buffer pointed to by pvRxData.
+ *
+ * @param pxMessageLengths An array of at least xMaxMessages elements, set to
+ * the length of each message received.
+ *
+ * @param xMaxMessages The maximum number of messages to receive.
+ *
+ * @param xTicksToWait As for xMessageBufferReceive().
+ *
+ * @param pxHigherPriorityTaskWoken As for xMessageBufferReceiveFromISR().
+ *
+ * @return The number of messages received.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( MessageBufferHandle_t xMessageBuffer )
+ * {
+ * uint8_t ucRxData[ 256 ];
+ * size_t xLengths[ 8 ], xMessages, x, xOffset = 0;
+ *
+ *  xMessages = xMessageBufferReceiveMany( xMessageBuffer, ucRxData, sizeof( ucRxData ), xLengths, 8, portMAX_DELAY );
+ *
+ *  for( x = 0; x < xMessages; x++ )
+ *  {
+ *      // Process the message at &( ucRxData[ xOffset ] ).
+ *      xOffset += xLengths[ x ];
+ *  }
+ * }
+ * @endcode
+ * \defgroup xMessageBufferReceiveMany xMessageBufferReceiveMany
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferReceiveMany( xMessageBuffer, pvRxData, xBufferLengthBytes, pxMessageLengths, xMaxMessages, xTicksToWait ) \
+    xStreamBufferReceiveMessages( ( xMessageBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxMessageLengths ), ( xMaxMessages ), ( xTicksToWait ) )
+#define xMessageBufferReceiveManyFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxMessageLengths, xMaxMessages, pxHigherPriorityTaskWoken ) \
+    xStreamBufferReceiveMessagesFromISR( ( xMessageBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxMessageLengths ), ( xMaxMessages ), ( pxHigherPriorityTaskWoken ) )
+
+/**
+ * message_buffer.h
+ * @code{c}
+ * void vMessageBufferSetHostDoorbell( MessageBufferHandle_t xMessageBuffer,
+ *                                     UBaseType_t uxInterruptNumber );
+ * size_t xMessageBufferSendFromHost( MessageBufferHandle_t xMessageBuffer,
+ *                                    const void * pvTxData,
+ *                                    size_t xDataLengthBytes );
+ * BaseType_t xMessageBufferHostDoorbellFromISR( MessageBufferHandle_t xMessageBuffer,
+ *                                               BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Writes a message from a thread that is not a task, such as a host thread on
+ * a simulator port, without blocking and without calling into the kernel.  The
+ * message is written completely or not at all.
+ *
+ * configUSE_STREAM_BUFFER_HOST_WRITER must be set to 1 in FreeRTOSConfig.h for
+ * these macros to be available.  See xStreamBufferSendFromHost().
+ *
+ * \defgroup xMessageBufferSendFromHost xMessageBufferSendFromHost
+ * \ingroup MessageBufferManagement
+ */
+#define vMessageBufferSetHostDoorbell( xMessageBuffer, uxInterruptNumber ) \
+    vStreamBufferSetHostDoorbell( ( xMessageBuffer ), ( uxInterruptNumber ) )
+#define xMessageBufferSendFromHost( xMessageBuffer, pvTxData, xDataLengthBytes ) \
+    xStreamBufferSendFromHost( ( xMessageBuffer ), ( pvTxData ), ( xDataLengthBytes ) )
+#define xMessageBufferHostDoorbellFromISR( xMessageBuffer, pxHigherPriorityTaskWoken ) \
+    xStreamBufferHostDoorbellFromISR( ( xMessageBuffer ), ( pxHigherPriorityTaskWoken ) )
+
 /**
  * message_buffer.h
  *
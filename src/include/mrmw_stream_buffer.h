@@ -0,0 +1,251 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Multi-reader, multi-writer stream buffers.
+ *
+ * An MRMW stream buffer carries a stream of bytes, like a stream buffer created
+ * with xStreamBufferCreate(), but any number of tasks can write to it and read
+ * from it at the same time without the application providing a lock.
+ *
+ * A writer reserves the space it needs with a single C11 compare and exchange,
+ * then copies its data in while other writers copy their data into the space
+ * they reserved.  Each write is all or nothing, so the bytes of one write are
+ * never interleaved with those of another.  Writes become visible to readers in
+ * the order the space was reserved - a writer that finishes copying before the
+ * writers that reserved space ahead of it waits for them to finish.  Readers
+ * share the data the same way, each taking the next bytes available.
+ *
+ * Tasks waiting for space or data wait on event lists, in priority order, so
+ * any number of tasks can be blocked on each side.
+ *
+ * The functions must not be called from an interrupt service routine.
+ * configUSE_MRMW_STREAM_BUFFERS must be set to 1 in FreeRTOSConfig.h, and the
+ * compiler must support C11 <stdatomic.h>, for MRMW stream buffers to be
+ * available.
+ */
+
+#ifndef MRMW_STREAM_BUFFER_H
+#define MRMW_STREAM_BUFFER_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include mrmw_stream_buffer.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which MRMW stream buffers are referenced.  For example, a call to
+ * xMRMWStreamBufferCreate() returns an MRMWStreamBufferHandle_t variable that
+ * can then be used as a parameter to xMRMWStreamBufferSend(),
+ * xMRMWStreamBufferReceive(), etc.
+ */
+struct MRMWStreamBufferDefinition;
+typedef struct MRMWStreamBufferDefinition * MRMWStreamBufferHandle_t;
+
+/**
+ * mrmw_stream_buffer.h
+ *
+ * @code{c}
+ * MRMWStreamBufferHandle_t xMRMWStreamBufferCreate( size_t xBufferSizeBytes );
+ * @endcode
+ *
+ * Creates a new MRMW stream buffer using dynamically allocated memory.  See
+ * xMRMWStreamBufferCreateStatic() for a version that uses statically allocated
+ * memory.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xMRMWStreamBufferCreate() to be available.
+ *
+ * @param xBufferSizeBytes The total number of bytes the buffer will be able to
+ * hold at any one time.  This is also the largest single write.
+ *
+ * @return If the buffer is successfully created then a handle to the created
+ * buffer is returned.  If the buffer cannot be created then NULL is returned.
+ *
+ * \defgroup xMRMWStreamBufferCreate xMRMWStreamBufferCreate
+ * \ingroup MRMWStreamBufferManagement
+ */
+MRMWStreamBufferHandle_t xMRMWStreamBufferCreate( size_t xBufferSizeBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * mrmw_stream_buffer.h
+ *
+ * @code{c}
+ * MRMWStreamBufferHandle_t xMRMWStreamBufferCreateStatic( size_t xBufferSizeBytes,
+ *                                                         uint8_t *pucStorage,
+ *                                                         StaticMRMWStreamBuffer_t *pxStaticBuffer );
+ * @endcode
+ *
+ * Creates a new MRMW stream buffer using statically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xMRMWStreamBufferCreateStatic() to be available.
+ *
+ * @param xBufferSizeBytes The total number of bytes the buffer will be able to
+ * hold at any one time.
+ *
+ * @param pucStorage Must point to a uint8_t array that is at least
+ * xBufferSizeBytes big.
+ *
+ * @param pxStaticBuffer Must point to a variable of type
+ * StaticMRMWStreamBuffer_t, which will be used to hold the buffer's data
+ * structure.
+ *
+ * @return If neither pucStorage or pxStaticBuffer are NULL then a handle to the
+ * created buffer is returned, otherwise NULL is returned.
+ *
+ * \defgroup xMRMWStreamBufferCreateStatic xMRMWStreamBufferCreateStatic
+ * \ingroup MRMWStreamBufferManagement
+ */
+MRMWStreamBufferHandle_t xMRMWStreamBufferCreateStatic( size_t xBufferSizeBytes,
+                                                        uint8_t * pucStorage,
+                                                        StaticMRMWStreamBuffer_t * pxStaticBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * mrmw_stream_buffer.h
+ *
+ * @code{c}
+ * void vMRMWStreamBufferDelete( MRMWStreamBufferHandle_t xBuffer );
+ * @endcode
+ *
+ * Deletes an MRMW stream buffer.  No task may be using the buffer, or be
+ * blocked on it, when it is deleted.
+ *
+ * \defgroup vMRMWStreamBufferDelete vMRMWStreamBufferDelete
+ * \ingroup MRMWStreamBufferManagement
+ */
+void vMRMWStreamBufferDelete( MRMWStreamBufferHandle_t xBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * mrmw_stream_buffer.h
+ *
+ * @code{c}
+ * size_t xMRMWStreamBufferSend( MRMWStreamBufferHandle_t xBuffer,
+ *                               const void *pvTxData,
+ *                               size_t xDataLengthBytes,
+ *                               TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Appends xDataLengthBytes bytes to an MRMW stream buffer.  Unlike
+ * xStreamBufferSend(), either all the bytes are written or none are, so the
+ * bytes cannot be interleaved with those of a write made by another task.
+ *
+ * Once its data is copied in the calling task can still block until every
+ * write that reserved space before it has finished, even if xTicksToWait is
+ * zero.  That wait is not subject to priority inheritance.
+ *
+ * @param xBuffer The handle of the buffer to write to.
+ *
+ * @param pvTxData A pointer to the bytes to copy into the buffer.
+ *
+ * @param xDataLengthBytes The number of bytes to write.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for xDataLengthBytes bytes of space to become
+ * free.  The calling task will not block for space if xTicksToWait is zero,
+ * or if xDataLengthBytes is larger than the buffer.
+ *
+ * @return xDataLengthBytes if the bytes were written, otherwise zero.
+ *
+ * \defgroup xMRMWStreamBufferSend xMRMWStreamBufferSend
+ * \ingroup MRMWStreamBufferManagement
+ */
+size_t xMRMWStreamBufferSend( MRMWStreamBufferHandle_t xBuffer,
+                              const void * pvTxData,
+                              size_t xDataLengthBytes,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mrmw_stream_buffer.h
+ *
+ * @code{c}
+ * size_t xMRMWStreamBufferReceive( MRMWStreamBufferHandle_t xBuffer,
+ *                                  void *pvRxData,
+ *                                  size_t xBufferLengthBytes,
+ *                                  TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Removes up to xBufferLengthBytes bytes from an MRMW stream buffer, in the
+ * same way as xStreamBufferReceive().  If several tasks receive at the same
+ * time each gets a different part of the stream.
+ *
+ * Once its data is copied out the calling task can still block until every
+ * task that started receiving before it has finished, even if xTicksToWait is
+ * zero.
+ *
+ * @param xBuffer The handle of the buffer to read from.
+ *
+ * @param pvRxData A pointer to the buffer into which the bytes are copied.
+ *
+ * @param xBufferLengthBytes The length of the buffer pointed to by pvRxData.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for data to become available.
+ *
+ * @return The number of bytes received, which is zero if the block time
+ * expired before any data became available.
+ *
+ * \defgroup xMRMWStreamBufferReceive xMRMWStreamBufferReceive
+ * \ingroup MRMWStreamBufferManagement
+ */
+size_t xMRMWStreamBufferReceive( MRMWStreamBufferHandle_t xBuffer,
+                                 void * pvRxData,
+                                 size_t xBufferLengthBytes,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mrmw_stream_buffer.h
+ *
+ * @code{c}
+ * size_t xMRMWStreamBufferBytesAvailable( MRMWStreamBufferHandle_t xBuffer );
+ * size_t xMRMWStreamBufferSpacesAvailable( MRMWStreamBufferHandle_t xBuffer );
+ * @endcode
+ *
+ * Return the number of bytes that can be received from, and the number of
+ * bytes that can be written to, an MRMW stream buffer.  Bytes that are still
+ * being copied in or out by other tasks are not counted.  The values are only
+ * snapshots while other tasks are using the buffer.
+ *
+ * \defgroup xMRMWStreamBufferBytesAvailable xMRMWStreamBufferBytesAvailable
+ * \ingroup MRMWStreamBufferManagement
+ */
+size_t xMRMWStreamBufferBytesAvailable( MRMWStreamBufferHandle_t xBuffer ) PRIVILEGED_FUNCTION;
+size_t xMRMWStreamBufferSpacesAvailable( MRMWStreamBufferHandle_t xBuffer ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( MRMW_STREAM_BUFFER_H ) */
@@ -76,6 +76,7 @@ typedef struct QueueDefinition   * QueueSetMemberHandle_t;
 #define queueQUEUE_TYPE_COUNTING_SEMAPHORE    ( ( uint8_t ) 2U )
 #define queueQUEUE_TYPE_BINARY_SEMAPHORE      ( ( uint8_t ) 3U )
 #define queueQUEUE_TYPE_RECURSIVE_MUTEX       ( ( uint8_t ) 4U )
+#define queueQUEUE_TYPE_PRIORITY              ( ( uint8_t ) 5U )
 
 /**
  * queue. h
@@ -541,7 +542,9 @@ typedef struct QueueDefinition   * QueueSetMemberHandle_t;
  * @return xQueueOverwrite() is a macro that calls xQueueGenericSend(), and
  * therefore has the same return values as xQueueSendToFront().  However, pdPASS
  * is the only value that can be returned because xQueueOverwrite() will write
- * to the queue even when the queue is already full.
+ * to the queue even when the queue is already full.  The exception is a queue
+ * with a slot reserved or an item acquired, see pvQueueReserve() and
+ * pvQueueAcquire(), to which it returns errQUEUE_FULL.
  *
  * Example usage:
  * @code{c}
@@ -688,6 +691,76 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                               TickType_t xTicksToWait,
                               const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueSendMultiple(
+ *                                 QueueHandle_t xQueue,
+ *                                 const void * const pvItemsToQueue,
+ *                                 const UBaseType_t uxItemsToQueue,
+ *                                 TickType_t xTicksToWait
+ *                               );
+ * @endcode
+ *
+ * Post a batch of items to the back of a queue.  As many items as there is
+ * room for are copied in each critical section, using at most two memcpy()
+ * calls, and tasks waiting to receive from the queue are woken once per
+ * batch rather than once per item.  The items are queued in order, but items
+ * posted by other tasks or interrupts may be interleaved with them if the
+ * calling task has to block part way through the batch.
+ *
+ * This function must not be called from an interrupt service routine, or on a
+ * semaphore or mutex.  See xQueueSendMultipleFromISR() for an alternative
+ * which may be used in an ISR.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemsToQueue items, each
+ * the size the queue was created to hold.
+ *
+ * @param uxItemsToQueue The number of items to post.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to post the whole batch.  The call will return
+ * immediately, having posted as many items as there was room for, if this is
+ * set to 0.  The time is defined in tick periods so the constant
+ * portTICK_PERIOD_MS should be used to convert to real time if this is
+ * required.
+ *
+ * @return The number of items posted.  This is less than uxItemsToQueue if
+ * the block time expired first.
+ *
+ * Example usage:
+ * @code{c}
+ * uint16_t usSamples[ 64 ];
+ *
+ * void vATask( void *pvParameters )
+ * {
+ * QueueHandle_t xQueue;
+ * UBaseType_t uxSent;
+ *
+ *  // Create a queue capable of containing 128 uint16_t values.
+ *  xQueue = xQueueCreate( 128, sizeof( uint16_t ) );
+ *
+ *  // ... Fill usSamples.
+ *
+ *  // Send the 64 samples, waiting up to 10 ticks for room if necessary.
+ *  uxSent = xQueueSendMultiple( xQueue, usSamples, 64, ( TickType_t ) 10 );
+ *
+ *  if( uxSent != 64 )
+ *  {
+ *      // Only the first uxSent samples were posted.
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                const void * const pvItemsToQueue,
+                                const UBaseType_t uxItemsToQueue,
+                                TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * @code{c}
@@ -914,6 +987,51 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                           void * const pvBuffer,
                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueReceiveMultiple(
+ *                                    QueueHandle_t xQueue,
+ *                                    void * const pvBuffer,
+ *                                    const UBaseType_t uxItemsToReceive,
+ *                                    TickType_t xTicksToWait
+ *                                  );
+ * @endcode
+ *
+ * Receive a batch of items from a queue.  As many items as the queue holds
+ * are copied in each critical section, using at most two memcpy() calls, and
+ * tasks waiting to post to the queue are woken once per batch rather than once
+ * per item.
+ *
+ * This function must not be called from an interrupt service routine, or on a
+ * semaphore or mutex.  See xQueueReceiveMultipleFromISR() for an alternative
+ * which may be used in an ISR.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to a buffer large enough to hold uxItemsToReceive
+ * items, into which the received items will be copied.
+ *
+ * @param uxItemsToReceive The number of items to receive.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for the whole batch to arrive.  The call will return immediately,
+ * having received as many items as the queue held, if this is set to 0.  The
+ * time is defined in tick periods so the constant portTICK_PERIOD_MS should be
+ * used to convert to real time if this is required.
+ *
+ * @return The number of items received.  This is less than uxItemsToReceive
+ * if the block time expired first.
+ *
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                   void * const pvBuffer,
+                                   const UBaseType_t uxItemsToReceive,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * @code{c}
@@ -1145,7 +1263,9 @@ void vQueueDelete( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
  * xQueueGenericSendFromISR(), and therefore has the same return values as
  * xQueueSendToFrontFromISR().  However, pdPASS is the only value that can be
  * returned because xQueueOverwriteFromISR() will write to the queue even when
- * the queue is already full.
+ * the queue is already full.  The exception is a queue with a slot reserved or
+ * an item acquired, see pvQueueReserve() and pvQueueAcquire(), to which it
+ * returns errQUEUE_FULL.
  *
  * Example usage:
  * @code{c}
@@ -1447,6 +1567,377 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
                                  void * const pvBuffer,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t xQueueSendMultipleFromISR(
+ *                                        QueueHandle_t xQueue,
+ *                                        const void * const pvItemsToQueue,
+ *                                        const UBaseType_t uxItemsToQueue,
+ *                                        BaseType_t * const pxHigherPriorityTaskWoken
+ *                                      );
+ *
+ * UBaseType_t xQueueReceiveMultipleFromISR(
+ *                                           QueueHandle_t xQueue,
+ *                                           void * const pvBuffer,
+ *                                           const UBaseType_t uxItemsToReceive,
+ *                                           BaseType_t * const pxHigherPriorityTaskWoken
+ *                                         );
+ * @endcode
+ *
+ * Versions of xQueueSendMultiple() and xQueueReceiveMultiple() that can be used
+ * from an interrupt service routine.  They never block, so post as many items
+ * as there is room for, or receive as many items as the queue holds, up to the
+ * number requested.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the call unblocked a task
+ * with a priority higher than the currently running task, in which case a
+ * context switch should be requested before the interrupt is exited.  Can be
+ * NULL.
+ *
+ * @return The number of items posted or received.
+ *
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                       const void * const pvItemsToQueue,
+                                       const UBaseType_t uxItemsToQueue,
+                                       BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                          void * const pvBuffer,
+                                          const UBaseType_t uxItemsToReceive,
+                                          BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void * pvQueueReserve( QueueHandle_t xQueue, TickType_t xTicksToWait );
+ * void vQueueCommit( QueueHandle_t xQueue, void * const pvReservedItem );
+ * @endcode
+ *
+ * Post an item to the back of a queue without copying it.  pvQueueReserve()
+ * returns a pointer to the slot in the queue storage area the item will
+ * occupy, the caller writes the item in place, then vQueueCommit() makes it
+ * available to receivers.
+ *
+ * A queue can only have one slot reserved at a time, however many free slots
+ * it has.  Until the slot is committed the queue appears full to every other
+ * sender: xQueueSend() and pvQueueReserve() block or fail as they would on a
+ * full queue, the FromISR() send functions send nothing, and
+ * uxQueueSpacesAvailable() returns 0.  This includes the task holding the
+ * reservation, so a task that calls pvQueueReserve() twice without committing
+ * in between waits until the second call times out.  Reservations should
+ * therefore be held only for as long as it takes to write the item; a producer
+ * that needs several items in place at once needs a queue of its own.
+ * xQueueOverwrite() would write to the reserved slot, so while a slot is
+ * reserved it too finds the queue full and, as it never blocks, it and
+ * xQueueOverwriteFromISR() return errQUEUE_FULL.
+ *
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.  They must not be called from an interrupt
+ * service routine, or on a semaphore or mutex.
+ *
+ * @param xQueue The handle to the queue on which the item is to be posted.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a free slot, in the same way as xQueueSend().
+ *
+ * @param pvReservedItem The pointer returned by pvQueueReserve().
+ *
+ * @return pvQueueReserve() returns a pointer to the reserved slot, or NULL if
+ * the block time expired before a slot became free.
+ *
+ * Example usage:
+ * @code{c}
+ * struct AFrame
+ * {
+ *  uint8_t ucSamples[ 512 ];
+ * };
+ *
+ * void vAProducerTask( void *pvParameters )
+ * {
+ * QueueHandle_t xQueue = ( QueueHandle_t ) pvParameters;
+ * struct AFrame *pxFrame;
+ *
+ *  for( ;; )
+ *  {
+ *      pxFrame = pvQueueReserve( xQueue, portMAX_DELAY );
+ *
+ *      // ... Fill pxFrame->ucSamples directly.
+ *
+ *      vQueueCommit( xQueue, pxFrame );
+ *  }
+ * }
+ * @endcode
+ * \defgroup pvQueueReserve pvQueueReserve
+ * \ingroup QueueManagement
+ */
+void * pvQueueReserve( QueueHandle_t xQueue,
+                       TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vQueueCommit( QueueHandle_t xQueue,
+                   void * const pvReservedItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void * pvQueueAcquire( QueueHandle_t xQueue, TickType_t xTicksToWait );
+ * void vQueueRelease( QueueHandle_t xQueue, void * const pvAcquiredItem );
+ * @endcode
+ *
+ * Receive an item from a queue without copying it.  pvQueueAcquire() returns
+ * a pointer to the item at the front of the queue, in the queue storage area,
+ * and vQueueRelease() removes it from the queue once the caller has finished
+ * with it.
+ *
+ * A queue can only have one item acquired at a time, however many items it
+ * holds.  Until the item is released the queue appears empty to every other
+ * receiver: xQueueReceive() and pvQueueAcquire() block or fail as they would
+ * on an empty queue, and the FromISR() receive functions receive nothing,
+ * although xQueuePeek() still copies out the acquired item and
+ * uxQueueMessagesWaiting() still counts it.  This includes the task holding
+ * the item, so a task that calls pvQueueAcquire() twice without releasing in
+ * between waits until the second call times out.  Items should therefore be
+ * held only for as long as it takes to consume them.  xQueueSendToFront() and
+ * xQueueOverwrite() would write over the acquired item, so while an item is
+ * acquired they find the queue full, even if it has free space:
+ * xQueueSendToFront() blocks until the item is released or its block time
+ * expires, and xQueueOverwrite() and the FromISR() versions of both return
+ * errQUEUE_FULL.
+ *
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.  They must not be called from an interrupt
+ * service routine, or on a semaphore or mutex.
+ *
+ * @param xQueue The handle to the queue from which the item is to be
+ * received.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item, in the same way as xQueueReceive().
+ *
+ * @param pvAcquiredItem The pointer returned by pvQueueAcquire().
+ *
+ * @return pvQueueAcquire() returns a pointer to the item, or NULL if the block
+ * time expired before an item was available.
+ *
+ * \defgroup pvQueueAcquire pvQueueAcquire
+ * \ingroup QueueManagement
+ */
+void * pvQueueAcquire( QueueHandle_t xQueue,
+                       TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vQueueRelease( QueueHandle_t xQueue,
+                    void * const pvAcquiredItem ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * QueueHandle_t xQueueCreatePriority(
+ *                                     UBaseType_t uxQueueLength,
+ *                                     UBaseType_t uxItemSize
+ *                                   );
+ * @endcode
+ *
+ * Creates a priority queue.  Each item is sent to a priority queue with an
+ * integer key, and the item with the lowest key is always the next to be
+ * received.  Items sent with the same key are received in the order they were
+ * sent.  Sending and receiving take O(log n) time, where n is the number of
+ * items in the queue, and block in the same way as xQueueSend() and
+ * xQueueReceive().  This allows prioritised work items to be passed through a
+ * single queue, rather than one queue per priority grouped by a queue set.
+ *
+ * Priority queues can only be used with xQueueSendWithKey(),
+ * xQueueReceiveWithKey() and their FromISR versions, though they can also be
+ * passed to the functions that query, reset, delete or register a queue, and
+ * can be added to a queue set.
+ *
+ * configUSE_PRIORITY_QUEUES must be set to 1 in FreeRTOSConfig.h for priority
+ * queues to be available.
+ *
+ * @param uxQueueLength The maximum number of items the queue can hold at any
+ * one time.
+ *
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ * Must be greater than zero.
+ *
+ * @return If the queue is successfully created then a handle to the newly
+ * created queue is returned.  If the queue cannot be created then 0 is
+ * returned.
+ *
+ * \defgroup xQueueCreatePriority xQueueCreatePriority
+ * \ingroup QueueManagement
+ */
+#if ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    #define xQueueCreatePriority( uxQueueLength, uxItemSize )    xQueueGenericCreate( ( uxQueueLength ), ( uxItemSize ), ( queueQUEUE_TYPE_PRIORITY ) )
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * QueueHandle_t xQueueCreatePriorityStatic(
+ *                                           UBaseType_t uxQueueLength,
+ *                                           UBaseType_t uxItemSize,
+ *                                           uint8_t *pucQueueStorage,
+ *                                           StaticQueue_t *pxQueueBuffer
+ *                                         );
+ * @endcode
+ *
+ * Creates a priority queue using statically allocated memory.  See
+ * xQueueCreatePriority().
+ *
+ * @param pucQueueStorage Must point to a buffer of at least
+ * queuePRIORITY_QUEUE_STORAGE_SIZE( uxQueueLength, uxItemSize ) bytes, aligned
+ * for a UBaseType_t.  As well as the items the buffer holds the heap that
+ * orders them.
+ *
+ * @param pxQueueBuffer Must point to a variable of type StaticQueue_t, which
+ * will be used to hold the queue's data structure.
+ *
+ * \defgroup xQueueCreatePriorityStatic xQueueCreatePriorityStatic
+ * \ingroup QueueManagement
+ */
+#if ( ( configUSE_PRIORITY_QUEUES == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    #define queuePRIORITY_QUEUE_STORAGE_SIZE( uxQueueLength, uxItemSize )                   ( ( size_t ) ( uxQueueLength ) * ( ( size_t ) ( uxItemSize ) + ( 3U * sizeof( UBaseType_t ) ) ) )
+    #define xQueueCreatePriorityStatic( uxQueueLength, uxItemSize, pucQueueStorage, pxQueueBuffer )    xQueueGenericCreateStatic( ( uxQueueLength ), ( uxItemSize ), ( pucQueueStorage ), ( pxQueueBuffer ), ( queueQUEUE_TYPE_PRIORITY ) )
+#endif
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendWithKey(
+ *                               QueueHandle_t xQueue,
+ *                               const void * const pvItemToQueue,
+ *                               const UBaseType_t uxKey,
+ *                               TickType_t xTicksToWait
+ *                             );
+ * @endcode
+ *
+ * Post an item to a queue created by xQueueCreatePriority().  The item is
+ * queued by copy, and will be received after every item already in the queue
+ * that has a lower or equal key, and before every item that has a higher key.
+ *
+ * @param xQueue The handle to the priority queue on which the item is to be
+ * posted.
+ *
+ * @param pvItemToQueue A pointer to the item that is to be placed on the
+ * queue.
+ *
+ * @param uxKey The key to order the item by.  Lower keys are received first.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue, should it already be
+ * full.  The call will return immediately if this is set to 0.
+ *
+ * @return pdTRUE if the item was successfully posted, otherwise errQUEUE_FULL.
+ *
+ * Example usage:
+ * @code{c}
+ * struct AJob
+ * {
+ *  uint32_t ulJobID;
+ * } xJob;
+ *
+ * void vADispatcherTask( void *pvParameters )
+ * {
+ * QueueHandle_t xJobs = xQueueCreatePriority( 10, sizeof( struct AJob ) );
+ * UBaseType_t uxUrgency;
+ *
+ *  // Urgent jobs are sent with key 0 so overtake the routine jobs sent with
+ *  // key 1.
+ *  xQueueSendWithKey( xJobs, &xJob, 1, portMAX_DELAY );
+ *  xQueueSendWithKey( xJobs, &xJob, 0, portMAX_DELAY );
+ *
+ *  // Receives the urgent job first.
+ *  xQueueReceiveWithKey( xJobs, &xJob, &uxUrgency, portMAX_DELAY );
+ * }
+ * @endcode
+ * \defgroup xQueueSendWithKey xQueueSendWithKey
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendWithKey( QueueHandle_t xQueue,
+                              const void * const pvItemToQueue,
+                              const UBaseType_t uxKey,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueReceiveWithKey(
+ *                                  QueueHandle_t xQueue,
+ *                                  void * const pvBuffer,
+ *                                  UBaseType_t * const puxKey,
+ *                                  TickType_t xTicksToWait
+ *                                );
+ * @endcode
+ *
+ * Receive the item with the lowest key from a queue created by
+ * xQueueCreatePriority().  The item is received by copy and removed from the
+ * queue.
+ *
+ * @param xQueue The handle to the priority queue from which the item is to be
+ * received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the received item will be
+ * copied.
+ *
+ * @param puxKey Set to the key the item was sent with.  Can be NULL.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive should the queue be empty at the time of the
+ * call.
+ *
+ * @return pdTRUE if an item was successfully received from the queue,
+ * otherwise errQUEUE_EMPTY.
+ *
+ * \defgroup xQueueReceiveWithKey xQueueReceiveWithKey
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveWithKey( QueueHandle_t xQueue,
+                                 void * const pvBuffer,
+                                 UBaseType_t * const puxKey,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendWithKeyFromISR(
+ *                                      QueueHandle_t xQueue,
+ *                                      const void * const pvItemToQueue,
+ *                                      const UBaseType_t uxKey,
+ *                                      BaseType_t * const pxHigherPriorityTaskWoken
+ *                                    );
+ *
+ * BaseType_t xQueueReceiveWithKeyFromISR(
+ *                                         QueueHandle_t xQueue,
+ *                                         void * const pvBuffer,
+ *                                         UBaseType_t * const puxKey,
+ *                                         BaseType_t * const pxHigherPriorityTaskWoken
+ *                                       );
+ * @endcode
+ *
+ * Versions of xQueueSendWithKey() and xQueueReceiveWithKey() that can be used
+ * from an interrupt service routine.  They never block.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the call unblocked a task
+ * with a priority higher than the currently running task, in which case a
+ * context switch should be requested before the interrupt is exited.  Can be
+ * NULL.
+ *
+ * @return xQueueSendWithKeyFromISR() returns pdTRUE if the item was posted,
+ * otherwise errQUEUE_FULL.  xQueueReceiveWithKeyFromISR() returns pdTRUE if an
+ * item was received, otherwise pdFALSE.
+ *
+ * \defgroup xQueueSendWithKeyFromISR xQueueSendWithKeyFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendWithKeyFromISR( QueueHandle_t xQueue,
+                                     const void * const pvItemToQueue,
+                                     const UBaseType_t uxKey,
+                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+BaseType_t xQueueReceiveWithKeyFromISR( QueueHandle_t xQueue,
+                                        void * const pvBuffer,
+                                        UBaseType_t * const puxKey,
+                                        BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from within an ISR, or within a critical section.
@@ -1520,7 +2011,18 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
  * registry can hold.  configQUEUE_REGISTRY_SIZE must be greater than 0
  * within FreeRTOSConfig.h for the registry to be available.  Its value
  * does not affect the number of queues, semaphores and mutexes that can be
- * created - just the number that the registry can hold.
+ * created - just the number that the registry can hold.  configASSERT() is
+ * called if the registry is full.
+ *
+ * If configQUEUE_REGISTRY_HASHED is set to 1 in FreeRTOSConfig.h then the
+ * registry is instead held in the queues themselves, indexed by a hash of the
+ * name, and configQUEUE_REGISTRY_SIZE sets the number of hash buckets rather
+ * than the number of handles the registry can hold - any number of queues can
+ * be registered.  Adding, removing and looking up a queue by handle then take
+ * constant time, as does looking up a queue by name provided
+ * configQUEUE_REGISTRY_SIZE is not much less than the number of queues
+ * registered.  The hashed registry is not laid out the way kernel aware
+ * debuggers expect.
  *
  * If vQueueAddToRegistry is called more than once with the same xQueue
  * parameter, the registry will store the pcQueueName parameter from the
@@ -1569,6 +2071,23 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
     const char * pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
+/*
+ * The queue registry is provided as a means for kernel aware debuggers to
+ * locate queues, semaphores and mutexes.  Call xQueueGetHandle() to look up
+ * the handle of a queue in the queue registry from the queue's name.  Names
+ * are compared as strings.
+ *
+ * @param pcQueueName The name of the queue the handle of which will be
+ * returned.
+ * @return If a queue with the name is in the registry then its handle is
+ * returned.  If more than one queue has been registered with the name then it
+ * is not defined which of them is returned.  If no queue in the registry has
+ * the name then NULL is returned.
+ */
+#if ( configQUEUE_REGISTRY_SIZE > 0 )
+    QueueHandle_t xQueueGetHandle( const char * pcQueueName ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+#endif
+
 /*
  * Generic version of the function used to create a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
@@ -1634,6 +2153,17 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
  * semaphore) operation must not be performed on a member of a queue set unless
  * a call to xQueueSelectFromSet() has first returned a handle to that set member.
  *
+ * Note 5:  If configUSE_QUEUE_SET_READY_LIST is set to 1 in FreeRTOSConfig.h
+ * then a queue set does not store an event per item.  Instead each member holds
+ * a list item that links it into its set's list of ready members, so sending to
+ * a member only touches the set when the member becomes non-empty, and the set
+ * needs no storage area.  xQueueSelectFromSet() returns the ready members in
+ * turn, and returns the same member again on a later call if it still holds
+ * items, so Notes 3 and 4 no longer apply and uxEventQueueLength is not used.
+ * Each member uses the RAM of one list item, and each set that of one list,
+ * whatever the length of the members.  Queues and semaphores can be added to
+ * and removed from the set when they are not empty.
+ *
  * @param uxEventQueueLength Queue sets store events that occur on
  * the queues and semaphores contained in the set.  uxEventQueueLength specifies
  * the maximum number of events that can be queued at once.  To be absolutely
@@ -1674,15 +2204,17 @@ QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength ) PRIVILE
  *
  * @return If the queue or semaphore was successfully added to the queue set
  * then pdPASS is returned.  If the queue could not be successfully added to the
- * queue set because it is already a member of a different queue set then pdFAIL
- * is returned.
+ * queue set because it is already a member of a different queue set, or (unless
+ * configUSE_QUEUE_SET_READY_LIST is set to 1) it is not empty, then pdFAIL is
+ * returned.
  */
 BaseType_t xQueueAddToSet( QueueSetMemberHandle_t xQueueOrSemaphore,
                            QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
 
 /*
- * Removes a queue or semaphore from a queue set.  A queue or semaphore can only
- * be removed from a set if the queue or semaphore is empty.
+ * Removes a queue or semaphore from a queue set.  Unless
+ * configUSE_QUEUE_SET_READY_LIST is set to 1, a queue or semaphore can only be
+ * removed from a set if the queue or semaphore is empty.
  *
  * See FreeRTOS/Source/Demo/Common/Minimal/QueueSet.c for an example using this
  * function.
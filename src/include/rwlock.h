@@ -0,0 +1,218 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Readers-writer locks.
+ *
+ * A readers-writer lock protects data that is read often and written rarely.
+ * Any number of tasks can hold the lock for reading at the same time, or one
+ * task can hold it for writing.  Taking and giving the lock for reading is a
+ * single C11 atomic read-modify-write of the lock's state while no writer
+ * holds or is waiting for the lock, so readers never serialise on a critical
+ * section.  The kernel is only entered when a task has to block, or has to
+ * unblock another task.
+ *
+ * Waiting writers are preferred over new readers, but only over readers with
+ * the same or a lower priority - a reader with a higher priority than every
+ * waiting writer can still join the readers that hold the lock.  While a task
+ * holds the lock for writing, it inherits the priority of the highest priority
+ * task waiting for the lock, in the same way as a mutex holder.  Tasks that
+ * hold the lock for reading do not inherit priorities, as there can be any
+ * number of them.
+ *
+ * Readers-writer locks cannot be used from an interrupt, and are not
+ * recursive - a task must not take a lock it already holds.  A task that calls
+ * xRWLockTakeWrite() on a lock it holds for writing fails configASSERT().
+ *
+ * configUSE_RW_LOCKS must be set to 1 in FreeRTOSConfig.h, and the compiler
+ * must support C11 <stdatomic.h>, for readers-writer locks to be available.
+ */
+
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include rwlock.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which readers-writer locks are referenced.  For example, a call to
+ * xRWLockCreate() returns an RWLockHandle_t variable that can then be used as a
+ * parameter to xRWLockTakeRead(), xRWLockTakeWrite(), etc.
+ */
+struct RWLockDefinition;
+typedef struct RWLockDefinition * RWLockHandle_t;
+
+/**
+ * rwlock.h
+ *
+ * @code{c}
+ * RWLockHandle_t xRWLockCreate( void );
+ * @endcode
+ *
+ * Creates a readers-writer lock using dynamically allocated memory.  See
+ * xRWLockCreateStatic() for a version that uses statically allocated memory.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xRWLockCreate() to be available.
+ *
+ * @return If the lock is successfully created then a handle to the created
+ * lock is returned.  If the lock cannot be created then NULL is returned.
+ *
+ * \defgroup xRWLockCreate xRWLockCreate
+ * \ingroup RWLocks
+ */
+RWLockHandle_t xRWLockCreate( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *
+ * @code{c}
+ * RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t *pxRWLockBuffer );
+ * @endcode
+ *
+ * Creates a readers-writer lock using statically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xRWLockCreateStatic() to be available.
+ *
+ * @param pxRWLockBuffer Must point to a variable of type StaticRWLock_t, which
+ * will be used to hold the lock's data structure.
+ *
+ * @return If pxRWLockBuffer is not NULL then a handle to the created lock is
+ * returned, otherwise NULL is returned.
+ *
+ * \defgroup xRWLockCreateStatic xRWLockCreateStatic
+ * \ingroup RWLocks
+ */
+RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t * pxRWLockBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *
+ * @code{c}
+ * void vRWLockDelete( RWLockHandle_t xLock );
+ * @endcode
+ *
+ * Deletes a readers-writer lock.  The lock must not be held, and no task may
+ * be blocked on it, when it is deleted.
+ *
+ * \defgroup vRWLockDelete vRWLockDelete
+ * \ingroup RWLocks
+ */
+void vRWLockDelete( RWLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *
+ * @code{c}
+ * BaseType_t xRWLockTakeRead( RWLockHandle_t xLock, TickType_t xTicksToWait );
+ * BaseType_t xRWLockGiveRead( RWLockHandle_t xLock );
+ * @endcode
+ *
+ * Take a readers-writer lock for reading, and give it back once the data it
+ * protects has been read.  Other tasks can hold the lock for reading at the
+ * same time.
+ *
+ * @param xLock The handle of the lock.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for the lock if a task holds it for writing, or
+ * a task with the same or a higher priority is waiting to take it for writing.
+ * The calling task will not block if xTicksToWait is zero.
+ *
+ * @return xRWLockTakeRead() returns pdPASS if the lock was taken, otherwise
+ * pdFAIL.  xRWLockGiveRead() returns pdPASS.
+ *
+ * Example usage:
+ * @code{c}
+ * RWLockHandle_t xConfigLock;
+ * struct AConfig xConfig;
+ *
+ * uint32_t ulGetTimeout( void )
+ * {
+ * uint32_t ulTimeout = 0;
+ *
+ *  if( xRWLockTakeRead( xConfigLock, pdMS_TO_TICKS( 10 ) ) == pdPASS )
+ *  {
+ *      ulTimeout = xConfig.ulTimeout;
+ *      xRWLockGiveRead( xConfigLock );
+ *  }
+ *
+ *  return ulTimeout;
+ * }
+ * @endcode
+ * \defgroup xRWLockTakeRead xRWLockTakeRead
+ * \ingroup RWLocks
+ */
+BaseType_t xRWLockTakeRead( RWLockHandle_t xLock,
+                            TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xRWLockGiveRead( RWLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/**
+ * rwlock.h
+ *
+ * @code{c}
+ * BaseType_t xRWLockTakeWrite( RWLockHandle_t xLock, TickType_t xTicksToWait );
+ * BaseType_t xRWLockGiveWrite( RWLockHandle_t xLock );
+ * @endcode
+ *
+ * Take a readers-writer lock for writing, and give it back once the data it
+ * protects has been updated.  No other task can hold the lock, for reading or
+ * writing, at the same time.
+ *
+ * @param xLock The handle of the lock.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for the lock if another task holds it.  The
+ * calling task will not block if xTicksToWait is zero.
+ *
+ * @return xRWLockTakeWrite() returns pdPASS if the lock was taken, otherwise
+ * pdFAIL.  xRWLockGiveWrite() returns pdPASS if the calling task held the lock
+ * for writing, otherwise pdFAIL.
+ *
+ * \defgroup xRWLockTakeWrite xRWLockTakeWrite
+ * \ingroup RWLocks
+ */
+BaseType_t xRWLockTakeWrite( RWLockHandle_t xLock,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xRWLockGiveWrite( RWLockHandle_t xLock ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( RWLOCK_H ) */
@@ -0,0 +1,283 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * Single producer, single consumer queues.
+ *
+ * An SPSC queue holds a fixed number of fixed size items, like a queue created
+ * with xQueueCreate(), but assumes there is only one task or interrupt that
+ * will write to it (the producer) and only one task or interrupt that will read
+ * from it (the consumer).  The read and write positions are C11 atomics that
+ * are each written by only one side, so sending and receiving never enter a
+ * critical section.  The kernel is only entered when the producer finds the
+ * queue full, or the consumer finds it empty, and has to block - and by the
+ * other side to unblock it.  A blocked task waits on an event list held in the
+ * queue, as it would on a queue created with xQueueCreate(), so the direct to
+ * task notifications of the producer and the consumer remain free for other
+ * uses.
+ *
+ * As with stream buffers it is not safe to have more than one producer or more
+ * than one consumer.
+ *
+ * configUSE_SPSC_QUEUES must be set to 1 in FreeRTOSConfig.h, and the compiler
+ * must support C11 <stdatomic.h>, for SPSC queues to be available.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include spsc_queue.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which SPSC queues are referenced.  For example, a call to
+ * xSPSCQueueCreate() returns an SPSCQueueHandle_t variable that can then be
+ * used as a parameter to xSPSCQueueSend(), xSPSCQueueReceive(), etc.
+ */
+struct SPSCQueueDefinition;
+typedef struct SPSCQueueDefinition * SPSCQueueHandle_t;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * SPSCQueueHandle_t xSPSCQueueCreate( UBaseType_t uxQueueLength, UBaseType_t uxItemSize );
+ * @endcode
+ *
+ * Creates a new SPSC queue using dynamically allocated memory.  See
+ * xSPSCQueueCreateStatic() for a version that uses statically allocated memory.
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xSPSCQueueCreate() to be available.
+ *
+ * @param uxQueueLength The maximum number of items the queue can hold at any
+ * one time.
+ *
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ * Items are queued by copy, not by reference.  Must be greater than zero.
+ *
+ * @return If the queue is successfully created then a handle to the created
+ * queue is returned.  If the queue cannot be created then NULL is returned.
+ *
+ * \defgroup xSPSCQueueCreate xSPSCQueueCreate
+ * \ingroup SPSCQueueManagement
+ */
+SPSCQueueHandle_t xSPSCQueueCreate( UBaseType_t uxQueueLength,
+                                    UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * SPSCQueueHandle_t xSPSCQueueCreateStatic( UBaseType_t uxQueueLength,
+ *                                           UBaseType_t uxItemSize,
+ *                                           uint8_t *pucQueueStorage,
+ *                                           StaticSPSCQueue_t *pxStaticQueue );
+ * @endcode
+ *
+ * Creates a new SPSC queue using statically allocated memory.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h for
+ * xSPSCQueueCreateStatic() to be available.
+ *
+ * @param uxQueueLength The maximum number of items the queue can hold at any
+ * one time.
+ *
+ * @param uxItemSize The number of bytes each item in the queue will require.
+ *
+ * @param pucQueueStorage Must point to a uint8_t array that is at least
+ * ( uxQueueLength * uxItemSize ) bytes big.
+ *
+ * @param pxStaticQueue Must point to a variable of type StaticSPSCQueue_t,
+ * which will be used to hold the queue's data structure.
+ *
+ * @return If neither pucQueueStorage or pxStaticQueue are NULL then a handle to
+ * the created queue is returned, otherwise NULL is returned.
+ *
+ * \defgroup xSPSCQueueCreateStatic xSPSCQueueCreateStatic
+ * \ingroup SPSCQueueManagement
+ */
+SPSCQueueHandle_t xSPSCQueueCreateStatic( UBaseType_t uxQueueLength,
+                                          UBaseType_t uxItemSize,
+                                          uint8_t * pucQueueStorage,
+                                          StaticSPSCQueue_t * pxStaticQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * void vSPSCQueueDelete( SPSCQueueHandle_t xQueue );
+ * @endcode
+ *
+ * Deletes an SPSC queue.  No task may be blocked on the queue when it is
+ * deleted.
+ *
+ * \defgroup vSPSCQueueDelete vSPSCQueueDelete
+ * \ingroup SPSCQueueManagement
+ */
+void vSPSCQueueDelete( SPSCQueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSPSCQueueSend( SPSCQueueHandle_t xQueue,
+ *                            const void * const pvItemToQueue,
+ *                            TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Copies an item to the back of an SPSC queue.  Must only be called by the
+ * queue's producer.
+ *
+ * @param xQueue The handle of the queue to which the item is to be sent.
+ *
+ * @param pvItemToQueue A pointer to the item that is to be copied to the queue.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for space to become available if the queue is
+ * full.  The calling task will not block if xTicksToWait is zero.
+ *
+ * @return pdPASS if the item was sent, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xSPSCQueueSend xSPSCQueueSend
+ * \ingroup SPSCQueueManagement
+ */
+BaseType_t xSPSCQueueSend( SPSCQueueHandle_t xQueue,
+                           const void * const pvItemToQueue,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSPSCQueueSendFromISR( SPSCQueueHandle_t xQueue,
+ *                                   const void * const pvItemToQueue,
+ *                                   BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Interrupt safe version of xSPSCQueueSend(), for use when the producer is an
+ * interrupt service routine.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending the item unblocked
+ * a task with a priority above the interrupted task, in which case a context
+ * switch should be requested before the interrupt is exited.  Can be NULL.
+ *
+ * @return pdPASS if the item was sent, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xSPSCQueueSendFromISR xSPSCQueueSendFromISR
+ * \ingroup SPSCQueueManagement
+ */
+BaseType_t xSPSCQueueSendFromISR( SPSCQueueHandle_t xQueue,
+                                  const void * const pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSPSCQueueReceive( SPSCQueueHandle_t xQueue,
+ *                               void * const pvBuffer,
+ *                               TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Copies the item at the front of an SPSC queue into pvBuffer and removes it
+ * from the queue.  Must only be called by the queue's consumer.
+ *
+ * @param xQueue The handle of the queue from which the item is to be received.
+ *
+ * @param pvBuffer Pointer to the buffer into which the received item will be
+ * copied.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should remain
+ * in the Blocked state to wait for an item if the queue is empty.  The calling
+ * task will not block if xTicksToWait is zero.
+ *
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ *
+ * \defgroup xSPSCQueueReceive xSPSCQueueReceive
+ * \ingroup SPSCQueueManagement
+ */
+BaseType_t xSPSCQueueReceive( SPSCQueueHandle_t xQueue,
+                              void * const pvBuffer,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSPSCQueueReceiveFromISR( SPSCQueueHandle_t xQueue,
+ *                                      void * const pvBuffer,
+ *                                      BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Interrupt safe version of xSPSCQueueReceive(), for use when the consumer is
+ * an interrupt service routine.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if receiving the item
+ * unblocked a task with a priority above the interrupted task, in which case a
+ * context switch should be requested before the interrupt is exited.  Can be
+ * NULL.
+ *
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ *
+ * \defgroup xSPSCQueueReceiveFromISR xSPSCQueueReceiveFromISR
+ * \ingroup SPSCQueueManagement
+ */
+BaseType_t xSPSCQueueReceiveFromISR( SPSCQueueHandle_t xQueue,
+                                     void * const pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * UBaseType_t uxSPSCQueueMessagesWaiting( SPSCQueueHandle_t xQueue );
+ * @endcode
+ *
+ * Returns the number of items in an SPSC queue.  The value is only a snapshot
+ * if the other side is using the queue at the same time.
+ *
+ * \defgroup uxSPSCQueueMessagesWaiting uxSPSCQueueMessagesWaiting
+ * \ingroup SPSCQueueManagement
+ */
+UBaseType_t uxSPSCQueueMessagesWaiting( SPSCQueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( SPSC_QUEUE_H ) */
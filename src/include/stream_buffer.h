@@ -78,6 +78,29 @@ typedef void (* StreamBufferCallbackFunction_t)( StreamBufferHandle_t xStreamBuf
                                                  BaseType_t xIsInsideISR,
                                                  BaseType_t * const pxHigherPriorityTaskWoken );
 
+/**
+ * Type used by xStreamBufferReserve() and xStreamBufferPeek() to describe a
+ * region of a stream buffer's storage area.  The region wraps around the end
+ * of the storage area if, and only if, xSecondLength is not zero.
+ */
+typedef struct xSTREAM_BUFFER_SPANS
+{
+    uint8_t * pucFirst;   /* Start of the region. */
+    size_t xFirstLength;  /* Number of bytes from pucFirst to the end of the region or the storage area, whichever comes first. */
+    uint8_t * pucSecond;  /* Start of the storage area if the region wraps, otherwise NULL. */
+    size_t xSecondLength; /* Number of bytes of the region at the start of the storage area. */
+} StreamBufferSpans_t;
+
+/**
+ * Type used by xStreamBufferSendVector() to describe one of the fragments
+ * gathered into a single write.
+ */
+typedef struct xSTREAM_BUFFER_FRAGMENT
+{
+    const void * pvData; /* Start of the fragment. */
+    size_t xLength;      /* Number of bytes in the fragment, which can be zero. */
+} StreamBufferFragment_t;
+
 /**
  * stream_buffer.h
  *
@@ -911,6 +934,284 @@ BaseType_t xStreamBufferSendCompletedFromISR( StreamBufferHandle_t xStreamBuffer
 BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer,
                                                  BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+ *                              size_t xBytesWanted,
+ *                              StreamBufferSpans_t * const pxSpans,
+ *                              TickType_t xTicksToWait );
+ * void vStreamBufferCommit( StreamBufferHandle_t xStreamBuffer, size_t xBytesWritten );
+ * @endcode
+ *
+ * Write to a stream buffer without copying.  xStreamBufferReserve() describes
+ * free space in the buffer's own storage area, as up to two spans because the
+ * space can wrap around the end of the storage area.  The writer fills the
+ * spans in order, then calls vStreamBufferCommit() to make the bytes visible
+ * to the reader, which in turn unblocks the reader if the trigger level has
+ * been reached.  Until the bytes are committed the reader cannot see them.
+ *
+ * Reserving does not claim the space, so the writer must not otherwise write
+ * to the stream buffer between the two calls.  Reserved space that is not
+ * needed is simply not committed.
+ *
+ * Use pvMessageBufferReserve() with message buffers.
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these functions to be available.  They must not be called from an interrupt
+ * service routine.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to write to.
+ *
+ * @param xBytesWanted The maximum number of bytes to reserve.
+ *
+ * @param pxSpans Set to describe the reserved space.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for xBytesWanted bytes of space to become free, in the
+ * same way as xStreamBufferSend().
+ *
+ * @param xBytesWritten The number of bytes written to the reserved space,
+ * starting at pxSpans->pucFirst.  Must not exceed the value returned by
+ * xStreamBufferReserve().
+ *
+ * @return xStreamBufferReserve() returns the number of bytes reserved, which
+ * is less than xBytesWanted if the block time expired first.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( StreamBufferHandle_t xStreamBuffer )
+ * {
+ * StreamBufferSpans_t xSpans;
+ * size_t xReserved;
+ *
+ *  xReserved = xStreamBufferReserve( xStreamBuffer, 256, &xSpans, pdMS_TO_TICKS( 100 ) );
+ *
+ *  // Fill xSpans.xFirstLength bytes at xSpans.pucFirst, then
+ *  // xSpans.xSecondLength bytes at xSpans.pucSecond.
+ *
+ *  vStreamBufferCommit( xStreamBuffer, xReserved );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferReserve xStreamBufferReserve
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesWanted,
+                             StreamBufferSpans_t * const pxSpans,
+                             TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+                          size_t xBytesWritten ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+ *                           StreamBufferSpans_t * const pxSpans,
+ *                           TickType_t xTicksToWait );
+ * void vStreamBufferConsume( StreamBufferHandle_t xStreamBuffer, size_t xBytesRead );
+ * @endcode
+ *
+ * Read from a stream buffer without copying.  xStreamBufferPeek() describes
+ * the bytes in the buffer's own storage area, as up to two spans because the
+ * bytes can wrap around the end of the storage area.  The reader processes the
+ * bytes in place, then calls vStreamBufferConsume() to remove them from the
+ * buffer, which in turn unblocks the writer if it was waiting for space.  Until
+ * the bytes are consumed the writer cannot overwrite them.
+ *
+ * When used on a message buffer xStreamBufferPeek() describes only the next
+ * message, and vStreamBufferConsume() removes that message, so xBytesRead must
+ * be the length returned by xStreamBufferPeek().
+ *
+ * configUSE_STREAM_BUFFER_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for
+ * these functions to be available.  They must not be called from an interrupt
+ * service routine.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param pxSpans Set to describe the bytes available to be read.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data, in the same way as xStreamBufferReceive().
+ *
+ * @param xBytesRead The number of bytes to remove from the buffer.  Must not
+ * exceed the value returned by xStreamBufferPeek().
+ *
+ * @return xStreamBufferPeek() returns the number of bytes described by pxSpans,
+ * which is zero if the block time expired before data became available.
+ *
+ * \defgroup xStreamBufferPeek xStreamBufferPeek
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+                          StreamBufferSpans_t * const pxSpans,
+                          TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+                           size_t xBytesRead ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferSendVector( StreamBufferHandle_t xStreamBuffer,
+ *                                 const StreamBufferFragment_t * pxFragments,
+ *                                 size_t xFragmentCount,
+ *                                 TickType_t xTicksToWait );
+ * size_t xStreamBufferSendVectorFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                        const StreamBufferFragment_t * pxFragments,
+ *                                        size_t xFragmentCount,
+ *                                        BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Gathers xFragmentCount fragments into a single write, so data that is held
+ * in several places, such as a header and a payload, does not first have to be
+ * copied into one temporary buffer.  The result is the same as calling
+ * xStreamBufferSend() (or xStreamBufferSendFromISR()) with the fragments
+ * concatenated - in particular, when used on a message buffer the fragments
+ * form one message, which the reader sees complete or not at all.
+ *
+ * configUSE_STREAM_BUFFER_SCATTER_GATHER must be set to 1 in FreeRTOSConfig.h
+ * for these functions to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to write to.
+ *
+ * @param pxFragments An array of xFragmentCount fragments, written in order.
+ *
+ * @param xFragmentCount The number of fragments in the array.
+ *
+ * @param xTicksToWait As for xStreamBufferSend().
+ *
+ * @param pxHigherPriorityTaskWoken As for xStreamBufferSendFromISR().
+ *
+ * @return The number of bytes written, as for xStreamBufferSend().
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( MessageBufferHandle_t xMessageBuffer, const Header_t *pxHeader, const uint8_t *pucPayload, size_t xPayloadLength )
+ * {
+ * StreamBufferFragment_t xFragments[ 2 ];
+ *
+ *  xFragments[ 0 ].pvData = pxHeader;
+ *  xFragments[ 0 ].xLength = sizeof( Header_t );
+ *  xFragments[ 1 ].pvData = pucPayload;
+ *  xFragments[ 1 ].xLength = xPayloadLength;
+ *
+ *  xMessageBufferSendVector( xMessageBuffer, xFragments, 2, portMAX_DELAY );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferSendVector xStreamBufferSendVector
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendVector( StreamBufferHandle_t xStreamBuffer,
+                                const StreamBufferFragment_t * pxFragments,
+                                size_t xFragmentCount,
+                                TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+size_t xStreamBufferSendVectorFromISR( StreamBufferHandle_t xStreamBuffer,
+                                       const StreamBufferFragment_t * pxFragments,
+                                       size_t xFragmentCount,
+                                       BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * void vStreamBufferSetHostDoorbell( StreamBufferHandle_t xStreamBuffer,
+ *                                    UBaseType_t uxInterruptNumber );
+ * size_t xStreamBufferSendFromHost( StreamBufferHandle_t xStreamBuffer,
+ *                                   const void * pvTxData,
+ *                                   size_t xDataLengthBytes );
+ * BaseType_t xStreamBufferHostDoorbellFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                              BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Lets a thread that is not a task, such as a host thread on a simulator
+ * port, be the writer of a stream or message buffer.  A task reads the buffer
+ * with the normal receive functions.
+ *
+ * xStreamBufferSendFromHost() never blocks and does not call into the kernel.
+ * It writes as xStreamBufferSendFromISR() would, then publishes the new head
+ * with release ordering.  Only if the reading task is blocked waiting for
+ * data, and the doorbell is not already ringing, does it raise the doorbell
+ * interrupt uxInterruptNumber with portHOST_RAISE_INTERRUPT().  The interrupt
+ * is raised in the kernel instance of the task that called
+ * vStreamBufferSetHostDoorbell(), see configNUMBER_OF_KERNEL_INSTANCES.  A reader that
+ * keeps up with the writer therefore costs the writer no system calls at all.
+ *
+ * The handler of the doorbell interrupt must call
+ * xStreamBufferHostDoorbellFromISR(), which unblocks the reading task.  As with
+ * the other stream buffer functions there must be only one writer - the host
+ * thread - and one reader.
+ *
+ * configUSE_STREAM_BUFFER_HOST_WRITER must be set to 1 in FreeRTOSConfig.h, and
+ * the port must define portHOST_RAISE_INTERRUPT(), for these functions to be
+ * available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer.
+ *
+ * @param uxInterruptNumber The interrupt raised to wake the reading task.  Must
+ * be set before the first call to xStreamBufferSendFromHost().
+ *
+ * @param pvTxData A pointer to the data to write.
+ *
+ * @param xDataLengthBytes The number of bytes to write.
+ *
+ * @param pxHigherPriorityTaskWoken As for xStreamBufferSendCompletedFromISR().
+ *
+ * @return xStreamBufferSendFromHost() returns the number of bytes written, as
+ * for xStreamBufferSendFromISR().  xStreamBufferHostDoorbellFromISR() returns
+ * pdTRUE if a task was unblocked, otherwise pdFALSE.
+ *
+ * Example use on the POSIX port:
+ * @code{c}
+ * #define INGEST_INTERRUPT    5
+ *
+ * static StreamBufferHandle_t xIngest;
+ *
+ * static uint32_t prvIngestInterruptHandler( void )
+ * {
+ * BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ *
+ *  xStreamBufferHostDoorbellFromISR( xIngest, &xHigherPriorityTaskWoken );
+ *  return ( uint32_t ) xHigherPriorityTaskWoken;
+ * }
+ *
+ * // Runs on a host thread created with all signals blocked.
+ * static void * prvPcapThread( void * pvParameters )
+ * {
+ * uint8_t ucFrame[ 1514 ];
+ * size_t xLength;
+ *
+ *  while( ( xLength = prvReadNextFrame( ucFrame ) ) > 0 )
+ *  {
+ *      while( xMessageBufferSendFromHost( xIngest, ucFrame, xLength ) == 0 )
+ *      {
+ *          sched_yield();
+ *      }
+ *  }
+ *
+ *  return NULL;
+ * }
+ *
+ * void vStartIngest( void )
+ * {
+ *  xIngest = xMessageBufferCreate( 16384 );
+ *  vPortSetInterruptHandler( INGEST_INTERRUPT, prvIngestInterruptHandler );
+ *  vStreamBufferSetHostDoorbell( xIngest, INGEST_INTERRUPT );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferSendFromHost xStreamBufferSendFromHost
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferSetHostDoorbell( StreamBufferHandle_t xStreamBuffer,
+                                   UBaseType_t uxInterruptNumber ) PRIVILEGED_FUNCTION;
+size_t xStreamBufferSendFromHost( StreamBufferHandle_t xStreamBuffer,
+                                  const void * pvTxData,
+                                  size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+BaseType_t xStreamBufferHostDoorbellFromISR( StreamBufferHandle_t xStreamBuffer,
+                                             BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /* Functions below here are not part of the public API. */
 StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
                                                  size_t xTriggerLevelBytes,
@@ -929,6 +1230,26 @@ StreamBufferHandle_t xStreamBufferGenericCreateStatic( size_t xBufferSizeBytes,
 
 size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer ) PRIVILEGED_FUNCTION;
 
+void * pvStreamBufferReserveMessage( StreamBufferHandle_t xStreamBuffer,
+                                     size_t xMessageLength,
+                                     TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vStreamBufferCommitMessage( StreamBufferHandle_t xStreamBuffer,
+                                 void * const pvReservedMessage,
+                                 size_t xMessageLength ) PRIVILEGED_FUNCTION;
+
+size_t xStreamBufferReceiveMessages( StreamBufferHandle_t xStreamBuffer,
+                                     void * pvRxData,
+                                     size_t xBufferLengthBytes,
+                                     size_t * const pxMessageLengths,
+                                     size_t xMaxMessages,
+                                     TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+size_t xStreamBufferReceiveMessagesFromISR( StreamBufferHandle_t xStreamBuffer,
+                                            void * pvRxData,
+                                            size_t xBufferLengthBytes,
+                                            size_t * const pxMessageLengths,
+                                            size_t xMaxMessages,
+                                            BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_TRACE_FACILITY == 1 )
     void vStreamBufferSetStreamBufferNumber( StreamBufferHandle_t xStreamBuffer,
                                              UBaseType_t uxStreamBufferNumber ) PRIVILEGED_FUNCTION;
@@ -1321,6 +1321,81 @@ void vTaskStartScheduler( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskEndScheduler( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * @code{c}
+ * void vTaskResetState( void );
+ * @endcode
+ *
+ * Reset the state in tasks.c to its start up values so the scheduler can be
+ * started again after vTaskEndScheduler() has returned control to the
+ * application.  All the tasks created by the application must have been
+ * deleted first.  vTimerResetState() resets the state of the timer service.
+ *
+ * When configNUMBER_OF_KERNEL_INSTANCES is greater than 1 only the kernel
+ * instance of the calling thread is reset.
+ *
+ * \defgroup vTaskResetState vTaskResetState
+ * \ingroup SchedulerControl
+ */
+void vTaskResetState( void ) PRIVILEGED_FUNCTION;
+
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskSetKernelInstance( UBaseType_t uxInstance );
+ * @endcode
+ *
+ * Only available when configNUMBER_OF_KERNEL_INSTANCES is greater than 1.
+ *
+ * Select the kernel instance, 0 to configNUMBER_OF_KERNEL_INSTANCES - 1, that
+ * the calling host thread uses.  Every FreeRTOS API call made by the thread,
+ * including vTaskStartScheduler(), acts on that instance.  Tasks belong to
+ * the instance of the thread that created them.  Threads that never call
+ * vTaskSetKernelInstance() use instance 0.
+ *
+ * Each instance can have its scheduler started from a different host thread,
+ * so several simulated systems run in parallel in one process.  Objects must
+ * only be used by the instance that created them.
+ *
+ * Example usage:
+ * @code{c}
+ * void * vSweepThread( void * pvInstance )
+ * {
+ *   vTaskSetKernelInstance( ( UBaseType_t ) pvInstance );
+ *
+ *   xTaskCreate( vTaskCode, "NAME", STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
+ *
+ *   // Returns when a task of this instance calls vTaskEndScheduler().
+ *   vTaskStartScheduler();
+ *
+ *   return NULL;
+ * }
+ * @endcode
+ * \defgroup vTaskSetKernelInstance vTaskSetKernelInstance
+ * \ingroup SchedulerControl
+ */
+    void vTaskSetKernelInstance( UBaseType_t uxInstance ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * @code{c}
+ * UBaseType_t uxTaskGetKernelInstance( void );
+ * @endcode
+ *
+ * Only available when configNUMBER_OF_KERNEL_INSTANCES is greater than 1.
+ *
+ * @return The kernel instance used by the calling thread.
+ *
+ * \defgroup uxTaskGetKernelInstance uxTaskGetKernelInstance
+ * \ingroup SchedulerControl
+ */
+    UBaseType_t uxTaskGetKernelInstance( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
+
 /**
  * task. h
  * @code{c}
@@ -3147,6 +3222,22 @@ BaseType_t xTaskPriorityDisinherit( TaskHandle_t const pxMutexHolder ) PRIVILEGE
 void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder,
                                           UBaseType_t uxHighestPriorityWaitingTask ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_RW_LOCKS == 1 )
+
+/*
+ * For internal use only.  Called when a lock is handed to a task that was
+ * blocked waiting for it.  Increments the task's count of mutexes held, as
+ * pvTaskIncrementMutexHeldCount() does when a task takes a mutex itself, and
+ * raises its priority to uxHighestPriorityWaitingTask, should its priority be
+ * lower, so it inherits the priority of the tasks still waiting for the lock
+ * in the same way as if they had blocked after it took the lock.  Must be
+ * called from a critical section.
+ */
+    void vTaskHandOverMutex( TaskHandle_t const pxNewMutexHolder,
+                             UBaseType_t uxHighestPriorityWaitingTask ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_RW_LOCKS */
+
 /*
  * Get the uxTaskNumber assigned to the task referenced by the xTask parameter.
  */
@@ -3197,6 +3288,90 @@ TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut ) PRIVILEGED_FUNCTION;
 
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+/*
+ * For internal use only.  Let priority inheritance follow a chain of mutex
+ * holders that are themselves blocked on mutexes.  vTaskSetMutexBlockedOn()
+ * records the mutex the calling task is about to block on, and must be called
+ * with the scheduler suspended before the task is placed on the mutex's event
+ * list.  The kernel clears the record when it removes the task from the event
+ * list, whether the mutex was given, the wait timed out or was aborted, or the
+ * task was suspended.
+ * pvTaskGetMutexBlockedOn() returns the mutex xTask is blocked on, or NULL, and
+ * must be called from a critical section.
+ */
+    void vTaskSetMutexBlockedOn( void * pvMutex ) PRIVILEGED_FUNCTION;
+    void * pvTaskGetMutexBlockedOn( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) */
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+/*
+ * For internal use only.  Equivalents of vTaskPlaceOnUnorderedEventList(),
+ * vTaskRemoveFromUnorderedEventList() and uxTaskResetEventItemValue() for 64-bit
+ * event groups, which keep the bits a task waits for, and the bits it was
+ * unblocked with, in the task's TCB instead of in its event list item value.
+ * ullTaskGetEventBits() returns the bits stored for the task that owns
+ * pxEventListItem.  All but ullTaskResetEventBits() must be called with the
+ * scheduler suspended.
+ */
+    void vTaskPlaceOnEventBitsList( List_t * pxEventList,
+                                    const uint64_t ullEventBits,
+                                    const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+    uint64_t ullTaskGetEventBits( const ListItem_t * pxEventListItem ) PRIVILEGED_FUNCTION;
+    void vTaskRemoveFromEventBitsList( ListItem_t * pxEventListItem,
+                                       const uint64_t ullEventBits ) PRIVILEGED_FUNCTION;
+    uint64_t ullTaskResetEventBits( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+
+#if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+
+/*
+ * For internal use only.  Let a task blocked in xQueueReceive() be handed an
+ * item directly.  vTaskSetHandoffBuffer() records where the calling task wants
+ * the item copied, and must be called with the scheduler suspended just before
+ * the task is placed on the queue's event list.  pvTaskTakeHandoffBuffer()
+ * returns the buffer recorded by the highest priority task on pxEventList, or
+ * NULL if it did not record one, and marks the task's receive as complete.  It
+ * must be called from a critical section with pxEventList not empty.
+ * xTaskClearHandoffBuffer() forgets the calling task's buffer, and returns
+ * pdTRUE if an item was copied to it.  It must be called from a critical
+ * section.
+ */
+    void vTaskSetHandoffBuffer( void * pvBuffer ) PRIVILEGED_FUNCTION;
+    void * pvTaskTakeHandoffBuffer( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+    BaseType_t xTaskClearHandoffBuffer( void ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+/*
+ * For internal use only.  Lets an interrupt defer work that needs the scheduler
+ * suspended, such as unblocking the tasks waiting for event bits, without
+ * involving a task.  The kernel runs the work by calling pxFunction( pxWork )
+ * with interrupts masked and the scheduler suspended - either when the next
+ * context switch is performed, which the interrupt must request, or when the
+ * scheduler is resumed if it was suspended.  vTaskDeferFromISR() queues pxWork,
+ * which must not already be queued, and vTaskCancelDeferredWork() removes it
+ * from the queue if it is still there.  Both must be called with interrupts
+ * masked.
+ */
+    typedef struct xTASK_DEFERRED_WORK
+    {
+        struct xTASK_DEFERRED_WORK * pxNext;
+        void ( * pxFunction )( struct xTASK_DEFERRED_WORK * pxWork );
+        void * pvOwner;
+    } TaskDeferredWork_t;
+
+    void vTaskDeferFromISR( TaskDeferredWork_t * pxWork ) PRIVILEGED_FUNCTION;
+    void vTaskCancelDeferredWork( TaskDeferredWork_t * pxWork ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+
 #if ( portUSING_MPU_WRAPPERS == 1 )
 
 /*
@@ -1343,6 +1343,16 @@ TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
                                       StaticTimer_t ** ppxTimerBuffer ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * void vTimerResetState( void );
+ *
+ * Reset the state in timers.c so the timer service task and its command
+ * queue are created again the next time the scheduler is started.  Must only
+ * be called after vTaskEndScheduler() has returned control to the
+ * application, together with vTaskResetState().
+ */
+void vTimerResetState( void ) PRIVILEGED_FUNCTION;
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
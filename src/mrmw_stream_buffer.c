@@ -0,0 +1,677 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mrmw_stream_buffer.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include MRMW stream buffer functionality.  This #if is closed at the very
+ * bottom of this file.  If you want to include MRMW stream buffers then ensure
+ * configUSE_MRMW_STREAM_BUFFERS is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_MRMW_STREAM_BUFFERS == 1 )
+
+    #include <stdatomic.h>
+
+/*
+ * Positions in the stream run from 0 to xWrap - 1, where xWrap is the largest
+ * multiple of xLength that fits in a size_t, and the byte a position refers to
+ * is the position modulo xLength.  Running over many laps of the buffer, rather
+ * than the two used by SPSC queues, means a task that is preempted between
+ * reading a position and exchanging it cannot mistake it for the same position
+ * a lap later.
+ *
+ * The writers and the readers each have a side.  A task reserves a region of
+ * the stream by advancing its side's xReserved with a compare and exchange -
+ * writers up to xLength bytes beyond where the readers have committed, readers
+ * up to where the writers have committed.  Once it has copied its bytes the
+ * task advances its side's xCommitted from the start to the end of its region.
+ * That only succeeds once every region before it has been committed, so a task
+ * that finishes early blocks until it does.
+ *
+ * The event lists are only changed with the scheduler suspended.  A task that
+ * cannot reserve or commit checks again with the scheduler suspended before it
+ * blocks, and a task that commits checks the event lists after it commits, so
+ * one of them always sees the other's change.
+ */
+    typedef struct MRMWStreamBufferSide
+    {
+        atomic_size_t xReserved;       /**< The end of the last region reserved by a task on this side. */
+        atomic_size_t xCommitted;      /**< The end of the last region committed by a task on this side. */
+        List_t xTasksWaitingToReserve; /**< Tasks waiting for space (writers) or data (readers), in priority order. */
+        List_t xTasksWaitingToCommit;  /**< Tasks waiting for earlier regions on this side to be committed. */
+    } MRMWStreamBufferSide_t;
+
+    typedef struct MRMWStreamBufferDefinition
+    {
+        uint8_t * pucBuffer;             /**< The storage area. */
+        size_t xLength;                  /**< The size of the storage area. */
+        size_t xWrap;                    /**< The position at which positions return to zero. */
+        MRMWStreamBufferSide_t xWriters; /**< The writers' side. */
+        MRMWStreamBufferSide_t xReaders; /**< The readers' side. */
+        uint8_t ucStaticallyAllocated;   /**< Set to pdTRUE if the buffer was created by xMRMWStreamBufferCreateStatic(). */
+    } MRMWStreamBuffer_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by both the create functions to initialise a new buffer.
+ */
+    static void prvInitialiseNewMRMWStreamBuffer( MRMWStreamBuffer_t * const pxBuffer,
+                                                  uint8_t * const pucStorage,
+                                                  size_t xBufferSizeBytes ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the position xCount bytes after xPosition, and the number of bytes
+ * from xFrom to xTo.
+ */
+    static size_t prvAdvance( const MRMWStreamBuffer_t * const pxBuffer,
+                              size_t xPosition,
+                              size_t xCount ) PRIVILEGED_FUNCTION;
+    static size_t prvBytesBetween( const MRMWStreamBuffer_t * const pxBuffer,
+                                   size_t xFrom,
+                                   size_t xTo ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the number of bytes a task on pxSide could reserve if the side's
+ * reserved position is xReserved.  xLap is xLength for the writers, who can
+ * run a whole buffer ahead of the readers, and zero for the readers.
+ */
+    static size_t prvBytesReservable( const MRMWStreamBuffer_t * const pxBuffer,
+                                      const MRMWStreamBufferSide_t * const pxOther,
+                                      size_t xLap,
+                                      size_t xReserved ) PRIVILEGED_FUNCTION;
+
+/*
+ * Reserve between xMinimum and xMaximum bytes on pxSide, blocking for up to
+ * xTicksToWait ticks for at least xMinimum to be available.  Returns the number
+ * of bytes reserved, or zero, and sets *pxStart to the start of the region.
+ */
+    static size_t prvReserve( MRMWStreamBuffer_t * const pxBuffer,
+                              MRMWStreamBufferSide_t * const pxSide,
+                              const MRMWStreamBufferSide_t * const pxOther,
+                              size_t xLap,
+                              size_t xMinimum,
+                              size_t xMaximum,
+                              TickType_t xTicksToWait,
+                              size_t * const pxStart ) PRIVILEGED_FUNCTION;
+    static size_t prvTryReserve( MRMWStreamBuffer_t * const pxBuffer,
+                                 MRMWStreamBufferSide_t * const pxSide,
+                                 const MRMWStreamBufferSide_t * const pxOther,
+                                 size_t xLap,
+                                 size_t xMinimum,
+                                 size_t xMaximum,
+                                 size_t * const pxStart ) PRIVILEGED_FUNCTION;
+
+/*
+ * Commit the xCount byte region reserved at xStart on pxSide, first blocking
+ * until all the regions before it have been committed, then unblock the tasks
+ * that can make progress as a result.
+ */
+    static void prvCommit( MRMWStreamBuffer_t * const pxBuffer,
+                           MRMWStreamBufferSide_t * const pxSide,
+                           MRMWStreamBufferSide_t * const pxOther,
+                           size_t xStart,
+                           size_t xCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock every task in pxEventList, to try again.
+ */
+    static void prvUnblockAll( List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        MRMWStreamBufferHandle_t xMRMWStreamBufferCreate( size_t xBufferSizeBytes )
+        {
+            MRMWStreamBuffer_t * pxNewBuffer = NULL;
+
+            configASSERT( xBufferSizeBytes > ( size_t ) 0 );
+
+            /* Check positions can run over at least two laps, and for addition
+             * overflow. */
+            if( ( xBufferSizeBytes > ( size_t ) 0 ) &&
+                ( xBufferSizeBytes <= ( SIZE_MAX / 2U ) ) &&
+                ( ( SIZE_MAX - sizeof( MRMWStreamBuffer_t ) ) >= xBufferSizeBytes ) )
+            {
+                /* The structure and the storage area are allocated in one block,
+                 * the storage area immediately after the structure. */
+                pxNewBuffer = ( MRMWStreamBuffer_t * ) pvPortMalloc( sizeof( MRMWStreamBuffer_t ) + xBufferSizeBytes ); /*lint !e9087 !e9079 see comment above. */
+
+                if( pxNewBuffer != NULL )
+                {
+                    prvInitialiseNewMRMWStreamBuffer( pxNewBuffer, ( ( uint8_t * ) pxNewBuffer ) + sizeof( MRMWStreamBuffer_t ), xBufferSizeBytes ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+                    pxNewBuffer->ucStaticallyAllocated = pdFALSE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewBuffer;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        MRMWStreamBufferHandle_t xMRMWStreamBufferCreateStatic( size_t xBufferSizeBytes,
+                                                                uint8_t * pucStorage,
+                                                                StaticMRMWStreamBuffer_t * pxStaticBuffer )
+        {
+            MRMWStreamBuffer_t * pxNewBuffer = NULL;
+
+            configASSERT( pucStorage );
+            configASSERT( pxStaticBuffer );
+            configASSERT( xBufferSizeBytes > ( size_t ) 0 );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticMRMWStreamBuffer_t equals the size of the
+                 * real buffer structure. */
+                volatile size_t xSize = sizeof( StaticMRMWStreamBuffer_t );
+                configASSERT( xSize == sizeof( MRMWStreamBuffer_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( ( pucStorage != NULL ) &&
+                ( pxStaticBuffer != NULL ) &&
+                ( xBufferSizeBytes > ( size_t ) 0 ) &&
+                ( xBufferSizeBytes <= ( SIZE_MAX / 2U ) ) )
+            {
+                pxNewBuffer = ( MRMWStreamBuffer_t * ) pxStaticBuffer; /*lint !e740 !e9087 MRMWStreamBuffer_t and StaticMRMWStreamBuffer_t are deliberately aliased, and checked by an assert. */
+                prvInitialiseNewMRMWStreamBuffer( pxNewBuffer, pucStorage, xBufferSizeBytes );
+                pxNewBuffer->ucStaticallyAllocated = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewBuffer;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vMRMWStreamBufferDelete( MRMWStreamBufferHandle_t xBuffer )
+    {
+        MRMWStreamBuffer_t * pxBuffer = xBuffer;
+
+        configASSERT( pxBuffer );
+        configASSERT( atomic_load( &( pxBuffer->xWriters.xReserved ) ) == atomic_load( &( pxBuffer->xWriters.xCommitted ) ) );
+        configASSERT( atomic_load( &( pxBuffer->xReaders.xReserved ) ) == atomic_load( &( pxBuffer->xReaders.xCommitted ) ) );
+        configASSERT( listLIST_IS_EMPTY( &( pxBuffer->xWriters.xTasksWaitingToReserve ) ) != pdFALSE );
+        configASSERT( listLIST_IS_EMPTY( &( pxBuffer->xReaders.xTasksWaitingToReserve ) ) != pdFALSE );
+
+        if( pxBuffer->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                /* Both the structure and the storage area were allocated using
+                 * a single call to pvPortMalloc(), hence only one call to
+                 * vPortFree() is required. */
+                vPortFree( ( void * ) pxBuffer );
+            }
+            #endif
+        }
+        else
+        {
+            /* The structure and storage area were not allocated dynamically and
+             * cannot be freed - just scrub the structure so future use will
+             * assert. */
+            ( void ) memset( ( void * ) pxBuffer, 0x00, sizeof( MRMWStreamBuffer_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xMRMWStreamBufferSend( MRMWStreamBufferHandle_t xBuffer,
+                                  const void * pvTxData,
+                                  size_t xDataLengthBytes,
+                                  TickType_t xTicksToWait )
+    {
+        MRMWStreamBuffer_t * const pxBuffer = xBuffer;
+        const uint8_t * const pucData = ( const uint8_t * ) pvTxData;
+        size_t xStart = 0, xIndex, xFirstLength, xReturn = 0;
+
+        configASSERT( pxBuffer );
+        configASSERT( pvTxData );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /* A write larger than the buffer could never fit, so don't wait for
+         * space. */
+        if( ( xDataLengthBytes != ( size_t ) 0 ) && ( xDataLengthBytes <= pxBuffer->xLength ) )
+        {
+            xReturn = prvReserve( pxBuffer, &( pxBuffer->xWriters ), &( pxBuffer->xReaders ), pxBuffer->xLength, xDataLengthBytes, xDataLengthBytes, xTicksToWait, &xStart );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xReturn != ( size_t ) 0 )
+        {
+            /* Copy in, wrapping back to the start of the storage area if the
+             * region does. */
+            xIndex = xStart % pxBuffer->xLength;
+            xFirstLength = configMIN( pxBuffer->xLength - xIndex, xReturn );
+            ( void ) memcpy( ( void * ) &( pxBuffer->pucBuffer[ xIndex ] ), ( const void * ) pucData, xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+            if( xReturn > xFirstLength )
+            {
+                ( void ) memcpy( ( void * ) pxBuffer->pucBuffer, ( const void * ) &( pucData[ xFirstLength ] ), xReturn - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvCommit( pxBuffer, &( pxBuffer->xWriters ), &( pxBuffer->xReaders ), xStart, xReturn );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xMRMWStreamBufferReceive( MRMWStreamBufferHandle_t xBuffer,
+                                     void * pvRxData,
+                                     size_t xBufferLengthBytes,
+                                     TickType_t xTicksToWait )
+    {
+        MRMWStreamBuffer_t * const pxBuffer = xBuffer;
+        uint8_t * const pucData = ( uint8_t * ) pvRxData;
+        size_t xStart = 0, xIndex, xFirstLength, xReturn = 0;
+
+        configASSERT( pxBuffer );
+        configASSERT( pvRxData );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        if( xBufferLengthBytes != ( size_t ) 0 )
+        {
+            /* As with stream buffers, take as many bytes as are available. */
+            xReturn = prvReserve( pxBuffer, &( pxBuffer->xReaders ), &( pxBuffer->xWriters ), ( size_t ) 0, ( size_t ) 1, xBufferLengthBytes, xTicksToWait, &xStart );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xReturn != ( size_t ) 0 )
+        {
+            /* Copy out, wrapping back to the start of the storage area if the
+             * region does. */
+            xIndex = xStart % pxBuffer->xLength;
+            xFirstLength = configMIN( pxBuffer->xLength - xIndex, xReturn );
+            ( void ) memcpy( ( void * ) pucData, ( const void * ) &( pxBuffer->pucBuffer[ xIndex ] ), xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+
+            if( xReturn > xFirstLength )
+            {
+                ( void ) memcpy( ( void * ) &( pucData[ xFirstLength ] ), ( const void * ) pxBuffer->pucBuffer, xReturn - xFirstLength ); /*lint !e9087 memcpy() requires void *. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvCommit( pxBuffer, &( pxBuffer->xReaders ), &( pxBuffer->xWriters ), xStart, xReturn );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xMRMWStreamBufferBytesAvailable( MRMWStreamBufferHandle_t xBuffer )
+    {
+        const MRMWStreamBuffer_t * const pxBuffer = xBuffer;
+
+        configASSERT( pxBuffer );
+
+        return prvBytesReservable( pxBuffer, &( pxBuffer->xWriters ), ( size_t ) 0, atomic_load( &( pxBuffer->xReaders.xReserved ) ) );
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xMRMWStreamBufferSpacesAvailable( MRMWStreamBufferHandle_t xBuffer )
+    {
+        const MRMWStreamBuffer_t * const pxBuffer = xBuffer;
+
+        configASSERT( pxBuffer );
+
+        return prvBytesReservable( pxBuffer, &( pxBuffer->xReaders ), pxBuffer->xLength, atomic_load( &( pxBuffer->xWriters.xReserved ) ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewMRMWStreamBuffer( MRMWStreamBuffer_t * const pxBuffer,
+                                                  uint8_t * const pucStorage,
+                                                  size_t xBufferSizeBytes )
+    {
+        pxBuffer->pucBuffer = pucStorage;
+        pxBuffer->xLength = xBufferSizeBytes;
+        pxBuffer->xWrap = ( SIZE_MAX / xBufferSizeBytes ) * xBufferSizeBytes;
+
+        atomic_init( &( pxBuffer->xWriters.xReserved ), ( size_t ) 0 );
+        atomic_init( &( pxBuffer->xWriters.xCommitted ), ( size_t ) 0 );
+        vListInitialise( &( pxBuffer->xWriters.xTasksWaitingToReserve ) );
+        vListInitialise( &( pxBuffer->xWriters.xTasksWaitingToCommit ) );
+
+        atomic_init( &( pxBuffer->xReaders.xReserved ), ( size_t ) 0 );
+        atomic_init( &( pxBuffer->xReaders.xCommitted ), ( size_t ) 0 );
+        vListInitialise( &( pxBuffer->xReaders.xTasksWaitingToReserve ) );
+        vListInitialise( &( pxBuffer->xReaders.xTasksWaitingToCommit ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvAdvance( const MRMWStreamBuffer_t * const pxBuffer,
+                              size_t xPosition,
+                              size_t xCount )
+    {
+        size_t xReturn;
+
+        /* Written so as not to overflow, as xWrap can be close to SIZE_MAX. */
+        if( xCount >= ( pxBuffer->xWrap - xPosition ) )
+        {
+            xReturn = xCount - ( pxBuffer->xWrap - xPosition );
+        }
+        else
+        {
+            xReturn = xPosition + xCount;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvBytesBetween( const MRMWStreamBuffer_t * const pxBuffer,
+                                   size_t xFrom,
+                                   size_t xTo )
+    {
+        size_t xReturn;
+
+        if( xTo >= xFrom )
+        {
+            xReturn = xTo - xFrom;
+        }
+        else
+        {
+            xReturn = ( pxBuffer->xWrap - xFrom ) + xTo;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvBytesReservable( const MRMWStreamBuffer_t * const pxBuffer,
+                                      const MRMWStreamBufferSide_t * const pxOther,
+                                      size_t xLap,
+                                      size_t xReserved )
+    {
+        size_t xLimit, xReturn;
+
+        xLimit = prvAdvance( pxBuffer, atomic_load_explicit( &( pxOther->xCommitted ), memory_order_acquire ), xLap );
+        xReturn = prvBytesBetween( pxBuffer, xReserved, xLimit );
+
+        /* A position read before the other side moved on can appear to be
+         * more than a lap behind.  The compare and exchange that follows will
+         * fail, so just keep the value in range. */
+        return configMIN( xReturn, pxBuffer->xLength );
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvTryReserve( MRMWStreamBuffer_t * const pxBuffer,
+                                 MRMWStreamBufferSide_t * const pxSide,
+                                 const MRMWStreamBufferSide_t * const pxOther,
+                                 size_t xLap,
+                                 size_t xMinimum,
+                                 size_t xMaximum,
+                                 size_t * const pxStart )
+    {
+        size_t xReserved, xAvailable, xReturn = 0;
+
+        /* A failed compare and exchange updates xReserved, so the loop only
+         * repeats while other tasks on the same side are reserving. */
+        xReserved = atomic_load_explicit( &( pxSide->xReserved ), memory_order_relaxed );
+
+        for( ; ; )
+        {
+            xAvailable = prvBytesReservable( pxBuffer, pxOther, xLap, xReserved );
+
+            if( xAvailable < xMinimum )
+            {
+                break;
+            }
+
+            xReturn = configMIN( xAvailable, xMaximum );
+
+            if( atomic_compare_exchange_weak_explicit( &( pxSide->xReserved ), &xReserved, prvAdvance( pxBuffer, xReserved, xReturn ),
+                                                       memory_order_relaxed, memory_order_relaxed ) != false )
+            {
+                *pxStart = xReserved;
+                break;
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvReserve( MRMWStreamBuffer_t * const pxBuffer,
+                              MRMWStreamBufferSide_t * const pxSide,
+                              const MRMWStreamBufferSide_t * const pxOther,
+                              size_t xLap,
+                              size_t xMinimum,
+                              size_t xMaximum,
+                              TickType_t xTicksToWait,
+                              size_t * const pxStart )
+    {
+        size_t xReturn;
+        TimeOut_t xTimeOut;
+        BaseType_t xEntryTimeSet = pdFALSE;
+
+        xReturn = prvTryReserve( pxBuffer, pxSide, pxOther, xLap, xMinimum, xMaximum, pxStart );
+
+        if( ( xReturn == ( size_t ) 0 ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+        {
+            for( ; ; )
+            {
+                vTaskSuspendAll();
+                {
+                    /* Try again now the other side cannot commit without
+                     * seeing this task in the event list. */
+                    xReturn = prvTryReserve( pxBuffer, pxSide, pxOther, xLap, xMinimum, xMaximum, pxStart );
+
+                    if( xReturn != ( size_t ) 0 )
+                    {
+                        ( void ) xTaskResumeAll();
+                        break;
+                    }
+
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The tick count cannot change while the scheduler is
+                         * suspended. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                    {
+                        vTaskPlaceOnEventList( &( pxSide->xTasksWaitingToReserve ), xTicksToWait );
+                    }
+                    else
+                    {
+                        ( void ) xTaskResumeAll();
+                        break;
+                    }
+                }
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvCommit( MRMWStreamBuffer_t * const pxBuffer,
+                           MRMWStreamBufferSide_t * const pxSide,
+                           MRMWStreamBufferSide_t * const pxOther,
+                           size_t xStart,
+                           size_t xCount )
+    {
+        size_t xEnd, xExpected = xStart;
+
+        xEnd = prvAdvance( pxBuffer, xStart, xCount );
+
+        if( atomic_compare_exchange_strong_explicit( &( pxSide->xCommitted ), &xExpected, xEnd,
+                                                     memory_order_release, memory_order_relaxed ) == false )
+        {
+            /* A task that reserved a region before this one has not committed
+             * it yet, so wait for it. */
+            for( ; ; )
+            {
+                vTaskSuspendAll();
+                {
+                    xExpected = xStart;
+
+                    if( atomic_compare_exchange_strong_explicit( &( pxSide->xCommitted ), &xExpected, xEnd,
+                                                                 memory_order_release, memory_order_relaxed ) != false )
+                    {
+                        ( void ) xTaskResumeAll();
+                        break;
+                    }
+
+                    vTaskPlaceOnEventList( &( pxSide->xTasksWaitingToCommit ), portMAX_DELAY );
+                }
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The next region on this side can now be committed, and the region can
+         * now be reserved by the other side. */
+        prvUnblockAll( &( pxSide->xTasksWaitingToCommit ) );
+        prvUnblockAll( &( pxOther->xTasksWaitingToReserve ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnblockAll( List_t * const pxEventList )
+    {
+        if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+        {
+            vTaskSuspendAll();
+            {
+                while( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
+                {
+                    ( void ) xTaskRemoveFromEventList( pxEventList );
+                }
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include MRMW stream buffer functionality.  If you want to include MRMW
+ * stream buffers then ensure configUSE_MRMW_STREAM_BUFFERS is set to 1 in
+ * FreeRTOSConfig.h. */
+#endif /* configUSE_MRMW_STREAM_BUFFERS == 1 */
@@ -50,6 +50,12 @@
     #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+/* Suspending the scheduler only keeps the tasks of the calling kernel instance
+ * out of the heap. */
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    #error This file cannot be used if configNUMBER_OF_KERNEL_INSTANCES is greater than 1 - use heap_3 or heap_5
+#endif
+
 /* A few bytes might be lost to byte aligning the heap start address. */
 #define configADJUSTED_HEAP_SIZE    ( configTOTAL_HEAP_SIZE - portBYTE_ALIGNMENT )
 
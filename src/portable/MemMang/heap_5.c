@@ -85,6 +85,29 @@
     #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
 #endif
 
+/* Suspending the scheduler only keeps the tasks of the calling kernel instance
+ * out of the heap, so with several instances the port's heap lock is also
+ * taken. */
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    #ifndef portHEAP_LOCK
+        #error configNUMBER_OF_KERNEL_INSTANCES is greater than 1 but the port does not define portHEAP_LOCK() and portHEAP_UNLOCK()
+    #endif
+
+    #define heapLOCK()                \
+    do {                              \
+        vTaskSuspendAll();            \
+        portHEAP_LOCK();              \
+    } while( 0 )
+    #define heapUNLOCK()              \
+    do {                              \
+        portHEAP_UNLOCK();            \
+        ( void ) xTaskResumeAll();    \
+    } while( 0 )
+#else
+    #define heapLOCK()      vTaskSuspendAll()
+    #define heapUNLOCK()    ( void ) xTaskResumeAll()
+#endif
+
 #ifndef configHEAP_CLEAR_MEMORY_ON_FREE
     #define configHEAP_CLEAR_MEMORY_ON_FREE    0
 #endif
@@ -165,7 +188,7 @@ void * pvPortMalloc( size_t xWantedSize )
      * prvPortMalloc(). */
     configASSERT( pxEnd );
 
-    vTaskSuspendAll();
+    heapLOCK();
     {
         if( xWantedSize > 0 )
         {
@@ -294,7 +317,7 @@ void * pvPortMalloc( size_t xWantedSize )
 
         traceMALLOC( pvReturn, xWantedSize );
     }
-    ( void ) xTaskResumeAll();
+    heapUNLOCK();
 
     #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
     {
@@ -343,7 +366,7 @@ void vPortFree( void * pv )
                 }
                 #endif
 
-                vTaskSuspendAll();
+                heapLOCK();
                 {
                     /* Add this block to the list of free blocks. */
                     xFreeBytesRemaining += pxLink->xBlockSize;
@@ -351,7 +374,7 @@ void vPortFree( void * pv )
                     prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
                     xNumberOfSuccessfulFrees++;
                 }
-                ( void ) xTaskResumeAll();
+                heapUNLOCK();
             }
             else
             {
@@ -558,7 +581,7 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
     BlockLink_t * pxBlock;
     size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
 
-    vTaskSuspendAll();
+    heapLOCK();
     {
         pxBlock = xStart.pxNextFreeBlock;
 
@@ -594,7 +617,7 @@ void vPortGetHeapStats( HeapStats_t * pxHeapStats )
             }
         }
     }
-    ( void ) xTaskResumeAll();
+    heapUNLOCK();
 
     pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
     pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
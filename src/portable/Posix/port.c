@@ -40,6 +40,12 @@
 * The timer interrupt uses SIGALRM and care is taken to ensure that
 * the signal handler runs only on the thread for the current task.
 *
+* Further peripheral interrupts can be simulated with
+* vPortGenerateSimulatedInterrupt().  They are delivered with
+* SIG_INTERRUPT, which is handled in the same way as SIGALRM, and are
+* dispatched by priority so that they can be masked by
+* portSET_INTERRUPT_MASK_FROM_ISR() and can nest.
+*
 * Use of part of the standard C library requires care as some
 * functions can take pthread mutexes internally which can result in
 * deadlocks as the FreeRTOS kernel can switch tasks while they're
@@ -48,7 +54,23 @@
 * stdio (printf() and friends) should be called from a single task
 * only or serialized with a FreeRTOS primitive such as a binary
 * semaphore or mutex.
+*
+* For repeatable timing the simulator threads can be pinned to one host
+* CPU, run with SCHED_FIFO and have their memory locked and prefaulted,
+* see the configPOSIX_* options below.
+*
+* With configNUMBER_OF_KERNEL_INSTANCES greater than 1 several kernels run
+* concurrently, each on the host thread that starts its scheduler and the
+* threads of its tasks.  Each instance then has its own tick thread, and the
+* tick and simulated interrupts are directed at the thread running the
+* instance's current task rather than at the process.
 *----------------------------------------------------------*/
+#ifdef __linux__
+    #ifndef _GNU_SOURCE
+        #define _GNU_SOURCE    /* For pthread_setaffinity_np(). */
+    #endif
+#endif
+
 #include "portmacro.h"
 
 #include <errno.h>
@@ -57,9 +79,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sched.h>
+#include <sys/mman.h>
 #include <sys/time.h>
-#include <sys/times.h>
 #include <time.h>
+#include <unistd.h>
 
 #ifdef __APPLE__
     #include <mach/mach_vm.h>
@@ -72,7 +96,68 @@
 #include "utils/wait_for_event.h"
 /*-----------------------------------------------------------*/
 
-#define SIG_RESUME    SIGUSR1
+#define SIG_RESUME       SIGUSR1
+#define SIG_INTERRUPT    SIGUSR2
+
+/* The priority of the tick interrupt.  Simulated interrupts use logical
+ * priorities where a higher number is more urgent, and level 0 is task
+ * (thread) level. */
+#ifndef configKERNEL_INTERRUPT_PRIORITY
+    #define configKERNEL_INTERRUPT_PRIORITY    ( 1 )
+#endif
+
+/* Simulated interrupts with a priority above this level are never masked by
+ * portSET_INTERRUPT_MASK_FROM_ISR() and must not call FreeRTOS API
+ * functions. */
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+    #define configMAX_SYSCALL_INTERRUPT_PRIORITY    ( portMAX_INTERRUPT_PRIORITY / 2 )
+#endif
+
+/* Set to 1 to count run time stats with a hardware counter rather than in
+ * nanoseconds: the time stamp counter (CPU cycles) on x86, or the virtual count
+ * of the generic timer (CNTVCT_EL0, which ticks at CNTFRQ_EL0 rather than at
+ * the CPU clock) on AArch64.  Falls back to nanoseconds on other hosts. */
+#ifndef configRUN_TIME_COUNTER_USE_CPU_CYCLES
+    #define configRUN_TIME_COUNTER_USE_CPU_CYCLES    0
+#endif
+
+/* The counter is read as 64 bits, and a nanosecond count wraps a 32-bit
+ * configRUN_TIME_COUNTER_TYPE in a little over four seconds. */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    _Static_assert( sizeof( configRUN_TIME_COUNTER_TYPE ) == sizeof( uint64_t ), "configRUN_TIME_COUNTER_TYPE must be 64 bits wide on the Posix port" );
+#endif
+
+/* Host CPU that all simulator threads are pinned to, or -1 to let the host
+ * migrate them.  The tick is a process signal taken by the running task's
+ * thread, so it is pinned with them.  Linux only. */
+#ifndef configPOSIX_CPU_AFFINITY
+    #define configPOSIX_CPU_AFFINITY    ( -1 )
+#endif
+
+/* Set to 1 to run the simulator threads with SCHED_FIFO at
+ * configPOSIX_SCHED_FIFO_PRIORITY.  Needs CAP_SYS_NICE or an rtprio limit. */
+#ifndef configPOSIX_USE_SCHED_FIFO
+    #define configPOSIX_USE_SCHED_FIFO    0
+#endif
+
+#ifndef configPOSIX_SCHED_FIFO_PRIORITY
+    #define configPOSIX_SCHED_FIFO_PRIORITY    ( 50 )
+#endif
+
+/* Set to 1 to lock all current and future memory with mlockall(). */
+#ifndef configPOSIX_LOCK_MEMORY
+    #define configPOSIX_LOCK_MEMORY    0
+#endif
+
+/* Set to 1 to touch every page of a task's stack before its thread is
+ * created, so the first run of the task does not take page faults. */
+#ifndef configPOSIX_PREFAULT_STACKS
+    #define configPOSIX_PREFAULT_STACKS    0
+#endif
+
+#if ( configKERNEL_INTERRUPT_PRIORITY > configMAX_SYSCALL_INTERRUPT_PRIORITY )
+    #error configKERNEL_INTERRUPT_PRIORITY must not be above configMAX_SYSCALL_INTERRUPT_PRIORITY
+#endif
 
 typedef struct THREAD
 {
@@ -80,6 +165,7 @@ typedef struct THREAD
     TaskFunction_t pxCode;
     void * pvParams;
     BaseType_t xDying;
+    UBaseType_t uxKernelInstance;
     struct event * ev;
 } Thread_t;
 
@@ -98,22 +184,134 @@ static inline Thread_t * prvGetThreadFromTask( TaskHandle_t xTask )
 
 static pthread_once_t hSigSetupThread = PTHREAD_ONCE_INIT;
 static sigset_t xAllSignals;
-static sigset_t xSchedulerOriginalSignalMask;
-static pthread_t hMainThread = ( pthread_t ) NULL;
-static volatile portBASE_TYPE uxCriticalNesting;
+static sigset_t xInterruptSignal;
+/*-----------------------------------------------------------*/
+
+/* State that belongs to the code that is executing, which is saved and
+ * restored across a switch.  Thread local when several kernel instances
+ * execute at the same time. */
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    #define portCONTEXT_LOCAL    __thread
+#else
+    #define portCONTEXT_LOCAL
+#endif
+
+__thread UBaseType_t uxPortKernelInstance = 0;
+
+static portCONTEXT_LOCAL volatile portBASE_TYPE uxCriticalNesting;
+
+/*
+ * Simulated interrupt controller state.  uxInterruptPriority is the
+ * priority of the code currently executing (0 for a task) and
+ * uxInterruptMask the level set by xPortSetInterruptMask().  Both are per
+ * context, so are saved and restored across a switch like
+ * uxCriticalNesting.  A pending interrupt is dispatched when its priority is
+ * above both of them.
+ */
+static portCONTEXT_LOCAL volatile UBaseType_t uxInterruptPriority = 0;
+static portCONTEXT_LOCAL volatile UBaseType_t uxInterruptMask = 0;
+static portCONTEXT_LOCAL volatile BaseType_t xInterruptNesting = 0;
+static portCONTEXT_LOCAL volatile BaseType_t xInterruptYieldPending = pdFALSE;
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+
+    static sigset_t xSchedulerOriginalSignalMask;
+    static pthread_t hMainThread = ( pthread_t ) NULL;
+    static portBASE_TYPE xSchedulerEnd = pdFALSE;
+    static uint64_t prvRunTimeBase;
+
+    static volatile uint32_t ulPendingInterrupts = 0UL;
+    static uint32_t ( * volatile pxIsrHandler[ portMAX_INTERRUPTS ] )( void ) = { 0 };
+    static volatile UBaseType_t uxIsrPriority[ portMAX_INTERRUPTS ] = { 0 };
+
+#else /* configNUMBER_OF_KERNEL_INSTANCES */
+
+/* The scheduler and interrupt controller state of each kernel instance.  The
+ * names used by the rest of this file resolve to the members belonging to the
+ * kernel instance of the calling thread. */
+    typedef struct PORT_KERNEL_INSTANCE
+    {
+        sigset_t xSchedulerOriginalSignalMask;
+        pthread_t hMainThread;
+        pthread_t hTickThread;
+        portBASE_TYPE xSchedulerEnd;
+        BaseType_t xSignalsBlocked;
+        volatile BaseType_t xTickThreadRun;
+        volatile BaseType_t xTickPending;
+        uint64_t prvRunTimeBase;
+
+        volatile uint32_t ulPendingInterrupts;
+        uint32_t ( * volatile pxIsrHandler[ portMAX_INTERRUPTS ] )( void );
+        volatile UBaseType_t uxIsrPriority[ portMAX_INTERRUPTS ];
+    } PortKernelInstance_t;
+
+    static PortKernelInstance_t xPortKernelInstances[ configNUMBER_OF_KERNEL_INSTANCES ];
+
+    #define portKERNEL_INSTANCE              ( xPortKernelInstances[ portGET_KERNEL_INSTANCE() ] )
+    #define xSchedulerOriginalSignalMask    ( portKERNEL_INSTANCE.xSchedulerOriginalSignalMask )
+    #define hMainThread                     ( portKERNEL_INSTANCE.hMainThread )
+    #define hTickThread                     ( portKERNEL_INSTANCE.hTickThread )
+    #define xSchedulerEnd                   ( portKERNEL_INSTANCE.xSchedulerEnd )
+    #define xSignalsBlocked                 ( portKERNEL_INSTANCE.xSignalsBlocked )
+    #define xTickThreadRun                  ( portKERNEL_INSTANCE.xTickThreadRun )
+    #define xTickPending                    ( portKERNEL_INSTANCE.xTickPending )
+    #define prvRunTimeBase                  ( portKERNEL_INSTANCE.prvRunTimeBase )
+    #define ulPendingInterrupts             ( portKERNEL_INSTANCE.ulPendingInterrupts )
+    #define pxIsrHandler                    ( portKERNEL_INSTANCE.pxIsrHandler )
+    #define uxIsrPriority                   ( portKERNEL_INSTANCE.uxIsrPriority )
+
+/* Held while a task's thread is signalled from outside the instance, so the
+ * thread cannot be cancelled in between. */
+    static pthread_mutex_t hThreadMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Held while the heap is in use, see portHEAP_LOCK(). */
+    static pthread_mutex_t hHeapMutex = PTHREAD_MUTEX_INITIALIZER;
+
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
 /*-----------------------------------------------------------*/
 
-static portBASE_TYPE xSchedulerEnd = pdFALSE;
+/* The first error, if any, from applying each host scheduling setting.
+ * Reported when the scheduler starts. */
+#if ( configPOSIX_CPU_AFFINITY >= 0 )
+    static int iAffinityError = 0;
+#endif
+
+#if ( configPOSIX_USE_SCHED_FIFO == 1 )
+    static int iSchedFifoError = 0;
+#endif
+
+#if ( configPOSIX_LOCK_MEMORY == 1 )
+    static int iLockMemoryError = 0;
+#endif
+
+#if ( configPOSIX_PREFAULT_STACKS == 1 )
+    static int iPrefaultError = 0;
+#endif
 /*-----------------------------------------------------------*/
 
 static void prvSetupSignalsAndSchedulerPolicy( void );
+static void prvBlockSignalsForScheduler( void );
+static void prvSignalCurrentTask( int iSignal );
+static void prvApplyHostSchedulingPolicy( pthread_t xThread );
+static void prvReportHostSchedulingPolicy( void );
+#if ( configPOSIX_PREFAULT_STACKS == 1 )
+    static int prvPrefaultStack( StackType_t * pxEndOfStack,
+                                 size_t ulStackSize );
+#endif
 static void prvSetupTimerInterrupt( void );
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    static void * prvTickThread( void * pvParams );
+    static void prvRaisePendingSignals( void );
+#endif
 static void * prvWaitForStart( void * pvParams );
 static void prvSwitchThread( Thread_t * xThreadToResume,
                              Thread_t * xThreadToSuspend );
 static void prvSuspendSelf( Thread_t * thread );
 static void prvResumeThread( Thread_t * xThreadId );
 static void vPortSystemTickHandler( int sig );
+static void prvInterruptSignalHandler( int sig );
+static BaseType_t prvGetHighestPendingInterrupt( UBaseType_t uxLevel );
 static void vPortStartFirstTask( void );
 static void prvPortYieldFromISR( void );
 /*-----------------------------------------------------------*/
@@ -143,6 +341,14 @@ portSTACK_TYPE * pxPortInitialiseStack( StackType_t * pxTopOfStack,
 
     ( void ) pthread_once( &hSigSetupThread, prvSetupSignalsAndSchedulerPolicy );
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        if( xSignalsBlocked == pdFALSE )
+        {
+            xSignalsBlocked = pdTRUE;
+            prvBlockSignalsForScheduler();
+        }
+    #endif
+
     /*
      * Store the additional thread data at the start of the stack.
      */
@@ -158,14 +364,28 @@ portSTACK_TYPE * pxPortInitialiseStack( StackType_t * pxTopOfStack,
     thread->pxCode = pxCode;
     thread->pvParams = pvParameters;
     thread->xDying = pdFALSE;
+    thread->uxKernelInstance = portGET_KERNEL_INSTANCE();
+
+    #if ( configPOSIX_PREFAULT_STACKS == 1 )
+    {
+        int iError = prvPrefaultStack( pxEndOfStack, ulStackSize );
+
+        if( ( iError != 0 ) && ( iPrefaultError == 0 ) )
+        {
+            iPrefaultError = iError;
+        }
+    }
+    #endif
 
     pthread_attr_init( &xThreadAttributes );
     pthread_attr_setstack( &xThreadAttributes, pxEndOfStack, ulStackSize );
 
-    thread->ev = event_create();
-
+    /* event_create() allocates, so is called with interrupts masked for the
+     * same reason as vPortCancelThread() is. */
     vPortEnterCritical();
 
+    thread->ev = event_create();
+
     iRet = pthread_create( &thread->pthread, &xThreadAttributes,
                            prvWaitForStart, thread );
 
@@ -174,6 +394,8 @@ portSTACK_TYPE * pxPortInitialiseStack( StackType_t * pxTopOfStack,
         prvFatalError( "pthread_create", iRet );
     }
 
+    prvApplyHostSchedulingPolicy( thread->pthread );
+
     vPortExitCritical();
 
     return pxTopOfStack;
@@ -199,6 +421,9 @@ portBASE_TYPE xPortStartScheduler( void )
 
     hMainThread = pthread_self();
 
+    prvApplyHostSchedulingPolicy( hMainThread );
+    prvReportHostSchedulingPolicy();
+
     /* Start the timer that generates the tick ISR(SIGALRM).
      * Interrupts are disabled here already. */
     prvSetupTimerInterrupt();
@@ -221,6 +446,12 @@ portBASE_TYPE xPortStartScheduler( void )
         sigwait( &xSignals, &iSignal );
     }
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        /* The tick thread signals the current task, so must stop before the
+         * task threads are cancelled. */
+        ( void ) pthread_join( hTickThread, NULL );
+    #endif
+
     /* Cancel the Idle task and free its resources */
     #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
         vPortCancelThread( xTaskGetIdleTaskHandle() );
@@ -234,29 +465,47 @@ portBASE_TYPE xPortStartScheduler( void )
     /* Restore original signal mask. */
     ( void ) pthread_sigmask( SIG_SETMASK, &xSchedulerOriginalSignalMask, NULL );
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        /* Allow the instance to be started again. */
+        xSchedulerEnd = pdFALSE;
+        xSignalsBlocked = pdFALSE;
+        xTickPending = pdFALSE;
+        ulPendingInterrupts = 0UL;
+    #endif
+
     return 0;
 }
 /*-----------------------------------------------------------*/
 
 void vPortEndScheduler( void )
 {
-    struct itimerval itimer;
-    struct sigaction sigtick;
     Thread_t * xCurrentThread;
 
-    /* Stop the timer and ignore any pending SIGALRMs that would end
-     * up running on the main thread when it is resumed. */
-    itimer.it_value.tv_sec = 0;
-    itimer.it_value.tv_usec = 0;
-
-    itimer.it_interval.tv_sec = 0;
-    itimer.it_interval.tv_usec = 0;
-    ( void ) setitimer( ITIMER_REAL, &itimer, NULL );
-
-    sigtick.sa_flags = 0;
-    sigtick.sa_handler = SIG_IGN;
-    sigemptyset( &sigtick.sa_mask );
-    sigaction( SIGALRM, &sigtick, NULL );
+    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+        struct itimerval itimer;
+        struct sigaction sigtick;
+
+        /* Stop the timer and ignore any pending SIGALRMs that would end
+         * up running on the main thread when it is resumed. */
+        itimer.it_value.tv_sec = 0;
+        itimer.it_value.tv_usec = 0;
+
+        itimer.it_interval.tv_sec = 0;
+        itimer.it_interval.tv_usec = 0;
+        ( void ) setitimer( ITIMER_REAL, &itimer, NULL );
+
+        sigtick.sa_flags = 0;
+        sigtick.sa_handler = SIG_IGN;
+        sigemptyset( &sigtick.sa_mask );
+        sigaction( SIGALRM, &sigtick, NULL );
+        sigaction( SIG_INTERRUPT, &sigtick, NULL );
+    #else
+
+        /* The signal handlers are shared with the other instances, so only
+         * this instance's tick thread is stopped.  Signals are only ever
+         * directed at task threads, never at the main thread. */
+        xTickThreadRun = pdFALSE;
+    #endif
 
     /* Signal the scheduler to exit its loop. */
     xSchedulerEnd = pdTRUE;
@@ -329,15 +578,163 @@ void vPortEnableInterrupts( void )
 
 UBaseType_t xPortSetInterruptMask( void )
 {
-    /* Interrupts are always disabled inside ISRs (signals
-     * handlers). */
-    return ( UBaseType_t )0;
+    UBaseType_t uxOriginalMask = uxInterruptMask;
+
+    /* Only simulated interrupts at or below the syscall priority are masked,
+     * as on ports that implement configMAX_SYSCALL_INTERRUPT_PRIORITY. */
+    if( uxOriginalMask < configMAX_SYSCALL_INTERRUPT_PRIORITY )
+    {
+        uxInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+    }
+
+    return uxOriginalMask;
 }
 /*-----------------------------------------------------------*/
 
 void vPortClearInterruptMask( UBaseType_t uxMask )
 {
-    ( void ) uxMask;
+    UBaseType_t uxLevel;
+
+    uxInterruptMask = uxMask;
+
+    /* Interrupts that were held off by the mask are now raised again. */
+    uxLevel = ( uxInterruptPriority > uxMask ) ? uxInterruptPriority : uxMask;
+
+    if( prvGetHighestPendingInterrupt( uxLevel ) >= 0 )
+    {
+        ( void ) pthread_kill( pthread_self(), SIG_INTERRUPT );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortValidateInterruptPriority( void )
+{
+    /* FreeRTOS API functions ending in FromISR must only be called from
+     * simulated interrupts at or below configMAX_SYSCALL_INTERRUPT_PRIORITY. */
+    configASSERT( uxInterruptPriority <= configMAX_SYSCALL_INTERRUPT_PRIORITY );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    if( xInterruptNesting > 0 )
+    {
+        /* The switch is performed when the outermost simulated interrupt
+         * returns. */
+        xInterruptYieldPending = pdTRUE;
+    }
+    else
+    {
+        vPortYield();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber,
+                               uint32_t ( * pvHandler )( void ) )
+{
+    if( ulInterruptNumber < portMAX_INTERRUPTS )
+    {
+        if( uxIsrPriority[ ulInterruptNumber ] == 0 )
+        {
+            uxIsrPriority[ ulInterruptNumber ] = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+        }
+
+        pxIsrHandler[ ulInterruptNumber ] = pvHandler;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber,
+                                UBaseType_t uxPriority )
+{
+    configASSERT( ( uxPriority > 0 ) && ( uxPriority <= portMAX_INTERRUPT_PRIORITY ) );
+
+    if( ulInterruptNumber < portMAX_INTERRUPTS )
+    {
+        uxIsrPriority[ ulInterruptNumber ] = uxPriority;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+    if( ulInterruptNumber < portMAX_INTERRUPTS )
+    {
+        ( void ) __atomic_fetch_or( &ulPendingInterrupts, 1UL << ulInterruptNumber, __ATOMIC_SEQ_CST );
+
+        prvSignalCurrentTask( SIG_INTERRUPT );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterruptFromHost( UBaseType_t uxKernelInstance,
+                                              uint32_t ulInterruptNumber )
+{
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        UBaseType_t uxSavedInstance = portGET_KERNEL_INSTANCE();
+
+        /* The interrupt controller state used by
+         * vPortGenerateSimulatedInterrupt() is that of the calling thread's
+         * instance, so borrow the target instance for the call. */
+        portSET_KERNEL_INSTANCE( uxKernelInstance );
+        vPortGenerateSimulatedInterrupt( ulInterruptNumber );
+        portSET_KERNEL_INSTANCE( uxSavedInstance );
+    #else
+        ( void ) uxKernelInstance;
+        vPortGenerateSimulatedInterrupt( ulInterruptNumber );
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvGetHighestPendingInterrupt( UBaseType_t uxLevel )
+{
+    uint32_t ulPending = __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST );
+    BaseType_t xHighest = -1;
+    UBaseType_t uxHighestPriority = uxLevel;
+    uint32_t i;
+
+    for( i = 0; ulPending != 0UL; i++, ulPending >>= 1 )
+    {
+        if( ( ( ulPending & 1UL ) != 0UL ) && ( uxIsrPriority[ i ] > uxHighestPriority ) )
+        {
+            uxHighestPriority = uxIsrPriority[ i ];
+            xHighest = ( BaseType_t ) i;
+        }
+    }
+
+    return xHighest;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSignalCurrentTask( int iSignal )
+{
+    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+        /* Process directed, so it is taken by the only thread with signals
+         * unblocked - the one running the current task - or held pending
+         * until a task leaves its critical section. */
+        ( void ) kill( getpid(), iSignal );
+    #else
+        TaskHandle_t xTask;
+        sigset_t xSavedSignals;
+
+        /* Directed at the thread running the instance's current task.  If
+         * that task is switched out before the signal is taken, the signal
+         * stays with its thread and the task switched in raises it again, see
+         * prvRaisePendingSignals(). */
+        ( void ) pthread_sigmask( SIG_BLOCK, &xAllSignals, &xSavedSignals );
+        ( void ) pthread_mutex_lock( &hThreadMutex );
+
+        xTask = xTaskGetCurrentTaskHandle();
+
+        if( xTask != NULL )
+        {
+            ( void ) pthread_kill( prvGetThreadFromTask( xTask )->pthread, iSignal );
+        }
+
+        ( void ) pthread_mutex_unlock( &hThreadMutex );
+        ( void ) pthread_sigmask( SIG_SETMASK, &xSavedSignals, NULL );
+    #endif /* configNUMBER_OF_KERNEL_INSTANCES */
 }
 /*-----------------------------------------------------------*/
 
@@ -350,7 +747,9 @@ static uint64_t prvGetTimeNs( void )
     return ( uint64_t )t.tv_sec * ( uint64_t )1000000000UL + ( uint64_t )t.tv_nsec;
 }
 
-static uint64_t prvStartTimeNs;
+#if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+    static uint64_t prvStartTimeNs;
+#endif
 
 /* commented as part of the code below in vPortSystemTickHandler,
  * to adjust timing according to full demo requirements */
@@ -362,48 +761,131 @@ static uint64_t prvStartTimeNs;
  */
 void prvSetupTimerInterrupt( void )
 {
-    struct itimerval itimer;
-    int iRet;
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        int iRet;
 
-    /* Initialise the structure with the current timer information. */
-    iRet = getitimer( ITIMER_REAL, &itimer );
+        /* ITIMER_REAL is shared by the whole process, so each instance has a
+         * thread that raises its tick.  Created with all signals blocked as
+         * interrupts are disabled here. */
+        xTickThreadRun = pdTRUE;
 
-    if( iRet == -1 )
+        iRet = pthread_create( &hTickThread, NULL, prvTickThread,
+                               ( void * ) ( uintptr_t ) portGET_KERNEL_INSTANCE() );
+
+        if( iRet != 0 )
+        {
+            prvFatalError( "pthread_create", iRet );
+        }
+
+        prvApplyHostSchedulingPolicy( hTickThread );
+    #else
+        struct itimerval itimer;
+        int iRet;
+
+        /* Initialise the structure with the current timer information. */
+        iRet = getitimer( ITIMER_REAL, &itimer );
+
+        if( iRet == -1 )
+        {
+            prvFatalError( "getitimer", errno );
+        }
+
+        /* Set the interval between timer events. */
+        itimer.it_interval.tv_sec = 0;
+        itimer.it_interval.tv_usec = portTICK_RATE_MICROSECONDS;
+
+        /* Set the current count-down. */
+        itimer.it_value.tv_sec = 0;
+        itimer.it_value.tv_usec = portTICK_RATE_MICROSECONDS;
+
+        /* Set-up the timer interrupt. */
+        iRet = setitimer( ITIMER_REAL, &itimer, NULL );
+
+        if( iRet == -1 )
+        {
+            prvFatalError( "setitimer", errno );
+        }
+
+        prvStartTimeNs = prvGetTimeNs();
+    #endif /* configNUMBER_OF_KERNEL_INSTANCES */
+}
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+
+    static void * prvTickThread( void * pvParams )
     {
-        prvFatalError( "getitimer", errno );
-    }
+        struct timespec xNextTick;
 
-    /* Set the interval between timer events. */
-    itimer.it_interval.tv_sec = 0;
-    itimer.it_interval.tv_usec = portTICK_RATE_MICROSECONDS;
+        portSET_KERNEL_INSTANCE( ( UBaseType_t ) ( uintptr_t ) pvParams );
 
-    /* Set the current count-down. */
-    itimer.it_value.tv_sec = 0;
-    itimer.it_value.tv_usec = portTICK_RATE_MICROSECONDS;
+        clock_gettime( CLOCK_MONOTONIC, &xNextTick );
 
-    /* Set-up the timer interrupt. */
-    iRet = setitimer( ITIMER_REAL, &itimer, NULL );
+        while( xTickThreadRun != pdFALSE )
+        {
+            xNextTick.tv_nsec += ( long ) portTICK_RATE_MICROSECONDS * 1000L;
 
-    if( iRet == -1 )
+            if( xNextTick.tv_nsec >= 1000000000L )
+            {
+                xNextTick.tv_nsec -= 1000000000L;
+                xNextTick.tv_sec++;
+            }
+
+            while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNextTick, NULL ) == EINTR )
+            {
+            }
+
+            __atomic_store_n( &xTickPending, pdTRUE, __ATOMIC_SEQ_CST );
+            prvSignalCurrentTask( SIGALRM );
+        }
+
+        return NULL;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRaisePendingSignals( void )
     {
-        prvFatalError( "setitimer", errno );
+        /* A signal directed at the previous task's thread after it was
+         * switched out is not taken until that task runs again, so is raised
+         * again on the thread of the task switched in.  Signals are blocked
+         * here, and a duplicate finds nothing pending. */
+        if( __atomic_load_n( &xTickPending, __ATOMIC_SEQ_CST ) != pdFALSE )
+        {
+            ( void ) pthread_kill( pthread_self(), SIGALRM );
+        }
+
+        if( __atomic_load_n( &ulPendingInterrupts, __ATOMIC_SEQ_CST ) != 0UL )
+        {
+            ( void ) pthread_kill( pthread_self(), SIG_INTERRUPT );
+        }
     }
 
-    prvStartTimeNs = prvGetTimeNs();
-}
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
 /*-----------------------------------------------------------*/
 
 static void vPortSystemTickHandler( int sig )
 {
     Thread_t * pxThreadToSuspend;
     Thread_t * pxThreadToResume;
+    UBaseType_t uxSavedInterruptPriority;
 
     ( void ) sig;
 
 /* uint64_t xExpectedTicks; */
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        if( __atomic_exchange_n( &xTickPending, pdFALSE, __ATOMIC_SEQ_CST ) == pdFALSE )
+        {
+            /* Already taken on the thread of another task. */
+            return;
+        }
+    #endif
+
     uxCriticalNesting++; /* Signals are blocked in this signal handler. */
 
+    uxSavedInterruptPriority = uxInterruptPriority;
+    uxInterruptPriority = configKERNEL_INTERRUPT_PRIORITY;
+
     #if ( configUSE_PREEMPTION == 1 )
         pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
     #endif
@@ -431,6 +913,68 @@ static void vPortSystemTickHandler( int sig )
         prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
     #endif
 
+    uxInterruptPriority = uxSavedInterruptPriority;
+    uxCriticalNesting--;
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int sig )
+{
+    Thread_t * pxThreadToSuspend;
+    Thread_t * pxThreadToResume;
+    UBaseType_t uxSavedInterruptPriority = uxInterruptPriority;
+    UBaseType_t uxLevel;
+    BaseType_t xInterrupt;
+
+    ( void ) sig;
+
+    uxCriticalNesting++; /* Signals are blocked in this signal handler. */
+    xInterruptNesting++;
+
+    for( ; ; )
+    {
+        uxLevel = ( uxSavedInterruptPriority > uxInterruptMask ) ? uxSavedInterruptPriority : uxInterruptMask;
+        xInterrupt = prvGetHighestPendingInterrupt( uxLevel );
+
+        if( xInterrupt < 0 )
+        {
+            break;
+        }
+
+        ( void ) __atomic_fetch_and( &ulPendingInterrupts, ~( 1UL << xInterrupt ), __ATOMIC_SEQ_CST );
+
+        if( pxIsrHandler[ xInterrupt ] != NULL )
+        {
+            /* Run the handler at its own priority with SIG_INTERRUPT
+             * unblocked, so only higher priority interrupts can nest. */
+            uxInterruptPriority = uxIsrPriority[ xInterrupt ];
+            ( void ) pthread_sigmask( SIG_UNBLOCK, &xInterruptSignal, NULL );
+
+            if( pxIsrHandler[ xInterrupt ]() != pdFALSE )
+            {
+                xInterruptYieldPending = pdTRUE;
+            }
+
+            ( void ) pthread_sigmask( SIG_BLOCK, &xInterruptSignal, NULL );
+            uxInterruptPriority = uxSavedInterruptPriority;
+        }
+    }
+
+    xInterruptNesting--;
+
+    if( ( xInterruptNesting == 0 ) && ( xInterruptYieldPending != pdFALSE ) )
+    {
+        xInterruptYieldPending = pdFALSE;
+
+        pxThreadToSuspend = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        vTaskSwitchContext();
+
+        pxThreadToResume = prvGetThreadFromTask( xTaskGetCurrentTaskHandle() );
+
+        prvSwitchThread( pxThreadToResume, pxThreadToSuspend );
+    }
+
     uxCriticalNesting--;
 }
 /*-----------------------------------------------------------*/
@@ -449,23 +993,61 @@ void vPortCancelThread( void * pxTaskToDelete )
 {
     Thread_t * pxThreadToCancel = prvGetThreadFromTask( pxTaskToDelete );
 
+    /* pthread_join() and free() take locks internal to the C library.  A
+     * task switched out by the tick while it held one would leave the next
+     * task to create a thread or allocate memory waiting for it forever. */
+    vPortEnterCritical();
+
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        ( void ) pthread_mutex_lock( &hThreadMutex );
+    #endif
+
     /*
      * The thread has already been suspended so it can be safely cancelled.
      */
     pthread_cancel( pxThreadToCancel->pthread );
     pthread_join( pxThreadToCancel->pthread, NULL );
     event_delete( pxThreadToCancel->ev );
+
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        ( void ) pthread_mutex_unlock( &hThreadMutex );
+    #endif
+
+    vPortExitCritical();
 }
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+
+    void vPortHeapLock( void )
+    {
+        ( void ) pthread_mutex_lock( &hHeapMutex );
+    }
+
+    void vPortHeapUnlock( void )
+    {
+        ( void ) pthread_mutex_unlock( &hHeapMutex );
+    }
+
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
+/*-----------------------------------------------------------*/
+
 static void * prvWaitForStart( void * pvParams )
 {
     Thread_t * pxThread = pvParams;
 
+    portSET_KERNEL_INSTANCE( pxThread->uxKernelInstance );
+
     prvSuspendSelf( pxThread );
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+        prvRaisePendingSignals();
+    #endif
+
     /* Resumed for the first time, unblocks all signals. */
     uxCriticalNesting = 0;
+    uxInterruptPriority = 0;
+    uxInterruptMask = 0;
     vPortEnableInterrupts();
 
     /* Call the task's entry point. */
@@ -486,6 +1068,8 @@ static void prvSwitchThread( Thread_t * pxThreadToResume,
                              Thread_t * pxThreadToSuspend )
 {
     BaseType_t uxSavedCriticalNesting;
+    UBaseType_t uxSavedInterruptPriority;
+    UBaseType_t uxSavedInterruptMask;
 
     if( pxThreadToSuspend != pxThreadToResume )
     {
@@ -494,9 +1078,12 @@ static void prvSwitchThread( Thread_t * pxThreadToResume,
          *
          * The critical section nesting is per-task, so save it on the
          * stack of the current (suspending thread), restoring it when
-         * we switch back to this task.
+         * we switch back to this task.  The same applies to the simulated
+         * interrupt priority and mask.
          */
         uxSavedCriticalNesting = uxCriticalNesting;
+        uxSavedInterruptPriority = uxInterruptPriority;
+        uxSavedInterruptMask = uxInterruptMask;
 
         prvResumeThread( pxThreadToResume );
 
@@ -507,7 +1094,13 @@ static void prvSwitchThread( Thread_t * pxThreadToResume,
 
         prvSuspendSelf( pxThreadToSuspend );
 
+        #if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+            prvRaisePendingSignals();
+        #endif
+
         uxCriticalNesting = uxSavedCriticalNesting;
+        uxInterruptPriority = uxSavedInterruptPriority;
+        uxInterruptMask = uxSavedInterruptMask;
     }
 }
 /*-----------------------------------------------------------*/
@@ -546,7 +1139,12 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     struct sigaction sigtick;
     int iRet;
 
-    hMainThread = pthread_self();
+    #if ( configPOSIX_LOCK_MEMORY == 1 )
+        if( mlockall( MCL_CURRENT | MCL_FUTURE ) != 0 )
+        {
+            iLockMemoryError = errno;
+        }
+    #endif
 
     /* Initialise common signal masks. */
     sigfillset( &xAllSignals );
@@ -555,6 +1153,41 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
      * in a critical section. */
     sigdelset( &xAllSignals, SIGINT );
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+        prvBlockSignalsForScheduler();
+    #endif
+
+    sigtick.sa_flags = 0;
+    sigtick.sa_handler = vPortSystemTickHandler;
+    sigfillset( &sigtick.sa_mask );
+
+    iRet = sigaction( SIGALRM, &sigtick, NULL );
+
+    if( iRet == -1 )
+    {
+        prvFatalError( "sigaction", errno );
+    }
+
+    /* Simulated interrupts are handled like the tick, with all signals
+     * blocked on entry. */
+    sigemptyset( &xInterruptSignal );
+    sigaddset( &xInterruptSignal, SIG_INTERRUPT );
+
+    sigtick.sa_handler = prvInterruptSignalHandler;
+
+    iRet = sigaction( SIG_INTERRUPT, &sigtick, NULL );
+
+    if( iRet == -1 )
+    {
+        prvFatalError( "sigaction", errno );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvBlockSignalsForScheduler( void )
+{
+    hMainThread = pthread_self();
+
     /*
      * Block all signals in this thread so all new threads
      * inherits this mask.
@@ -565,26 +1198,156 @@ static void prvSetupSignalsAndSchedulerPolicy( void )
     ( void ) pthread_sigmask( SIG_SETMASK,
                               &xAllSignals,
                               &xSchedulerOriginalSignalMask );
+}
+/*-----------------------------------------------------------*/
 
-    sigtick.sa_flags = 0;
-    sigtick.sa_handler = vPortSystemTickHandler;
-    sigfillset( &sigtick.sa_mask );
+static void prvApplyHostSchedulingPolicy( pthread_t xThread )
+{
+    int iRet = 0;
 
-    iRet = sigaction( SIGALRM, &sigtick, NULL );
+    #if ( configPOSIX_CPU_AFFINITY >= 0 )
+        #ifdef __linux__
+            cpu_set_t xCpuSet;
 
-    if( iRet == -1 )
+            CPU_ZERO( &xCpuSet );
+            CPU_SET( configPOSIX_CPU_AFFINITY, &xCpuSet );
+            iRet = pthread_setaffinity_np( xThread, sizeof( xCpuSet ), &xCpuSet );
+        #else
+            iRet = ENOTSUP;
+        #endif
+
+        if( ( iRet != 0 ) && ( iAffinityError == 0 ) )
+        {
+            iAffinityError = iRet;
+        }
+    #endif /* configPOSIX_CPU_AFFINITY */
+
+    #if ( configPOSIX_USE_SCHED_FIFO == 1 )
+        struct sched_param xParam;
+
+        memset( &xParam, 0, sizeof( xParam ) );
+        xParam.sched_priority = configPOSIX_SCHED_FIFO_PRIORITY;
+        iRet = pthread_setschedparam( xThread, SCHED_FIFO, &xParam );
+
+        if( ( iRet != 0 ) && ( iSchedFifoError == 0 ) )
+        {
+            iSchedFifoError = iRet;
+        }
+    #endif /* configPOSIX_USE_SCHED_FIFO */
+
+    ( void ) xThread;
+    ( void ) iRet;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReportHostSchedulingPolicy( void )
+{
+    #if ( configPOSIX_CPU_AFFINITY >= 0 )
+        fprintf( stderr, "Posix port: pin threads to CPU %d: %s\n", configPOSIX_CPU_AFFINITY,
+                 ( iAffinityError == 0 ) ? "ok" : strerror( iAffinityError ) );
+    #endif
+
+    #if ( configPOSIX_USE_SCHED_FIFO == 1 )
+        fprintf( stderr, "Posix port: SCHED_FIFO priority %d: %s\n", configPOSIX_SCHED_FIFO_PRIORITY,
+                 ( iSchedFifoError == 0 ) ? "ok" : strerror( iSchedFifoError ) );
+    #endif
+
+    #if ( configPOSIX_LOCK_MEMORY == 1 )
+        fprintf( stderr, "Posix port: mlockall: %s\n",
+                 ( iLockMemoryError == 0 ) ? "ok" : strerror( iLockMemoryError ) );
+    #endif
+
+    #if ( configPOSIX_PREFAULT_STACKS == 1 )
+        fprintf( stderr, "Posix port: prefault task stacks: %s\n",
+                 ( iPrefaultError == 0 ) ? "ok" : strerror( iPrefaultError ) );
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+#if ( configPOSIX_PREFAULT_STACKS == 1 )
+
+    /* Returns 0 if every page of the stack is resident once touched, otherwise
+     * the error that stopped it being checked, or EAGAIN if a page is still not
+     * resident. */
+    static int prvPrefaultStack( StackType_t * pxEndOfStack,
+                                 size_t ulStackSize )
     {
-        prvFatalError( "sigaction", errno );
+        volatile uint8_t * pucByte = ( volatile uint8_t * ) pxEndOfStack;
+        long lPageSize = sysconf( _SC_PAGESIZE );
+        uintptr_t uxPage, uxEnd;
+        unsigned char ucResident;
+        size_t x;
+
+        if( lPageSize <= 0 )
+        {
+            return ( errno != 0 ) ? errno : EINVAL;
+        }
+
+        if( ulStackSize == 0 )
+        {
+            return 0;
+        }
+
+        /* Write each byte back to itself so the page is faulted in for
+         * writing without disturbing any stack fill pattern. */
+        for( x = 0; x < ulStackSize; x += ( size_t ) lPageSize )
+        {
+            pucByte[ x ] = pucByte[ x ];
+        }
+
+        pucByte[ ulStackSize - 1 ] = pucByte[ ulStackSize - 1 ];
+
+        /* The stack need not start on a page boundary. */
+        uxPage = ( uintptr_t ) pxEndOfStack & ~( ( uintptr_t ) lPageSize - 1U );
+        uxEnd = ( uintptr_t ) pxEndOfStack + ulStackSize;
+
+        for( ; uxPage < uxEnd; uxPage += ( uintptr_t ) lPageSize )
+        {
+            if( mincore( ( void * ) uxPage, ( size_t ) lPageSize, ( void * ) &ucResident ) != 0 )
+            {
+                return errno;
+            }
+
+            if( ( ucResident & 1U ) == 0U )
+            {
+                return EAGAIN;
+            }
+        }
+
+        return 0;
     }
-}
+
+#endif /* configPOSIX_PREFAULT_STACKS */
 /*-----------------------------------------------------------*/
 
-unsigned long ulPortGetRunTime( void )
+static inline uint64_t prvGetRunTimeCounter( void )
 {
-    struct tms xTimes;
+    #if ( configRUN_TIME_COUNTER_USE_CPU_CYCLES == 1 ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+        return __builtin_ia32_rdtsc();
+    #elif ( configRUN_TIME_COUNTER_USE_CPU_CYCLES == 1 ) && defined( __aarch64__ )
+        uint64_t ulGenericTimerCount;
+
+        /* Not a cycle counter - PMCCNTR_EL0 is not readable from user space
+         * by default - but the generic timer, which is. */
+        __asm volatile ( "mrs %0, cntvct_el0" : "=r" ( ulGenericTimerCount ) );
+
+        return ulGenericTimerCount;
+    #else
+        return prvGetTimeNs();
+    #endif
+}
+/*-----------------------------------------------------------*/
 
-    times( &xTimes );
+void vPortConfigureTimerForRunTimeStats( void )
+{
+    prvRunTimeBase = prvGetRunTimeCounter();
+}
+/*-----------------------------------------------------------*/
 
-    return ( unsigned long ) xTimes.tms_utime;
+uint64_t ulPortGetRunTime( void )
+{
+    /* Read at every context switch, so the resolution of the counter is the
+     * resolution of each task's ulRunTimeCounter. */
+    return prvGetRunTimeCounter() - prvRunTimeBase;
 }
 /*-----------------------------------------------------------*/
@@ -37,6 +37,7 @@
 /* *INDENT-ON* */
 
 #include <limits.h>
+#include <stdint.h>
 #include <curses.h>
 
 #define NOP __asm("NOP")
@@ -82,10 +83,11 @@ typedef unsigned long TickType_t;
 
 /* Scheduler utilities. */
 extern void vPortYield( void );
+extern void vPortYieldFromISR( void );
 
 #define portYIELD() vPortYield()
 
-#define portEND_SWITCHING_ISR( xSwitchRequired ) if( xSwitchRequired != pdFALSE ) vPortYield()
+#define portEND_SWITCHING_ISR( xSwitchRequired ) if( xSwitchRequired != pdFALSE ) vPortYieldFromISR()
 #define portYIELD_FROM_ISR( x ) portEND_SWITCHING_ISR( x )
 /*-----------------------------------------------------------*/
 
@@ -107,6 +109,54 @@ extern void vPortExitCritical( void );
 #define portENTER_CRITICAL()                    vPortEnterCritical()
 #define portEXIT_CRITICAL()                     vPortExitCritical()
 
+extern void vPortValidateInterruptPriority( void );
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID()    vPortValidateInterruptPriority()
+
+/*-----------------------------------------------------------*/
+
+/* Simulated interrupts. */
+#define portMAX_INTERRUPTS              ( 32UL )
+#define portMAX_INTERRUPT_PRIORITY      ( 16UL )
+
+/*
+ * Raise the simulated interrupt ulInterruptNumber.  The interrupt is held
+ * pending until its priority is above both the priority of the code that is
+ * executing and the mask set by portSET_INTERRUPT_MASK_FROM_ISR(), then its
+ * handler runs on the thread of the task that is running.  Critical sections
+ * entered with portENTER_CRITICAL() mask all simulated interrupts.
+ *
+ * Can be called from tasks, from simulated interrupts and from host threads,
+ * which, as for the tick, must be created with all signals blocked.
+ */
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Install an interrupt handler for ulInterruptNumber, which must be lower
+ * than portMAX_INTERRUPTS.  Interrupt handler functions must return a
+ * non-zero value if executing the handler resulted in a task switch being
+ * required; the switch is performed when the outermost simulated interrupt
+ * returns.
+ */
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
+
+/*
+ * Set the priority of ulInterruptNumber, from 1 (the tick priority,
+ * configKERNEL_INTERRUPT_PRIORITY) to portMAX_INTERRUPT_PRIORITY.  An
+ * interrupt can nest inside any interrupt of lower priority.  Interrupts that
+ * call FreeRTOS API functions must not be above
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.  Defaults to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ */
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, UBaseType_t uxPriority );
+
+/*
+ * Raise the simulated interrupt ulInterruptNumber of kernel instance
+ * uxKernelInstance from a host thread, which belongs to no instance.  Used by
+ * xStreamBufferSendFromHost() to ring its doorbell.
+ */
+void vPortGenerateSimulatedInterruptFromHost( UBaseType_t uxKernelInstance, uint32_t ulInterruptNumber );
+#define portHOST_RAISE_INTERRUPT( uxKernelInstance, uxInterruptNumber )    vPortGenerateSimulatedInterruptFromHost( ( uxKernelInstance ), ( uint32_t ) ( uxInterruptNumber ) )
+
 /*-----------------------------------------------------------*/
 
 extern void vPortThreadDying( void *pxTaskToDelete, volatile BaseType_t *pxPendYield );
@@ -129,10 +179,36 @@ extern void vPortCancelThread( void *pxTaskToDelete );
  */
 #define portMEMORY_BARRIER() __asm volatile( "" ::: "memory" )
 
-extern unsigned long ulPortGetRunTime( void );
-#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() /* no-op */
+/*
+ * The run time counter counts nanoseconds since the scheduler was started, or,
+ * if configRUN_TIME_COUNTER_USE_CPU_CYCLES is 1, CPU cycles on x86 and generic
+ * timer ticks on AArch64.  configRUN_TIME_COUNTER_TYPE must be 64 bits wide.
+ */
+extern void vPortConfigureTimerForRunTimeStats( void );
+extern uint64_t ulPortGetRunTime( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vPortConfigureTimerForRunTimeStats()
 #define portGET_RUN_TIME_COUNTER_VALUE()         ulPortGetRunTime()
 
+/*
+ * The kernel instance a thread belongs to, see configNUMBER_OF_KERNEL_INSTANCES.
+ * Set with vTaskSetKernelInstance() by the host thread that creates an
+ * instance's tasks and starts its scheduler, and inherited by the threads of
+ * the tasks it creates.
+ */
+extern __thread UBaseType_t uxPortKernelInstance;
+#define portGET_KERNEL_INSTANCE()                ( uxPortKernelInstance )
+#define portSET_KERNEL_INSTANCE( uxInstance )    ( uxPortKernelInstance = ( uxInstance ) )
+
+/*
+ * Held by heap_5 while it uses the heap, which is shared by all the kernel
+ * instances.  Only defined when configNUMBER_OF_KERNEL_INSTANCES is greater
+ * than 1.
+ */
+extern void vPortHeapLock( void );
+extern void vPortHeapUnlock( void );
+#define portHEAP_LOCK()      vPortHeapLock()
+#define portHEAP_UNLOCK()    vPortHeapUnlock()
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
@@ -78,6 +78,26 @@ typedef struct SemaphoreData
     UBaseType_t uxRecursiveCallCount; /**< Maintains a count of the number of times a recursive mutex has been recursively 'taken' when the structure is used as a mutex. */
 } SemaphoreData_t;
 
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+/* A priority queue keeps its items in fixed slots in the queue storage area,
+ * and orders them with a binary heap of PriorityQueueEntry_t structures that
+ * is held in front of the slots.  Only the small heap entries move as items are
+ * sent and received, never the items themselves. */
+    typedef struct PriorityQueueEntry
+    {
+        UBaseType_t uxKey;      /**< The key the item was sent with.  Items with lower keys are received first. */
+        UBaseType_t uxSequence; /**< Orders items that have the same key so they are received in the order they were sent. */
+        UBaseType_t uxSlot;     /**< The index of the slot that holds the item. */
+    } PriorityQueueEntry_t;
+
+    typedef struct PriorityQueueData
+    {
+        PriorityQueueEntry_t * pxHeap; /**< The heap of queued items.  Entries past the end of the heap hold the indexes of the free slots. */
+        UBaseType_t uxNextSequence;    /**< The sequence number given to the next item sent. */
+    } PriorityQueueData_t;
+#endif /* configUSE_PRIORITY_QUEUES */
+
 /* Semaphores do not actually store or copy data, so have an item size of
  * zero. */
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH    ( ( UBaseType_t ) 0 )
@@ -106,6 +126,9 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
     {
         QueuePointers_t xQueue;     /**< Data required exclusively when this structure is used as a queue. */
         SemaphoreData_t xSemaphore; /**< Data required exclusively when this structure is used as a semaphore. */
+        #if ( configUSE_PRIORITY_QUEUES == 1 )
+            PriorityQueueData_t xPriorityQueue; /**< Data required exclusively when this structure is used as a priority queue. */
+        #endif
     } u;
 
     List_t xTasksWaitingToSend;             /**< List of tasks that are blocked waiting to post onto this queue.  Stored in priority order. */
@@ -130,6 +153,27 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
     #endif
+
+    #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+        int8_t * pcReservedSlot; /**< The slot handed out by pvQueueReserve() and not yet committed, or NULL. */
+        int8_t * pcAcquiredSlot; /**< The item handed out by pvQueueAcquire() and not yet released, or NULL. */
+        uint8_t ucFrontSenderWaiting; /**< Set to pdTRUE when a task blocks in xQueueSendToFront() or xQueueOverwrite() because of pcReservedSlot or pcAcquiredSlot. */
+    #endif
+
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+        uint8_t ucIsPriorityQueue; /**< Set to pdTRUE if the queue was created by xQueueCreatePriority(), so is ordered by key. */
+    #endif
+
+    #if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+        const char * pcQueueName;                        /**< The name the queue is registered with, or NULL if it is not in the registry. */ /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+        struct QueueDefinition * pxNextRegistered;       /**< The next queue in the same registry bucket. */
+        struct QueueDefinition ** ppxPreviousRegistered; /**< The pointer that points to this queue in its registry bucket, so the queue can be unregistered without a search. */
+    #endif
+
+    #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+        ListItem_t xQueueSetReadyItem; /**< Used by a queue set member to reference the member from its set's ready list. */
+        List_t xQueueSetReadyMembers;  /**< Used by a queue set.  The members that have become non-empty, in the order they did so. */
+    #endif
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -142,7 +186,21 @@ typedef xQUEUE Queue_t;
  * The queue registry is just a means for kernel aware debuggers to locate
  * queue structures.  It has no other purpose so is an optional component.
  */
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+/* The hashed registry is an array of configQUEUE_REGISTRY_SIZE buckets, each
+ * the head of a doubly linked chain of the queues whose names hash to it.  The
+ * links and the name are held in the queue structure itself, so the number of
+ * queues that can be registered is not limited by the size of the array, and a
+ * queue's name is found from its handle without a search. */
+    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+        PRIVILEGED_DATA Queue_t * pxQueueRegistryBuckets[ configQUEUE_REGISTRY_SIZE ];
+    #else
+        PRIVILEGED_DATA Queue_t * pxQueueRegistryBucketArrays[ configNUMBER_OF_KERNEL_INSTANCES ][ configQUEUE_REGISTRY_SIZE ];
+        #define pxQueueRegistryBuckets    ( pxQueueRegistryBucketArrays[ portGET_KERNEL_INSTANCE() ] )
+    #endif
+
+#elif ( configQUEUE_REGISTRY_SIZE > 0 )
 
 /* The type stored within the queue registry array.  This allows a name
  * to be assigned to each queue making kernel aware debugging a little
@@ -161,7 +219,15 @@ typedef xQUEUE Queue_t;
 /* The queue registry is simply an array of QueueRegistryItem_t structures.
  * The pcQueueName member of a structure being NULL is indicative of the
  * array position being vacant. */
-    PRIVILEGED_DATA QueueRegistryItem_t xQueueRegistry[ configQUEUE_REGISTRY_SIZE ];
+    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+        PRIVILEGED_DATA QueueRegistryItem_t xQueueRegistry[ configQUEUE_REGISTRY_SIZE ];
+    #else
+
+/* Each kernel instance has its own registry so queue names registered by one
+ * instance are not visible to another. */
+        PRIVILEGED_DATA QueueRegistryItem_t xQueueRegistries[ configNUMBER_OF_KERNEL_INSTANCES ][ configQUEUE_REGISTRY_SIZE ];
+        #define xQueueRegistry    ( xQueueRegistries[ portGET_KERNEL_INSTANCE() ] )
+    #endif
 
 #endif /* configQUEUE_REGISTRY_SIZE */
 
@@ -189,6 +255,24 @@ static BaseType_t prvIsQueueEmpty( const Queue_t * pxQueue ) PRIVILEGED_FUNCTION
  */
 static BaseType_t prvIsQueueFull( const Queue_t * pxQueue ) PRIVILEGED_FUNCTION;
 
+/*
+ * As prvIsQueueFull(), but for a send to xCopyPosition, see queueCAN_SEND().
+ * Records that a sender is about to block because of a reserved or acquired
+ * slot, so the commit or release wakes it.
+ */
+static BaseType_t prvIsQueueFullFor( Queue_t * const pxQueue,
+                                     const BaseType_t xCopyPosition ) PRIVILEGED_FUNCTION;
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+/*
+ * Wakes the senders that blocked in xQueueSendToFront() or xQueueOverwrite()
+ * because of a reserved or acquired slot, once neither is outstanding.  Must
+ * be called from a critical section.
+ */
+    static void prvWakeFrontSenders( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Copies an item into the queue, either at the front of the queue or the
  * back of the queue.
@@ -203,13 +287,106 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies uxItems items to the back of the queue, or out of the front of the
+ * queue, using at most two calls to memcpy() - one up to the end of the queue
+ * storage area and one from its start if the items wrap.  The caller must have
+ * checked there is space for, or there are, uxItems items.
+ */
+static void prvCopyMultipleDataToQueue( Queue_t * const pxQueue,
+                                        const int8_t * pcItemsToQueue,
+                                        const UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+static void prvCopyMultipleDataFromQueue( Queue_t * const pxQueue,
+                                          int8_t * pcBuffer,
+                                          const UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes up to uxMaxTasks tasks from pxEventList.  Called once per batch by
+ * the xQueueSendMultiple() and xQueueReceiveMultiple() families so waiting tasks
+ * are woken once per batch rather than once per item.
+ *
+ * @return pdTRUE if any of the tasks removed has a priority above the calling
+ * task, otherwise pdFALSE.
+ */
+static BaseType_t prvUnblockMultipleTasks( List_t * const pxEventList,
+                                           UBaseType_t uxMaxTasks ) PRIVILEGED_FUNCTION;
+
+/*
+ * Tells receivers that uxItems items have been added to a queue, either by
+ * unblocking tasks waiting to receive from the queue or, if the queue is in a
+ * queue set, by posting the queue to the set once per item.
+ *
+ * @return pdTRUE if a task with a priority above the calling task was
+ * unblocked, otherwise pdFALSE.
+ */
+static BaseType_t prvNotifyMultipleReceivers( Queue_t * const pxQueue,
+                                              UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+/*
+ * Returns the registry bucket a queue with the name pcQueueName is held in.
+ */
+    static Queue_t ** prvGetRegistryBucket( const char * pcQueueName ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+
+/*
+ * Unlinks a registered queue from its registry bucket.  Must be called from a
+ * critical section.
+ */
+    static void prvRemoveFromRegistry( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+/*
+ * Add an item to, or remove the item with the lowest key from, a queue created
+ * by xQueueCreatePriority().  The caller must have checked there is space for,
+ * or there is, an item.  Both take O(log n) time.
+ */
+    static void prvInsertIntoPriorityQueue( Queue_t * const pxQueue,
+                                            const void * pvItemToQueue,
+                                            const UBaseType_t uxKey ) PRIVILEGED_FUNCTION;
+    static void prvRemoveFromPriorityQueue( Queue_t * const pxQueue,
+                                            void * const pvBuffer,
+                                            UBaseType_t * const puxKey ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+
+/*
+ * If the queue is empty and the highest priority task waiting to receive from
+ * it is blocked in xQueueReceive(), copy the item straight into that task's
+ * buffer and unblock it with its receive already complete, so the item is not
+ * copied into and back out of the queue storage area.  Called from a critical
+ * section.
+ *
+ * @return pdTRUE if the item was handed off, otherwise pdFALSE, in which case
+ * it must be posted to the queue as normal.
+ */
+    static BaseType_t prvHandoffToWaitingReceiver( Queue_t * const pxQueue,
+                                                   const void * pvItemToQueue ) PRIVILEGED_FUNCTION;
+#endif
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
  * Checks to see if a queue is a member of a queue set, and if so, notifies
  * the queue set that the queue contains data.
  */
-    static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvNotifyQueueSetContainer( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+#if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+
+/*
+ * Returns the member at the head of a queue set's ready list, and moves it to
+ * the back so ready members are selected in turn.  Members are not taken off
+ * the ready list when they are emptied, so any empty members found at the head
+ * are taken off first.  Called from a critical section.
+ *
+ * @return The handle of a member that is not empty, or NULL if there is none.
+ */
+    static QueueSetMemberHandle_t prvSelectReadyMember( Queue_t * const pxQueueSet ) PRIVILEGED_FUNCTION;
 #endif
 
 /*
@@ -242,6 +419,21 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
  */
     static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+/*
+ * The holder of pxMutex has just inherited, or disinherited after a timeout,
+ * the priority of a task waiting for pxMutex.  If the holder is itself blocked
+ * on a mutex then pass the change on to that mutex's holder, and so on along
+ * the chain, following at most configMAX_PRIORITY_INHERITANCE_DEPTH holders in
+ * total.  Must be called from a critical section.
+ * prvInheritAlongMutexChain() returns pdTRUE if any holder inherited the
+ * calling task's priority.
+ */
+    static BaseType_t prvInheritAlongMutexChain( const Queue_t * const pxMutex ) PRIVILEGED_FUNCTION;
+    static void prvDisinheritAlongMutexChain( const Queue_t * const pxMutex ) PRIVILEGED_FUNCTION;
+#endif
 /*-----------------------------------------------------------*/
 
 /*
@@ -291,6 +483,96 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             ( pxQueue )->cRxLock = ( int8_t ) ( ( cRxLock ) + ( int8_t ) 1 ); \
         }                                                                     \
     } while( 0 )
+
+/*
+ * Macro to copy one item into or out of the queue storage area.  Most queues
+ * hold word or pointer sized items, so unless configQUEUE_FIXED_SIZE_COPY is
+ * set to 0 those sizes are copied by a memcpy() of constant length, which the
+ * compiler reduces to a single load and store, rather than by a call to
+ * memcpy() with a variable length.  The item size is fixed when the queue is
+ * created, so each queue always takes the same path.
+ */
+#if ( configQUEUE_FIXED_SIZE_COPY == 1 )
+    #define prvCopyItem( pvDestination, pvSource, uxItemSize )                                     \
+    do {                                                                                           \
+        switch( uxItemSize )                                                                       \
+        {                                                                                          \
+            case 4U:                                                                               \
+                ( void ) memcpy( ( pvDestination ), ( pvSource ), ( size_t ) 4U );                 \
+                break;                                                                             \
+                                                                                                   \
+            case 8U:                                                                               \
+                ( void ) memcpy( ( pvDestination ), ( pvSource ), ( size_t ) 8U );                 \
+                break;                                                                             \
+                                                                                                   \
+            default:                                                                               \
+                ( void ) memcpy( ( pvDestination ), ( pvSource ), ( size_t ) ( uxItemSize ) );     \
+                break;                                                                             \
+        }                                                                                          \
+    } while( 0 )
+#else
+    #define prvCopyItem( pvDestination, pvSource, uxItemSize ) \
+    ( void ) memcpy( ( pvDestination ), ( pvSource ), ( size_t ) ( uxItemSize ) )
+#endif
+
+/*
+ * Macros that return the number of items that can be posted to, and received
+ * from, the queue.  While a slot is reserved by pvQueueReserve() the queue is
+ * full to every other sender, and while an item is acquired by
+ * pvQueueAcquire() the queue is empty to every other receiver, so the items
+ * stay in FIFO order and the slots handed out cannot be reused.
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    #define queueSPACES_AVAILABLE( pxQueue ) \
+    ( ( ( pxQueue )->pcReservedSlot == NULL ) ? ( ( pxQueue )->uxLength - ( pxQueue )->uxMessagesWaiting ) : ( UBaseType_t ) 0 )
+    #define queueITEMS_AVAILABLE( pxQueue ) \
+    ( ( ( pxQueue )->pcAcquiredSlot == NULL ) ? ( pxQueue )->uxMessagesWaiting : ( UBaseType_t ) 0 )
+#else
+    #define queueSPACES_AVAILABLE( pxQueue )    ( ( pxQueue )->uxLength - ( pxQueue )->uxMessagesWaiting )
+    #define queueITEMS_AVAILABLE( pxQueue )     ( ( pxQueue )->uxMessagesWaiting )
+#endif
+
+/*
+ * xQueueSendToFront() and xQueueOverwrite() write to the slot in front of the
+ * queue, which can be the slot reserved by pvQueueReserve() or the item
+ * acquired by pvQueueAcquire().  While either is outstanding the queue is
+ * therefore full to them, however much space it has, and a task that blocks
+ * for that reason is woken by vQueueCommit() or vQueueRelease().
+ */
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+    #define queueFRONT_SLOT_IN_USE( pxQueue ) \
+    ( ( ( pxQueue )->pcReservedSlot != NULL ) || ( ( pxQueue )->pcAcquiredSlot != NULL ) )
+#else
+    #define queueFRONT_SLOT_IN_USE( pxQueue )    ( 0 )
+#endif
+
+#define queueCAN_SEND( pxQueue, xPosition )                                            \
+    ( ( ( ( xPosition ) == queueSEND_TO_BACK ) || !queueFRONT_SLOT_IN_USE( pxQueue ) ) && \
+      ( ( queueSPACES_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 ) || ( ( xPosition ) == queueOVERWRITE ) ) )
+
+/* Priority queues can only be used with the ...WithKey() functions. */
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+    #define queueIS_PRIORITY_QUEUE( pxQueue )    ( ( BaseType_t ) ( pxQueue )->ucIsPriorityQueue )
+
+/* The heap is at the start of the storage area passed to
+ * xQueueGenericCreateStatic(), in front of the item slots. */
+    #define prvGetQueueStorage( pxQueue )                                    \
+    ( ( ( pxQueue )->ucIsPriorityQueue != ( uint8_t ) pdFALSE ) ?            \
+      ( uint8_t * ) ( pxQueue )->u.xPriorityQueue.pxHeap : /*lint !e9087 */ \
+      ( uint8_t * ) ( pxQueue )->pcHead )
+
+/* Items with equal keys are ordered by sequence number.  The subtraction
+ * keeps the order correct when the sequence number wraps. */
+    #define prvPriorityQueueEntryPrecedes( pxA, pxB )                                                    \
+    ( ( ( ( pxA )->uxKey < ( pxB )->uxKey ) ||                                                       \
+        ( ( ( pxA )->uxKey == ( pxB )->uxKey ) &&                                                    \
+          ( ( BaseType_t ) ( ( pxA )->uxSequence - ( pxB )->uxSequence ) < ( BaseType_t ) 0 ) ) ) ? \
+      pdTRUE : pdFALSE )
+#else
+    #define queueIS_PRIORITY_QUEUE( pxQueue )    ( pdFALSE )
+    #define prvGetQueueStorage( pxQueue )        ( ( uint8_t * ) ( pxQueue )->pcHead )
+#endif
+
 /*-----------------------------------------------------------*/
 
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
@@ -308,13 +590,43 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
     {
         taskENTER_CRITICAL();
         {
-            pxQueue->u.xQueue.pcTail = pxQueue->pcHead + ( pxQueue->uxLength * pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+            #if ( configUSE_PRIORITY_QUEUES == 1 )
+                if( pxQueue->ucIsPriorityQueue != pdFALSE )
+                {
+                    /* The heap entries always hold every slot index once, so
+                     * only need setting when the queue is created. */
+                    if( xNewQueue != pdFALSE )
+                    {
+                        UBaseType_t uxSlot;
+
+                        for( uxSlot = 0; uxSlot < pxQueue->uxLength; uxSlot++ )
+                        {
+                            pxQueue->u.xPriorityQueue.pxHeap[ uxSlot ].uxSlot = uxSlot;
+                        }
+                    }
+
+                    pxQueue->u.xPriorityQueue.uxNextSequence = ( UBaseType_t ) 0U;
+                }
+                else
+            #endif /* configUSE_PRIORITY_QUEUES */
+            {
+                pxQueue->u.xQueue.pcTail = pxQueue->pcHead + ( pxQueue->uxLength * pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+                pxQueue->pcWriteTo = pxQueue->pcHead;
+                pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( ( pxQueue->uxLength - 1U ) * pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+            }
+
             pxQueue->uxMessagesWaiting = ( UBaseType_t ) 0U;
-            pxQueue->pcWriteTo = pxQueue->pcHead;
-            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( ( pxQueue->uxLength - 1U ) * pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
             pxQueue->cRxLock = queueUNLOCKED;
             pxQueue->cTxLock = queueUNLOCKED;
 
+            #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+            {
+                pxQueue->pcReservedSlot = NULL;
+                pxQueue->pcAcquiredSlot = NULL;
+                pxQueue->ucFrontSenderWaiting = ( uint8_t ) pdFALSE;
+            }
+            #endif
+
             if( xNewQueue == pdFALSE )
             {
                 /* If there are tasks blocked waiting to read from the queue, then
@@ -343,7 +655,26 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
                 /* Ensure the event queues start in the correct state. */
                 vListInitialise( &( pxQueue->xTasksWaitingToSend ) );
                 vListInitialise( &( pxQueue->xTasksWaitingToReceive ) );
+
+                #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+                {
+                    vListInitialiseItem( &( pxQueue->xQueueSetReadyItem ) );
+                    listSET_LIST_ITEM_OWNER( &( pxQueue->xQueueSetReadyItem ), pxQueue );
+                    vListInitialise( &( pxQueue->xQueueSetReadyMembers ) );
+                }
+                #endif
             }
+
+            #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+            {
+                /* A reset queue set has no ready members.  The count of ready
+                 * members was zeroed above. */
+                while( listLIST_IS_EMPTY( &( pxQueue->xQueueSetReadyMembers ) ) == pdFALSE )
+                {
+                    ( void ) uxListRemove( listGET_HEAD_ENTRY( &( pxQueue->xQueueSetReadyMembers ) ) );
+                }
+            }
+            #endif
         }
         taskEXIT_CRITICAL();
     }
@@ -442,7 +773,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             {
                 if( ppucQueueStorage != NULL )
                 {
-                    *ppucQueueStorage = ( uint8_t * ) pxQueue->pcHead;
+                    *ppucQueueStorage = prvGetQueueStorage( pxQueue );
                 }
 
                 *ppxStaticQueue = ( StaticQueue_t * ) pxQueue;
@@ -458,7 +789,7 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
             /* Queue must have been statically allocated. */
             if( ppucQueueStorage != NULL )
             {
-                *ppucQueueStorage = ( uint8_t * ) pxQueue->pcHead;
+                *ppucQueueStorage = prvGetQueueStorage( pxQueue );
             }
 
             *ppxStaticQueue = ( StaticQueue_t * ) pxQueue;
@@ -481,17 +812,28 @@ BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
         Queue_t * pxNewQueue = NULL;
         size_t xQueueSizeInBytes;
         uint8_t * pucQueueStorage;
+        size_t xSlotSize = ( size_t ) uxItemSize;
+
+        #if ( configUSE_PRIORITY_QUEUES == 1 )
+        {
+            /* A priority queue also needs a heap entry per item. */
+            if( ucQueueType == queueQUEUE_TYPE_PRIORITY )
+            {
+                xSlotSize += sizeof( PriorityQueueEntry_t );
+            }
+        }
+        #endif
 
         if( ( uxQueueLength > ( UBaseType_t ) 0 ) &&
             /* Check for multiplication overflow. */
-            ( ( SIZE_MAX / uxQueueLength ) >= uxItemSize ) &&
+            ( ( SIZE_MAX / uxQueueLength ) >= xSlotSize ) &&
             /* Check for addition overflow. */
-            ( ( SIZE_MAX - sizeof( Queue_t ) ) >= ( uxQueueLength * uxItemSize ) ) )
+            ( ( SIZE_MAX - sizeof( Queue_t ) ) >= ( uxQueueLength * xSlotSize ) ) )
         {
             /* Allocate enough space to hold the maximum number of items that
              * can be in the queue at any time.  It is valid for uxItemSize to be
              * zero in the case the queue is used as a semaphore. */
-            xQueueSizeInBytes = ( size_t ) ( uxQueueLength * uxItemSize ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            xQueueSizeInBytes = ( size_t ) ( uxQueueLength * xSlotSize ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
             /* Allocate the queue and storage area.  Justification for MISRA
              * deviation as follows:  pvPortMalloc() always ensures returned memory
@@ -564,6 +906,24 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
         pxNewQueue->pcHead = ( int8_t * ) pucQueueStorage;
     }
 
+    #if ( configUSE_PRIORITY_QUEUES == 1 )
+    {
+        if( ucQueueType == queueQUEUE_TYPE_PRIORITY )
+        {
+            /* The heap goes at the start of the storage area, where it is
+             * aligned, and the item slots after it. */
+            configASSERT( uxItemSize != ( UBaseType_t ) 0 );
+            pxNewQueue->u.xPriorityQueue.pxHeap = ( PriorityQueueEntry_t * ) pucQueueStorage; /*lint !e9087 !e826 The storage area is sized and aligned for the heap entries. */
+            pxNewQueue->pcHead += ( size_t ) uxQueueLength * sizeof( PriorityQueueEntry_t ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+            pxNewQueue->ucIsPriorityQueue = pdTRUE;
+        }
+        else
+        {
+            pxNewQueue->ucIsPriorityQueue = pdFALSE;
+        }
+    }
+    #endif /* configUSE_PRIORITY_QUEUES */
+
     /* Initialise the queue members as described where the queue type is
      * defined. */
     pxNewQueue->uxLength = uxQueueLength;
@@ -582,6 +942,12 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
     }
     #endif /* configUSE_QUEUE_SETS */
 
+    #if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+    {
+        pxNewQueue->pcQueueName = NULL;
+    }
+    #endif
+
     traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -893,6 +1259,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
     configASSERT( pxQueue );
     configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
     configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
     {
         configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
@@ -910,10 +1277,24 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
              * highest priority task wanting to access the queue.  If the head item
              * in the queue is to be overwritten then it does not matter if the
              * queue is full. */
-            if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+            if( queueCAN_SEND( pxQueue, xCopyPosition ) )
             {
                 traceQUEUE_SEND( pxQueue );
 
+                #if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+                {
+                    if( prvHandoffToWaitingReceiver( pxQueue, pvItemToQueue ) != pdFALSE )
+                    {
+                        taskEXIT_CRITICAL();
+                        return pdPASS;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+
                 #if ( configUSE_QUEUE_SETS == 1 )
                 {
                     const UBaseType_t uxPreviousMessagesWaiting = pxQueue->uxMessagesWaiting;
@@ -1051,7 +1432,7 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
         /* Update the timeout state to see if it has expired yet. */
         if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
         {
-            if( prvIsQueueFull( pxQueue ) != pdFALSE )
+            if( prvIsQueueFullFor( pxQueue, xCopyPosition ) != pdFALSE )
             {
                 traceBLOCKING_ON_QUEUE_SEND( pxQueue );
                 vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
@@ -1093,6 +1474,141 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                                const void * const pvItemsToQueue,
+                                const UBaseType_t uxItemsToQueue,
+                                TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+    const int8_t * pcNextItem = ( const int8_t * ) pvItemsToQueue;
+    UBaseType_t uxItemsSent = 0, uxItems;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemsToQueue );
+
+    /* Semaphores and mutexes do not hold data so cannot be used here. */
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    /*lint -save -e904 This function relaxes the coding standard somewhat to
+     * allow return statements within the function itself.  This is done in the
+     * interest of execution time efficiency. */
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* Post as many of the remaining items as there is room for. */
+            uxItems = queueSPACES_AVAILABLE( pxQueue );
+
+            if( uxItems > ( uxItemsToQueue - uxItemsSent ) )
+            {
+                uxItems = uxItemsToQueue - uxItemsSent;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( uxItems > ( UBaseType_t ) 0 )
+            {
+                traceQUEUE_SEND( pxQueue );
+
+                prvCopyMultipleDataToQueue( pxQueue, pcNextItem, uxItems );
+                pcNextItem += ( size_t ) uxItems * ( size_t ) pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+                uxItemsSent += uxItems;
+
+                /* Unblock at most one receiving task per item posted, all in
+                 * this one critical section. */
+                if( prvNotifyMultipleReceivers( pxQueue, uxItems ) != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( uxItemsSent == uxItemsToQueue )
+            {
+                taskEXIT_CRITICAL();
+                return uxItemsSent;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue is full and no block time is specified (or the
+                 * block time has expired) so return the number of items
+                 * posted so far. */
+                taskEXIT_CRITICAL();
+                traceQUEUE_SEND_FAILED( pxQueue );
+                return uxItemsSent;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                /* The queue is full and a block time was specified so
+                 * configure the timeout structure. */
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                /* Entry time was already set. */
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Interrupts and other tasks can send to and receive from the queue
+         * now the critical section has been exited. */
+
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        /* Update the timeout state to see if it has expired yet. */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            if( prvIsQueueFull( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+            }
+            else
+            {
+                /* Try again. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* The timeout has expired. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+
+            traceQUEUE_SEND_FAILED( pxQueue );
+            return uxItemsSent;
+        }
+    } /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
                                      const void * const pvItemToQueue,
                                      BaseType_t * const pxHigherPriorityTaskWoken,
@@ -1105,6 +1621,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
     configASSERT( pxQueue );
     configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
     configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
     /* RTOS ports that support interrupt nesting have the concept of a maximum
      * system call (or maximum API call) interrupt priority.  Interrupts that are
@@ -1129,7 +1646,7 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
      * post). */
     uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
     {
-        if( ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) || ( xCopyPosition == queueOVERWRITE ) )
+        if( queueCAN_SEND( pxQueue, xCopyPosition ) )
         {
             const int8_t cTxLock = pxQueue->cTxLock;
             const UBaseType_t uxPreviousMessagesWaiting = pxQueue->uxMessagesWaiting;
@@ -1258,31 +1775,113 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
-                              BaseType_t * const pxHigherPriorityTaskWoken )
+UBaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                       const void * const pvItemsToQueue,
+                                       const UBaseType_t uxItemsToQueue,
+                                       BaseType_t * const pxHigherPriorityTaskWoken )
 {
-    BaseType_t xReturn;
+    UBaseType_t uxItems;
     UBaseType_t uxSavedInterruptStatus;
     Queue_t * const pxQueue = xQueue;
 
-    /* Similar to xQueueGenericSendFromISR() but used with semaphores where the
-     * item size is 0.  Don't directly wake a task that was blocked on a queue
-     * read, instead return a flag to say whether a context switch is required or
-     * not (i.e. has a task with a higher priority than us been woken by this
-     * post). */
-
     configASSERT( pxQueue );
+    configASSERT( pvItemsToQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
-    /* xQueueGenericSendFromISR() should be used instead of xQueueGiveFromISR()
-     * if the item size is not 0. */
-    configASSERT( pxQueue->uxItemSize == 0 );
+    /* See the comments in xQueueGenericSendFromISR(). */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
-    /* Normally a mutex would not be given from an interrupt, especially if
-     * there is a mutex holder, as priority inheritance makes no sense for an
-     * interrupts, only tasks. */
-    configASSERT( !( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( pxQueue->u.xSemaphore.xMutexHolder != NULL ) ) );
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        uxItems = queueSPACES_AVAILABLE( pxQueue );
 
-    /* RTOS ports that support interrupt nesting have the concept of a maximum
+        if( uxItems > uxItemsToQueue )
+        {
+            uxItems = uxItemsToQueue;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( uxItems > ( UBaseType_t ) 0 )
+        {
+            UBaseType_t x;
+
+            traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+            prvCopyMultipleDataToQueue( pxQueue, ( const int8_t * ) pvItemsToQueue, uxItems );
+
+            /* The event list is not altered if the queue is locked.  This will
+             * be done when the queue is unlocked later. */
+            if( pxQueue->cTxLock == queueUNLOCKED )
+            {
+                if( prvNotifyMultipleReceivers( pxQueue, uxItems ) != pdFALSE )
+                {
+                    if( pxHigherPriorityTaskWoken != NULL )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* Increment the lock count once per item so the task that
+                 * unlocks the queue knows how much data was posted while it was
+                 * locked. */
+                for( x = 0; x < uxItems; x++ )
+                {
+                    const int8_t cTxLock = pxQueue->cTxLock;
+
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                }
+            }
+        }
+        else
+        {
+            traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return uxItems;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
+                              BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    /* Similar to xQueueGenericSendFromISR() but used with semaphores where the
+     * item size is 0.  Don't directly wake a task that was blocked on a queue
+     * read, instead return a flag to say whether a context switch is required or
+     * not (i.e. has a task with a higher priority than us been woken by this
+     * post). */
+
+    configASSERT( pxQueue );
+
+    /* xQueueGenericSendFromISR() should be used instead of xQueueGiveFromISR()
+     * if the item size is not 0. */
+    configASSERT( pxQueue->uxItemSize == 0 );
+
+    /* Normally a mutex would not be given from an interrupt, especially if
+     * there is a mutex holder, as priority inheritance makes no sense for an
+     * interrupts, only tasks. */
+    configASSERT( !( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( pxQueue->u.xSemaphore.xMutexHolder != NULL ) ) );
+
+    /* RTOS ports that support interrupt nesting have the concept of a maximum
      * system call (or maximum API call) interrupt priority.  Interrupts that are
      * above the maximum system call priority are kept permanently enabled, even
      * when the RTOS kernel is in a critical section, but cannot make any calls to
@@ -1438,6 +2037,7 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
     /* The buffer into which data is received can only be NULL if the data size
      * is zero (so no data is copied into the buffer). */
     configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
     /* Cannot block if the scheduler is suspended. */
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -1455,9 +2055,26 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
         {
             const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
+            #if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+            {
+                /* If this task has blocked, a sender may have copied an item
+                 * straight into pvBuffer before unblocking it. */
+                if( ( xEntryTimeSet != pdFALSE ) && ( xTaskClearHandoffBuffer() != pdFALSE ) )
+                {
+                    traceQUEUE_RECEIVE( pxQueue );
+                    taskEXIT_CRITICAL();
+                    return pdPASS;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+
             /* Is there data in the queue now?  To be running the calling task
              * must be the highest priority task wanting to access the queue. */
-            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+            if( queueITEMS_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
             {
                 /* Data available, remove one item. */
                 prvCopyDataFromQueue( pxQueue, pvBuffer );
@@ -1526,6 +2143,13 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
             if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
             {
                 traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+
+                #if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+                {
+                    vTaskSetHandoffBuffer( pvBuffer );
+                }
+                #endif
+
                 vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
                 prvUnlockQueue( pxQueue );
 
@@ -1567,6 +2191,143 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                   void * const pvBuffer,
+                                   const UBaseType_t uxItemsToReceive,
+                                   TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+    int8_t * pcNextItem = ( int8_t * ) pvBuffer;
+    UBaseType_t uxItemsReceived = 0, uxItems;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+
+    /* Semaphores and mutexes do not hold data so cannot be used here. */
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    /*lint -save -e904  This function relaxes the coding standard somewhat to
+     * allow return statements within the function itself.  This is done in the
+     * interest of execution time efficiency. */
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* Remove as many of the remaining items as the queue holds. */
+            uxItems = queueITEMS_AVAILABLE( pxQueue );
+
+            if( uxItems > ( uxItemsToReceive - uxItemsReceived ) )
+            {
+                uxItems = uxItemsToReceive - uxItemsReceived;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( uxItems > ( UBaseType_t ) 0 )
+            {
+                prvCopyMultipleDataFromQueue( pxQueue, pcNextItem, uxItems );
+                traceQUEUE_RECEIVE( pxQueue );
+                pcNextItem += ( size_t ) uxItems * ( size_t ) pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+                uxItemsReceived += uxItems;
+
+                /* There is now space for uxItems items in the queue, so
+                 * unblock up to that many tasks waiting to post to it. */
+                if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), uxItems ) != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( uxItemsReceived == uxItemsToReceive )
+            {
+                taskEXIT_CRITICAL();
+                return uxItemsReceived;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue is empty and no block time is specified (or the
+                 * block time has expired) so return the number of items
+                 * received so far. */
+                taskEXIT_CRITICAL();
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+                return uxItemsReceived;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                /* The queue is empty and a block time was specified so
+                 * configure the timeout structure. */
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                /* Entry time was already set. */
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Interrupts and other tasks can send to and receive from the queue
+         * now the critical section has been exited. */
+
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        /* Update the timeout state to see if it has expired yet. */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    portYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* The queue contains data again.  Loop back to try and read the
+                 * data. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* Timed out.  xTicksToWait is now zero, so looping back collects
+             * any data that arrived in the meantime then returns. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+        }
+    } /*lint -restore */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                                 TickType_t xTicksToWait )
 {
@@ -1699,6 +2460,13 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                         taskENTER_CRITICAL();
                         {
                             xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
+
+                            #if ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 )
+                            {
+                                vTaskSetMutexBlockedOn( ( void * ) pxQueue );
+                                xInheritanceOccurred |= prvInheritAlongMutexChain( pxQueue );
+                            }
+                            #endif
                         }
                         taskEXIT_CRITICAL();
                     }
@@ -1759,6 +2527,12 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                              * task that is waiting for the same mutex. */
                             uxHighestWaitingPriority = prvGetDisinheritPriorityAfterTimeout( pxQueue );
                             vTaskPriorityDisinheritAfterTimeout( pxQueue->u.xSemaphore.xMutexHolder, uxHighestWaitingPriority );
+
+                            #if ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 )
+                            {
+                                prvDisinheritAlongMutexChain( pxQueue );
+                            }
+                            #endif
                         }
                         taskEXIT_CRITICAL();
                     }
@@ -1792,6 +2566,7 @@ BaseType_t xQueuePeek( QueueHandle_t xQueue,
     /* The buffer into which data is received can only be NULL if the data size
      * is zero (so no data is copied into the buffer. */
     configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
     /* Cannot block if the scheduler is suspended. */
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -1938,6 +2713,7 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 
     configASSERT( pxQueue );
     configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
     /* RTOS ports that support interrupt nesting have the concept of a maximum
      * system call (or maximum API call) interrupt priority.  Interrupts that are
@@ -1960,7 +2736,7 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
         const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
 
         /* Cannot block in an ISR, so check there is data available. */
-        if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+        if( queueITEMS_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
         {
             const int8_t cRxLock = pxQueue->cRxLock;
 
@@ -2021,62 +2797,894 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
-                              void * const pvBuffer )
+UBaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                          void * const pvBuffer,
+                                          const UBaseType_t uxItemsToReceive,
+                                          BaseType_t * const pxHigherPriorityTaskWoken )
 {
-    BaseType_t xReturn;
+    UBaseType_t uxItems;
     UBaseType_t uxSavedInterruptStatus;
-    int8_t * pcOriginalReadPosition;
     Queue_t * const pxQueue = xQueue;
 
     configASSERT( pxQueue );
-    configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
-    configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
+    configASSERT( pvBuffer );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
 
-    /* RTOS ports that support interrupt nesting have the concept of a maximum
-     * system call (or maximum API call) interrupt priority.  Interrupts that are
-     * above the maximum system call priority are kept permanently enabled, even
-     * when the RTOS kernel is in a critical section, but cannot make any calls to
-     * FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
-     * then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
-     * failure if a FreeRTOS API function is called from an interrupt that has been
-     * assigned a priority above the configured maximum system call priority.
-     * Only FreeRTOS functions that end in FromISR can be called from interrupts
-     * that have been assigned a priority at or (logically) below the maximum
-     * system call interrupt priority.  FreeRTOS maintains a separate interrupt
-     * safe API to ensure interrupt entry is as fast and as simple as possible.
-     * More information (albeit Cortex-M specific) is provided on the following
-     * link: https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html */
+    /* See the comments in xQueueReceiveFromISR(). */
     portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
 
     uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
     {
-        /* Cannot block in an ISR, so check there is data available. */
-        if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        uxItems = queueITEMS_AVAILABLE( pxQueue );
+
+        if( uxItems > uxItemsToReceive )
         {
-            traceQUEUE_PEEK_FROM_ISR( pxQueue );
+            uxItems = uxItemsToReceive;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-            /* Remember the read position so it can be reset as nothing is
-             * actually being removed from the queue. */
-            pcOriginalReadPosition = pxQueue->u.xQueue.pcReadFrom;
-            prvCopyDataFromQueue( pxQueue, pvBuffer );
-            pxQueue->u.xQueue.pcReadFrom = pcOriginalReadPosition;
+        if( uxItems > ( UBaseType_t ) 0 )
+        {
+            UBaseType_t x;
 
-            xReturn = pdPASS;
+            traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+            prvCopyMultipleDataFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxItems );
+
+            /* If the queue is locked the event list will not be modified.
+             * Instead update the lock count once per item so the task that
+             * unlocks the queue will know how much data an ISR removed while
+             * the queue was locked. */
+            if( pxQueue->cRxLock == queueUNLOCKED )
+            {
+                if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), uxItems ) != pdFALSE )
+                {
+                    if( pxHigherPriorityTaskWoken != NULL )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                for( x = 0; x < uxItems; x++ )
+                {
+                    const int8_t cRxLock = pxQueue->cRxLock;
+
+                    prvIncrementQueueRxLock( pxQueue, cRxLock );
+                }
+            }
         }
         else
         {
-            xReturn = pdFAIL;
-            traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue );
+            traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
         }
     }
     portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
-    return xReturn;
+    return uxItems;
 }
 /*-----------------------------------------------------------*/
 
-UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    static void prvWakeFrontSenders( Queue_t * const pxQueue )
+    {
+        /* This function is called from a critical section.  A task blocked in
+         * xQueueSendToFront() or xQueueOverwrite() can be queued behind senders
+         * that are still blocked by a full queue, so every waiting sender is
+         * woken once the front slot is free, and each checks again. */
+        if( ( pxQueue->ucFrontSenderWaiting != ( uint8_t ) pdFALSE ) && !queueFRONT_SLOT_IN_USE( pxQueue ) )
+        {
+            pxQueue->ucFrontSenderWaiting = ( uint8_t ) pdFALSE;
+
+            if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToSend ) ) ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvQueueReserve( QueueHandle_t xQueue,
+                           TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueue = xQueue;
+        void * pvReturn;
+
+        configASSERT( pxQueue );
+
+        /* Semaphores and mutexes do not hold data so cannot be used here. */
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /*lint -save -e904 This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( queueSPACES_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
+                {
+                    /* Hand out the slot the next item would be copied to.  The
+                     * write position is not moved until the item is committed. */
+                    pxQueue->pcReservedSlot = pxQueue->pcWriteTo;
+                    pvReturn = ( void * ) pxQueue->pcReservedSlot;
+
+                    taskEXIT_CRITICAL();
+                    return pvReturn;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        taskEXIT_CRITICAL();
+                        traceQUEUE_SEND_FAILED( pxQueue );
+                        return NULL;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                traceQUEUE_SEND_FAILED( pxQueue );
+                return NULL;
+            }
+        } /*lint -restore */
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void vQueueCommit( QueueHandle_t xQueue,
+                       void * const pvReservedItem )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+
+        taskENTER_CRITICAL();
+        {
+            /* Only the slot returned by pvQueueReserve() can be committed. */
+            configASSERT( pxQueue->pcReservedSlot != NULL );
+            configASSERT( pvReservedItem == ( void * ) pxQueue->pcReservedSlot );
+
+            traceQUEUE_SEND( pxQueue );
+
+            pxQueue->pcReservedSlot = NULL;
+            pxQueue->pcWriteTo += pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+
+            if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+            {
+                pxQueue->pcWriteTo = pxQueue->pcHead;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxQueue->uxMessagesWaiting++;
+
+            if( prvNotifyMultipleReceivers( pxQueue, ( UBaseType_t ) 1 ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Other senders found the queue full while the slot was reserved,
+             * so let one try again if there is still space. */
+            if( queueSPACES_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
+            {
+                if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), ( UBaseType_t ) 1 ) != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvWakeFrontSenders( pxQueue );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void * pvQueueAcquire( QueueHandle_t xQueue,
+                           TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueue = xQueue;
+        int8_t * pcItem;
+
+        configASSERT( pxQueue );
+
+        /* Semaphores and mutexes do not hold data so cannot be used here. */
+        configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /*lint -save -e904  This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( queueITEMS_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
+                {
+                    /* Hand out the item at the front of the queue.  The item
+                     * stays in the queue, so its slot cannot be reused, until it
+                     * is released. */
+                    pcItem = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+
+                    if( pcItem >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+                    {
+                        pcItem = pxQueue->pcHead;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    pxQueue->pcAcquiredSlot = pcItem;
+
+                    taskEXIT_CRITICAL();
+                    return ( void * ) pcItem;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        taskEXIT_CRITICAL();
+                        traceQUEUE_RECEIVE_FAILED( pxQueue );
+                        return NULL;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The queue contains data again.  Loop back to try and
+                     * acquire it. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  xTicksToWait is now zero, so looping back
+                 * acquires any data that arrived in the meantime or returns. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        } /*lint -restore */
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_ZERO_COPY == 1 )
+
+    void vQueueRelease( QueueHandle_t xQueue,
+                        void * const pvAcquiredItem )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+
+        taskENTER_CRITICAL();
+        {
+            /* Only the item returned by pvQueueAcquire() can be released. */
+            configASSERT( pxQueue->pcAcquiredSlot != NULL );
+            configASSERT( pvAcquiredItem == ( void * ) pxQueue->pcAcquiredSlot );
+
+            traceQUEUE_RECEIVE( pxQueue );
+
+            /* Remove the item, exactly as prvCopyDataFromQueue() would have. */
+            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcAcquiredSlot;
+            pxQueue->pcAcquiredSlot = NULL;
+            pxQueue->uxMessagesWaiting--;
+
+            if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), ( UBaseType_t ) 1 ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Other receivers found the queue empty while the item was
+             * acquired, so let one try again if items remain. */
+            if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToReceive ), ( UBaseType_t ) 1 ) != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvWakeFrontSenders( pxQueue );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_QUEUE_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    BaseType_t xQueueSendWithKey( QueueHandle_t xQueue,
+                                  const void * const pvItemToQueue,
+                                  const UBaseType_t uxKey,
+                                  TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+        configASSERT( pvItemToQueue );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE );
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /*lint -save -e904 This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( pxQueue->uxMessagesWaiting < pxQueue->uxLength )
+                {
+                    traceQUEUE_SEND( pxQueue );
+
+                    prvInsertIntoPriorityQueue( pxQueue, pvItemToQueue, uxKey );
+
+                    /* Unblock the highest priority task waiting to receive, or
+                     * notify the queue set the queue is a member of. */
+                    if( prvNotifyMultipleReceivers( pxQueue, ( UBaseType_t ) 1 ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    taskEXIT_CRITICAL();
+                    return pdPASS;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was full and no block time is specified (or
+                         * the block time has expired) so leave now. */
+                        taskEXIT_CRITICAL();
+                        traceQUEUE_SEND_FAILED( pxQueue );
+                        return errQUEUE_FULL;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The queue was full and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* Interrupts and other tasks can send to and receive from the queue
+             * now the critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                if( prvIsQueueFull( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                }
+                else
+                {
+                    /* Try again. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* The timeout has expired. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                traceQUEUE_SEND_FAILED( pxQueue );
+                return errQUEUE_FULL;
+            }
+        } /*lint -restore */
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    BaseType_t xQueueSendWithKeyFromISR( QueueHandle_t xQueue,
+                                         const void * const pvItemToQueue,
+                                         const UBaseType_t uxKey,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        BaseType_t xReturn;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+        configASSERT( pvItemToQueue );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE );
+
+        /* See the comments in xQueueGenericSendFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            if( pxQueue->uxMessagesWaiting < pxQueue->uxLength )
+            {
+                const int8_t cTxLock = pxQueue->cTxLock;
+
+                traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+                prvInsertIntoPriorityQueue( pxQueue, pvItemToQueue, uxKey );
+
+                /* The event list is not altered if the queue is locked.  This
+                 * will be done when the queue is unlocked later. */
+                if( cTxLock == queueUNLOCKED )
+                {
+                    if( prvNotifyMultipleReceivers( pxQueue, ( UBaseType_t ) 1 ) != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* Increment the lock count so the task that unlocks the
+                     * queue knows that data was posted while it was locked. */
+                    prvIncrementQueueTxLock( pxQueue, cTxLock );
+                }
+
+                xReturn = pdPASS;
+            }
+            else
+            {
+                traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+                xReturn = errQUEUE_FULL;
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    BaseType_t xQueueReceiveWithKey( QueueHandle_t xQueue,
+                                     void * const pvBuffer,
+                                     UBaseType_t * const puxKey,
+                                     TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE );
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /*lint -save -e904  This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+                {
+                    /* Data available, remove the item with the lowest key. */
+                    prvRemoveFromPriorityQueue( pxQueue, pvBuffer, puxKey );
+                    traceQUEUE_RECEIVE( pxQueue );
+
+                    /* There is now space in the queue, were any tasks waiting
+                     * to post to the queue?  If so, unblock the highest priority
+                     * waiting task. */
+                    if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), ( UBaseType_t ) 1 ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    taskEXIT_CRITICAL();
+                    return pdPASS;
+                }
+                else
+                {
+                    if( xTicksToWait == ( TickType_t ) 0 )
+                    {
+                        /* The queue was empty and no block time is specified
+                         * (or the block time has expired) so leave now. */
+                        taskEXIT_CRITICAL();
+                        traceQUEUE_RECEIVE_FAILED( pxQueue );
+                        return errQUEUE_EMPTY;
+                    }
+                    else if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The queue was empty and a block time was specified so
+                         * configure the timeout structure. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        /* Entry time was already set. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* Interrupts and other tasks can send to and receive from the queue
+             * now the critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueue );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                /* The timeout has not expired.  If the queue is still empty
+                 * place the task on the list of tasks waiting to receive from
+                 * the queue. */
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                    vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueue );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* The queue contains data again.  Loop back to try and
+                     * read the data. */
+                    prvUnlockQueue( pxQueue );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  If there is no data in the queue exit, otherwise
+                 * loop back and attempt to read the data. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+                {
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    return errQUEUE_EMPTY;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        } /*lint -restore */
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    BaseType_t xQueueReceiveWithKeyFromISR( QueueHandle_t xQueue,
+                                            void * const pvBuffer,
+                                            UBaseType_t * const puxKey,
+                                            BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        BaseType_t xReturn;
+        UBaseType_t uxSavedInterruptStatus;
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) != pdFALSE );
+
+        /* See the comments in xQueueReceiveFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                const int8_t cRxLock = pxQueue->cRxLock;
+
+                traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+                prvRemoveFromPriorityQueue( pxQueue, pvBuffer, puxKey );
+
+                /* If the queue is locked the event list will not be modified.
+                 * Instead update the lock count so the task that unlocks the
+                 * queue will know that an ISR has removed data while the queue
+                 * was locked. */
+                if( cRxLock == queueUNLOCKED )
+                {
+                    if( prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToSend ), ( UBaseType_t ) 1 ) != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    prvIncrementQueueRxLock( pxQueue, cRxLock );
+                }
+
+                xReturn = pdPASS;
+            }
+            else
+            {
+                xReturn = pdFAIL;
+                traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
+                              void * const pvBuffer )
+{
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus;
+    int8_t * pcOriginalReadPosition;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( !( ( pvBuffer == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue->uxItemSize != 0 ); /* Can't peek a semaphore. */
+    configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
+    /* RTOS ports that support interrupt nesting have the concept of a maximum
+     * system call (or maximum API call) interrupt priority.  Interrupts that are
+     * above the maximum system call priority are kept permanently enabled, even
+     * when the RTOS kernel is in a critical section, but cannot make any calls to
+     * FreeRTOS API functions.  If configASSERT() is defined in FreeRTOSConfig.h
+     * then portASSERT_IF_INTERRUPT_PRIORITY_INVALID() will result in an assertion
+     * failure if a FreeRTOS API function is called from an interrupt that has been
+     * assigned a priority above the configured maximum system call priority.
+     * Only FreeRTOS functions that end in FromISR can be called from interrupts
+     * that have been assigned a priority at or (logically) below the maximum
+     * system call interrupt priority.  FreeRTOS maintains a separate interrupt
+     * safe API to ensure interrupt entry is as fast and as simple as possible.
+     * More information (albeit Cortex-M specific) is provided on the following
+     * link: https://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        /* Cannot block in an ISR, so check there is data available. */
+        if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        {
+            traceQUEUE_PEEK_FROM_ISR( pxQueue );
+
+            /* Remember the read position so it can be reset as nothing is
+             * actually being removed from the queue. */
+            pcOriginalReadPosition = pxQueue->u.xQueue.pcReadFrom;
+            prvCopyDataFromQueue( pxQueue, pvBuffer );
+            pxQueue->u.xQueue.pcReadFrom = pcOriginalReadPosition;
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = pdFAIL;
+            traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
 {
     UBaseType_t uxReturn;
 
@@ -2101,7 +3709,7 @@ UBaseType_t uxQueueSpacesAvailable( const QueueHandle_t xQueue )
 
     taskENTER_CRITICAL();
     {
-        uxReturn = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+        uxReturn = queueSPACES_AVAILABLE( pxQueue );
     }
     taskEXIT_CRITICAL();
 
@@ -2134,6 +3742,28 @@ void vQueueDelete( QueueHandle_t xQueue )
     }
     #endif
 
+    #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+    {
+        /* A member is only dropped from its set's ready list when a select
+         * finds it empty, so a member that was drained by a receive can still
+         * be in the list.  Unlink it, as xQueueRemoveFromSet() would, before
+         * its memory is freed. */
+        taskENTER_CRITICAL();
+        {
+            if( listLIST_ITEM_CONTAINER( &( pxQueue->xQueueSetReadyItem ) ) != NULL )
+            {
+                ( void ) uxListRemove( &( pxQueue->xQueueSetReadyItem ) );
+                pxQueue->pxQueueSetContainer->uxMessagesWaiting--;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+    #endif /* configUSE_QUEUE_SET_READY_LIST */
+
     #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
     {
         /* The queue can only have been allocated dynamically - free it
@@ -2233,6 +3863,83 @@ UBaseType_t uxQueueGetQueueLength( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+    static BaseType_t prvInheritAlongMutexChain( const Queue_t * const pxMutex )
+    {
+        const Queue_t * pxNextMutex;
+        TaskHandle_t xHolder = pxMutex->u.xSemaphore.xMutexHolder;
+        UBaseType_t uxDepth = ( UBaseType_t ) 1;
+        BaseType_t xReturn = pdFALSE;
+
+        /* The holder of pxMutex is the first link in the chain, and has
+         * already been dealt with by the caller.  The walk is bounded, so a
+         * deadlocked cycle of holders cannot keep it going. */
+        while( ( uxDepth < ( UBaseType_t ) configMAX_PRIORITY_INHERITANCE_DEPTH ) && ( xHolder != NULL ) )
+        {
+            pxNextMutex = ( const Queue_t * ) pvTaskGetMutexBlockedOn( xHolder );
+
+            if( pxNextMutex != NULL )
+            {
+                xHolder = pxNextMutex->u.xSemaphore.xMutexHolder;
+                xReturn |= xTaskPriorityInherit( xHolder );
+            }
+            else
+            {
+                xHolder = NULL;
+            }
+
+            uxDepth++;
+        }
+
+        return xReturn;
+    }
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+    static void prvDisinheritAlongMutexChain( const Queue_t * const pxMutex )
+    {
+        const Queue_t * pxNextMutex;
+        TaskHandle_t xHolder = pxMutex->u.xSemaphore.xMutexHolder;
+        UBaseType_t uxDepth = ( UBaseType_t ) 1;
+
+        /* Each holder is lowered to the priority of the highest priority task
+         * still waiting for the mutex it holds, which includes the previous
+         * holder in the chain at its now lowered priority. */
+        while( ( uxDepth < ( UBaseType_t ) configMAX_PRIORITY_INHERITANCE_DEPTH ) && ( xHolder != NULL ) )
+        {
+            pxNextMutex = ( const Queue_t * ) pvTaskGetMutexBlockedOn( xHolder );
+
+            if( pxNextMutex != NULL )
+            {
+                xHolder = pxNextMutex->u.xSemaphore.xMutexHolder;
+
+                /* A deadlocked cycle of holders can lead back to the calling
+                 * task, which is running so cannot be blocked on a mutex. */
+                if( xHolder != xTaskGetCurrentTaskHandle() )
+                {
+                    vTaskPriorityDisinheritAfterTimeout( xHolder, prvGetDisinheritPriorityAfterTimeout( pxNextMutex ) );
+                }
+                else
+                {
+                    xHolder = NULL;
+                }
+            }
+            else
+            {
+                xHolder = NULL;
+            }
+
+            uxDepth++;
+        }
+    }
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) */
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
                                       const void * pvItemToQueue,
                                       const BaseType_t xPosition )
@@ -2242,98 +3949,433 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 
     /* This function is called from a critical section. */
 
-    uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+    uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+    if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
+    {
+        #if ( configUSE_MUTEXES == 1 )
+        {
+            if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+            {
+                /* The mutex is no longer being held. */
+                xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
+                pxQueue->u.xSemaphore.xMutexHolder = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_MUTEXES */
+    }
+    else if( xPosition == queueSEND_TO_BACK )
+    {
+        prvCopyItem( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+        pxQueue->pcWriteTo += pxQueue->uxItemSize;                                                       /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )                                             /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+        {
+            /* The slot in front of the queue can be the one reserved or
+             * acquired, so the callers treat the queue as full while either
+             * is outstanding, see queueCAN_SEND(). */
+            configASSERT( !queueFRONT_SLOT_IN_USE( pxQueue ) );
+        }
+        #endif
+
+        prvCopyItem( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, pxQueue->uxItemSize ); /*lint !e961 !e9087 !e418 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes.  Assert checks null pointer only used when length is 0. */
+        pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
+
+        if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+        {
+            pxQueue->u.xQueue.pcReadFrom = ( pxQueue->u.xQueue.pcTail - pxQueue->uxItemSize );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xPosition == queueOVERWRITE )
+        {
+            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+            {
+                /* An item is not being added but overwritten, so subtract
+                 * one from the recorded number of items in the queue so when
+                 * one is added again below the number of recorded items remains
+                 * correct. */
+                --uxMessagesWaiting;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyDataFromQueue( Queue_t * const pxQueue,
+                                  void * const pvBuffer )
+{
+    if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+    {
+        pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;           /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+
+        if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+        {
+            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        prvCopyItem( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyMultipleDataToQueue( Queue_t * const pxQueue,
+                                        const int8_t * pcItemsToQueue,
+                                        const UBaseType_t uxItems )
+{
+    const size_t xBytes = ( size_t ) uxItems * ( size_t ) pxQueue->uxItemSize;
+    size_t xFirstBytes;
+
+    /* This function is called from a critical section.  The distance to the
+     * end of the storage area is always a whole number of items, so a wrap
+     * never splits an item. */
+    xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo ); /*lint !e946 !e9016 MISRA exception justified as pointer arithmetic on char types is the clearest way of conveying intent. */
+
+    if( xFirstBytes > xBytes )
+    {
+        xFirstBytes = xBytes;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pcItemsToQueue, xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+
+    if( xFirstBytes < xBytes )
+    {
+        ( void ) memcpy( ( void * ) pxQueue->pcHead, ( const void * ) &( pcItemsToQueue[ xFirstBytes ] ), xBytes - xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+        pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xFirstBytes );
+    }
+    else
+    {
+        pxQueue->pcWriteTo += xBytes;
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+    pxQueue->uxMessagesWaiting += uxItems;
+}
+/*-----------------------------------------------------------*/
+
+static void prvCopyMultipleDataFromQueue( Queue_t * const pxQueue,
+                                          int8_t * pcBuffer,
+                                          const UBaseType_t uxItems )
+{
+    const size_t xBytes = ( size_t ) uxItems * ( size_t ) pxQueue->uxItemSize;
+    int8_t * pcReadFrom;
+    size_t xFirstBytes;
+
+    /* This function is called from a critical section.  pcReadFrom points to
+     * the last item read, so the first item to read follows it. */
+    pcReadFrom = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize; /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+
+    if( pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+    {
+        pcReadFrom = pxQueue->pcHead;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadFrom ); /*lint !e946 !e9016 MISRA exception justified as pointer arithmetic on char types is the clearest way of conveying intent. */
+
+    if( xFirstBytes > xBytes )
+    {
+        xFirstBytes = xBytes;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    ( void ) memcpy( ( void * ) pcBuffer, ( void * ) pcReadFrom, xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+
+    if( xFirstBytes < xBytes )
+    {
+        ( void ) memcpy( ( void * ) &( pcBuffer[ xFirstBytes ] ), ( void * ) pxQueue->pcHead, xBytes - xFirstBytes ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports. */
+        pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( xBytes - xFirstBytes ) - pxQueue->uxItemSize;
+    }
+    else
+    {
+        pxQueue->u.xQueue.pcReadFrom = pcReadFrom + xBytes - pxQueue->uxItemSize;
+    }
+
+    pxQueue->uxMessagesWaiting -= uxItems;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
 
-    if( pxQueue->uxItemSize == ( UBaseType_t ) 0 )
+    static void prvInsertIntoPriorityQueue( Queue_t * const pxQueue,
+                                            const void * pvItemToQueue,
+                                            const UBaseType_t uxKey )
     {
-        #if ( configUSE_MUTEXES == 1 )
+        PriorityQueueEntry_t * const pxHeap = pxQueue->u.xPriorityQueue.pxHeap;
+        UBaseType_t uxIndex = pxQueue->uxMessagesWaiting;
+        UBaseType_t uxParent;
+        PriorityQueueEntry_t xNewEntry;
+
+        /* The entry just past the end of the heap holds a free slot. */
+        xNewEntry.uxKey = uxKey;
+        xNewEntry.uxSequence = pxQueue->u.xPriorityQueue.uxNextSequence;
+        xNewEntry.uxSlot = pxHeap[ uxIndex ].uxSlot;
+        pxQueue->u.xPriorityQueue.uxNextSequence++;
+
+        prvCopyItem( pxQueue->pcHead + ( xNewEntry.uxSlot * pxQueue->uxItemSize ), pvItemToQueue, pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+
+        /* Sift the new entry up towards the root. */
+        while( uxIndex > ( UBaseType_t ) 0 )
         {
-            if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+            uxParent = ( uxIndex - ( UBaseType_t ) 1 ) / ( UBaseType_t ) 2;
+
+            if( prvPriorityQueueEntryPrecedes( &xNewEntry, &( pxHeap[ uxParent ] ) ) != pdFALSE )
             {
-                /* The mutex is no longer being held. */
-                xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
-                pxQueue->u.xSemaphore.xMutexHolder = NULL;
+                pxHeap[ uxIndex ] = pxHeap[ uxParent ];
+                uxIndex = uxParent;
             }
             else
             {
-                mtCOVERAGE_TEST_MARKER();
+                break;
             }
         }
-        #endif /* configUSE_MUTEXES */
-    }
-    else if( xPosition == queueSEND_TO_BACK )
-    {
-        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
-        pxQueue->pcWriteTo += pxQueue->uxItemSize;                                                       /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
 
-        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )                                             /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
-        {
-            pxQueue->pcWriteTo = pxQueue->pcHead;
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
-        }
+        pxHeap[ uxIndex ] = xNewEntry;
+        pxQueue->uxMessagesWaiting++;
     }
-    else
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PRIORITY_QUEUES == 1 )
+
+    static void prvRemoveFromPriorityQueue( Queue_t * const pxQueue,
+                                            void * const pvBuffer,
+                                            UBaseType_t * const puxKey )
     {
-        ( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e9087 !e418 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes.  Assert checks null pointer only used when length is 0. */
-        pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
+        PriorityQueueEntry_t * const pxHeap = pxQueue->u.xPriorityQueue.pxHeap;
+        const UBaseType_t uxLast = pxQueue->uxMessagesWaiting - ( UBaseType_t ) 1;
+        const UBaseType_t uxFreedSlot = pxHeap[ 0 ].uxSlot;
+        const PriorityQueueEntry_t xLastEntry = pxHeap[ uxLast ];
+        UBaseType_t uxIndex = 0, uxChild;
 
-        if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
+        prvCopyItem( pvBuffer, pxQueue->pcHead + ( uxFreedSlot * pxQueue->uxItemSize ), pxQueue->uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+
+        if( puxKey != NULL )
         {
-            pxQueue->u.xQueue.pcReadFrom = ( pxQueue->u.xQueue.pcTail - pxQueue->uxItemSize );
+            *puxKey = pxHeap[ 0 ].uxKey;
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
 
-        if( xPosition == queueOVERWRITE )
+        /* Sift the last entry down from the root into the space left by the
+         * removed entry. */
+        for( ; ; )
         {
-            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+            uxChild = ( uxIndex * ( UBaseType_t ) 2 ) + ( UBaseType_t ) 1;
+
+            if( uxChild >= uxLast )
             {
-                /* An item is not being added but overwritten, so subtract
-                 * one from the recorded number of items in the queue so when
-                 * one is added again below the number of recorded items remains
-                 * correct. */
-                --uxMessagesWaiting;
+                break;
+            }
+            else if( ( ( uxChild + ( UBaseType_t ) 1 ) < uxLast ) &&
+                     ( prvPriorityQueueEntryPrecedes( &( pxHeap[ uxChild + ( UBaseType_t ) 1 ] ), &( pxHeap[ uxChild ] ) ) != pdFALSE ) )
+            {
+                uxChild++;
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
+
+            if( prvPriorityQueueEntryPrecedes( &( pxHeap[ uxChild ] ), &xLastEntry ) != pdFALSE )
+            {
+                pxHeap[ uxIndex ] = pxHeap[ uxChild ];
+                uxIndex = uxChild;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        pxHeap[ uxIndex ] = xLastEntry;
+
+        /* The entry that is now just past the end of the heap keeps the slot
+         * that was freed. */
+        pxHeap[ uxLast ].uxSlot = uxFreedSlot;
+        pxQueue->uxMessagesWaiting = uxLast;
+    }
+
+#endif /* configUSE_PRIORITY_QUEUES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+
+    static BaseType_t prvHandoffToWaitingReceiver( Queue_t * const pxQueue,
+                                                   const void * pvItemToQueue )
+    {
+        BaseType_t xReturn = pdFALSE;
+        void * pvBuffer;
+
+        /* This function is called from a critical section.  Only hand off if the
+         * queue is empty, otherwise the item would overtake those already
+         * queued. */
+        if( ( pxQueue->uxItemSize != ( UBaseType_t ) 0 ) &&
+            ( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 ) &&
+            ( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE ) )
+        {
+            #if ( configUSE_QUEUE_SETS == 1 )
+                if( pxQueue->pxQueueSetContainer == NULL )
+            #endif
+            {
+                /* NULL if the highest priority waiting task is not blocked in
+                 * xQueueReceive(), for example because it is peeking. */
+                pvBuffer = pvTaskTakeHandoffBuffer( &( pxQueue->xTasksWaitingToReceive ) );
+
+                if( pvBuffer != NULL )
+                {
+                    prvCopyItem( pvBuffer, pvItemToQueue, pxQueue->uxItemSize );
+
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
+
+        return xReturn;
     }
 
-    pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+#endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockMultipleTasks( List_t * const pxEventList,
+                                           UBaseType_t uxMaxTasks )
+{
+    BaseType_t xReturn = pdFALSE;
+
+    /* This function is called from a critical section. */
+    while( ( uxMaxTasks > ( UBaseType_t ) 0 ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
+    {
+        if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxMaxTasks--;
+    }
 
     return xReturn;
 }
 /*-----------------------------------------------------------*/
 
-static void prvCopyDataFromQueue( Queue_t * const pxQueue,
-                                  void * const pvBuffer )
+static BaseType_t prvNotifyMultipleReceivers( Queue_t * const pxQueue,
+                                              UBaseType_t uxItems )
 {
-    if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
-    {
-        pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;           /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
+    BaseType_t xReturn = pdFALSE;
 
-        if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail ) /*lint !e946 MISRA exception justified as use of the relational operator is the cleanest solutions. */
+    #if ( configUSE_QUEUE_SETS == 1 )
+    {
+        if( pxQueue->pxQueueSetContainer != NULL )
         {
-            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+            #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+            {
+                /* The queue set holds one entry per non-empty member. */
+                uxItems = ( UBaseType_t ) 1;
+            }
+            #endif
+
+            /* The queue set holds one entry per item in its member queues. */
+            while( uxItems > ( UBaseType_t ) 0 )
+            {
+                if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                {
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                uxItems--;
+            }
         }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            xReturn = prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToReceive ), uxItems );
         }
-
-        ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
     }
+    #else /* configUSE_QUEUE_SETS */
+    {
+        xReturn = prvUnblockMultipleTasks( &( pxQueue->xTasksWaitingToReceive ), uxItems );
+    }
+    #endif /* configUSE_QUEUE_SETS */
+
+    return xReturn;
 }
 /*-----------------------------------------------------------*/
 
@@ -2463,7 +4505,7 @@ static BaseType_t prvIsQueueEmpty( const Queue_t * pxQueue )
 
     taskENTER_CRITICAL();
     {
-        if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
+        if( queueITEMS_AVAILABLE( pxQueue ) == ( UBaseType_t ) 0 )
         {
             xReturn = pdTRUE;
         }
@@ -2485,7 +4527,7 @@ BaseType_t xQueueIsQueueEmptyFromISR( const QueueHandle_t xQueue )
 
     configASSERT( pxQueue );
 
-    if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
+    if( queueITEMS_AVAILABLE( pxQueue ) == ( UBaseType_t ) 0 )
     {
         xReturn = pdTRUE;
     }
@@ -2504,7 +4546,7 @@ static BaseType_t prvIsQueueFull( const Queue_t * pxQueue )
 
     taskENTER_CRITICAL();
     {
-        if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+        if( queueSPACES_AVAILABLE( pxQueue ) == ( UBaseType_t ) 0 )
         {
             xReturn = pdTRUE;
         }
@@ -2519,6 +4561,41 @@ static BaseType_t prvIsQueueFull( const Queue_t * pxQueue )
 }
 /*-----------------------------------------------------------*/
 
+static BaseType_t prvIsQueueFullFor( Queue_t * const pxQueue,
+                                     const BaseType_t xCopyPosition )
+{
+    BaseType_t xReturn;
+
+    taskENTER_CRITICAL();
+    {
+        if( queueCAN_SEND( pxQueue, xCopyPosition ) )
+        {
+            xReturn = pdFALSE;
+        }
+        else
+        {
+            xReturn = pdTRUE;
+
+            #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+            {
+                if( xCopyPosition != queueSEND_TO_BACK )
+                {
+                    pxQueue->ucFrontSenderWaiting = ( uint8_t ) pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 {
     BaseType_t xReturn;
@@ -2526,7 +4603,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
     configASSERT( pxQueue );
 
-    if( pxQueue->uxMessagesWaiting == pxQueue->uxLength )
+    if( queueSPACES_AVAILABLE( pxQueue ) == ( UBaseType_t ) 0 )
     {
         xReturn = pdTRUE;
     }
@@ -2548,6 +4625,9 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         BaseType_t xReturn;
         Queue_t * const pxQueue = xQueue;
 
+        configASSERT( pxQueue );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
         /* If the queue is already full we may have to block.  A critical section
          * is required to prevent an interrupt removing something from the queue
          * between the check to see if the queue is full and blocking on the queue. */
@@ -2576,7 +4656,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
         portDISABLE_INTERRUPTS();
         {
-            if( pxQueue->uxMessagesWaiting < pxQueue->uxLength )
+            if( queueSPACES_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
             {
                 /* There is room in the queue, copy the data into the queue. */
                 prvCopyDataToQueue( pxQueue, pvItemToQueue, queueSEND_TO_BACK );
@@ -2627,12 +4707,15 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         BaseType_t xReturn;
         Queue_t * const pxQueue = xQueue;
 
+        configASSERT( pxQueue );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
         /* If the queue is already empty we may have to block.  A critical section
          * is required to prevent an interrupt adding something to the queue
          * between the check to see if the queue is empty and blocking on the queue. */
         portDISABLE_INTERRUPTS();
         {
-            if( pxQueue->uxMessagesWaiting == ( UBaseType_t ) 0 )
+            if( queueITEMS_AVAILABLE( pxQueue ) == ( UBaseType_t ) 0 )
             {
                 /* There are no messages in the queue, do we want to block or just
                  * leave with nothing? */
@@ -2659,7 +4742,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 
         portDISABLE_INTERRUPTS();
         {
-            if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+            if( queueITEMS_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
             {
                 /* Data is available from the queue. */
                 pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;
@@ -2720,9 +4803,12 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
     {
         Queue_t * const pxQueue = xQueue;
 
+        configASSERT( pxQueue );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
         /* Cannot block within an ISR so if there is no space on the queue then
          * exit without doing anything. */
-        if( pxQueue->uxMessagesWaiting < pxQueue->uxLength )
+        if( queueSPACES_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
         {
             prvCopyDataToQueue( pxQueue, pvItemToQueue, queueSEND_TO_BACK );
 
@@ -2771,62 +4857,161 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         BaseType_t xReturn;
         Queue_t * const pxQueue = xQueue;
 
+        configASSERT( pxQueue );
+        configASSERT( queueIS_PRIORITY_QUEUE( pxQueue ) == pdFALSE );
+
         /* We cannot block from an ISR, so check there is data available. If
          * not then just leave without doing anything. */
-        if( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 )
+        if( queueITEMS_AVAILABLE( pxQueue ) > ( UBaseType_t ) 0 )
+        {
+            /* Copy the data from the queue. */
+            pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;
+
+            if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail )
+            {
+                pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            --( pxQueue->uxMessagesWaiting );
+            ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( unsigned ) pxQueue->uxItemSize );
+
+            if( ( *pxCoRoutineWoken ) == pdFALSE )
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    if( xCoRoutineRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        *pxCoRoutineWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = pdFAIL;
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_CO_ROUTINES */
+/*-----------------------------------------------------------*/
+
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+    static Queue_t ** prvGetRegistryBucket( const char * pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    {
+        /* 32-bit FNV-1a hash of the name. */
+        uint32_t ulHash = 2166136261UL;
+
+        while( *pcQueueName != '\0' )
+        {
+            ulHash ^= ( uint32_t ) ( uint8_t ) *pcQueueName;
+            ulHash *= 16777619UL;
+            pcQueueName++;
+        }
+
+        return &( pxQueueRegistryBuckets[ ulHash % ( uint32_t ) configQUEUE_REGISTRY_SIZE ] );
+    }
+
+#endif /* if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+    static void prvRemoveFromRegistry( Queue_t * const pxQueue )
+    {
+        /* Called from a critical section. */
+        *( pxQueue->ppxPreviousRegistered ) = pxQueue->pxNextRegistered;
+
+        if( pxQueue->pxNextRegistered != NULL )
+        {
+            pxQueue->pxNextRegistered->ppxPreviousRegistered = pxQueue->ppxPreviousRegistered;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxQueue->pcQueueName = NULL;
+    }
+
+#endif /* if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+    void vQueueAddToRegistry( QueueHandle_t xQueue,
+                              const char * pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    {
+        Queue_t * const pxQueue = xQueue;
+        Queue_t ** ppxBucket;
+
+        configASSERT( pxQueue );
+
+        if( pcQueueName != NULL )
         {
-            /* Copy the data from the queue. */
-            pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;
+            ppxBucket = prvGetRegistryBucket( pcQueueName );
 
-            if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail )
-            {
-                pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
-            }
-            else
+            taskENTER_CRITICAL();
             {
-                mtCOVERAGE_TEST_MARKER();
-            }
+                /* Replace the existing entry if the queue is already in the
+                 * registry. */
+                if( pxQueue->pcQueueName != NULL )
+                {
+                    prvRemoveFromRegistry( pxQueue );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
 
-            --( pxQueue->uxMessagesWaiting );
-            ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( unsigned ) pxQueue->uxItemSize );
+                /* Insert at the head of the bucket, so the most recently added
+                 * of several queues with the same name is found first. */
+                pxQueue->pcQueueName = pcQueueName;
+                pxQueue->pxNextRegistered = *ppxBucket;
+                pxQueue->ppxPreviousRegistered = ppxBucket;
 
-            if( ( *pxCoRoutineWoken ) == pdFALSE )
-            {
-                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                if( *ppxBucket != NULL )
                 {
-                    if( xCoRoutineRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
-                    {
-                        *pxCoRoutineWoken = pdTRUE;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+                    ( *ppxBucket )->ppxPreviousRegistered = &( pxQueue->pxNextRegistered );
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
-            }
-            else
-            {
-                mtCOVERAGE_TEST_MARKER();
-            }
 
-            xReturn = pdPASS;
+                *ppxBucket = pxQueue;
+
+                traceQUEUE_REGISTRY_ADD( xQueue, pcQueueName );
+            }
+            taskEXIT_CRITICAL();
         }
         else
         {
-            xReturn = pdFAIL;
+            mtCOVERAGE_TEST_MARKER();
         }
-
-        return xReturn;
     }
 
-#endif /* configUSE_CO_ROUTINES */
-/*-----------------------------------------------------------*/
-
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#elif ( configQUEUE_REGISTRY_SIZE > 0 )
 
     void vQueueAddToRegistry( QueueHandle_t xQueue,
                               const char * pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
@@ -2858,6 +5043,11 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
+
+            /* The registry is full.  Increase configQUEUE_REGISTRY_SIZE, or set
+             * configQUEUE_REGISTRY_HASHED to 1 so the number of queues that can
+             * be registered is not limited. */
+            configASSERT( pxEntryToWrite );
         }
 
         if( pxEntryToWrite != NULL )
@@ -2873,7 +5063,16 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 #endif /* configQUEUE_REGISTRY_SIZE */
 /*-----------------------------------------------------------*/
 
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+    const char * pcQueueGetName( QueueHandle_t xQueue ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    {
+        configASSERT( xQueue );
+
+        return xQueue->pcQueueName;
+    } /*lint !e818 xQueue cannot be a pointer to const because it is a typedef. */
+
+#elif ( configQUEUE_REGISTRY_SIZE > 0 )
 
     const char * pcQueueGetName( QueueHandle_t xQueue ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
     {
@@ -2904,7 +5103,91 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 #endif /* configQUEUE_REGISTRY_SIZE */
 /*-----------------------------------------------------------*/
 
-#if ( configQUEUE_REGISTRY_SIZE > 0 )
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+    QueueHandle_t xQueueGetHandle( const char * pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    {
+        Queue_t * pxQueue;
+
+        configASSERT( pcQueueName );
+
+        /* The registry is only updated from critical sections, so suspending
+         * the scheduler is enough to keep the chain stable while it is
+         * searched. */
+        vTaskSuspendAll();
+        {
+            for( pxQueue = *prvGetRegistryBucket( pcQueueName ); pxQueue != NULL; pxQueue = pxQueue->pxNextRegistered )
+            {
+                if( strcmp( pxQueue->pcQueueName, pcQueueName ) == 0 )
+                {
+                    break;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return pxQueue;
+    }
+
+#elif ( configQUEUE_REGISTRY_SIZE > 0 )
+
+    QueueHandle_t xQueueGetHandle( const char * pcQueueName ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+    {
+        UBaseType_t ux;
+        QueueHandle_t xReturn = NULL;
+
+        configASSERT( pcQueueName );
+
+        /* Note there is nothing here to protect against another task adding or
+         * removing entries from the registry while it is being searched. */
+
+        for( ux = ( UBaseType_t ) 0U; ux < ( UBaseType_t ) configQUEUE_REGISTRY_SIZE; ux++ )
+        {
+            if( ( xQueueRegistry[ ux ].pcQueueName != NULL ) &&
+                ( strcmp( xQueueRegistry[ ux ].pcQueueName, pcQueueName ) == 0 ) )
+            {
+                xReturn = xQueueRegistry[ ux ].xHandle;
+                break;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return xReturn;
+    }
+
+#endif /* configQUEUE_REGISTRY_SIZE */
+/*-----------------------------------------------------------*/
+
+#if ( ( configQUEUE_REGISTRY_SIZE > 0 ) && ( configQUEUE_REGISTRY_HASHED == 1 ) )
+
+    void vQueueUnregisterQueue( QueueHandle_t xQueue )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+
+        taskENTER_CRITICAL();
+        {
+            if( pxQueue->pcQueueName != NULL )
+            {
+                prvRemoveFromRegistry( pxQueue );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+    } /*lint !e818 xQueue could not be pointer to const because it is a typedef. */
+
+#elif ( configQUEUE_REGISTRY_SIZE > 0 )
 
     void vQueueUnregisterQueue( QueueHandle_t xQueue )
     {
@@ -2983,7 +5266,18 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
     {
         QueueSetHandle_t pxQueue;
 
-        pxQueue = xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) sizeof( Queue_t * ), queueQUEUE_TYPE_SET );
+        #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+        {
+            /* Members are linked into the set's ready list rather than having
+             * their handles copied into the set, so the set needs no storage
+             * area. */
+            pxQueue = xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) 0, queueQUEUE_TYPE_SET );
+        }
+        #else
+        {
+            pxQueue = xQueueGenericCreate( uxEventQueueLength, ( UBaseType_t ) sizeof( Queue_t * ), queueQUEUE_TYPE_SET );
+        }
+        #endif
 
         return pxQueue;
     }
@@ -3007,9 +5301,30 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
             }
             else if( ( ( Queue_t * ) xQueueOrSemaphore )->uxMessagesWaiting != ( UBaseType_t ) 0 )
             {
-                /* Cannot add a queue/semaphore to a queue set if there are already
-                 * items in the queue/semaphore. */
-                xReturn = pdFAIL;
+                #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+                {
+                    /* A member that already holds items goes straight onto the
+                     * set's ready list. */
+                    ( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer = xQueueSet;
+
+                    if( prvNotifyQueueSetContainer( ( Queue_t * ) xQueueOrSemaphore ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    xReturn = pdPASS;
+                }
+                #else
+                {
+                    /* Cannot add a queue/semaphore to a queue set if there are already
+                     * items in the queue/semaphore. */
+                    xReturn = pdFAIL;
+                }
+                #endif /* configUSE_QUEUE_SET_READY_LIST */
             }
             else
             {
@@ -3038,17 +5353,37 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
             /* The queue was not a member of the set. */
             xReturn = pdFAIL;
         }
-        else if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
-        {
-            /* It is dangerous to remove a queue from a set when the queue is
-             * not empty because the queue set will still hold pending events for
-             * the queue. */
-            xReturn = pdFAIL;
-        }
+
+        #if ( configUSE_QUEUE_SET_READY_LIST == 0 )
+            else if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
+            {
+                /* It is dangerous to remove a queue from a set when the queue is
+                 * not empty because the queue set will still hold pending events for
+                 * the queue. */
+                xReturn = pdFAIL;
+            }
+        #endif /* configUSE_QUEUE_SET_READY_LIST */
         else
         {
             taskENTER_CRITICAL();
             {
+                #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+                {
+                    /* The set only references the member through the member's
+                     * ready list item, so the member can be removed even if it
+                     * is not empty. */
+                    if( listLIST_ITEM_CONTAINER( &( pxQueueOrSemaphore->xQueueSetReadyItem ) ) != NULL )
+                    {
+                        ( void ) uxListRemove( &( pxQueueOrSemaphore->xQueueSetReadyItem ) );
+                        ( ( Queue_t * ) xQueueSet )->uxMessagesWaiting--;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_QUEUE_SET_READY_LIST */
+
                 /* The queue is no longer contained in the set. */
                 pxQueueOrSemaphore->pxQueueSetContainer = NULL;
             }
@@ -3062,7 +5397,7 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 #endif /* configUSE_QUEUE_SETS */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_READY_LIST == 0 ) )
 
     QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet,
                                                 TickType_t const xTicksToWait )
@@ -3073,10 +5408,10 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         return xReturn;
     }
 
-#endif /* configUSE_QUEUE_SETS */
+#endif /* ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_READY_LIST == 0 ) */
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_QUEUE_SETS == 1 )
+#if ( ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_READY_LIST == 0 ) )
 
     QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet )
     {
@@ -3086,12 +5421,176 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
         return xReturn;
     }
 
-#endif /* configUSE_QUEUE_SETS */
+#endif /* ( configUSE_QUEUE_SETS == 1 ) && ( configUSE_QUEUE_SET_READY_LIST == 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+
+    QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet,
+                                                TickType_t xTicksToWait )
+    {
+        BaseType_t xEntryTimeSet = pdFALSE;
+        TimeOut_t xTimeOut;
+        Queue_t * const pxQueueSet = ( Queue_t * ) xQueueSet;
+        QueueSetMemberHandle_t xReturn;
+
+        configASSERT( pxQueueSet );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /*lint -save -e904  This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            taskENTER_CRITICAL();
+            {
+                xReturn = prvSelectReadyMember( pxQueueSet );
+
+                if( xReturn != NULL )
+                {
+                    traceQUEUE_RECEIVE( pxQueueSet );
+                    taskEXIT_CRITICAL();
+                    return xReturn;
+                }
+                else if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* No member is ready and no block time is specified (or the
+                     * block time has expired) so exit now. */
+                    taskEXIT_CRITICAL();
+                    traceQUEUE_RECEIVE_FAILED( pxQueueSet );
+                    return NULL;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            /* Interrupts and other tasks can send to the members of the set now
+             * the critical section has been exited. */
+
+            vTaskSuspendAll();
+            prvLockQueue( pxQueueSet );
+
+            /* Update the timeout state to see if it has expired yet. */
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+            {
+                /* The set's message count is the number of entries in its ready
+                 * list, so the set is empty if no member has become ready. */
+                if( prvIsQueueEmpty( pxQueueSet ) != pdFALSE )
+                {
+                    traceBLOCKING_ON_QUEUE_RECEIVE( pxQueueSet );
+                    vTaskPlaceOnEventList( &( pxQueueSet->xTasksWaitingToReceive ), xTicksToWait );
+                    prvUnlockQueue( pxQueueSet );
+
+                    if( xTaskResumeAll() == pdFALSE )
+                    {
+                        portYIELD_WITHIN_API();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    /* A member became ready, so try again. */
+                    prvUnlockQueue( pxQueueSet );
+                    ( void ) xTaskResumeAll();
+                }
+            }
+            else
+            {
+                /* Timed out.  Try once more if a member became ready, otherwise
+                 * exit now. */
+                prvUnlockQueue( pxQueueSet );
+                ( void ) xTaskResumeAll();
+
+                if( prvIsQueueEmpty( pxQueueSet ) != pdFALSE )
+                {
+                    traceQUEUE_RECEIVE_FAILED( pxQueueSet );
+                    return NULL;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        } /*lint -restore */
+    }
+
+#endif /* configUSE_QUEUE_SET_READY_LIST */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+
+    QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet )
+    {
+        QueueSetMemberHandle_t xReturn;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( xQueueSet );
+
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            xReturn = prvSelectReadyMember( ( Queue_t * ) xQueueSet );
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_SET_READY_LIST */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+
+    static QueueSetMemberHandle_t prvSelectReadyMember( Queue_t * const pxQueueSet )
+    {
+        ListItem_t * pxReadyItem;
+        Queue_t * pxMember;
+        QueueSetMemberHandle_t xReturn = NULL;
+
+        while( ( xReturn == NULL ) && ( listLIST_IS_EMPTY( &( pxQueueSet->xQueueSetReadyMembers ) ) == pdFALSE ) )
+        {
+            pxReadyItem = listGET_HEAD_ENTRY( &( pxQueueSet->xQueueSetReadyMembers ) );
+            pxMember = ( Queue_t * ) listGET_LIST_ITEM_OWNER( pxReadyItem );
+            ( void ) uxListRemove( pxReadyItem );
+
+            if( pxMember->uxMessagesWaiting != ( UBaseType_t ) 0 )
+            {
+                vListInsertEnd( &( pxQueueSet->xQueueSetReadyMembers ), pxReadyItem );
+                xReturn = ( QueueSetMemberHandle_t ) pxMember;
+            }
+            else
+            {
+                /* The member was emptied since it was last selected. */
+                pxQueueSet->uxMessagesWaiting--;
+            }
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_SET_READY_LIST */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_QUEUE_SETS == 1 )
 
-    static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue )
+    static BaseType_t prvNotifyQueueSetContainer( Queue_t * const pxQueue )
     {
         Queue_t * pxQueueSetContainer = pxQueue->pxQueueSetContainer;
         BaseType_t xReturn = pdFALSE;
@@ -3102,16 +5601,34 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
          * to prvNotifyQueueSetContainer is preceded by a check that
          * pxQueueSetContainer != NULL */
         configASSERT( pxQueueSetContainer ); /* LCOV_EXCL_BR_LINE */
-        configASSERT( pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength );
 
-        if( pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength )
+        #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+            /* A member that is already in the set's ready list is not added
+             * again, however many items are sent to it. */
+            if( listLIST_ITEM_CONTAINER( &( pxQueue->xQueueSetReadyItem ) ) == NULL )
+        #else
+            configASSERT( pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength );
+
+            if( pxQueueSetContainer->uxMessagesWaiting < pxQueueSetContainer->uxLength )
+        #endif
         {
             const int8_t cTxLock = pxQueueSetContainer->cTxLock;
 
             traceQUEUE_SET_SEND( pxQueueSetContainer );
 
-            /* The data copied is the handle of the queue that contains data. */
-            xReturn = prvCopyDataToQueue( pxQueueSetContainer, &pxQueue, queueSEND_TO_BACK );
+            #if ( configUSE_QUEUE_SET_READY_LIST == 1 )
+            {
+                /* Link the queue into the set's ready list rather than copying
+                 * its handle into the set. */
+                vListInsertEnd( &( pxQueueSetContainer->xQueueSetReadyMembers ), &( pxQueue->xQueueSetReadyItem ) );
+                ( pxQueueSetContainer->uxMessagesWaiting )++;
+            }
+            #else
+            {
+                /* The data copied is the handle of the queue that contains data. */
+                xReturn = prvCopyDataToQueue( pxQueueSetContainer, &pxQueue, queueSEND_TO_BACK );
+            }
+            #endif
 
             if( cTxLock == queueUNLOCKED )
             {
@@ -0,0 +1,797 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "rwlock.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include readers-writer lock functionality.  This #if is closed at the very
+ * bottom of this file.  If you want to include readers-writer locks then ensure
+ * configUSE_RW_LOCKS is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_RW_LOCKS == 1 )
+
+    #include <stdatomic.h>
+
+    #if ( configUSE_MUTEXES != 1 )
+        #error configUSE_MUTEXES must be set to 1 to build rwlock.c
+    #endif
+
+    #if ( INCLUDE_xTaskGetCurrentTaskHandle != 1 )
+        #error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to build rwlock.c
+    #endif
+
+    #if ( INCLUDE_uxTaskPriorityGet != 1 )
+        #error INCLUDE_uxTaskPriorityGet must be set to 1 to build rwlock.c
+    #endif
+
+/* Bits in the lock's state.  The top bit is set while a task holds the lock for
+ * writing, the next two bits are set while at least one task is blocked waiting
+ * to take the lock for writing or for reading respectively, and the remaining
+ * bits count the tasks that hold the lock for reading. */
+    #define rwlockWRITER_BIT             ( ( size_t ) 1 << ( ( sizeof( size_t ) * ( size_t ) 8 ) - ( size_t ) 1 ) )
+    #define rwlockWRITERS_WAITING_BIT    ( ( size_t ) 1 << ( ( sizeof( size_t ) * ( size_t ) 8 ) - ( size_t ) 2 ) )
+    #define rwlockREADERS_WAITING_BIT    ( ( size_t ) 1 << ( ( sizeof( size_t ) * ( size_t ) 8 ) - ( size_t ) 3 ) )
+    #define rwlockREADER_COUNT_MASK      ( rwlockREADERS_WAITING_BIT - ( size_t ) 1 )
+
+/* The event list item value of a task that is blocked on the lock, which is
+ * used to compare its priority with that of other tasks.  Event lists are
+ * ordered by this value, so the head of an event list holds its highest
+ * priority task. */
+    #define rwlockPRIORITY_ITEM_VALUE( uxPriority )    ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) ( uxPriority ) )
+
+/*
+ * xState is only changed outside of the kernel by the fast paths - taking the
+ * lock for reading while neither writer bit is set, taking it for writing while
+ * xState is zero, and giving it back.  Everything else, including any change to
+ * the event lists, is done with the scheduler suspended.  A task sets the
+ * matching waiting bit before it blocks, and the fast paths cannot take or give
+ * the lock in a way that would leave it blocked while the bit is set, so the
+ * task that gives the lock back always sees the bit and unblocks it.
+ *
+ * The writer bit is only ever set or cleared together with xWriter, from a
+ * critical section or with the scheduler suspended, so a task that finds the
+ * writer bit set in the slow paths always finds the writer whose priority it
+ * must raise.
+ */
+    typedef struct RWLockDefinition
+    {
+        atomic_size_t xState;          /**< The writer bits and the reader count, as described above. */
+        TaskHandle_t xWriter;          /**< The task that holds the lock for writing, or NULL. */
+        List_t xTasksWaitingToRead;    /**< Tasks blocked waiting to take the lock for reading, in priority order. */
+        List_t xTasksWaitingToWrite;   /**< Tasks blocked waiting to take the lock for writing, in priority order. */
+        uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the lock was created by xRWLockCreateStatic(). */
+    } RWLock_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by both the create functions to initialise a new lock.
+ */
+    static void prvInitialiseNewRWLock( RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if the calling task can take the lock for reading - that is,
+ * if no task holds the lock for writing and no task with the same or a higher
+ * priority is waiting to take it for writing.  Must be called with the
+ * scheduler suspended.
+ */
+    static BaseType_t prvReaderCanEnter( RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock the tasks that can now take the lock.  If the lock is free and the
+ * highest priority task waiting to take it for writing has the same or a higher
+ * priority than every task waiting to take it for reading, then the lock is
+ * handed to that writer before the writer runs, and the writer inherits the
+ * priority of the tasks that are still waiting.  Otherwise the readers that
+ * prvReaderCanEnter() would let in are unblocked to try again.  Also clears the
+ * waiting bits of event lists that are empty.  Must be called with the
+ * scheduler suspended.
+ */
+    static void prvUnblockWaitingTasks( RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called by a task that timed out waiting for the lock after raising the
+ * priority of the task that holds the lock for writing.  Lowers the holder's
+ * priority to that of the highest priority task still waiting for the lock.
+ * Must be called with the scheduler suspended.
+ */
+    static void prvDisinheritAfterTimeout( RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the priority of the highest priority task waiting to take the lock,
+ * for reading or for writing, or tskIDLE_PRIORITY if no task is waiting.  Must
+ * be called with the scheduler suspended.
+ */
+    static UBaseType_t prvGetHighestWaitingPriority( RWLock_t * const pxLock ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        RWLockHandle_t xRWLockCreate( void )
+        {
+            RWLock_t * pxNewLock;
+
+            pxNewLock = ( RWLock_t * ) pvPortMalloc( sizeof( RWLock_t ) ); /*lint !e9087 !e9079 RWLock_t is the real type of the allocated memory. */
+
+            if( pxNewLock != NULL )
+            {
+                prvInitialiseNewRWLock( pxNewLock );
+                pxNewLock->ucStaticallyAllocated = pdFALSE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewLock;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        RWLockHandle_t xRWLockCreateStatic( StaticRWLock_t * pxRWLockBuffer )
+        {
+            RWLock_t * pxNewLock = NULL;
+
+            configASSERT( pxRWLockBuffer );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticRWLock_t equals the size of the real
+                 * lock structure. */
+                volatile size_t xSize = sizeof( StaticRWLock_t );
+                configASSERT( xSize == sizeof( RWLock_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( pxRWLockBuffer != NULL )
+            {
+                pxNewLock = ( RWLock_t * ) pxRWLockBuffer; /*lint !e740 !e9087 RWLock_t and StaticRWLock_t are deliberately aliased, and checked by an assert. */
+                prvInitialiseNewRWLock( pxNewLock );
+                pxNewLock->ucStaticallyAllocated = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewLock;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vRWLockDelete( RWLockHandle_t xLock )
+    {
+        RWLock_t * pxLock = xLock;
+
+        configASSERT( pxLock );
+        configASSERT( atomic_load( &( pxLock->xState ) ) == ( size_t ) 0 );
+        configASSERT( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) != pdFALSE );
+        configASSERT( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE );
+
+        if( pxLock->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                vPortFree( ( void * ) pxLock );
+            }
+            #endif
+        }
+        else
+        {
+            /* The structure was not allocated dynamically and cannot be freed -
+             * just scrub it so future use will assert. */
+            ( void ) memset( ( void * ) pxLock, 0x00, sizeof( RWLock_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xRWLockTakeRead( RWLockHandle_t xLock,
+                                TickType_t xTicksToWait )
+    {
+        RWLock_t * const pxLock = xLock;
+        size_t xState;
+        TimeOut_t xTimeOut;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xInheritanceOccurred = pdFALSE;
+
+        configASSERT( pxLock );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /* Join the readers that hold the lock, or take it for the first reader,
+         * without entering the kernel if no writer holds the lock or is waiting
+         * for it.  A failed compare and exchange updates xState, so the loop
+         * only repeats while other readers are changing the count. */
+        xState = atomic_load_explicit( &( pxLock->xState ), memory_order_relaxed );
+
+        while( ( xState & ( rwlockWRITER_BIT | rwlockWRITERS_WAITING_BIT ) ) == ( size_t ) 0 )
+        {
+            configASSERT( ( xState & rwlockREADER_COUNT_MASK ) != rwlockREADER_COUNT_MASK );
+
+            if( atomic_compare_exchange_weak_explicit( &( pxLock->xState ), &xState, xState + ( size_t ) 1,
+                                                       memory_order_acquire, memory_order_relaxed ) != false )
+            {
+                return pdPASS;
+            }
+        }
+
+        /*lint -save -e904  This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            vTaskSuspendAll();
+            {
+                /* Hand the lock on if it was given back between the task that
+                 * gave it finding the writers waiting bit set and suspending the
+                 * scheduler.  Not if this task can take the lock itself, as it
+                 * may be a reader that was unblocked ahead of the writers, and
+                 * the lock would then be handed to a writer first. */
+                if( prvReaderCanEnter( pxLock ) == pdFALSE )
+                {
+                    prvUnblockWaitingTasks( pxLock );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( prvReaderCanEnter( pxLock ) != pdFALSE )
+                {
+                    ( void ) atomic_fetch_add_explicit( &( pxLock->xState ), ( size_t ) 1, memory_order_acquire );
+                    ( void ) xTaskResumeAll();
+                    return pdPASS;
+                }
+                else if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    ( void ) xTaskResumeAll();
+                    return pdFAIL;
+                }
+                else
+                {
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        /* The tick count cannot change while the scheduler is
+                         * suspended. */
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                    {
+                        configASSERT( ( ( atomic_load_explicit( &( pxLock->xState ), memory_order_relaxed ) & rwlockWRITER_BIT ) == ( size_t ) 0 ) ==
+                                      ( pxLock->xWriter == NULL ) );
+
+                        if( pxLock->xWriter != NULL )
+                        {
+                            taskENTER_CRITICAL();
+                            {
+                                xInheritanceOccurred |= xTaskPriorityInherit( pxLock->xWriter );
+                            }
+                            taskEXIT_CRITICAL();
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        /* Stop the writer giving the lock back on the fast
+                         * path without unblocking this task. */
+                        ( void ) atomic_fetch_or_explicit( &( pxLock->xState ), rwlockREADERS_WAITING_BIT, memory_order_relaxed );
+                        vTaskPlaceOnEventList( &( pxLock->xTasksWaitingToRead ), xTicksToWait );
+                    }
+                    else
+                    {
+                        if( xInheritanceOccurred != pdFALSE )
+                        {
+                            prvDisinheritAfterTimeout( pxLock );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        ( void ) xTaskResumeAll();
+                        return pdFAIL;
+                    }
+                }
+            }
+
+            if( xTaskResumeAll() == pdFALSE )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        } /*lint -restore */
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xRWLockGiveRead( RWLockHandle_t xLock )
+    {
+        RWLock_t * const pxLock = xLock;
+        size_t xState;
+
+        configASSERT( pxLock );
+
+        xState = atomic_fetch_sub_explicit( &( pxLock->xState ), ( size_t ) 1, memory_order_release );
+
+        /* The lock must be held for reading. */
+        configASSERT( ( xState & rwlockREADER_COUNT_MASK ) != ( size_t ) 0 );
+
+        /* Only the last reader to leave has to look for a blocked writer. */
+        if( ( ( xState & rwlockREADER_COUNT_MASK ) == ( size_t ) 1 ) &&
+            ( ( xState & rwlockWRITERS_WAITING_BIT ) != ( size_t ) 0 ) )
+        {
+            vTaskSuspendAll();
+            {
+                prvUnblockWaitingTasks( pxLock );
+            }
+            ( void ) xTaskResumeAll();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xRWLockTakeWrite( RWLockHandle_t xLock,
+                                 TickType_t xTicksToWait )
+    {
+        RWLock_t * const pxLock = xLock;
+        size_t xState = 0;
+        TimeOut_t xTimeOut;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xInheritanceOccurred = pdFALSE;
+
+        configASSERT( pxLock );
+
+        /* Cannot block if the scheduler is suspended. */
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+        #endif
+
+        /* Take the lock without suspending the scheduler if nothing holds it
+         * and nothing is waiting for it.  The critical section publishes the
+         * writer with the writer bit - were this task preempted between the
+         * two, a reader of higher priority would block without raising the
+         * priority of this task. */
+        taskENTER_CRITICAL();
+        {
+            if( atomic_compare_exchange_strong_explicit( &( pxLock->xState ), &xState, rwlockWRITER_BIT,
+                                                         memory_order_acquire, memory_order_relaxed ) != false )
+            {
+                pxLock->xWriter = pvTaskIncrementMutexHeldCount();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xState == ( size_t ) 0 )
+        {
+            return pdPASS;
+        }
+
+        /*lint -save -e904  This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            vTaskSuspendAll();
+            {
+                if( pxLock->xWriter == xTaskGetCurrentTaskHandle() )
+                {
+                    /* The lock can only have been handed to this task while it
+                     * was blocked, which it cannot have been on the first pass.
+                     * Otherwise the task already held the lock for writing, and
+                     * the lock is not recursive. */
+                    configASSERT( xEntryTimeSet != pdFALSE );
+
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        ( void ) xTaskResumeAll();
+                        return pdFAIL;
+                    }
+
+                    /* Already counted as a mutex held by vTaskHandOverMutex(). */
+                    ( void ) xTaskResumeAll();
+                    return pdPASS;
+                }
+
+                prvUnblockWaitingTasks( pxLock );
+                xState = atomic_load_explicit( &( pxLock->xState ), memory_order_relaxed );
+
+                if( ( xState & ( rwlockWRITER_BIT | rwlockREADER_COUNT_MASK ) ) == ( size_t ) 0 )
+                {
+                    ( void ) atomic_fetch_or_explicit( &( pxLock->xState ), rwlockWRITER_BIT, memory_order_acquire );
+                    pxLock->xWriter = pvTaskIncrementMutexHeldCount();
+                    ( void ) xTaskResumeAll();
+                    return pdPASS;
+                }
+                else if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    ( void ) xTaskResumeAll();
+                    return pdFAIL;
+                }
+                else
+                {
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                    {
+                        configASSERT( ( ( atomic_load_explicit( &( pxLock->xState ), memory_order_relaxed ) & rwlockWRITER_BIT ) == ( size_t ) 0 ) ==
+                                      ( pxLock->xWriter == NULL ) );
+
+                        if( pxLock->xWriter != NULL )
+                        {
+                            taskENTER_CRITICAL();
+                            {
+                                xInheritanceOccurred |= xTaskPriorityInherit( pxLock->xWriter );
+                            }
+                            taskEXIT_CRITICAL();
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        /* Stop new readers taking the lock on the fast path,
+                         * and make the last reader to leave look for this
+                         * task. */
+                        ( void ) atomic_fetch_or_explicit( &( pxLock->xState ), rwlockWRITERS_WAITING_BIT, memory_order_relaxed );
+                        vTaskPlaceOnEventList( &( pxLock->xTasksWaitingToWrite ), xTicksToWait );
+                    }
+                    else
+                    {
+                        /* This task may have been holding back readers with a
+                         * lower priority, which can now take the lock. */
+                        prvUnblockWaitingTasks( pxLock );
+
+                        if( xInheritanceOccurred != pdFALSE )
+                        {
+                            prvDisinheritAfterTimeout( pxLock );
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+
+                        ( void ) xTaskResumeAll();
+                        return pdFAIL;
+                    }
+                }
+            }
+
+            if( xTaskResumeAll() == pdFALSE )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        } /*lint -restore */
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xRWLockGiveWrite( RWLockHandle_t xLock )
+    {
+        RWLock_t * const pxLock = xLock;
+        BaseType_t xYieldRequired;
+        TaskHandle_t xCurrentTask;
+        size_t xState = rwlockWRITER_BIT;
+
+        configASSERT( pxLock );
+
+        xCurrentTask = xTaskGetCurrentTaskHandle();
+
+        /* Only the task that holds the lock for writing can give it. */
+        configASSERT( pxLock->xWriter == xCurrentTask );
+
+        if( pxLock->xWriter != xCurrentTask )
+        {
+            return pdFAIL; /*lint !e904 Early return for invalid use. */
+        }
+
+        /* Give the lock back without suspending the scheduler if no task is
+         * waiting for it - nothing else can change xState while it is held for
+         * writing and no writer is waiting.  xWriter is cleared with the writer
+         * bit, in the same critical section, for the reason given in
+         * xRWLockTakeWrite(). */
+        taskENTER_CRITICAL();
+        {
+            if( atomic_compare_exchange_strong_explicit( &( pxLock->xState ), &xState, ( size_t ) 0,
+                                                         memory_order_release, memory_order_relaxed ) != false )
+            {
+                pxLock->xWriter = NULL;
+
+                /* Still required to decrement the count of mutexes held, and
+                 * to return to the base priority if a reader that has since
+                 * timed out raised the priority of this task. */
+                xYieldRequired = xTaskPriorityDisinherit( xCurrentTask );
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xState == rwlockWRITER_BIT )
+        {
+            if( xYieldRequired != pdFALSE )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            vTaskSuspendAll();
+            {
+                pxLock->xWriter = NULL;
+                ( void ) atomic_fetch_and_explicit( &( pxLock->xState ), ~rwlockWRITER_BIT, memory_order_release );
+
+                /* Return to the base priority if a waiting task raised the
+                 * priority of this task, and this task holds no mutexes. */
+                taskENTER_CRITICAL();
+                {
+                    xYieldRequired = xTaskPriorityDisinherit( xCurrentTask );
+                }
+                taskEXIT_CRITICAL();
+
+                prvUnblockWaitingTasks( pxLock );
+            }
+
+            if( ( xTaskResumeAll() == pdFALSE ) && ( xYieldRequired != pdFALSE ) )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewRWLock( RWLock_t * const pxLock )
+    {
+        atomic_init( &( pxLock->xState ), ( size_t ) 0 );
+        pxLock->xWriter = NULL;
+        vListInitialise( &( pxLock->xTasksWaitingToRead ) );
+        vListInitialise( &( pxLock->xTasksWaitingToWrite ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReaderCanEnter( RWLock_t * const pxLock )
+    {
+        BaseType_t xReturn;
+
+        if( ( atomic_load_explicit( &( pxLock->xState ), memory_order_relaxed ) & rwlockWRITER_BIT ) != ( size_t ) 0 )
+        {
+            xReturn = pdFALSE;
+        }
+        else if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE )
+        {
+            xReturn = pdTRUE;
+        }
+        else if( rwlockPRIORITY_ITEM_VALUE( uxTaskPriorityGet( NULL ) ) < listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) ) )
+        {
+            /* The calling task has a higher priority than every waiting
+             * writer. */
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnblockWaitingTasks( RWLock_t * const pxLock )
+    {
+        size_t xState;
+
+        xState = atomic_load_explicit( &( pxLock->xState ), memory_order_relaxed );
+
+        /* Nothing can be unblocked while a task holds the lock for writing - the
+         * writer unblocks the waiting tasks when it gives the lock back. */
+        if( ( xState & rwlockWRITER_BIT ) == ( size_t ) 0 )
+        {
+            /* xTaskRemoveFromEventList() must be called from a critical section
+             * even though the scheduler is suspended. */
+            taskENTER_CRITICAL();
+            {
+                /* The head of each event list holds its highest priority task,
+                 * and a lower item value means a higher priority. */
+                if( ( ( xState & rwlockREADER_COUNT_MASK ) == ( size_t ) 0 ) &&
+                    ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) == pdFALSE ) &&
+                    ( ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) != pdFALSE ) ||
+                      ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) ) <= listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToRead ) ) ) ) )
+                {
+                    /* Hand the lock to the highest priority writer, which finds
+                     * it already holds the lock when it runs. */
+                    pxLock->xWriter = listGET_OWNER_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) );
+                    ( void ) xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToWrite ) );
+                    ( void ) atomic_fetch_or_explicit( &( pxLock->xState ), rwlockWRITER_BIT, memory_order_relaxed );
+
+                    /* The tasks still waiting blocked before the writer held
+                     * the lock, so did not raise its priority as they would
+                     * have done had they blocked after. */
+                    vTaskHandOverMutex( pxLock->xWriter, prvGetHighestWaitingPriority( pxLock ) );
+                }
+                else
+                {
+                    /* Unblock the readers with a higher priority than every
+                     * waiting writer, which is all of them if no writer is
+                     * waiting. */
+                    while( ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) == pdFALSE ) &&
+                           ( ( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE ) ||
+                             ( listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToRead ) ) < listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) ) ) ) )
+                    {
+                        ( void ) xTaskRemoveFromEventList( &( pxLock->xTasksWaitingToRead ) );
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) != pdFALSE )
+        {
+            ( void ) atomic_fetch_and_explicit( &( pxLock->xState ), ~rwlockWRITERS_WAITING_BIT, memory_order_relaxed );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) != pdFALSE )
+        {
+            ( void ) atomic_fetch_and_explicit( &( pxLock->xState ), ~rwlockREADERS_WAITING_BIT, memory_order_relaxed );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvDisinheritAfterTimeout( RWLock_t * const pxLock )
+    {
+        if( pxLock->xWriter != NULL )
+        {
+            taskENTER_CRITICAL();
+            {
+                vTaskPriorityDisinheritAfterTimeout( pxLock->xWriter, prvGetHighestWaitingPriority( pxLock ) );
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvGetHighestWaitingPriority( RWLock_t * const pxLock )
+    {
+        UBaseType_t uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+        TickType_t xItemValue;
+
+        /* The head of each event list holds its highest priority task. */
+        if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToRead ) ) == pdFALSE )
+        {
+            xItemValue = listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToRead ) );
+            uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) xItemValue;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( listLIST_IS_EMPTY( &( pxLock->xTasksWaitingToWrite ) ) == pdFALSE )
+        {
+            xItemValue = listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxLock->xTasksWaitingToWrite ) );
+
+            if( ( ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) xItemValue ) > uxHighestPriorityOfWaitingTasks )
+            {
+                uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) xItemValue;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return uxHighestPriorityOfWaitingTasks;
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include readers-writer lock functionality.  If you want to include
+ * readers-writer locks then ensure configUSE_RW_LOCKS is set to 1 in
+ * FreeRTOSConfig.h. */
+#endif /* configUSE_RW_LOCKS == 1 */
@@ -0,0 +1,711 @@
+/*
+ * FreeRTOS Kernel V10.6.1
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "spsc_queue.h"
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include SPSC queue functionality.  This #if is closed at the very bottom of
+ * this file.  If you want to include SPSC queues then ensure
+ * configUSE_SPSC_QUEUES is set to 1 in FreeRTOSConfig.h. */
+#if ( configUSE_SPSC_QUEUES == 1 )
+
+    #include <stdatomic.h>
+
+    #if ( configUSE_PREEMPTION == 0 )
+
+/* If the cooperative scheduler is being used then a yield should not be
+ * performed just because a higher priority task has been woken. */
+        #define spscYIELD_IF_USING_PREEMPTION()
+    #else
+        #define spscYIELD_IF_USING_PREEMPTION()    portYIELD_WITHIN_API()
+    #endif
+
+/*
+ * The read and write positions run from 0 to ( 2 * xLength ) - 1 so a full
+ * queue can be told apart from an empty one without leaving a slot unused, and
+ * without a division on each access.  The slot a position refers to is the
+ * position modulo xLength.
+ *
+ * xHead is only written by the producer and xTail only by the consumer.  Each
+ * side publishes its position with a sequentially consistent store, then
+ * checks whether the other side is blocked.  The blocking side sets its
+ * waiting flag then checks the position again before it blocks.  Sequential
+ * consistency guarantees at least one side sees the other's store, so a
+ * wake up cannot be lost.
+ *
+ * A blocked task waits on the queue's own event list, as it would on a queue
+ * created with xQueueCreate(), so the task notifications of the producer and
+ * the consumer are left free for the application.  The event lists are only
+ * accessed from critical sections, which is what allows them to be used from
+ * interrupts.  The waiting flags let the side that did not block check for a
+ * blocked task without entering a critical section.
+ */
+    typedef struct SPSCQueueDefinition
+    {
+        atomic_size_t xHead;                         /**< The position the next item will be written to. */
+        atomic_size_t xTail;                         /**< The position the next item will be read from. */
+        _Atomic( BaseType_t ) xReceiverWaiting;      /**< Set to pdTRUE while the consumer is, or is about to be, blocked waiting for an item. */
+        _Atomic( BaseType_t ) xSenderWaiting;        /**< Set to pdTRUE while the producer is, or is about to be, blocked waiting for space. */
+        List_t xTasksWaitingToReceive;               /**< Holds the consumer while it is blocked waiting for an item. */
+        List_t xTasksWaitingToSend;                  /**< Holds the producer while it is blocked waiting for space. */
+        uint8_t * pucStorage;                        /**< The queue storage area. */
+        size_t xLength;                              /**< The number of items the queue can hold. */
+        size_t xItemSize;                            /**< The size of each item. */
+        uint8_t ucStaticallyAllocated;               /**< Set to pdTRUE if the queue was created by xSPSCQueueCreateStatic(). */
+    } SPSCQueue_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by both the create functions to initialise a new queue.
+ */
+    static void prvInitialiseNewSPSCQueue( SPSCQueue_t * const pxQueue,
+                                           uint8_t * const pucStorage,
+                                           UBaseType_t uxQueueLength,
+                                           UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the number of items between xTail and xHead.
+ */
+    static size_t prvItemsBetween( const SPSCQueue_t * const pxQueue,
+                                   size_t xTail,
+                                   size_t xHead ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copy an item to or from the queue if there is space or an item, without
+ * entering a critical section.
+ *
+ * @return pdTRUE if an item was copied, otherwise pdFALSE.
+ */
+    static BaseType_t prvWriteItem( SPSCQueue_t * const pxQueue,
+                                    const void * pvItemToQueue ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvReadItem( SPSCQueue_t * const pxQueue,
+                                   void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return pdTRUE if the queue is full, or empty, when seen from the producer,
+ * or the consumer, respectively.
+ */
+    static BaseType_t prvIsQueueFull( const SPSCQueue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+    static BaseType_t prvIsQueueEmpty( const SPSCQueue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+
+/*
+ * Block the calling task on pxWaitingList for up to xTicksToWait ticks, unless
+ * the queue stopped being full (if xIsProducer is pdTRUE) or empty (if it is
+ * pdFALSE) before the task set *pxWaiting.
+ */
+    static void prvBlockOnQueue( SPSCQueue_t * const pxQueue,
+                                 _Atomic( BaseType_t ) * pxWaiting,
+                                 List_t * const pxWaitingList,
+                                 BaseType_t xIsProducer,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * If a task is blocked on the other side of the queue, as shown by *pxWaiting,
+ * remove it from pxWaitingList.
+ */
+    static void prvUnblockWaitingTask( _Atomic( BaseType_t ) * pxWaiting,
+                                       List_t * const pxWaitingList ) PRIVILEGED_FUNCTION;
+    static void prvUnblockWaitingTaskFromISR( _Atomic( BaseType_t ) * pxWaiting,
+                                              List_t * const pxWaitingList,
+                                              BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+        SPSCQueueHandle_t xSPSCQueueCreate( UBaseType_t uxQueueLength,
+                                            UBaseType_t uxItemSize )
+        {
+            SPSCQueue_t * pxNewQueue = NULL;
+            size_t xStorageSize;
+
+            configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+            configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+            /* Check for multiplication and addition overflow. */
+            if( ( uxQueueLength > ( UBaseType_t ) 0 ) &&
+                ( uxItemSize > ( UBaseType_t ) 0 ) &&
+                ( ( SIZE_MAX / 2U / uxQueueLength ) >= uxItemSize ) )
+            {
+                xStorageSize = ( size_t ) uxQueueLength * ( size_t ) uxItemSize;
+
+                if( ( SIZE_MAX - sizeof( SPSCQueue_t ) ) >= xStorageSize )
+                {
+                    /* The structure and the storage area are allocated in one
+                     * block, the storage area immediately after the structure. */
+                    pxNewQueue = ( SPSCQueue_t * ) pvPortMalloc( sizeof( SPSCQueue_t ) + xStorageSize ); /*lint !e9087 !e9079 see comment above. */
+
+                    if( pxNewQueue != NULL )
+                    {
+                        prvInitialiseNewSPSCQueue( pxNewQueue, ( ( uint8_t * ) pxNewQueue ) + sizeof( SPSCQueue_t ), uxQueueLength, uxItemSize ); /*lint !e9016 Pointer arithmetic allowed on char types, especially when it assists conveying intent. */
+                        pxNewQueue->ucStaticallyAllocated = pdFALSE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewQueue;
+        }
+
+    #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+        SPSCQueueHandle_t xSPSCQueueCreateStatic( UBaseType_t uxQueueLength,
+                                                  UBaseType_t uxItemSize,
+                                                  uint8_t * pucQueueStorage,
+                                                  StaticSPSCQueue_t * pxStaticQueue )
+        {
+            SPSCQueue_t * pxNewQueue = NULL;
+
+            configASSERT( pucQueueStorage );
+            configASSERT( pxStaticQueue );
+            configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+            configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+            #if ( configASSERT_DEFINED == 1 )
+            {
+                /* Sanity check that the size of the structure used to declare a
+                 * variable of type StaticSPSCQueue_t equals the size of the real
+                 * queue structure. */
+                volatile size_t xSize = sizeof( StaticSPSCQueue_t );
+                configASSERT( xSize == sizeof( SPSCQueue_t ) );
+                ( void ) xSize; /* Keeps lint quiet when configASSERT() is not defined. */
+            }
+            #endif /* configASSERT_DEFINED */
+
+            if( ( pucQueueStorage != NULL ) &&
+                ( pxStaticQueue != NULL ) &&
+                ( uxQueueLength > ( UBaseType_t ) 0 ) &&
+                ( uxItemSize > ( UBaseType_t ) 0 ) &&
+                ( ( SIZE_MAX / 2U / uxQueueLength ) >= uxItemSize ) )
+            {
+                pxNewQueue = ( SPSCQueue_t * ) pxStaticQueue; /*lint !e740 !e9087 SPSCQueue_t and StaticSPSCQueue_t are deliberately aliased, and checked by an assert. */
+                prvInitialiseNewSPSCQueue( pxNewQueue, pucQueueStorage, uxQueueLength, uxItemSize );
+                pxNewQueue->ucStaticallyAllocated = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return pxNewQueue;
+        }
+
+    #endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+    void vSPSCQueueDelete( SPSCQueueHandle_t xQueue )
+    {
+        SPSCQueue_t * pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+        configASSERT( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE );
+        configASSERT( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE );
+
+        if( pxQueue->ucStaticallyAllocated == ( uint8_t ) pdFALSE )
+        {
+            #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+            {
+                /* Both the structure and the storage area were allocated using
+                 * a single call to pvPortMalloc(), hence only one call to
+                 * vPortFree() is required. */
+                vPortFree( ( void * ) pxQueue );
+            }
+            #endif
+        }
+        else
+        {
+            /* The structure and storage area were not allocated dynamically and
+             * cannot be freed - just scrub the structure so future use will
+             * assert. */
+            ( void ) memset( ( void * ) pxQueue, 0x00, sizeof( SPSCQueue_t ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xSPSCQueueSend( SPSCQueueHandle_t xQueue,
+                               const void * const pvItemToQueue,
+                               TickType_t xTicksToWait )
+    {
+        SPSCQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+        TimeOut_t xTimeOut;
+
+        configASSERT( pxQueue );
+        configASSERT( pvItemToQueue );
+
+        /* The fast path - there is space so no need to enter the kernel. */
+        xReturn = prvWriteItem( pxQueue, pvItemToQueue );
+
+        if( ( xReturn == pdFALSE ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+
+            do
+            {
+                prvBlockOnQueue( pxQueue, &( pxQueue->xSenderWaiting ), &( pxQueue->xTasksWaitingToSend ), pdTRUE, xTicksToWait );
+                xReturn = prvWriteItem( pxQueue, pvItemToQueue );
+            } while( ( xReturn == pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xReturn != pdFALSE )
+        {
+            prvUnblockWaitingTask( &( pxQueue->xReceiverWaiting ), &( pxQueue->xTasksWaitingToReceive ) );
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = errQUEUE_FULL;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xSPSCQueueSendFromISR( SPSCQueueHandle_t xQueue,
+                                      const void * const pvItemToQueue,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        SPSCQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+
+        configASSERT( pxQueue );
+        configASSERT( pvItemToQueue );
+
+        if( prvWriteItem( pxQueue, pvItemToQueue ) != pdFALSE )
+        {
+            prvUnblockWaitingTaskFromISR( &( pxQueue->xReceiverWaiting ), &( pxQueue->xTasksWaitingToReceive ), pxHigherPriorityTaskWoken );
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = errQUEUE_FULL;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xSPSCQueueReceive( SPSCQueueHandle_t xQueue,
+                                  void * const pvBuffer,
+                                  TickType_t xTicksToWait )
+    {
+        SPSCQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+        TimeOut_t xTimeOut;
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+
+        /* The fast path - there is an item so no need to enter the kernel. */
+        xReturn = prvReadItem( pxQueue, pvBuffer );
+
+        if( ( xReturn == pdFALSE ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+
+            do
+            {
+                prvBlockOnQueue( pxQueue, &( pxQueue->xReceiverWaiting ), &( pxQueue->xTasksWaitingToReceive ), pdFALSE, xTicksToWait );
+                xReturn = prvReadItem( pxQueue, pvBuffer );
+            } while( ( xReturn == pdFALSE ) && ( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xReturn != pdFALSE )
+        {
+            prvUnblockWaitingTask( &( pxQueue->xSenderWaiting ), &( pxQueue->xTasksWaitingToSend ) );
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = errQUEUE_EMPTY;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xSPSCQueueReceiveFromISR( SPSCQueueHandle_t xQueue,
+                                         void * const pvBuffer,
+                                         BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        SPSCQueue_t * const pxQueue = xQueue;
+        BaseType_t xReturn;
+
+        configASSERT( pxQueue );
+        configASSERT( pvBuffer );
+
+        if( prvReadItem( pxQueue, pvBuffer ) != pdFALSE )
+        {
+            prvUnblockWaitingTaskFromISR( &( pxQueue->xSenderWaiting ), &( pxQueue->xTasksWaitingToSend ), pxHigherPriorityTaskWoken );
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = errQUEUE_EMPTY;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxSPSCQueueMessagesWaiting( SPSCQueueHandle_t xQueue )
+    {
+        SPSCQueue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+
+        return ( UBaseType_t ) prvItemsBetween( pxQueue, atomic_load( &( pxQueue->xTail ) ), atomic_load( &( pxQueue->xHead ) ) );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvInitialiseNewSPSCQueue( SPSCQueue_t * const pxQueue,
+                                           uint8_t * const pucStorage,
+                                           UBaseType_t uxQueueLength,
+                                           UBaseType_t uxItemSize )
+    {
+        atomic_init( &( pxQueue->xHead ), ( size_t ) 0 );
+        atomic_init( &( pxQueue->xTail ), ( size_t ) 0 );
+        atomic_init( &( pxQueue->xReceiverWaiting ), pdFALSE );
+        atomic_init( &( pxQueue->xSenderWaiting ), pdFALSE );
+        vListInitialise( &( pxQueue->xTasksWaitingToReceive ) );
+        vListInitialise( &( pxQueue->xTasksWaitingToSend ) );
+        pxQueue->pucStorage = pucStorage;
+        pxQueue->xLength = ( size_t ) uxQueueLength;
+        pxQueue->xItemSize = ( size_t ) uxItemSize;
+    }
+/*-----------------------------------------------------------*/
+
+    static size_t prvItemsBetween( const SPSCQueue_t * const pxQueue,
+                                   size_t xTail,
+                                   size_t xHead )
+    {
+        size_t xReturn;
+
+        if( xHead >= xTail )
+        {
+            xReturn = xHead - xTail;
+        }
+        else
+        {
+            xReturn = ( ( 2U * pxQueue->xLength ) - xTail ) + xHead;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvWriteItem( SPSCQueue_t * const pxQueue,
+                                    const void * pvItemToQueue )
+    {
+        /* Only the producer writes xHead, so it can be read without ordering.
+         * Acquire xTail so the consumer has finished with a slot before it is
+         * overwritten. */
+        const size_t xHead = atomic_load_explicit( &( pxQueue->xHead ), memory_order_relaxed );
+        const size_t xTail = atomic_load_explicit( &( pxQueue->xTail ), memory_order_acquire );
+        size_t xSlot, xNextHead;
+        BaseType_t xReturn;
+
+        if( prvItemsBetween( pxQueue, xTail, xHead ) < pxQueue->xLength )
+        {
+            xSlot = ( xHead >= pxQueue->xLength ) ? ( xHead - pxQueue->xLength ) : xHead;
+            ( void ) memcpy( ( void * ) &( pxQueue->pucStorage[ xSlot * pxQueue->xItemSize ] ), pvItemToQueue, pxQueue->xItemSize ); /*lint !e9087 Cast to void required by function signature. */
+
+            xNextHead = xHead + 1U;
+
+            if( xNextHead == ( 2U * pxQueue->xLength ) )
+            {
+                xNextHead = 0U;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Publish the item. */
+            atomic_store( &( pxQueue->xHead ), xNextHead );
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReadItem( SPSCQueue_t * const pxQueue,
+                                   void * pvBuffer )
+    {
+        /* Only the consumer writes xTail, so it can be read without ordering.
+         * Acquire xHead so the item is seen once its position is. */
+        const size_t xTail = atomic_load_explicit( &( pxQueue->xTail ), memory_order_relaxed );
+        const size_t xHead = atomic_load_explicit( &( pxQueue->xHead ), memory_order_acquire );
+        size_t xSlot, xNextTail;
+        BaseType_t xReturn;
+
+        if( xHead != xTail )
+        {
+            xSlot = ( xTail >= pxQueue->xLength ) ? ( xTail - pxQueue->xLength ) : xTail;
+            ( void ) memcpy( pvBuffer, ( const void * ) &( pxQueue->pucStorage[ xSlot * pxQueue->xItemSize ] ), pxQueue->xItemSize ); /*lint !e9087 Cast to void required by function signature. */
+
+            xNextTail = xTail + 1U;
+
+            if( xNextTail == ( 2U * pxQueue->xLength ) )
+            {
+                xNextTail = 0U;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Free the slot. */
+            atomic_store( &( pxQueue->xTail ), xNextTail );
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvIsQueueFull( const SPSCQueue_t * const pxQueue )
+    {
+        BaseType_t xReturn;
+
+        if( prvItemsBetween( pxQueue, atomic_load( &( pxQueue->xTail ) ), atomic_load_explicit( &( pxQueue->xHead ), memory_order_relaxed ) ) == pxQueue->xLength )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvIsQueueEmpty( const SPSCQueue_t * const pxQueue )
+    {
+        BaseType_t xReturn;
+
+        if( atomic_load( &( pxQueue->xHead ) ) == atomic_load_explicit( &( pxQueue->xTail ), memory_order_relaxed ) )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvBlockOnQueue( SPSCQueue_t * const pxQueue,
+                                 _Atomic( BaseType_t ) * pxWaiting,
+                                 List_t * const pxWaitingList,
+                                 BaseType_t xIsProducer,
+                                 TickType_t xTicksToWait )
+    {
+        BaseType_t xMustBlock;
+
+        vTaskSuspendAll();
+        {
+            /* The other side removes the task from the list from a critical
+             * section, which may be in an interrupt, so the task must be
+             * placed on the list from one too. */
+            taskENTER_CRITICAL();
+            {
+                /* Register as waiting and look again, in case the other side
+                 * sent an item or made space before it could see the
+                 * registration. */
+                atomic_store( pxWaiting, pdTRUE );
+
+                if( xIsProducer != pdFALSE )
+                {
+                    xMustBlock = prvIsQueueFull( pxQueue );
+                }
+                else
+                {
+                    xMustBlock = prvIsQueueEmpty( pxQueue );
+                }
+
+                if( xMustBlock != pdFALSE )
+                {
+                    vTaskPlaceOnEventList( pxWaitingList, xTicksToWait );
+                }
+                else
+                {
+                    atomic_store( pxWaiting, pdFALSE );
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if( xTaskResumeAll() == pdFALSE )
+        {
+            portYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Either the other side removed the task from the list and cleared the
+         * flag, or the block time expired and the kernel removed the task from
+         * the list.  Only the flag can still need clearing. */
+        atomic_store( pxWaiting, pdFALSE );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnblockWaitingTask( _Atomic( BaseType_t ) * pxWaiting,
+                                       List_t * const pxWaitingList )
+    {
+        /* Only enter the kernel if the other side is blocked. */
+        if( atomic_load( pxWaiting ) != pdFALSE )
+        {
+            taskENTER_CRITICAL();
+            {
+                atomic_store( pxWaiting, pdFALSE );
+
+                if( listLIST_IS_EMPTY( pxWaitingList ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( pxWaitingList ) != pdFALSE )
+                    {
+                        /* The unblocked task has a priority higher than our
+                         * own so yield immediately.  Yes it is ok to do this
+                         * from within the critical section - the kernel takes
+                         * care of that. */
+                        spscYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvUnblockWaitingTaskFromISR( _Atomic( BaseType_t ) * pxWaiting,
+                                              List_t * const pxWaitingList,
+                                              BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        UBaseType_t uxSavedInterruptStatus;
+
+        if( atomic_load( pxWaiting ) != pdFALSE )
+        {
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                atomic_store( pxWaiting, pdFALSE );
+
+                if( listLIST_IS_EMPTY( pxWaitingList ) == pdFALSE )
+                {
+                    if( ( xTaskRemoveFromEventList( pxWaitingList ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/* This entire source file will be skipped if the application is not configured
+ * to include SPSC queue functionality.  If you want to include SPSC queues then
+ * ensure configUSE_SPSC_QUEUES is set to 1 in FreeRTOSConfig.h. */
+#endif /* configUSE_SPSC_QUEUES == 1 */
@@ -54,6 +54,10 @@
  * correct privileged Vs unprivileged linkage and placement. */
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
 
+#if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+    #include <stdatomic.h>
+#endif
+
 /* If the user has not provided application specific Rx notification macros,
  * or #defined the notification macros away, then provide default implementations
  * that uses task notifications. */
@@ -217,6 +221,29 @@
 #define sbFLAGS_IS_MESSAGE_BUFFER          ( ( uint8_t ) 1 ) /* Set if the stream buffer was created as a message buffer, in which case it holds discrete messages rather than a stream. */
 #define sbFLAGS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 2 ) /* Set if the stream buffer was created using statically allocated memory. */
 
+/* Message length written in place of a real length by vStreamBufferCommitMessage()
+ * when the message had to start at the beginning of the buffer to remain
+ * contiguous.  The reader skips from the marker to the end of the buffer. */
+#define sbMESSAGE_PADDING_MARKER           ( ( configMESSAGE_BUFFER_LENGTH_TYPE ) ~( ( configMESSAGE_BUFFER_LENGTH_TYPE ) 0 ) )
+
+/* A host writer, see xStreamBufferSendFromHost(), runs truly in parallel with
+ * the reading task, so the indexes must be published with release ordering and
+ * read with acquire ordering.  Task and interrupt writers do not need this as
+ * they run on the same core as the reader. */
+#if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+    #define sbPUBLISH_INDEX()     atomic_thread_fence( memory_order_release )
+    #define sbACQUIRE_INDEX()     atomic_thread_fence( memory_order_acquire )
+    #define sbNO_HOST_DOORBELL    ( ~( UBaseType_t ) 0 )
+
+/* The reading task registers itself as waiting while a host writer may be
+ * looking for it, so the handle is read and written atomically. */
+    typedef _Atomic ( TaskHandle_t ) sbWaitingTask_t;
+#else
+    typedef TaskHandle_t sbWaitingTask_t;
+    #define sbPUBLISH_INDEX()
+    #define sbACQUIRE_INDEX()
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Structure that hold state information on the buffer. */
@@ -226,7 +253,7 @@ typedef struct StreamBufferDef_t                 /*lint !e9058 Style convention
     volatile size_t xHead;                       /* Index to the next item to write within the buffer. */
     size_t xLength;                              /* The length of the buffer pointed to by pucBuffer. */
     size_t xTriggerLevelBytes;                   /* The number of bytes that must be in the stream buffer before a task that is waiting for data is unblocked. */
-    volatile TaskHandle_t xTaskWaitingToReceive; /* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
+    volatile sbWaitingTask_t xTaskWaitingToReceive; /* Holds the handle of a task waiting for data, or NULL if no tasks are waiting. */
     volatile TaskHandle_t xTaskWaitingToSend;    /* Holds the handle of a task waiting to send data to a message buffer that is full. */
     uint8_t * pucBuffer;                         /* Points to the buffer itself - that is - the RAM that stores the data passed through the buffer. */
     uint8_t ucFlags;
@@ -239,6 +266,12 @@ typedef struct StreamBufferDef_t                 /*lint !e9058 Style convention
         StreamBufferCallbackFunction_t pxSendCompletedCallback;    /* Optional callback called on send complete. sbSEND_COMPLETED is called if this is NULL. */
         StreamBufferCallbackFunction_t pxReceiveCompletedCallback; /* Optional callback called on receive complete.  sbRECEIVE_COMPLETED is called if this is NULL. */
     #endif
+
+    #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+        UBaseType_t uxHostDoorbell;         /* The interrupt a host writer raises to wake the reading task. */
+        UBaseType_t uxHostKernelInstance;   /* The kernel instance uxHostDoorbell belongs to. */
+        atomic_size_t xHostDoorbellPending; /* Non-zero from when a host writer raises uxHostDoorbell until its handler runs. */
+    #endif
 } StreamBuffer_t;
 
 /*
@@ -304,6 +337,99 @@ static size_t prvReadBytesFromBuffer( StreamBuffer_t * pxStreamBuffer,
                                       size_t xCount,
                                       size_t xTail ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+/*
+ * Returns the index from which the length of the next message in a message
+ * buffer should be read.  That is xTail, unless xTail holds the padding marker
+ * written by vStreamBufferCommitMessage(), in which case the message starts at
+ * the beginning of the buffer.
+ */
+    static size_t prvSkipMessagePadding( StreamBuffer_t * pxStreamBuffer,
+                                         size_t xTail ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+
+#if ( ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 ) || ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 ) )
+
+/*
+ * Blocks the calling task for up to xTicksToWait ticks until at least
+ * xRequiredSpace bytes are free, then returns the number of free bytes - which
+ * will be less than xRequiredSpace if the block time expired first.
+ */
+    static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                                   size_t xRequiredSpace,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Blocks the calling task for up to xTicksToWait ticks until more than
+ * xBytesToStoreMessageLength bytes are in the buffer, then returns the number
+ * of bytes in the buffer.
+ */
+    static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+                                  size_t xBytesToStoreMessageLength,
+                                  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+#endif /* ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 ) || ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 ) */
+
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+/*
+ * Describes the xCount bytes starting at index xIndex as at most two spans
+ * within the buffer's data storage area - the second span only being used if
+ * the bytes wrap around to the start of the storage area.
+ */
+    static void prvGetSpans( const StreamBuffer_t * const pxStreamBuffer,
+                             size_t xIndex,
+                             size_t xCount,
+                             StreamBufferSpans_t * const pxSpans ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+/*
+ * Returns the total length of xFragmentCount fragments.
+ */
+    static size_t prvFragmentsLength( const StreamBufferFragment_t * pxFragments,
+                                      size_t xFragmentCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the space xDataLengthBytes bytes will need in the buffer, in the same
+ * way as xStreamBufferSend(), and clears *pxTicksToWait if it is not worth
+ * waiting for that space.
+ */
+    static size_t prvRequiredSpace( const StreamBuffer_t * const pxStreamBuffer,
+                                    size_t xDataLengthBytes,
+                                    TickType_t * const pxTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * The same as prvWriteMessageToBuffer(), but gathers the data from
+ * xFragmentCount fragments that total xDataLengthBytes bytes.
+ */
+    static size_t prvWriteVectorToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                          const StreamBufferFragment_t * pxFragments,
+                                          size_t xFragmentCount,
+                                          size_t xDataLengthBytes,
+                                          size_t xSpace,
+                                          size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
+
+/*
+ * Reads up to xMaxMessages messages out of a message buffer, one after another
+ * into pvRxData, by calling prvReadMessageFromBuffer() until a message does
+ * not fit.  Returns the number of messages read, and sets *pxBytesRead to
+ * their total length.
+ */
+    static size_t prvReadMessagesFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                             void * pvRxData,
+                                             size_t xBufferLengthBytes,
+                                             size_t * const pxMessageLengths,
+                                             size_t xMaxMessages,
+                                             size_t xBytesAvailable,
+                                             size_t * const pxBytesRead ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+
 /*
  * Called by both pxStreamBufferCreate() and pxStreamBufferCreateStatic() to
  * initialise the members of the newly created stream buffer structure.
@@ -545,6 +671,10 @@ BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
         UBaseType_t uxStreamBufferNumber;
     #endif
 
+    #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+        UBaseType_t uxHostDoorbell = pxStreamBuffer->uxHostDoorbell;
+    #endif
+
     configASSERT( pxStreamBuffer );
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -581,6 +711,12 @@ BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
             }
             #endif
 
+            #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+            {
+                pxStreamBuffer->uxHostDoorbell = uxHostDoorbell;
+            }
+            #endif
+
             traceSTREAM_BUFFER_RESET( xStreamBuffer );
 
             xReturn = pdPASS;
@@ -640,6 +776,8 @@ size_t xStreamBufferSpacesAvailable( StreamBufferHandle_t xStreamBuffer )
         xSpace -= pxStreamBuffer->xHead;
     } while( xOriginalTail != pxStreamBuffer->xTail );
 
+    sbACQUIRE_INDEX();
+
     xSpace -= ( size_t ) 1;
 
     if( xSpace >= pxStreamBuffer->xLength )
@@ -868,6 +1006,13 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
         /* Ensure the data length given fits within configMESSAGE_BUFFER_LENGTH_TYPE. */
         configASSERT( ( size_t ) xMessageLength == xDataLengthBytes );
 
+        #if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+        {
+            /* The largest value of the length type is reserved for padding. */
+            configASSERT( xMessageLength != sbMESSAGE_PADDING_MARKER );
+        }
+        #endif
+
         if( xSpace >= xRequiredSpace )
         {
             /* There is enough space to write both the message length and the message
@@ -892,7 +1037,9 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
     if( xDataLengthBytes != ( size_t ) 0 )
     {
         /* Write the data to the buffer. */
-        pxStreamBuffer->xHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+        xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+        sbPUBLISH_INDEX();
+        pxStreamBuffer->xHead = xNextHead;
     }
 
     return xDataLengthBytes;
@@ -939,12 +1086,33 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
              * be 0. */
             if( xBytesAvailable <= xBytesToStoreMessageLength )
             {
+                traceSTREAM_BUFFER_RECEIVE_EMPTY( xStreamBuffer );
+
                 /* Clear notification state as going to wait for data. */
                 ( void ) xTaskNotifyStateClear( NULL );
 
                 /* Should only be one reader. */
                 configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
                 pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+
+                #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+                {
+                    /* A host writer publishes its data and then looks for a waiting
+                     * task without entering the critical section, so look for data
+                     * again now that the task is visible to it. */
+                    atomic_thread_fence( memory_order_seq_cst );
+                    xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+                    if( xBytesAvailable > xBytesToStoreMessageLength )
+                    {
+                        pxStreamBuffer->xTaskWaitingToReceive = NULL;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif
             }
             else
             {
@@ -1021,7 +1189,15 @@ size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
             /* The number of bytes available is greater than the number of bytes
              * required to hold the length of the next message, so another message
              * is available. */
-            ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempReturn, sbBYTES_TO_STORE_MESSAGE_LENGTH, pxStreamBuffer->xTail );
+            #if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+            {
+                ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempReturn, sbBYTES_TO_STORE_MESSAGE_LENGTH, prvSkipMessagePadding( pxStreamBuffer, pxStreamBuffer->xTail ) );
+            }
+            #else
+            {
+                ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempReturn, sbBYTES_TO_STORE_MESSAGE_LENGTH, pxStreamBuffer->xTail );
+            }
+            #endif
             xReturn = ( size_t ) xTempReturn;
         }
         else
@@ -1100,181 +1276,826 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvReadMessageFromBuffer( StreamBuffer_t * pxStreamBuffer,
-                                        void * pvRxData,
-                                        size_t xBufferLengthBytes,
-                                        size_t xBytesAvailable )
-{
-    size_t xCount, xNextMessageLength;
-    configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
-    size_t xNextTail = pxStreamBuffer->xTail;
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
 
-    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    size_t xStreamBufferReserve( StreamBufferHandle_t xStreamBuffer,
+                                 size_t xBytesWanted,
+                                 StreamBufferSpans_t * const pxSpans,
+                                 TickType_t xTicksToWait )
     {
-        /* A discrete message is being received.  First receive the length
-         * of the message. */
-        xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextTail );
-        xNextMessageLength = ( size_t ) xTempNextMessageLength;
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xSpace;
 
-        /* Reduce the number of bytes available by the number of bytes just
-         * read out. */
-        xBytesAvailable -= sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        configASSERT( pxStreamBuffer );
+        configASSERT( pxSpans );
 
-        /* Check there is enough space in the buffer provided by the
-         * user. */
-        if( xNextMessageLength > xBufferLengthBytes )
+        /* A message must not be split, so message buffers use
+         * pvStreamBufferReserveMessage() instead. */
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+        /* As with xStreamBufferSend(), it is acceptable to obtain less space
+         * than wanted, but never wait for more than the buffer can hold. */
+        xSpace = prvWaitForSpace( pxStreamBuffer, configMIN( xBytesWanted, pxStreamBuffer->xLength - ( size_t ) 1 ), xTicksToWait );
+        xSpace = configMIN( xSpace, xBytesWanted );
+
+        prvGetSpans( pxStreamBuffer, pxStreamBuffer->xHead, xSpace, pxSpans );
+
+        return xSpace;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    void vStreamBufferCommit( StreamBufferHandle_t xStreamBuffer,
+                              size_t xBytesWritten )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xNextHead;
+
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+        /* Only space returned by xStreamBufferReserve() can be committed, and
+         * the reader can only ever have freed more since then. */
+        configASSERT( xBytesWritten <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+        if( xBytesWritten != ( size_t ) 0 )
         {
-            /* The user has provided insufficient space to read the message. */
-            xNextMessageLength = 0;
+            xNextHead = pxStreamBuffer->xHead + xBytesWritten;
+
+            if( xNextHead >= pxStreamBuffer->xLength )
+            {
+                xNextHead -= pxStreamBuffer->xLength;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxStreamBuffer->xHead = xNextHead;
+
+            traceSTREAM_BUFFER_SEND( xStreamBuffer, xBytesWritten );
+
+            /* Was a task waiting for the data? */
+            if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+            {
+                prvSEND_COMPLETED( pxStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
         else
         {
             mtCOVERAGE_TEST_MARKER();
         }
     }
-    else
-    {
-        /* A stream of bytes is being received (as opposed to a discrete
-         * message), so read as many bytes as possible. */
-        xNextMessageLength = xBufferLengthBytes;
-    }
 
-    /* Use the minimum of the wanted bytes and the available bytes. */
-    xCount = configMIN( xNextMessageLength, xBytesAvailable );
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
 
-    if( xCount != ( size_t ) 0 )
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    void * pvStreamBufferReserveMessage( StreamBufferHandle_t xStreamBuffer,
+                                         size_t xMessageLength,
+                                         TickType_t xTicksToWait )
     {
-        /* Read the actual data and update the tail to mark the data as officially consumed. */
-        pxStreamBuffer->xTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xCount, xNextTail ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
-    }
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xHead, xPayload, xRequiredSpace, xSpace;
+        void * pvReturn = NULL;
 
-    return xCount;
-}
-/*-----------------------------------------------------------*/
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+        configASSERT( xMessageLength > ( size_t ) 0 );
 
-BaseType_t xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer )
-{
-    const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-    BaseType_t xReturn;
-    size_t xTail;
+        /* Only the writer moves xHead, so the position of the message cannot
+         * change while waiting for space. */
+        xHead = pxStreamBuffer->xHead;
+        xPayload = xHead + sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        xRequiredSpace = sbBYTES_TO_STORE_MESSAGE_LENGTH + xMessageLength;
 
-    configASSERT( pxStreamBuffer );
+        if( xPayload >= pxStreamBuffer->xLength )
+        {
+            /* The length wraps, so the message itself starts near the beginning
+             * of the buffer and cannot wrap. */
+            xPayload -= pxStreamBuffer->xLength;
+        }
+        else if( ( xPayload + xMessageLength ) > pxStreamBuffer->xLength )
+        {
+            /* The message would wrap.  Instead it is placed at the start of the
+             * buffer and the bytes from xHead to the end of the buffer are
+             * given up as padding. */
+            xPayload = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+            xRequiredSpace += pxStreamBuffer->xLength - xHead;
+
+            /* Overflow? */
+            configASSERT( xRequiredSpace > xMessageLength );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-    /* True if no bytes are available. */
-    xTail = pxStreamBuffer->xTail;
+        if( xRequiredSpace > ( pxStreamBuffer->xLength - ( size_t ) 1 ) )
+        {
+            /* The message would not fit even if the entire buffer was empty,
+             * so don't wait for space. */
+            xTicksToWait = ( TickType_t ) 0;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-    if( pxStreamBuffer->xHead == xTail )
-    {
-        xReturn = pdTRUE;
-    }
-    else
-    {
-        xReturn = pdFALSE;
+        xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
+
+        if( xSpace >= xRequiredSpace )
+        {
+            pvReturn = ( void * ) &( pxStreamBuffer->pucBuffer[ xPayload ] );
+        }
+        else
+        {
+            traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+        }
+
+        return pvReturn;
     }
 
-    return xReturn;
-}
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
 /*-----------------------------------------------------------*/
 
-BaseType_t xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer )
-{
-    BaseType_t xReturn;
-    size_t xBytesToStoreMessageLength;
-    const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-
-    configASSERT( pxStreamBuffer );
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
 
-    /* This generic version of the receive function is used by both message
-     * buffers, which store discrete messages, and stream buffers, which store a
-     * continuous stream of bytes.  Discrete messages include an additional
-     * sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the message. */
-    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
-    {
-        xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
-    }
-    else
+    void vStreamBufferCommitMessage( StreamBufferHandle_t xStreamBuffer,
+                                     void * const pvReservedMessage,
+                                     size_t xMessageLength )
     {
-        xBytesToStoreMessageLength = 0;
-    }
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xHead, xPayload, xLengthIndex, xRequiredSpace;
+        configMESSAGE_BUFFER_LENGTH_TYPE xLengthToWrite;
 
-    /* True if the available space equals zero. */
-    if( xStreamBufferSpacesAvailable( xStreamBuffer ) <= xBytesToStoreMessageLength )
-    {
-        xReturn = pdTRUE;
-    }
-    else
-    {
-        xReturn = pdFALSE;
-    }
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+        configASSERT( pvReservedMessage );
+        configASSERT( xMessageLength > ( size_t ) 0 );
 
-    return xReturn;
-}
-/*-----------------------------------------------------------*/
+        xHead = pxStreamBuffer->xHead;
+        xPayload = ( size_t ) ( ( uint8_t * ) pvReservedMessage - pxStreamBuffer->pucBuffer ); /*lint !e9079 !e946 !e947 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+        configASSERT( ( xPayload + xMessageLength ) <= pxStreamBuffer->xLength );
 
-BaseType_t xStreamBufferSendCompletedFromISR( StreamBufferHandle_t xStreamBuffer,
-                                              BaseType_t * pxHigherPriorityTaskWoken )
-{
-    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-    BaseType_t xReturn;
-    UBaseType_t uxSavedInterruptStatus;
+        /* The length of the message sits immediately before it. */
+        if( xPayload >= sbBYTES_TO_STORE_MESSAGE_LENGTH )
+        {
+            xLengthIndex = xPayload - sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        }
+        else
+        {
+            xLengthIndex = ( xPayload + pxStreamBuffer->xLength ) - sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        }
 
-    configASSERT( pxStreamBuffer );
+        xRequiredSpace = sbBYTES_TO_STORE_MESSAGE_LENGTH + xMessageLength;
 
-    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
-    {
-        if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )
+        if( xLengthIndex != xHead )
         {
-            ( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToReceive,
-                                         ( uint32_t ) 0,
-                                         eNoAction,
-                                         pxHigherPriorityTaskWoken );
-            ( pxStreamBuffer )->xTaskWaitingToReceive = NULL;
-            xReturn = pdTRUE;
+            /* pvStreamBufferReserveMessage() moved the message to the start of
+             * the buffer, so mark the end of the buffer as padding.  There is
+             * always room for the marker, otherwise the message could not have
+             * wrapped. */
+            configASSERT( xLengthIndex == ( size_t ) 0 );
+            xRequiredSpace += pxStreamBuffer->xLength - xHead;
+            xLengthToWrite = sbMESSAGE_PADDING_MARKER;
+            ( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &xLengthToWrite, sbBYTES_TO_STORE_MESSAGE_LENGTH, xHead );
         }
         else
         {
-            xReturn = pdFALSE;
+            mtCOVERAGE_TEST_MARKER();
         }
-    }
-    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
-    return xReturn;
-}
-/*-----------------------------------------------------------*/
+        configASSERT( xRequiredSpace <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
 
-BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer,
-                                                 BaseType_t * pxHigherPriorityTaskWoken )
-{
-    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-    BaseType_t xReturn;
-    UBaseType_t uxSavedInterruptStatus;
+        xLengthToWrite = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xMessageLength;
+        configASSERT( ( size_t ) xLengthToWrite == xMessageLength );
+        configASSERT( xLengthToWrite != sbMESSAGE_PADDING_MARKER );
+        ( void ) prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &xLengthToWrite, sbBYTES_TO_STORE_MESSAGE_LENGTH, xLengthIndex );
 
-    configASSERT( pxStreamBuffer );
+        /* Publish the padding, length and message in one step. */
+        xHead = xPayload + xMessageLength;
 
-    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
-    {
-        if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )
+        if( xHead >= pxStreamBuffer->xLength )
         {
-            ( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToSend,
-                                         ( uint32_t ) 0,
-                                         eNoAction,
-                                         pxHigherPriorityTaskWoken );
-            ( pxStreamBuffer )->xTaskWaitingToSend = NULL;
-            xReturn = pdTRUE;
+            xHead -= pxStreamBuffer->xLength;
         }
         else
         {
-            xReturn = pdFALSE;
+            mtCOVERAGE_TEST_MARKER();
         }
-    }
-    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
 
-    return xReturn;
-}
-/*-----------------------------------------------------------*/
+        pxStreamBuffer->xHead = xHead;
 
-static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer,
-                                     const uint8_t * pucData,
+        traceSTREAM_BUFFER_SEND( xStreamBuffer, xMessageLength );
+
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+                              StreamBufferSpans_t * const pxSpans,
+                              TickType_t xTicksToWait )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xBytesAvailable, xBytesToStoreMessageLength, xIndex, xCount = 0;
+        configMESSAGE_BUFFER_LENGTH_TYPE xTempLength;
+
+        configASSERT( pxStreamBuffer );
+        configASSERT( pxSpans );
+
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+        }
+        else
+        {
+            xBytesToStoreMessageLength = 0;
+        }
+
+        xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
+        xIndex = pxStreamBuffer->xTail;
+
+        if( xBytesAvailable > xBytesToStoreMessageLength )
+        {
+            if( xBytesToStoreMessageLength != ( size_t ) 0 )
+            {
+                /* Describe only the next message, not its length. */
+                xIndex = prvSkipMessagePadding( pxStreamBuffer, xIndex );
+                xIndex = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xIndex );
+                xCount = ( size_t ) xTempLength;
+            }
+            else
+            {
+                xCount = xBytesAvailable;
+            }
+        }
+        else
+        {
+            traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+        }
+
+        prvGetSpans( pxStreamBuffer, xIndex, xCount, pxSpans );
+
+        return xCount;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    void vStreamBufferConsume( StreamBufferHandle_t xStreamBuffer,
+                               size_t xBytesRead )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xNextTail;
+        configMESSAGE_BUFFER_LENGTH_TYPE xTempLength;
+
+        configASSERT( pxStreamBuffer );
+
+        if( xBytesRead != ( size_t ) 0 )
+        {
+            xNextTail = pxStreamBuffer->xTail;
+
+            if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+            {
+                /* Messages are consumed whole, along with their length and any
+                 * padding in front of them. */
+                configASSERT( prvBytesInBuffer( pxStreamBuffer ) > sbBYTES_TO_STORE_MESSAGE_LENGTH );
+                xNextTail = prvSkipMessagePadding( pxStreamBuffer, xNextTail );
+                xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextTail );
+                configASSERT( ( size_t ) xTempLength == xBytesRead );
+            }
+            else
+            {
+                configASSERT( xBytesRead <= prvBytesInBuffer( pxStreamBuffer ) );
+            }
+
+            xNextTail += xBytesRead;
+
+            if( xNextTail >= pxStreamBuffer->xLength )
+            {
+                xNextTail -= pxStreamBuffer->xLength;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            sbPUBLISH_INDEX();
+            pxStreamBuffer->xTail = xNextTail;
+
+            traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xBytesRead );
+
+            /* Was a task waiting for space in the buffer? */
+            prvRECEIVE_COMPLETED( xStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    size_t xStreamBufferSendVector( StreamBufferHandle_t xStreamBuffer,
+                                    const StreamBufferFragment_t * pxFragments,
+                                    size_t xFragmentCount,
+                                    TickType_t xTicksToWait )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xReturn, xSpace, xRequiredSpace, xDataLengthBytes;
+
+        configASSERT( pxStreamBuffer );
+
+        xDataLengthBytes = prvFragmentsLength( pxFragments, xFragmentCount );
+        xRequiredSpace = prvRequiredSpace( pxStreamBuffer, xDataLengthBytes, &xTicksToWait );
+        xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
+        xReturn = prvWriteVectorToBuffer( pxStreamBuffer, pxFragments, xFragmentCount, xDataLengthBytes, xSpace, xRequiredSpace );
+
+        if( xReturn > ( size_t ) 0 )
+        {
+            traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+            /* Was a task waiting for the data? */
+            if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+            {
+                prvSEND_COMPLETED( pxStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+            traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    size_t xStreamBufferSendVectorFromISR( StreamBufferHandle_t xStreamBuffer,
+                                           const StreamBufferFragment_t * pxFragments,
+                                           size_t xFragmentCount,
+                                           BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xReturn, xSpace, xRequiredSpace, xDataLengthBytes;
+        TickType_t xTicksToWait = ( TickType_t ) 0;
+
+        configASSERT( pxStreamBuffer );
+
+        xDataLengthBytes = prvFragmentsLength( pxFragments, xFragmentCount );
+        xRequiredSpace = prvRequiredSpace( pxStreamBuffer, xDataLengthBytes, &xTicksToWait );
+        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+        xReturn = prvWriteVectorToBuffer( pxStreamBuffer, pxFragments, xFragmentCount, xDataLengthBytes, xSpace, xRequiredSpace );
+
+        if( xReturn > ( size_t ) 0 )
+        {
+            /* Was a task waiting for the data? */
+            if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+            {
+                prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    size_t xStreamBufferReceiveMessages( StreamBufferHandle_t xStreamBuffer,
+                                         void * pvRxData,
+                                         size_t xBufferLengthBytes,
+                                         size_t * const pxMessageLengths,
+                                         size_t xMaxMessages,
+                                         TickType_t xTicksToWait )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xBytesAvailable, xBytesRead = 0, xReturn = 0;
+
+        configASSERT( pvRxData );
+        configASSERT( pxMessageLengths );
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+
+        /* Only wait for the first message. */
+        xBytesAvailable = prvWaitForData( pxStreamBuffer, sbBYTES_TO_STORE_MESSAGE_LENGTH, xTicksToWait );
+
+        if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+        {
+            xReturn = prvReadMessagesFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, pxMessageLengths, xMaxMessages, xBytesAvailable, &xBytesRead );
+
+            /* Was a task waiting for space in the buffer?  It is only notified
+             * once, however many messages were read. */
+            if( xReturn != ( size_t ) 0 )
+            {
+                traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xBytesRead );
+                prvRECEIVE_COMPLETED( xStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    size_t xStreamBufferReceiveMessagesFromISR( StreamBufferHandle_t xStreamBuffer,
+                                                void * pvRxData,
+                                                size_t xBufferLengthBytes,
+                                                size_t * const pxMessageLengths,
+                                                size_t xMaxMessages,
+                                                BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xBytesAvailable, xBytesRead = 0, xReturn = 0;
+
+        configASSERT( pvRxData );
+        configASSERT( pxMessageLengths );
+        configASSERT( pxStreamBuffer );
+        configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 );
+
+        xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+        if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+        {
+            xReturn = prvReadMessagesFromBuffer( pxStreamBuffer, pvRxData, xBufferLengthBytes, pxMessageLengths, xMaxMessages, xBytesAvailable, &xBytesRead );
+
+            /* Was a task waiting for space in the buffer? */
+            if( xReturn != ( size_t ) 0 )
+            {
+                prvRECEIVE_COMPLETED_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xBytesRead );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+static size_t prvReadMessageFromBuffer( StreamBuffer_t * pxStreamBuffer,
+                                        void * pvRxData,
+                                        size_t xBufferLengthBytes,
+                                        size_t xBytesAvailable )
+{
+    size_t xCount, xNextMessageLength;
+    configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+    size_t xNextTail = pxStreamBuffer->xTail;
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        #if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+        {
+            /* Skip any padding placed in front of the message to keep it
+             * contiguous. */
+            xNextTail = prvSkipMessagePadding( pxStreamBuffer, xNextTail );
+
+            if( xNextTail != pxStreamBuffer->xTail )
+            {
+                xBytesAvailable -= pxStreamBuffer->xLength - pxStreamBuffer->xTail;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+
+        /* A discrete message is being received.  First receive the length
+         * of the message. */
+        xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextTail );
+        xNextMessageLength = ( size_t ) xTempNextMessageLength;
+
+        /* Reduce the number of bytes available by the number of bytes just
+         * read out. */
+        xBytesAvailable -= sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+        /* Check there is enough space in the buffer provided by the
+         * user. */
+        if( xNextMessageLength > xBufferLengthBytes )
+        {
+            /* The user has provided insufficient space to read the message. */
+            xNextMessageLength = 0;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        /* A stream of bytes is being received (as opposed to a discrete
+         * message), so read as many bytes as possible. */
+        xNextMessageLength = xBufferLengthBytes;
+    }
+
+    /* Use the minimum of the wanted bytes and the available bytes. */
+    xCount = configMIN( xNextMessageLength, xBytesAvailable );
+
+    if( xCount != ( size_t ) 0 )
+    {
+        /* Read the actual data and update the tail to mark the data as officially consumed. */
+        xNextTail = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xCount, xNextTail ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
+        sbPUBLISH_INDEX();
+        pxStreamBuffer->xTail = xNextTail;
+    }
+
+    return xCount;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferIsEmpty( StreamBufferHandle_t xStreamBuffer )
+{
+    const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    BaseType_t xReturn;
+    size_t xTail;
+
+    configASSERT( pxStreamBuffer );
+
+    /* True if no bytes are available. */
+    xTail = pxStreamBuffer->xTail;
+
+    if( pxStreamBuffer->xHead == xTail )
+    {
+        xReturn = pdTRUE;
+    }
+    else
+    {
+        xReturn = pdFALSE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferIsFull( StreamBufferHandle_t xStreamBuffer )
+{
+    BaseType_t xReturn;
+    size_t xBytesToStoreMessageLength;
+    const StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+    configASSERT( pxStreamBuffer );
+
+    /* This generic version of the receive function is used by both message
+     * buffers, which store discrete messages, and stream buffers, which store a
+     * continuous stream of bytes.  Discrete messages include an additional
+     * sbBYTES_TO_STORE_MESSAGE_LENGTH bytes that hold the length of the message. */
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xBytesToStoreMessageLength = sbBYTES_TO_STORE_MESSAGE_LENGTH;
+    }
+    else
+    {
+        xBytesToStoreMessageLength = 0;
+    }
+
+    /* True if the available space equals zero. */
+    if( xStreamBufferSpacesAvailable( xStreamBuffer ) <= xBytesToStoreMessageLength )
+    {
+        xReturn = pdTRUE;
+    }
+    else
+    {
+        xReturn = pdFALSE;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferSendCompletedFromISR( StreamBufferHandle_t xStreamBuffer,
+                                              BaseType_t * pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxStreamBuffer );
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        if( ( pxStreamBuffer )->xTaskWaitingToReceive != NULL )
+        {
+            ( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToReceive,
+                                         ( uint32_t ) 0,
+                                         eNoAction,
+                                         pxHigherPriorityTaskWoken );
+            ( pxStreamBuffer )->xTaskWaitingToReceive = NULL;
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xStreamBufferReceiveCompletedFromISR( StreamBufferHandle_t xStreamBuffer,
+                                                 BaseType_t * pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    BaseType_t xReturn;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxStreamBuffer );
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        if( ( pxStreamBuffer )->xTaskWaitingToSend != NULL )
+        {
+            ( void ) xTaskNotifyFromISR( ( pxStreamBuffer )->xTaskWaitingToSend,
+                                         ( uint32_t ) 0,
+                                         eNoAction,
+                                         pxHigherPriorityTaskWoken );
+            ( pxStreamBuffer )->xTaskWaitingToSend = NULL;
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+
+    void vStreamBufferSetHostDoorbell( StreamBufferHandle_t xStreamBuffer,
+                                       UBaseType_t uxInterruptNumber )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        configASSERT( pxStreamBuffer );
+        configASSERT( uxInterruptNumber != sbNO_HOST_DOORBELL );
+
+        /* The host writer's thread belongs to no kernel instance, so it must
+         * be told which instance's interrupt to raise. */
+        pxStreamBuffer->uxHostKernelInstance = ( UBaseType_t ) portGET_KERNEL_INSTANCE();
+        pxStreamBuffer->uxHostDoorbell = uxInterruptNumber;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_HOST_WRITER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+
+    size_t xStreamBufferSendFromHost( StreamBufferHandle_t xStreamBuffer,
+                                      const void * pvTxData,
+                                      size_t xDataLengthBytes )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+        size_t xReturn, xSpace;
+        size_t xRequiredSpace = xDataLengthBytes;
+
+        configASSERT( pvTxData );
+        configASSERT( pxStreamBuffer );
+        configASSERT( pxStreamBuffer->uxHostDoorbell != sbNO_HOST_DOORBELL );
+
+        /* This runs on a thread the kernel knows nothing about, so it must not
+         * enter a critical section or call any other kernel function - the
+         * indexes alone keep the writer and the reading task apart, as they
+         * do for the other functions that write to the buffer. */
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+            /* Overflow? */
+            configASSERT( xRequiredSpace > xDataLengthBytes );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+        xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+
+        if( xReturn > ( size_t ) 0 )
+        {
+            /* The reading task sets xTaskWaitingToReceive and then looks for
+             * data, so with the new head published first either it sees the
+             * data or it is seen waiting here.  Only a waiting task needs the
+             * doorbell, and only one doorbell is needed until its handler
+             * runs. */
+            atomic_thread_fence( memory_order_seq_cst );
+
+            if( ( atomic_load_explicit( &( pxStreamBuffer->xTaskWaitingToReceive ), memory_order_seq_cst ) != NULL ) &&
+                ( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes ) &&
+                ( atomic_exchange_explicit( &( pxStreamBuffer->xHostDoorbellPending ), ( size_t ) 1, memory_order_acq_rel ) == ( size_t ) 0 ) )
+            {
+                portHOST_RAISE_INTERRUPT( pxStreamBuffer->uxHostKernelInstance, pxStreamBuffer->uxHostDoorbell );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_HOST_WRITER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+
+    BaseType_t xStreamBufferHostDoorbellFromISR( StreamBufferHandle_t xStreamBuffer,
+                                                 BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        configASSERT( pxStreamBuffer );
+
+        /* Clear the doorbell before looking for the waiting task, so a write
+         * that is too late to be seen here rings it again. */
+        atomic_store_explicit( &( pxStreamBuffer->xHostDoorbellPending ), ( size_t ) 0, memory_order_seq_cst );
+
+        return xStreamBufferSendCompletedFromISR( xStreamBuffer, pxHigherPriorityTaskWoken );
+    }
+
+#endif /* configUSE_STREAM_BUFFER_HOST_WRITER */
+/*-----------------------------------------------------------*/
+
+static size_t prvWriteBytesToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                     const uint8_t * pucData,
                                      size_t xCount,
                                      size_t xHead )
 {
@@ -1371,6 +2192,8 @@ static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
     xCount = pxStreamBuffer->xLength + pxStreamBuffer->xHead;
     xCount -= pxStreamBuffer->xTail;
 
+    sbACQUIRE_INDEX();
+
     if( xCount >= pxStreamBuffer->xLength )
     {
         xCount -= pxStreamBuffer->xLength;
@@ -1384,6 +2207,379 @@ static size_t prvBytesInBuffer( const StreamBuffer_t * const pxStreamBuffer )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    static size_t prvSkipMessagePadding( StreamBuffer_t * pxStreamBuffer,
+                                         size_t xTail )
+    {
+        configMESSAGE_BUFFER_LENGTH_TYPE xTempLength;
+
+        ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xTail );
+
+        if( xTempLength == sbMESSAGE_PADDING_MARKER )
+        {
+            xTail = 0;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xTail;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 ) || ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 ) )
+
+    static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                                   size_t xRequiredSpace,
+                                   TickType_t xTicksToWait )
+    {
+        size_t xSpace;
+        TimeOut_t xTimeOut;
+
+        if( xTicksToWait != ( TickType_t ) 0 )
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+
+            do
+            {
+                /* Wait until the required number of bytes are free, in the
+                 * same way as xStreamBufferSend(). */
+                taskENTER_CRITICAL();
+                {
+                    xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+                    if( xSpace < xRequiredSpace )
+                    {
+                        /* Clear notification state as going to wait for space. */
+                        ( void ) xTaskNotifyStateClear( NULL );
+
+                        /* Should only be one writer. */
+                        configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+                        pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+                    }
+                    else
+                    {
+                        taskEXIT_CRITICAL();
+                        break;
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
+                ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+                pxStreamBuffer->xTaskWaitingToSend = NULL;
+            } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The reader can only have freed more space since the last check. */
+        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+        return xSpace;
+    }
+
+#endif /* ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 ) || ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 ) || ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 ) )
+
+    static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+                                  size_t xBytesToStoreMessageLength,
+                                  TickType_t xTicksToWait )
+    {
+        size_t xBytesAvailable;
+
+        if( xTicksToWait != ( TickType_t ) 0 )
+        {
+            /* Checking if there is data and clearing the notification state
+             * must be performed atomically, as in xStreamBufferReceive(). */
+            taskENTER_CRITICAL();
+            {
+                xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+                if( xBytesAvailable <= xBytesToStoreMessageLength )
+                {
+                    traceSTREAM_BUFFER_RECEIVE_EMPTY( pxStreamBuffer );
+
+                    /* Clear notification state as going to wait for data. */
+                    ( void ) xTaskNotifyStateClear( NULL );
+
+                    /* Should only be one reader. */
+                    configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+                    pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+
+                    #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+                    {
+                        /* A host writer publishes its data and then looks for a waiting
+                         * task without entering the critical section, so look for data
+                         * again now that the task is visible to it. */
+                        atomic_thread_fence( memory_order_seq_cst );
+                        xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+                        if( xBytesAvailable > xBytesToStoreMessageLength )
+                        {
+                            pxStreamBuffer->xTaskWaitingToReceive = NULL;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #endif
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xBytesAvailable <= xBytesToStoreMessageLength )
+            {
+                /* Wait for data to be available. */
+                traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( pxStreamBuffer );
+                ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+                pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+                /* Recheck the data available after blocking. */
+                xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+        }
+
+        return xBytesAvailable;
+    }
+
+#endif /* ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 ) || ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+
+    static void prvGetSpans( const StreamBuffer_t * const pxStreamBuffer,
+                             size_t xIndex,
+                             size_t xCount,
+                             StreamBufferSpans_t * const pxSpans )
+    {
+        size_t xFirstLength;
+
+        xFirstLength = configMIN( pxStreamBuffer->xLength - xIndex, xCount );
+
+        pxSpans->pucFirst = &( pxStreamBuffer->pucBuffer[ xIndex ] );
+        pxSpans->xFirstLength = xFirstLength;
+
+        if( xCount > xFirstLength )
+        {
+            pxSpans->pucSecond = pxStreamBuffer->pucBuffer;
+            pxSpans->xSecondLength = xCount - xFirstLength;
+        }
+        else
+        {
+            pxSpans->pucSecond = NULL;
+            pxSpans->xSecondLength = 0;
+        }
+    }
+
+#endif /* configUSE_STREAM_BUFFER_ZERO_COPY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    static size_t prvFragmentsLength( const StreamBufferFragment_t * pxFragments,
+                                      size_t xFragmentCount )
+    {
+        size_t xLength = 0, x;
+
+        configASSERT( ( pxFragments != NULL ) || ( xFragmentCount == ( size_t ) 0 ) );
+
+        for( x = 0; x < xFragmentCount; x++ )
+        {
+            configASSERT( ( pxFragments[ x ].pvData != NULL ) || ( pxFragments[ x ].xLength == ( size_t ) 0 ) );
+
+            /* Overflow? */
+            configASSERT( ( xLength + pxFragments[ x ].xLength ) >= xLength );
+            xLength += pxFragments[ x ].xLength;
+        }
+
+        return xLength;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    static size_t prvRequiredSpace( const StreamBuffer_t * const pxStreamBuffer,
+                                    size_t xDataLengthBytes,
+                                    TickType_t * const pxTicksToWait )
+    {
+        size_t xRequiredSpace = xDataLengthBytes;
+
+        /* The maximum amount of space a stream buffer will ever report is its
+         * length minus 1. */
+        const size_t xMaxReportedSpace = pxStreamBuffer->xLength - ( size_t ) 1;
+
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+
+            /* Overflow? */
+            configASSERT( xRequiredSpace > xDataLengthBytes );
+
+            if( xRequiredSpace > xMaxReportedSpace )
+            {
+                /* The message would not fit even if the entire buffer was
+                 * empty, so don't wait for space. */
+                *pxTicksToWait = ( TickType_t ) 0;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            /* It is acceptable to write only part of the data to a stream
+             * buffer, so never wait for more than the buffer can hold. */
+            xRequiredSpace = configMIN( xRequiredSpace, xMaxReportedSpace );
+        }
+
+        return xRequiredSpace;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    static size_t prvWriteVectorToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                          const StreamBufferFragment_t * pxFragments,
+                                          size_t xFragmentCount,
+                                          size_t xDataLengthBytes,
+                                          size_t xSpace,
+                                          size_t xRequiredSpace )
+    {
+        size_t xNextHead = pxStreamBuffer->xHead, xRemaining, xCount, x;
+        configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
+
+        if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+        {
+            /* Convert xDataLengthBytes to the message length type. */
+            xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xDataLengthBytes;
+
+            /* Ensure the data length given fits within configMESSAGE_BUFFER_LENGTH_TYPE. */
+            configASSERT( ( size_t ) xMessageLength == xDataLengthBytes );
+
+            #if ( configUSE_STREAM_BUFFER_ZERO_COPY == 1 )
+            {
+                /* The largest value of the length type is reserved for padding. */
+                configASSERT( xMessageLength != sbMESSAGE_PADDING_MARKER );
+            }
+            #endif
+
+            if( ( xSpace >= xRequiredSpace ) && ( xDataLengthBytes != ( size_t ) 0 ) )
+            {
+                /* Write the length of the whole message, then the fragments
+                 * after it. */
+                xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xMessageLength ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
+            }
+            else
+            {
+                /* Not enough space, so do not write data to the buffer. */
+                xDataLengthBytes = 0;
+            }
+        }
+        else
+        {
+            /* Write as many bytes as possible, as with xStreamBufferSend(). */
+            xDataLengthBytes = configMIN( xDataLengthBytes, xSpace );
+        }
+
+        if( xDataLengthBytes != ( size_t ) 0 )
+        {
+            xRemaining = xDataLengthBytes;
+
+            for( x = 0; ( x < xFragmentCount ) && ( xRemaining != ( size_t ) 0 ); x++ )
+            {
+                xCount = configMIN( pxFragments[ x ].xLength, xRemaining );
+
+                if( xCount != ( size_t ) 0 )
+                {
+                    xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pxFragments[ x ].pvData, xCount, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+                    xRemaining -= xCount;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            /* Make the whole write visible to the reader in one step. */
+            pxStreamBuffer->xHead = xNextHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xDataLengthBytes;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_STREAM_BUFFER_SCATTER_GATHER == 1 )
+
+    static size_t prvReadMessagesFromBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                             void * pvRxData,
+                                             size_t xBufferLengthBytes,
+                                             size_t * const pxMessageLengths,
+                                             size_t xMaxMessages,
+                                             size_t xBytesAvailable,
+                                             size_t * const pxBytesRead )
+    {
+        uint8_t * const pucRxData = ( uint8_t * ) pvRxData;
+        size_t xLength, xOffset = 0, xReturn = 0;
+
+        while( ( xReturn < xMaxMessages ) && ( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH ) )
+        {
+            xLength = prvReadMessageFromBuffer( pxStreamBuffer, &( pucRxData[ xOffset ] ), xBufferLengthBytes - xOffset, xBytesAvailable );
+
+            if( xLength == ( size_t ) 0 )
+            {
+                /* The next message does not fit, so leave it in the buffer. */
+                break;
+            }
+
+            pxMessageLengths[ xReturn ] = xLength;
+            xOffset += xLength;
+            xReturn++;
+
+            /* The writer may also have added messages since the last check. */
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+        }
+
+        *pxBytesRead = xOffset;
+
+        return xReturn;
+    }
+
+#endif /* configUSE_STREAM_BUFFER_SCATTER_GATHER */
+/*-----------------------------------------------------------*/
+
 static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
                                           uint8_t * const pucBuffer,
                                           size_t xBufferSizeBytes,
@@ -1421,6 +2617,15 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
         ( void ) pxReceiveCompletedCallback;
     }
     #endif
+
+    #if ( configUSE_STREAM_BUFFER_HOST_WRITER == 1 )
+    {
+        pxStreamBuffer->uxHostDoorbell = sbNO_HOST_DOORBELL;
+        pxStreamBuffer->uxHostKernelInstance = ( UBaseType_t ) portGET_KERNEL_INSTANCE();
+        atomic_init( &( pxStreamBuffer->xTaskWaitingToReceive ), NULL );
+        atomic_init( &( pxStreamBuffer->xHostDoorbellPending ), ( size_t ) 0 );
+    }
+    #endif
 }
 
 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -251,6 +251,17 @@
     #define taskEVENT_LIST_ITEM_VALUE_IN_USE    0x8000000000000000ULL
 #endif
 
+/* A task waiting for a mutex records the mutex in its TCB so priority
+ * inheritance can follow chains of mutex holders.  The record is cleared
+ * wherever the task is removed from an event list, while the scheduler is
+ * suspended or from a critical section, so a chain walk never passes through a
+ * task that is no longer waiting. */
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+    #define taskCLEAR_MUTEX_BLOCKED_ON( pxTCB )    ( ( pxTCB )->pvMutexBlockedOn = NULL )
+#else
+    #define taskCLEAR_MUTEX_BLOCKED_ON( pxTCB )
+#endif
+
 /*
  * Task control block.  A task control block (TCB) is allocated for each task,
  * and stores task state information, including a pointer to the task's context
@@ -322,6 +333,19 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+        void * pvHandoffBuffer;    /**< Where a sender can copy an item straight to while the task is blocked in xQueueReceive(), or NULL. */
+        uint8_t ucHandoffComplete; /**< Set to pdTRUE once a sender has copied an item to pvHandoffBuffer. */
+    #endif
+
+    #if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+        void * pvMutexBlockedOn; /**< The mutex the task is blocked waiting to take, or NULL.  Lets priority inheritance follow chains of mutex holders. */
+    #endif
+
+    #if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+        uint64_t ullEventBits; /**< The bits the task waits for in a 64-bit event group, which do not fit in xEventListItem's value when TickType_t is narrower. */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -330,54 +354,45 @@ typedef tskTCB TCB_t;
 
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
-portDONT_DISCARD PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+
+    portDONT_DISCARD PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
 
 /* Lists for ready and blocked tasks. --------------------
  * xDelayedTaskList1 and xDelayedTaskList2 could be moved to function scope but
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
-PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
+    PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
+    PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
+    PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+    PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
+    PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+    PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
-#if ( INCLUDE_vTaskDelete == 1 )
+    #if ( INCLUDE_vTaskDelete == 1 )
 
-    PRIVILEGED_DATA static List_t xTasksWaitingTermination; /**< Tasks that have been deleted - but their memory not yet freed. */
-    PRIVILEGED_DATA static volatile UBaseType_t uxDeletedTasksWaitingCleanUp = ( UBaseType_t ) 0U;
+        PRIVILEGED_DATA static List_t xTasksWaitingTermination; /**< Tasks that have been deleted - but their memory not yet freed. */
+        PRIVILEGED_DATA static volatile UBaseType_t uxDeletedTasksWaitingCleanUp = ( UBaseType_t ) 0U;
 
-#endif
-
-#if ( INCLUDE_vTaskSuspend == 1 )
+    #endif
 
-    PRIVILEGED_DATA static List_t xSuspendedTaskList; /**< Tasks that are currently suspended. */
+    #if ( INCLUDE_vTaskSuspend == 1 )
 
-#endif
+        PRIVILEGED_DATA static List_t xSuspendedTaskList; /**< Tasks that are currently suspended. */
 
-/* Global POSIX errno. Its value is changed upon context switching to match
- * the errno of the currently running task. */
-#if ( configUSE_POSIX_ERRNO == 1 )
-    int FreeRTOS_errno = 0;
-#endif
+    #endif
 
 /* Other file private variables. --------------------------------*/
-PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
-PRIVILEGED_DATA static volatile TickType_t xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
-PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
-PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning = pdFALSE;
-PRIVILEGED_DATA static volatile TickType_t xPendedTicks = ( TickType_t ) 0U;
-PRIVILEGED_DATA static volatile BaseType_t xYieldPending = pdFALSE;
-PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows = ( BaseType_t ) 0;
-PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
-PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
-PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle = NULL;                          /**< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
-
-/* Improve support for OpenOCD. The kernel tracks Ready tasks via priority lists.
- * For tracking the state of remote threads, OpenOCD uses uxTopUsedPriority
- * to determine the number of priority lists to read back from the remote target. */
-const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
+    PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
+    PRIVILEGED_DATA static volatile TickType_t xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
+    PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
+    PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning = pdFALSE;
+    PRIVILEGED_DATA static volatile TickType_t xPendedTicks = ( TickType_t ) 0U;
+    PRIVILEGED_DATA static volatile BaseType_t xYieldPending = pdFALSE;
+    PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows = ( BaseType_t ) 0;
+    PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
+    PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
+    PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle = NULL;                          /**< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
 
 /* Context switches are held pending while the scheduler is suspended.  Also,
  * interrupts must not manipulate the xStateListItem of a TCB, or any of the
@@ -387,17 +402,117 @@ const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
  * kernel to move the task from the pending ready list into the real ready list
  * when the scheduler is unsuspended.  The pending ready list itself can only be
  * accessed from a critical section. */
-PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t ) 0U;
+    PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t ) 0U;
 
-#if ( configGENERATE_RUN_TIME_STATS == 1 )
+    #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+/* Work deferred by interrupts until the next context switch, or until the
+ * scheduler is resumed, in the order it was deferred.  Only accessed with
+ * interrupts masked. */
+        PRIVILEGED_DATA static TaskDeferredWork_t * pxDeferredWorkHead = NULL;
+        PRIVILEGED_DATA static TaskDeferredWork_t * pxDeferredWorkTail = NULL;
+
+    #endif
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
 
 /* Do not move these variables to function scope as doing so prevents the
  * code working with debuggers that need to remove the static qualifier. */
-    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime = 0UL;    /**< Holds the value of a timer/counter the last time a task was switched in. */
-    PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0UL; /**< Holds the total amount of execution time as defined by the run time counter clock. */
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime = 0UL;    /**< Holds the value of a timer/counter the last time a task was switched in. */
+        PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0UL; /**< Holds the total amount of execution time as defined by the run time counter clock. */
+
+    #endif
+
+#else /* configNUMBER_OF_KERNEL_INSTANCES */
+
+/* Each kernel instance has its own copy of the variables above, selected by the
+ * instance of the calling thread - see vTaskSetKernelInstance().  The names
+ * used by the rest of this file refer to the copy of the current instance. */
+    typedef struct tskKernelInstanceState
+    {
+        TCB_t * volatile pxCurrentTCB;
+        List_t pxReadyTasksLists[ configMAX_PRIORITIES ];
+        List_t xDelayedTaskList1;
+        List_t xDelayedTaskList2;
+        List_t * volatile pxDelayedTaskList;
+        List_t * volatile pxOverflowDelayedTaskList;
+        List_t xPendingReadyList;
+
+        #if ( INCLUDE_vTaskDelete == 1 )
+            List_t xTasksWaitingTermination;
+            volatile UBaseType_t uxDeletedTasksWaitingCleanUp;
+        #endif
+
+        #if ( INCLUDE_vTaskSuspend == 1 )
+            List_t xSuspendedTaskList;
+        #endif
+
+        volatile UBaseType_t uxCurrentNumberOfTasks;
+        volatile TickType_t xTickCount;
+        volatile UBaseType_t uxTopReadyPriority;
+        volatile BaseType_t xSchedulerRunning;
+        volatile TickType_t xPendedTicks;
+        volatile BaseType_t xYieldPending;
+        volatile BaseType_t xNumOfOverflows;
+        UBaseType_t uxTaskNumber;
+        volatile TickType_t xNextTaskUnblockTime;
+        TaskHandle_t xIdleTaskHandle;
+        volatile UBaseType_t uxSchedulerSuspended;
+
+        #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+            TaskDeferredWork_t * pxDeferredWorkHead;
+            TaskDeferredWork_t * pxDeferredWorkTail;
+        #endif
 
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime;
+            volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime;
+        #endif
+    } KernelInstanceState_t;
+
+    PRIVILEGED_DATA static KernelInstanceState_t xKernelInstances[ configNUMBER_OF_KERNEL_INSTANCES ];
+
+    #define tskKERNEL_INSTANCE              ( xKernelInstances[ portGET_KERNEL_INSTANCE() ] )
+
+    #define pxCurrentTCB                    ( tskKERNEL_INSTANCE.pxCurrentTCB )
+    #define pxReadyTasksLists               ( tskKERNEL_INSTANCE.pxReadyTasksLists )
+    #define xDelayedTaskList1               ( tskKERNEL_INSTANCE.xDelayedTaskList1 )
+    #define xDelayedTaskList2               ( tskKERNEL_INSTANCE.xDelayedTaskList2 )
+    #define pxDelayedTaskList               ( tskKERNEL_INSTANCE.pxDelayedTaskList )
+    #define pxOverflowDelayedTaskList       ( tskKERNEL_INSTANCE.pxOverflowDelayedTaskList )
+    #define xPendingReadyList               ( tskKERNEL_INSTANCE.xPendingReadyList )
+    #define xTasksWaitingTermination        ( tskKERNEL_INSTANCE.xTasksWaitingTermination )
+    #define uxDeletedTasksWaitingCleanUp    ( tskKERNEL_INSTANCE.uxDeletedTasksWaitingCleanUp )
+    #define xSuspendedTaskList              ( tskKERNEL_INSTANCE.xSuspendedTaskList )
+    #define uxCurrentNumberOfTasks          ( tskKERNEL_INSTANCE.uxCurrentNumberOfTasks )
+    #define xTickCount                      ( tskKERNEL_INSTANCE.xTickCount )
+    #define uxTopReadyPriority              ( tskKERNEL_INSTANCE.uxTopReadyPriority )
+    #define xSchedulerRunning               ( tskKERNEL_INSTANCE.xSchedulerRunning )
+    #define xPendedTicks                    ( tskKERNEL_INSTANCE.xPendedTicks )
+    #define xYieldPending                   ( tskKERNEL_INSTANCE.xYieldPending )
+    #define xNumOfOverflows                 ( tskKERNEL_INSTANCE.xNumOfOverflows )
+    #define uxTaskNumber                    ( tskKERNEL_INSTANCE.uxTaskNumber )
+    #define xNextTaskUnblockTime            ( tskKERNEL_INSTANCE.xNextTaskUnblockTime )
+    #define xIdleTaskHandle                 ( tskKERNEL_INSTANCE.xIdleTaskHandle )
+    #define uxSchedulerSuspended            ( tskKERNEL_INSTANCE.uxSchedulerSuspended )
+    #define pxDeferredWorkHead              ( tskKERNEL_INSTANCE.pxDeferredWorkHead )
+    #define pxDeferredWorkTail              ( tskKERNEL_INSTANCE.pxDeferredWorkTail )
+    #define ulTaskSwitchedInTime            ( tskKERNEL_INSTANCE.ulTaskSwitchedInTime )
+    #define ulTotalRunTime                  ( tskKERNEL_INSTANCE.ulTotalRunTime )
+
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
+
+/* Global POSIX errno. Its value is changed upon context switching to match
+ * the errno of the currently running task. */
+#if ( configUSE_POSIX_ERRNO == 1 )
+    int FreeRTOS_errno = 0;
 #endif
 
+/* Improve support for OpenOCD. The kernel tracks Ready tasks via priority lists.
+ * For tracking the state of remote threads, OpenOCD uses uxTopUsedPriority
+ * to determine the number of priority lists to read back from the remote target. */
+const volatile UBaseType_t uxTopUsedPriority = configMAX_PRIORITIES - 1U;
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -520,6 +635,27 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+/*
+ * Run, and empty, the work deferred by vTaskDeferFromISR().  Must be called
+ * with interrupts masked and the scheduler suspended.
+ */
+    static void prvRunDeferredWork( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+/*
+ * Called when the priority of a task that is blocked waiting for a mutex
+ * changes, to move the task to its new position in the mutex's event list so
+ * the mutex is given to the highest priority waiting task.
+ */
+    static void prvRepositionInMutexEventList( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -1137,6 +1273,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
             {
                 ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+                taskCLEAR_MUTEX_BLOCKED_ON( pxTCB );
             }
             else
             {
@@ -1711,6 +1848,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
             {
                 ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+                taskCLEAR_MUTEX_BLOCKED_ON( pxTCB );
             }
             else
             {
@@ -2101,6 +2239,56 @@ void vTaskEndScheduler( void )
 }
 /*----------------------------------------------------------*/
 
+void vTaskResetState( void )
+{
+    /* The task lists are initialised again when the first task is created. */
+    pxCurrentTCB = NULL;
+
+    #if ( INCLUDE_vTaskDelete == 1 )
+    {
+        uxDeletedTasksWaitingCleanUp = ( UBaseType_t ) 0U;
+    }
+    #endif
+
+    uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
+    xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
+    uxTopReadyPriority = tskIDLE_PRIORITY;
+    xSchedulerRunning = pdFALSE;
+    xPendedTicks = ( TickType_t ) 0U;
+    xYieldPending = pdFALSE;
+    xNumOfOverflows = ( BaseType_t ) 0;
+    uxTaskNumber = ( UBaseType_t ) 0U;
+    xNextTaskUnblockTime = ( TickType_t ) 0U;
+    xIdleTaskHandle = NULL;
+    uxSchedulerSuspended = ( UBaseType_t ) 0U;
+
+    #if ( configGENERATE_RUN_TIME_STATS == 1 )
+    {
+        ulTaskSwitchedInTime = 0UL;
+        ulTotalRunTime = 0UL;
+    }
+    #endif
+}
+/*----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+
+    void vTaskSetKernelInstance( UBaseType_t uxInstance )
+    {
+        configASSERT( uxInstance < ( UBaseType_t ) configNUMBER_OF_KERNEL_INSTANCES );
+
+        portSET_KERNEL_INSTANCE( uxInstance );
+    }
+/*----------------------------------------------------------*/
+
+    UBaseType_t uxTaskGetKernelInstance( void )
+    {
+        return ( UBaseType_t ) portGET_KERNEL_INSTANCE();
+    }
+
+#endif /* configNUMBER_OF_KERNEL_INSTANCES */
+/*----------------------------------------------------------*/
+
 void vTaskSuspendAll( void )
 {
     /* A critical section is not required as the variable is of type
@@ -2201,6 +2389,22 @@ BaseType_t xTaskResumeAll( void )
      * tasks from this list into their appropriate ready list. */
     taskENTER_CRITICAL();
     {
+        #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+        {
+            /* Interrupts defer work to the next context switch, which cannot
+             * happen while the scheduler is suspended, so run it now while the
+             * scheduler is still suspended. */
+            if( uxSchedulerSuspended == ( UBaseType_t ) 1U )
+            {
+                prvRunDeferredWork();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+
         --uxSchedulerSuspended;
 
         if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
@@ -2729,6 +2933,7 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                     if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
                     {
                         ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+                        taskCLEAR_MUTEX_BLOCKED_ON( pxTCB );
 
                         /* This lets the task know it was forcibly removed from the
                          * blocked state so it should not re-evaluate its block time and
@@ -2858,6 +3063,7 @@ BaseType_t xTaskIncrementTick( void )
                     if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
                     {
                         listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+                        taskCLEAR_MUTEX_BLOCKED_ON( pxTCB );
                     }
                     else
                     {
@@ -2935,6 +3141,21 @@ BaseType_t xTaskIncrementTick( void )
             {
                 mtCOVERAGE_TEST_MARKER();
             }
+
+            #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+            {
+                /* Work deferred by an interrupt that did not request a context
+                 * switch runs in the switch requested here. */
+                if( pxDeferredWorkHead != NULL )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            #endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
         }
         #endif /* configUSE_PREEMPTION */
     }
@@ -3077,6 +3298,25 @@ void vTaskSwitchContext( void )
     }
     else
     {
+        #if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+        {
+            /* Run the work deferred by the interrupts that requested this
+             * switch before a task is selected, so any task it unblocks can be
+             * selected.  Interrupts are masked here, so no interrupt sees the
+             * scheduler suspended while the work runs. */
+            if( pxDeferredWorkHead != NULL )
+            {
+                ++uxSchedulerSuspended;
+                prvRunDeferredWork();
+                --uxSchedulerSuspended;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        #endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+
         xYieldPending = pdFALSE;
         traceTASK_SWITCHED_OUT();
 
@@ -3248,6 +3488,7 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
     pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
     configASSERT( pxUnblockedTCB );
     listREMOVE_ITEM( &( pxUnblockedTCB->xEventListItem ) );
+    taskCLEAR_MUTEX_BLOCKED_ON( pxUnblockedTCB );
 
     if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
     {
@@ -3364,6 +3605,211 @@ void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    void vTaskPlaceOnEventBitsList( List_t * pxEventList,
+                                    const uint64_t ullEventBits,
+                                    const TickType_t xTicksToWait )
+    {
+        /* Called with the scheduler suspended, as for
+         * vTaskPlaceOnUnorderedEventList(). */
+        pxCurrentTCB->ullEventBits = ullEventBits;
+        vTaskPlaceOnUnorderedEventList( pxEventList, ( TickType_t ) 0, xTicksToWait );
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    uint64_t ullTaskGetEventBits( const ListItem_t * pxEventListItem )
+    {
+        const TCB_t * pxTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+        return pxTCB->ullEventBits;
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    void vTaskRemoveFromEventBitsList( ListItem_t * pxEventListItem,
+                                       const uint64_t ullEventBits )
+    {
+        TCB_t * pxTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+        pxTCB->ullEventBits = ullEventBits;
+        vTaskRemoveFromUnorderedEventList( pxEventListItem, ( TickType_t ) 0 );
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_64_BIT_EVENT_GROUPS == 1 )
+
+    uint64_t ullTaskResetEventBits( void )
+    {
+        uint64_t ullReturn = pxCurrentTCB->ullEventBits;
+
+        pxCurrentTCB->ullEventBits = 0;
+        ( void ) uxTaskResetEventItemValue();
+
+        return ullReturn;
+    }
+
+#endif /* configUSE_64_BIT_EVENT_GROUPS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+
+    void vTaskSetHandoffBuffer( void * pvBuffer )
+    {
+        /* Called with the scheduler suspended, so no sender can look at the
+         * buffer until the task is on the event list. */
+        pxCurrentTCB->pvHandoffBuffer = pvBuffer;
+        pxCurrentTCB->ucHandoffComplete = pdFALSE;
+    }
+
+#endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+
+    void * pvTaskTakeHandoffBuffer( const List_t * const pxEventList )
+    {
+        TCB_t * const pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        void * pvReturn = pxTCB->pvHandoffBuffer;
+
+        /* Called from a critical section.  The buffer can only be taken once,
+         * and the caller will remove pxTCB from the event list before the
+         * critical section is exited. */
+        if( pvReturn != NULL )
+        {
+            pxTCB->pvHandoffBuffer = NULL;
+            pxTCB->ucHandoffComplete = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pvReturn;
+    }
+
+#endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_DIRECT_HANDOFF == 1 )
+
+    BaseType_t xTaskClearHandoffBuffer( void )
+    {
+        BaseType_t xReturn = ( BaseType_t ) pxCurrentTCB->ucHandoffComplete;
+
+        pxCurrentTCB->pvHandoffBuffer = NULL;
+        pxCurrentTCB->ucHandoffComplete = pdFALSE;
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_DIRECT_HANDOFF */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+    void vTaskDeferFromISR( TaskDeferredWork_t * pxWork )
+    {
+        /* Called with interrupts masked. */
+        pxWork->pxNext = NULL;
+
+        if( pxDeferredWorkTail == NULL )
+        {
+            pxDeferredWorkHead = pxWork;
+        }
+        else
+        {
+            pxDeferredWorkTail->pxNext = pxWork;
+        }
+
+        pxDeferredWorkTail = pxWork;
+    }
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+    void vTaskCancelDeferredWork( TaskDeferredWork_t * pxWork )
+    {
+        TaskDeferredWork_t * pxPrevious = NULL;
+        TaskDeferredWork_t * pxIterator = pxDeferredWorkHead;
+
+        /* Called with interrupts masked.  Only the work that is waiting to run
+         * is searched. */
+        while( ( pxIterator != NULL ) && ( pxIterator != pxWork ) )
+        {
+            pxPrevious = pxIterator;
+            pxIterator = pxIterator->pxNext;
+        }
+
+        if( pxIterator != NULL )
+        {
+            if( pxPrevious == NULL )
+            {
+                pxDeferredWorkHead = pxWork->pxNext;
+            }
+            else
+            {
+                pxPrevious->pxNext = pxWork->pxNext;
+            }
+
+            if( pxDeferredWorkTail == pxWork )
+            {
+                pxDeferredWorkTail = pxPrevious;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 )
+
+    static void prvRunDeferredWork( void )
+    {
+        TaskDeferredWork_t * pxWork;
+
+        /* Work is removed before it runs, so it can be deferred again by an
+         * interrupt that occurs as soon as interrupts are unmasked. */
+        while( pxDeferredWorkHead != NULL )
+        {
+            pxWork = pxDeferredWorkHead;
+            pxDeferredWorkHead = pxWork->pxNext;
+
+            if( pxDeferredWorkHead == NULL )
+            {
+                pxDeferredWorkTail = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxWork->pxFunction( pxWork );
+        }
+    }
+
+#endif /* configUSE_EVENT_GROUP_DIRECT_ISR_SET */
+/*-----------------------------------------------------------*/
+
 BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut,
                                  TickType_t * const pxTicksToWait )
 {
@@ -3435,6 +3881,11 @@ void vTaskMissedYield( void )
 }
 /*-----------------------------------------------------------*/
 
+/* uxTaskNumber below is the TCB member, not the kernel instance's counter. */
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    #undef uxTaskNumber
+#endif
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
     UBaseType_t uxTaskGetTaskNumber( TaskHandle_t xTask )
@@ -3474,6 +3925,10 @@ void vTaskMissedYield( void )
 
 #endif /* configUSE_TRACE_FACILITY */
 
+#if ( configNUMBER_OF_KERNEL_INSTANCES > 1 )
+    #define uxTaskNumber    ( tskKERNEL_INSTANCE.uxTaskNumber )
+#endif
+
 /*
  * -----------------------------------------------------------
  * The Idle task.
@@ -4102,7 +4557,7 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
 /*-----------------------------------------------------------*/
 
-#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+#if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 ) )
 
     BaseType_t xTaskGetSchedulerState( void )
     {
@@ -4127,7 +4582,7 @@ static void prvResetNextTaskUnblockTime( void )
         return xReturn;
     }
 
-#endif /* ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) ) */
+#endif /* ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) || ( configUSE_EVENT_GROUP_DIRECT_ISR_SET == 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( configUSE_MUTEXES == 1 )
@@ -4183,6 +4638,12 @@ static void prvResetNextTaskUnblockTime( void )
                 {
                     /* Just inherit the priority. */
                     pxMutexHolderTCB->uxPriority = pxCurrentTCB->uxPriority;
+
+                    #if ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 )
+                    {
+                        prvRepositionInMutexEventList( pxMutexHolderTCB );
+                    }
+                    #endif
                 }
 
                 traceTASK_PRIORITY_INHERIT( pxMutexHolderTCB, pxCurrentTCB->uxPriority );
@@ -4220,6 +4681,71 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_RW_LOCKS == 1 ) )
+
+    void vTaskHandOverMutex( TaskHandle_t const pxNewMutexHolder,
+                             UBaseType_t uxHighestPriorityWaitingTask )
+    {
+        TCB_t * const pxTCB = pxNewMutexHolder;
+        UBaseType_t uxPriorityUsedOnEntry;
+
+        configASSERT( pxTCB );
+        configASSERT( uxHighestPriorityWaitingTask < ( UBaseType_t ) configMAX_PRIORITIES );
+
+        /* Counted now rather than when the task runs, so the count is right if
+         * a waiting task times out and lowers the new holder's priority
+         * first. */
+        ( pxTCB->uxMutexesHeld )++;
+
+        if( pxTCB->uxPriority < uxHighestPriorityWaitingTask )
+        {
+            /* Only reset the event list item value if the value is not being
+             * used for anything else. */
+            if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+            {
+                listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxHighestPriorityWaitingTask ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            traceTASK_PRIORITY_INHERIT( pxTCB, uxHighestPriorityWaitingTask );
+            uxPriorityUsedOnEntry = pxTCB->uxPriority;
+            pxTCB->uxPriority = uxHighestPriorityWaitingTask;
+
+            /* The task is usually still in xPendingReadyList, having just been
+             * unblocked with the scheduler suspended, in which case it is added
+             * to the ready list of its new priority when the scheduler is
+             * resumed.  Otherwise it is moved if it is in the Ready state, as
+             * there is one Ready list per priority. */
+            if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+            {
+                if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                {
+                    portRESET_READY_PRIORITY( uxPriorityUsedOnEntry, uxTopReadyPriority );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvAddTaskToReadyList( pxTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configUSE_RW_LOCKS == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     BaseType_t xTaskPriorityDisinherit( TaskHandle_t const pxMutexHolder )
@@ -4384,7 +4910,11 @@ static void prvResetNextTaskUnblockTime( void )
                     }
                     else
                     {
-                        mtCOVERAGE_TEST_MARKER();
+                        #if ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 )
+                        {
+                            prvRepositionInMutexEventList( pxTCB );
+                        }
+                        #endif
                     }
                 }
                 else
@@ -4406,6 +4936,55 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+    static void prvRepositionInMutexEventList( TCB_t * const pxTCB )
+    {
+        List_t * const pxEventList = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+        /* Only tasks blocked on a mutex are moved.  A task that has already
+         * been removed from the event list while the scheduler was suspended is
+         * in xPendingReadyList, which is not ordered by priority. */
+        if( ( pxTCB->pvMutexBlockedOn != NULL ) &&
+            ( pxEventList != NULL ) &&
+            ( pxEventList != &xPendingReadyList ) )
+        {
+            ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+            vListInsert( pxEventList, &( pxTCB->xEventListItem ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+    void vTaskSetMutexBlockedOn( void * pvMutex )
+    {
+        /* Called with the scheduler suspended.  The record is cleared by
+         * taskCLEAR_MUTEX_BLOCKED_ON() when the task leaves the event list. */
+        pxCurrentTCB->pvMutexBlockedOn = pvMutex;
+    }
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) )
+
+    void * pvTaskGetMutexBlockedOn( TaskHandle_t xTask )
+    {
+        const TCB_t * const pxTCB = xTask;
+
+        return pxTCB->pvMutexBlockedOn;
+    }
+
+#endif /* ( configUSE_MUTEXES == 1 ) && ( configMAX_PRIORITY_INHERITANCE_DEPTH > 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( portCRITICAL_NESTING_IN_TCB == 1 )
 
     void vTaskEnterCritical( void )
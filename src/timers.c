@@ -128,20 +128,62 @@
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
 
+    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+
 /* The list in which active timers are stored.  Timers are referenced in expire
  * time order, with the nearest expiry time at the front of the list.  Only the
  * timer service task is allowed to access these lists.
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
 
 /* A queue that is used to send commands to the timer service task. */
-    PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
-    PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
+        PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
+        PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
+
+/* The tick count last sampled by the timer service task, used to detect tick
+ * count overflows.  Only accessible to the timer service task. */
+        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U;
+
+    #else /* configNUMBER_OF_KERNEL_INSTANCES */
+
+/* Each kernel instance has its own timer service task, command queue and
+ * active timer lists.  The names used by the rest of this file resolve to the
+ * members belonging to the kernel instance of the calling thread. */
+        typedef struct tmrKernelInstanceState
+        {
+            List_t xActiveTimerList1;
+            List_t xActiveTimerList2;
+            List_t * pxCurrentTimerList;
+            List_t * pxOverflowTimerList;
+            QueueHandle_t xTimerQueue;
+            TaskHandle_t xTimerTaskHandle;
+            TickType_t xLastTime;
+
+            #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+                StaticQueue_t xStaticTimerQueue;
+                uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ];
+            #endif
+        } TimerKernelInstanceState_t;
+
+        PRIVILEGED_DATA static TimerKernelInstanceState_t xTimerKernelInstances[ configNUMBER_OF_KERNEL_INSTANCES ];
+
+        #define tmrKERNEL_INSTANCE           ( xTimerKernelInstances[ portGET_KERNEL_INSTANCE() ] )
+        #define xActiveTimerList1            ( tmrKERNEL_INSTANCE.xActiveTimerList1 )
+        #define xActiveTimerList2            ( tmrKERNEL_INSTANCE.xActiveTimerList2 )
+        #define pxCurrentTimerList           ( tmrKERNEL_INSTANCE.pxCurrentTimerList )
+        #define pxOverflowTimerList          ( tmrKERNEL_INSTANCE.pxOverflowTimerList )
+        #define xTimerQueue                  ( tmrKERNEL_INSTANCE.xTimerQueue )
+        #define xTimerTaskHandle             ( tmrKERNEL_INSTANCE.xTimerTaskHandle )
+        #define xLastTime                    ( tmrKERNEL_INSTANCE.xLastTime )
+        #define xStaticTimerQueue            ( tmrKERNEL_INSTANCE.xStaticTimerQueue )
+        #define ucStaticTimerQueueStorage    ( tmrKERNEL_INSTANCE.ucStaticTimerQueueStorage )
+
+    #endif /* configNUMBER_OF_KERNEL_INSTANCES */
 
 /*lint -restore */
 
@@ -715,7 +757,6 @@
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
         xTimeNow = xTaskGetTickCount();
 
@@ -970,8 +1011,10 @@
                 {
                     /* The timer queue is allocated statically in case
                      * configSUPPORT_DYNAMIC_ALLOCATION is 0. */
-                    PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueue;                                                                          /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
-                    PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ]; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+                    #if ( configNUMBER_OF_KERNEL_INSTANCES == 1 )
+                        PRIVILEGED_DATA static StaticQueue_t xStaticTimerQueue;                                                                          /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+                        PRIVILEGED_DATA static uint8_t ucStaticTimerQueueStorage[ ( size_t ) configTIMER_QUEUE_LENGTH * sizeof( DaemonTaskMessage_t ) ]; /*lint !e956 Ok to declare in this manner to prevent additional conditional compilation guards in other locations. */
+                    #endif
 
                     xTimerQueue = xQueueCreateStatic( ( UBaseType_t ) configTIMER_QUEUE_LENGTH, ( UBaseType_t ) sizeof( DaemonTaskMessage_t ), &( ucStaticTimerQueueStorage[ 0 ] ), &xStaticTimerQueue );
                 }
@@ -1140,6 +1183,16 @@
     #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
+    void vTimerResetState( void )
+    {
+        /* The lists and command queue are created again by the next call to
+         * xTimerCreateTimerTask() or xTimerCreate(). */
+        xTimerQueue = NULL;
+        xTimerTaskHandle = NULL;
+        xLastTime = ( TickType_t ) 0U;
+    }
+/*-----------------------------------------------------------*/
+
 /* This entire source file will be skipped if the application is not configured
  * to include software timer functionality.  If you want to include software timer
  * functionality then ensure configUSE_TIMERS is set to 1 in FreeRTOSConfig.h. */